@@ -1,11 +1,15 @@
 
 #include "helpers/infrared_parser.h"
 #include "infrared_app_brute_force.h"
-#include "infrared_app_signal.h"
 #include <memory>
-#include <m-string.h>
+#include <string.h>
 #include <furi.h>
 #include <file_worker_cpp.h>
+#include <infrared_transmit.h>
+#include <infrared_worker.h>
+
+#define INFRARED_BRUTE_FORCE_NAME_SIZE 32
+#define INFRARED_BRUTE_FORCE_KEY_SIZE 16
 
 void InfraredAppBruteForce::add_record(int index, const char* name) {
     records[name].index = index;
@@ -20,17 +24,16 @@ bool InfraredAppBruteForce::calculate_messages() {
     result = flipper_format_file_open_existing(ff, universal_db_filename);
 
     if(result) {
-        InfraredAppSignal signal;
-
-        string_t signal_name;
-        string_init(signal_name);
-        while(flipper_format_read_string(ff, "name", signal_name)) {
-            auto element = records.find(string_get_cstr(signal_name));
+        // Only names are needed here, signals are skipped without parsing
+        FlipperFormatCursor* cursor = flipper_format_cursor_alloc(ff, "name");
+        char signal_name[INFRARED_BRUTE_FORCE_NAME_SIZE];
+        while(flipper_format_cursor_next_record(cursor, signal_name, sizeof(signal_name))) {
+            auto element = records.find(signal_name);
             if(element != records.cend()) {
                 ++element->second.amount;
             }
         }
-        string_clear(signal_name);
+        flipper_format_cursor_free(cursor);
     }
 
     flipper_format_free(ff);
@@ -44,25 +47,73 @@ void InfraredAppBruteForce::stop_bruteforce() {
     if(current_record.size()) {
         furi_assert(ff);
         current_record.clear();
+        flipper_format_cursor_free(cursor);
         flipper_format_free(ff);
+        free(timings);
         furi_record_close("storage");
     }
 }
 
+bool InfraredAppBruteForce::send_record() {
+    char key[INFRARED_BRUTE_FORCE_KEY_SIZE];
+    char value[INFRARED_BRUTE_FORCE_KEY_SIZE];
+    bool is_raw = false;
+    bool is_parsed = false;
+    size_t timings_cnt = 0;
+    uint32_t frequency = 0;
+    float duty_cycle = 0;
+    InfraredMessage message = {};
+    message.protocol = InfraredProtocolUnknown;
+
+    while(flipper_format_cursor_next_key(cursor, key, sizeof(key))) {
+        bool read = true;
+        if(!strcmp(key, "type")) {
+            read = flipper_format_cursor_read_string(cursor, value, sizeof(value));
+            is_raw = read && !strcmp(value, "raw");
+            is_parsed = read && !strcmp(value, "parsed");
+        } else if(!strcmp(key, "frequency")) {
+            read = flipper_format_cursor_read_uint32(cursor, &frequency, 1, NULL);
+        } else if(!strcmp(key, "duty_cycle")) {
+            read = flipper_format_cursor_read_float(cursor, &duty_cycle, 1, NULL);
+        } else if(!strcmp(key, "data")) {
+            read = flipper_format_cursor_read_uint32(
+                cursor, timings, MAX_TIMINGS_AMOUNT, &timings_cnt);
+        } else if(!strcmp(key, "protocol")) {
+            read = flipper_format_cursor_read_string(cursor, value, sizeof(value));
+            message.protocol = infrared_get_protocol_by_name(value);
+        } else if(!strcmp(key, "address")) {
+            read = flipper_format_cursor_read_hex(cursor, (uint8_t*)&message.address, 4, NULL);
+        } else if(!strcmp(key, "command")) {
+            read = flipper_format_cursor_read_hex(cursor, (uint8_t*)&message.command, 4, NULL);
+        }
+        if(!read) return false;
+    }
+
+    bool result = false;
+    if(is_raw && infrared_parser_is_raw_signal_valid(frequency, duty_cycle, timings_cnt)) {
+        infrared_send_raw_ext(timings, timings_cnt, true, frequency, duty_cycle);
+        result = true;
+    } else if(is_parsed && infrared_parser_is_parsed_signal_valid(&message)) {
+        infrared_send(&message, 1);
+        result = true;
+    }
+
+    return result;
+}
+
 bool InfraredAppBruteForce::send_next_bruteforce(void) {
     furi_assert(current_record.size());
     furi_assert(ff);
 
-    InfraredAppSignal signal;
-    std::string signal_name;
+    char signal_name[INFRARED_BRUTE_FORCE_NAME_SIZE];
     bool result = false;
-    do {
-        result = infrared_parser_read_signal(ff, signal, signal_name);
-    } while(result && current_record.compare(signal_name));
-
-    if(result) {
-        signal.transmit();
+    while(flipper_format_cursor_next_record(cursor, signal_name, sizeof(signal_name))) {
+        if(!current_record.compare(signal_name)) {
+            result = send_record();
+            break;
+        }
     }
+
     return result;
 }
 
@@ -84,7 +135,10 @@ bool InfraredAppBruteForce::start_bruteforce(int index, int& record_amount) {
         Storage* storage = static_cast<Storage*>(furi_record_open("storage"));
         ff = flipper_format_file_alloc(storage);
         result = flipper_format_file_open_existing(ff, universal_db_filename);
-        if(!result) {
+        if(result) {
+            cursor = flipper_format_cursor_alloc(ff, "name");
+            timings = static_cast<uint32_t*>(malloc(sizeof(uint32_t) * MAX_TIMINGS_AMOUNT));
+        } else {
             flipper_format_free(ff);
             furi_record_close("storage");
         }
@@ -7,6 +7,7 @@
 #include <unordered_map>
 #include <memory>
 #include <flipper_format/flipper_format.h>
+#include <flipper_format/flipper_format_cursor.h>
 
 /** Class handles brute force mechanic */
 class InfraredAppBruteForce {
@@ -20,6 +21,12 @@ class InfraredAppBruteForce {
     /** Flipper File Format instance */
     FlipperFormat* ff;
 
+    /** Record cursor over 'ff', signals are read straight from it */
+    FlipperFormatCursor* cursor;
+
+    /** Raw signal timings buffer, reused for every signal */
+    uint32_t* timings;
+
     /** Data about every record - index in button panel view
      * and amount of signals, which is need for correct
      * progress bar displaying. */
@@ -39,6 +46,9 @@ class InfraredAppBruteForce {
      */
     std::unordered_map<std::string, Record> records;
 
+    /** Read the rest of the current record and transmit it */
+    bool send_record();
+
 public:
     /** Calculate messages. Walk through the file ('universal_db_name')
      * and calculate amount of records of certain type. */
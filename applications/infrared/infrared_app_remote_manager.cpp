@@ -1,5 +1,8 @@
 #include <file_worker_cpp.h>
 #include <flipper_format/flipper_format.h>
+#include <flipper_format/flipper_format_i.h>
+#include <flipper_format/flipper_format_cursor.h>
+#include <toolbox/stream/stream.h>
 #include "infrared_app_remote_manager.h"
 #include "infrared/helpers/infrared_parser.h"
 #include "infrared/infrared_app_signal.h"
@@ -13,7 +16,12 @@
 #include <storage/storage.h>
 #include "infrared_app.h"
 
+#define TAG "RemoteManager"
+
 static const std::string default_remote_name = "remote";
+static const char* const remote_temp_extension = ".tmp";
+/* Button names are limited by max_button_name_length, keep room for older files */
+static constexpr const size_t button_name_buffer_size = 64;
 
 std::string InfraredAppRemoteManager::make_full_name(
     const std::string& path,
@@ -46,7 +54,11 @@ std::string InfraredAppRemoteManager::find_vacant_remote_name(const std::string&
 
 bool InfraredAppRemoteManager::add_button(const char* button_name, const InfraredAppSignal& signal) {
     remote->buttons.emplace_back(button_name, signal);
-    return store();
+    bool result = store();
+    if(!result) {
+        remote->buttons.pop_back();
+    }
+    return result;
 }
 
 bool InfraredAppRemoteManager::add_remote_with_button(
@@ -75,12 +87,45 @@ std::vector<std::string> InfraredAppRemoteManager::get_button_list(void) const {
     return name_vector;
 }
 
-const InfraredAppSignal& InfraredAppRemoteManager::get_button_data(size_t index) const {
+bool InfraredAppRemoteManager::read_button_signal(
+    FlipperFormat* ff,
+    const InfraredAppRemoteButton& button,
+    InfraredAppSignal& signal) const {
+    std::string name;
+    Stream* stream = flipper_format_get_raw_stream(ff);
+
+    if(!stream_seek(stream, button.offset, StreamOffsetFromStart)) return false;
+    if(!infrared_parser_read_signal(ff, signal, name)) return false;
+    /* file was changed behind our back */
+    return name == button.name;
+}
+
+bool InfraredAppRemoteManager::get_button_data(size_t index, InfraredAppSignal& signal) const {
     furi_check(remote.get() != nullptr);
     auto& buttons = remote->buttons;
     furi_check(index < buttons.size());
+    auto& button = buttons.at(index);
+
+    if(button.signal) {
+        signal = *button.signal;
+        return true;
+    }
+
+    Storage* storage = static_cast<Storage*>(furi_record_open("storage"));
+    FlipperFormat* ff = flipper_format_file_alloc(storage);
+
+    bool result = flipper_format_file_open_existing(
+        ff, make_full_name(remote->path, remote->name).c_str());
+    if(result) {
+        result = read_button_signal(ff, button, signal);
+    }
+    if(!result) {
+        FURI_LOG_E(TAG, "failed to read button \'%s\'", button.name.c_str());
+    }
 
-    return buttons.at(index).signal;
+    flipper_format_free(ff);
+    furi_record_close("storage");
+    return result;
 }
 
 bool InfraredAppRemoteManager::delete_remote() {
@@ -144,8 +189,24 @@ bool InfraredAppRemoteManager::rename_button(uint32_t index, const char* str) {
     auto& buttons = remote->buttons;
     furi_check(index < buttons.size());
 
-    buttons[index].name = str;
-    return store();
+    auto& button = buttons[index];
+
+    /* Stored signal is checked against the button name, read it before the name changes */
+    if(!button.signal) {
+        InfraredAppSignal signal;
+        if(!get_button_data(index, signal)) {
+            return false;
+        }
+        button.signal = std::make_unique<InfraredAppSignal>(signal);
+    }
+
+    std::string old_name = button.name;
+    button.name = str;
+    bool result = store();
+    if(!result) {
+        button.name = old_name;
+    }
+    return result;
 }
 
 size_t InfraredAppRemoteManager::get_number_of_buttons() {
@@ -153,32 +214,70 @@ size_t InfraredAppRemoteManager::get_number_of_buttons() {
     return remote->buttons.size();
 }
 
+/* Signals of stored buttons are copied from the current file one by one,
+ * so remote is written to a temporary file first and then replaces it. */
 bool InfraredAppRemoteManager::store(void) {
     bool result = false;
     FileWorkerCpp file_worker;
 
     if(!file_worker.mkdir(InfraredApp::infrared_directory)) return false;
 
+    std::string filename = make_full_name(remote->path, remote->name);
+    std::string temp_filename = filename + remote_temp_extension;
+    bool has_stored_buttons = false;
+    for(const auto& button : remote->buttons) {
+        if(!button.signal) has_stored_buttons = true;
+    }
+
     Storage* storage = static_cast<Storage*>(furi_record_open("storage"));
-    FlipperFormat* ff = flipper_format_file_alloc(storage);
+    FlipperFormat* ff_in = flipper_format_file_alloc(storage);
+    FlipperFormat* ff_out = flipper_format_file_alloc(storage);
+    std::vector<size_t> offsets;
+    offsets.reserve(remote->buttons.size());
 
-    FURI_LOG_I(
-        "RemoteManager", "store file: \'%s\'", make_full_name(remote->path, remote->name).c_str());
-    result =
-        flipper_format_file_open_always(ff, make_full_name(remote->path, remote->name).c_str());
+    FURI_LOG_I(TAG, "store file: \'%s\'", filename.c_str());
+    result = !has_stored_buttons || flipper_format_file_open_existing(ff_in, filename.c_str());
     if(result) {
-        result = flipper_format_write_header_cstr(ff, "IR signals file", 1);
+        result = flipper_format_file_open_always(ff_out, temp_filename.c_str());
     }
     if(result) {
+        result = flipper_format_write_header_cstr(ff_out, "IR signals file", 1);
+    }
+    if(result) {
+        Stream* stream = flipper_format_get_raw_stream(ff_out);
+        InfraredAppSignal signal;
         for(const auto& button : remote->buttons) {
-            result = infrared_parser_save_signal(ff, button.signal, button.name.c_str());
+            offsets.push_back(stream_tell(stream));
+            if(button.signal) {
+                result = infrared_parser_save_signal(ff_out, *button.signal, button.name);
+            } else {
+                result = read_button_signal(ff_in, button, signal) &&
+                         infrared_parser_save_signal(ff_out, signal, button.name);
+            }
             if(!result) {
                 break;
             }
         }
     }
 
-    flipper_format_free(ff);
+    flipper_format_free(ff_in);
+    flipper_format_free(ff_out);
+
+    if(result) {
+        result = storage_simply_remove(storage, filename.c_str()) &&
+                 (storage_common_rename(storage, temp_filename.c_str(), filename.c_str()) ==
+                  FSE_OK);
+    } else {
+        storage_simply_remove(storage, temp_filename.c_str());
+    }
+
+    if(result) {
+        for(size_t i = 0; i < remote->buttons.size(); ++i) {
+            remote->buttons[i].offset = offsets[i];
+            remote->buttons[i].signal.reset();
+        }
+    }
+
     furi_record_close("storage");
     return result;
 }
@@ -188,7 +287,7 @@ bool InfraredAppRemoteManager::load(const std::string& path, const std::string&
     Storage* storage = static_cast<Storage*>(furi_record_open("storage"));
     FlipperFormat* ff = flipper_format_file_alloc(storage);
 
-    FURI_LOG_I("RemoteManager", "load file: \'%s\'", make_full_name(path, remote_name).c_str());
+    FURI_LOG_I(TAG, "load file: \'%s\'", make_full_name(path, remote_name).c_str());
     result = flipper_format_file_open_existing(ff, make_full_name(path, remote_name).c_str());
     if(result) {
         string_t header;
@@ -202,11 +301,14 @@ bool InfraredAppRemoteManager::load(const std::string& path, const std::string&
     }
     if(result) {
         remote = std::make_unique<InfraredAppRemote>(path, remote_name);
-        InfraredAppSignal signal;
-        std::string signal_name;
-        while(infrared_parser_read_signal(ff, signal, signal_name)) {
-            remote->buttons.emplace_back(signal_name.c_str(), std::move(signal));
+        // Only names and offsets are kept, signals are skipped without parsing
+        FlipperFormatCursor* cursor = flipper_format_cursor_alloc(ff, "name");
+        char button_name[button_name_buffer_size];
+        while(flipper_format_cursor_next_record(cursor, button_name, sizeof(button_name))) {
+            remote->buttons.emplace_back(
+                button_name, flipper_format_cursor_get_record_offset(cursor));
         }
+        flipper_format_cursor_free(cursor);
     }
 
     flipper_format_free(ff);
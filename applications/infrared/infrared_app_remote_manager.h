@@ -10,42 +10,54 @@
 
 #include <infrared_worker.h>
 #include <infrared.h>
+#include <flipper_format/flipper_format.h>
 
 #include <cstdint>
 #include <string>
 #include <memory>
 #include <vector>
 
-/** Class to handle remote button */
+/** Class to handle remote button.
+ * Only name and position in remote file are kept in memory,
+ * signal is read from file when it is needed.
+ */
 class InfraredAppRemoteButton {
     /** Allow field access */
     friend class InfraredAppRemoteManager;
     /** Name of signal */
     std::string name;
-    /** Signal data */
-    InfraredAppSignal signal;
+    /** Offset of button record in remote file */
+    size_t offset;
+    /** Signal data, only for button that is not stored yet */
+    std::unique_ptr<InfraredAppSignal> signal;
 
 public:
-    /** Initialize remote button
+    /** Initialize remote button stored in file
      *
      * @param name - button name
-     * @param signal - signal to copy for remote button
+     * @param offset - offset of button record in remote file
      */
-    InfraredAppRemoteButton(const char* name, const InfraredAppSignal& signal)
+    InfraredAppRemoteButton(const char* name, size_t offset)
         : name(name)
-        , signal(signal) {
+        , offset(offset) {
     }
 
-    /** Initialize remote button
+    /** Initialize remote button that is not stored yet
      *
      * @param name - button name
-     * @param signal - signal to move for remote button
+     * @param signal - signal to copy for remote button
      */
-    InfraredAppRemoteButton(const char* name, InfraredAppSignal&& signal)
+    InfraredAppRemoteButton(const char* name, const InfraredAppSignal& signal)
         : name(name)
-        , signal(std::move(signal)) {
+        , offset(0)
+        , signal(std::make_unique<InfraredAppSignal>(signal)) {
     }
 
+    /** Move constructor */
+    InfraredAppRemoteButton(InfraredAppRemoteButton&& other) = default;
+    /** Move assignment operator */
+    InfraredAppRemoteButton& operator=(InfraredAppRemoteButton&& other) = default;
+
     /** Deinitialize remote button */
     ~InfraredAppRemoteButton() {
     }
@@ -84,6 +96,17 @@ class InfraredAppRemoteManager {
      * @retval full name of remote on disk
      */
     std::string make_full_name(const std::string& path, const std::string& remote_name) const;
+    /** Read button signal from remote file
+     *
+     * @param ff - remote file
+     * @param button - button to read signal for
+     * @param signal - signal to read to
+     * @retval true for success, false otherwise
+     */
+    bool read_button_signal(
+        FlipperFormat* ff,
+        const InfraredAppRemoteButton& button,
+        InfraredAppSignal& signal) const;
 
 public:
     /** Restriction to button name length. Buttons larger are ignored. */
@@ -154,12 +177,13 @@ public:
      */
     size_t get_number_of_buttons();
 
-    /** Get button's signal
+    /** Get button's signal. Signal is read from remote file.
      *
      * @param index - index of interested button
-     * @retval signal
+     * @param signal - signal to read to
+     * @retval true for success, false otherwise
      */
-    const InfraredAppSignal& get_button_data(size_t index) const;
+    bool get_button_data(size_t index, InfraredAppSignal& signal) const;
 
     /** Delete button
      *
@@ -183,7 +207,8 @@ public:
      */
     bool store();
 
-    /** Load data from disk into current remote
+    /** Load button list from disk into current remote.
+     * Signals are not loaded, see get_button_data().
      *
      * @param name - name of remote to load
      * @retval true if success, false otherwise
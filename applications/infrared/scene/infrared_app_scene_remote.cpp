@@ -88,11 +88,15 @@ bool InfraredAppSceneRemote::on_event(InfraredApp* app, InfraredAppEvent* event)
             bool pressed = (event->type == InfraredAppEvent::Type::MenuSelectedPress);
 
             if(pressed && !button_pressed) {
+                InfraredAppSignal button_signal;
+                if(!app->get_remote_manager()->get_button_data(
+                       event->payload.menu_index, button_signal)) {
+                    break;
+                }
+
                 button_pressed = true;
                 app->notify_click_and_green_blink();
 
-                auto button_signal =
-                    app->get_remote_manager()->get_button_data(event->payload.menu_index);
                 if(button_signal.is_raw()) {
                     infrared_worker_set_raw_signal(
                         app->get_infrared_worker(),
@@ -1,81 +1,469 @@
 #include "nfc_emv_parser.h"
+
+#include <furi.h>
+#include <fnv1a-hash.h>
+#include <lib/toolbox/hex.h>
 #include <flipper_format/flipper_format.h>
+#include <flipper_format/flipper_format_cursor.h>
+
+#define TAG "NfcEmvParser"
+
+#define NFC_EMV_PARSER_INDEX_MAGIC (0x49564D45) /* "EMVI" */
+#define NFC_EMV_PARSER_INDEX_VERSION (1)
+#define NFC_EMV_PARSER_KEY_SIZE (16)
+#define NFC_EMV_PARSER_VALUE_SIZE (64)
+#define NFC_EMV_PARSER_READ_SIZE (128)
+#define NFC_EMV_PARSER_INITIAL_CAPACITY (64)
 
 static const char* nfc_resources_header = "Flipper EMV resources";
 static const uint32_t nfc_resources_file_version = 1;
 
-static bool nfc_emv_parser_search_data(
+typedef enum {
+    NfcEmvParserResourceAid,
+    NfcEmvParserResourceCountry,
+    NfcEmvParserResourceCurrency,
+    NfcEmvParserResourceNum,
+} NfcEmvParserResourceType;
+
+static const struct {
+    const char* asset;
+    const char* index;
+} nfc_emv_parser_paths[NfcEmvParserResourceNum] = {
+    {"/ext/nfc/assets/aid.nfc", "/ext/nfc/assets/aid.nfc.idx"},
+    {"/ext/nfc/assets/country_code.nfc", "/ext/nfc/assets/country_code.nfc.idx"},
+    {"/ext/nfc/assets/currency_code.nfc", "/ext/nfc/assets/currency_code.nfc.idx"},
+};
+
+/* Index file: header, entries sorted by key, key pool, value pool. Resource file is
+ * identified by its size and hash, index made for another file is rebuilt. */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t asset_size;
+    uint32_t asset_hash;
+    uint16_t keys_size;
+    uint16_t values_size;
+} NfcEmvParserIndexHeader;
+
+typedef struct {
+    uint16_t key_offset;
+    uint16_t value_offset;
+    uint8_t key_size;
+    uint8_t value_size;
+} NfcEmvParserIndexEntry;
+
+typedef enum {
+    NfcEmvParserResourceStateNone,
+    NfcEmvParserResourceStateLoaded,
+    NfcEmvParserResourceStateFailed,
+} NfcEmvParserResourceState;
+
+typedef struct {
+    NfcEmvParserResourceState state;
+    NfcEmvParserIndexEntry* entries;
+    uint8_t* keys;
+    /** Value pool, only kept in RAM when the index file could not be saved */
+    uint8_t* values;
+    uint16_t count;
+    uint32_t values_offset;
+} NfcEmvParserResource;
+
+struct NfcEmvParser {
+    Storage* storage;
+    NfcEmvParserResource resources[NfcEmvParserResourceNum];
+};
+
+NfcEmvParser* nfc_emv_parser_alloc(Storage* storage) {
+    furi_assert(storage);
+    NfcEmvParser* parser = malloc(sizeof(NfcEmvParser));
+    parser->storage = storage;
+    return parser;
+}
+
+static void nfc_emv_parser_resource_clear(NfcEmvParserResource* resource) {
+    free(resource->entries);
+    free(resource->keys);
+    free(resource->values);
+    resource->entries = NULL;
+    resource->keys = NULL;
+    resource->values = NULL;
+    resource->count = 0;
+}
+
+void nfc_emv_parser_free(NfcEmvParser* parser) {
+    furi_assert(parser);
+    for(size_t i = 0; i < NfcEmvParserResourceNum; i++) {
+        nfc_emv_parser_resource_clear(&parser->resources[i]);
+    }
+    free(parser);
+}
+
+static bool nfc_emv_parser_file_read(File* file, void* data, size_t size) {
+    uint8_t* buffer = data;
+    while(size) {
+        uint16_t chunk = MIN(size, UINT16_MAX);
+        if(storage_file_read(file, buffer, chunk) != chunk) return false;
+        buffer += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+static bool nfc_emv_parser_file_write(File* file, const void* data, size_t size) {
+    const uint8_t* buffer = data;
+    while(size) {
+        uint16_t chunk = MIN(size, UINT16_MAX);
+        if(storage_file_write(file, buffer, chunk) != chunk) return false;
+        buffer += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+static bool nfc_emv_parser_hash_asset(
     Storage* storage,
-    const char* file_name,
-    string_t key,
-    string_t data) {
-    bool parsed = false;
+    const char* path,
+    uint32_t* asset_size,
+    uint32_t* asset_hash) {
+    uint8_t buffer[NFC_EMV_PARSER_READ_SIZE];
+    File* file = storage_file_alloc(storage);
+    bool hashed = false;
+
+    if(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        *asset_size = storage_file_size(file);
+        *asset_hash = FNV_1A_INIT;
+        uint16_t was_read;
+        while((was_read = storage_file_read(file, buffer, sizeof(buffer))) > 0) {
+            *asset_hash = fnv1a_buffer_hash(buffer, was_read, *asset_hash);
+        }
+        hashed = true;
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return hashed;
+}
+
+static int nfc_emv_parser_compare_key(
+    const uint8_t* key_a,
+    uint8_t key_a_size,
+    const uint8_t* key_b,
+    uint8_t key_b_size) {
+    int result = memcmp(key_a, key_b, MIN(key_a_size, key_b_size));
+    if(result) return result;
+    return (int)key_a_size - (int)key_b_size;
+}
+
+static size_t nfc_emv_parser_lower_bound(
+    NfcEmvParserResource* resource,
+    const uint8_t* key,
+    uint8_t key_size,
+    bool* found) {
+    size_t left = 0;
+    size_t right = resource->count;
+    while(left < right) {
+        size_t middle = left + (right - left) / 2;
+        NfcEmvParserIndexEntry* entry = &resource->entries[middle];
+        if(nfc_emv_parser_compare_key(
+               &resource->keys[entry->key_offset], entry->key_size, key, key_size) < 0) {
+            left = middle + 1;
+        } else {
+            right = middle;
+        }
+    }
+
+    *found = false;
+    if(left < resource->count) {
+        NfcEmvParserIndexEntry* entry = &resource->entries[left];
+        *found = nfc_emv_parser_compare_key(
+                     &resource->keys[entry->key_offset], entry->key_size, key, key_size) == 0;
+    }
+    return left;
+}
+
+static bool nfc_emv_parser_load_index(
+    Storage* storage,
+    NfcEmvParserResource* resource,
+    const char* path,
+    uint32_t asset_size,
+    uint32_t asset_hash) {
+    NfcEmvParserIndexHeader header;
+    File* file = storage_file_alloc(storage);
+    bool loaded = false;
+
+    do {
+        if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+        if(!nfc_emv_parser_file_read(file, &header, sizeof(header))) break;
+        if(header.magic != NFC_EMV_PARSER_INDEX_MAGIC ||
+           header.version != NFC_EMV_PARSER_INDEX_VERSION)
+            break;
+        if(header.asset_size != asset_size || header.asset_hash != asset_hash) break;
+        if(header.count == 0) break;
+
+        size_t entries_size = header.count * sizeof(NfcEmvParserIndexEntry);
+        size_t values_offset = sizeof(header) + entries_size + header.keys_size;
+        if(storage_file_size(file) != values_offset + header.values_size) break;
+
+        resource->entries = malloc(entries_size);
+        resource->keys = malloc(header.keys_size);
+        if(!nfc_emv_parser_file_read(file, resource->entries, entries_size)) break;
+        if(!nfc_emv_parser_file_read(file, resource->keys, header.keys_size)) break;
+
+        // Index is trusted after this check, lookups don't check offsets
+        loaded = true;
+        for(size_t i = 0; i < header.count && loaded; i++) {
+            NfcEmvParserIndexEntry* entry = &resource->entries[i];
+            loaded = (entry->key_offset + entry->key_size <= header.keys_size) &&
+                     (entry->value_offset + entry->value_size <= header.values_size) &&
+                     (entry->value_size < NFC_EMV_PARSER_VALUE_SIZE);
+        }
+        resource->count = header.count;
+        resource->values_offset = values_offset;
+    } while(false);
+
+    if(!loaded) nfc_emv_parser_resource_clear(resource);
+    storage_file_close(file);
+    storage_file_free(file);
+    return loaded;
+}
+
+static bool nfc_emv_parser_save_index(
+    Storage* storage,
+    NfcEmvParserResource* resource,
+    const char* path,
+    NfcEmvParserIndexHeader* header) {
+    File* file = storage_file_alloc(storage);
+    bool saved = false;
+
+    do {
+        if(!storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) break;
+        if(!nfc_emv_parser_file_write(file, header, sizeof(NfcEmvParserIndexHeader))) break;
+        if(!nfc_emv_parser_file_write(
+               file, resource->entries, resource->count * sizeof(NfcEmvParserIndexEntry)))
+            break;
+        if(!nfc_emv_parser_file_write(file, resource->keys, header->keys_size)) break;
+        if(!nfc_emv_parser_file_write(file, resource->values, header->values_size)) break;
+        saved = true;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    if(!saved) storage_simply_remove(storage, path);
+    return saved;
+}
+
+/*
+ * Resource files have the same key rules as FlipperFormat, first line with the key wins.
+ * Keys are hex numbers and are stored as bytes, entries are kept sorted while reading.
+ */
+static bool nfc_emv_parser_build_index(
+    Storage* storage,
+    NfcEmvParserResource* resource,
+    const char* path,
+    NfcEmvParserIndexHeader* header) {
+    char key_str[NFC_EMV_PARSER_KEY_SIZE * 2 + 1];
+    char value[NFC_EMV_PARSER_VALUE_SIZE];
+    uint8_t key[NFC_EMV_PARSER_KEY_SIZE];
+    size_t capacity = NFC_EMV_PARSER_INITIAL_CAPACITY;
+    size_t keys_capacity = NFC_EMV_PARSER_INITIAL_CAPACITY * 2;
+    size_t values_capacity = NFC_EMV_PARSER_INITIAL_CAPACITY * 16;
+    size_t keys_size = 0;
+    size_t values_size = 0;
+    bool built = false;
+
     FlipperFormat* file = flipper_format_file_alloc(storage);
     string_t temp_str;
     string_init(temp_str);
+    resource->entries = malloc(capacity * sizeof(NfcEmvParserIndexEntry));
+    resource->keys = malloc(keys_capacity);
+    resource->values = malloc(values_capacity);
 
     do {
         // Open file
-        if(!flipper_format_file_open_existing(file, file_name)) break;
+        if(!flipper_format_file_open_existing(file, path)) break;
         // Read file header and version
         uint32_t version = 0;
         if(!flipper_format_read_header(file, temp_str, &version)) break;
         if(string_cmp_str(temp_str, nfc_resources_header) ||
            (version != nfc_resources_file_version))
             break;
-        if(!flipper_format_read_string(file, string_get_cstr(key), data)) break;
-        parsed = true;
+
+        // Resources have no records, empty record key never matches so every line is read
+        FlipperFormatCursor* cursor = flipper_format_cursor_alloc(file, "");
+        built = true;
+        while(flipper_format_cursor_next_key(cursor, key_str, sizeof(key_str))) {
+            size_t key_str_size = strlen(key_str);
+            if(key_str_size == 0 || key_str_size % 2) continue;
+
+            uint8_t key_size = key_str_size / 2;
+            bool key_valid = true;
+            for(uint8_t i = 0; i < key_size && key_valid; i++) {
+                key_valid = hex_chars_to_uint8(key_str[i * 2], key_str[i * 2 + 1], &key[i]);
+            }
+            if(!key_valid) continue;
+            if(!flipper_format_cursor_read_string(cursor, value, sizeof(value))) continue;
+
+            bool found;
+            size_t index = nfc_emv_parser_lower_bound(resource, key, key_size, &found);
+            if(found) continue;
+
+            uint8_t value_size = strlen(value);
+            if(resource->count == UINT16_MAX || keys_size + key_size > UINT16_MAX ||
+               values_size + value_size > UINT16_MAX) {
+                built = false;
+                break;
+            }
+
+            if(resource->count == capacity) {
+                capacity *= 2;
+                resource->entries =
+                    realloc(resource->entries, capacity * sizeof(NfcEmvParserIndexEntry));
+            }
+            if(keys_size + key_size > keys_capacity) {
+                keys_capacity *= 2;
+                resource->keys = realloc(resource->keys, keys_capacity);
+            }
+            if(values_size + value_size > values_capacity) {
+                values_capacity *= 2;
+                resource->values = realloc(resource->values, values_capacity);
+            }
+
+            memmove(
+                &resource->entries[index + 1],
+                &resource->entries[index],
+                (resource->count - index) * sizeof(NfcEmvParserIndexEntry));
+            NfcEmvParserIndexEntry* entry = &resource->entries[index];
+            entry->key_offset = keys_size;
+            entry->key_size = key_size;
+            entry->value_offset = values_size;
+            entry->value_size = value_size;
+            memcpy(&resource->keys[keys_size], key, key_size);
+            memcpy(&resource->values[values_size], value, value_size);
+            keys_size += key_size;
+            values_size += value_size;
+            resource->count++;
+        }
+        flipper_format_cursor_free(cursor);
     } while(false);
 
     string_clear(temp_str);
     flipper_format_free(file);
+
+    if(!built || resource->count == 0) {
+        nfc_emv_parser_resource_clear(resource);
+        return false;
+    }
+
+    header->count = resource->count;
+    header->keys_size = keys_size;
+    header->values_size = values_size;
+    resource->values_offset =
+        sizeof(NfcEmvParserIndexHeader) + resource->count * sizeof(NfcEmvParserIndexEntry) +
+        keys_size;
+    return true;
+}
+
+static NfcEmvParserResource*
+    nfc_emv_parser_get_resource(NfcEmvParser* parser, NfcEmvParserResourceType type) {
+    NfcEmvParserResource* resource = &parser->resources[type];
+    if(resource->state != NfcEmvParserResourceStateNone) {
+        return resource->state == NfcEmvParserResourceStateLoaded ? resource : NULL;
+    }
+
+    const char* asset_path = nfc_emv_parser_paths[type].asset;
+    const char* index_path = nfc_emv_parser_paths[type].index;
+    NfcEmvParserIndexHeader header = {
+        .magic = NFC_EMV_PARSER_INDEX_MAGIC,
+        .version = NFC_EMV_PARSER_INDEX_VERSION,
+    };
+    resource->state = NfcEmvParserResourceStateFailed;
+
+    do {
+        if(!nfc_emv_parser_hash_asset(
+               parser->storage, asset_path, &header.asset_size, &header.asset_hash))
+            break;
+
+        if(nfc_emv_parser_load_index(
+               parser->storage, resource, index_path, header.asset_size, header.asset_hash)) {
+            resource->state = NfcEmvParserResourceStateLoaded;
+            break;
+        }
+
+        if(!nfc_emv_parser_build_index(parser->storage, resource, asset_path, &header)) break;
+        FURI_LOG_I(TAG, "Index rebuilt: %s, %u entries", asset_path, resource->count);
+        if(nfc_emv_parser_save_index(parser->storage, resource, index_path, &header)) {
+            free(resource->values);
+            resource->values = NULL;
+        }
+        resource->state = NfcEmvParserResourceStateLoaded;
+    } while(false);
+
+    return resource->state == NfcEmvParserResourceStateLoaded ? resource : NULL;
+}
+
+static bool nfc_emv_parser_search_data(
+    NfcEmvParser* parser,
+    NfcEmvParserResourceType type,
+    const uint8_t* key,
+    uint8_t key_size,
+    string_t data) {
+    furi_assert(parser);
+    NfcEmvParserResource* resource = nfc_emv_parser_get_resource(parser, type);
+    if(!resource) return false;
+
+    bool found;
+    size_t index = nfc_emv_parser_lower_bound(resource, key, key_size, &found);
+    if(!found) return false;
+
+    NfcEmvParserIndexEntry* entry = &resource->entries[index];
+    char value[NFC_EMV_PARSER_VALUE_SIZE];
+    bool parsed = false;
+
+    if(resource->values) {
+        memcpy(value, &resource->values[entry->value_offset], entry->value_size);
+        parsed = true;
+    } else {
+        File* file = storage_file_alloc(parser->storage);
+        if(storage_file_open(
+               file, nfc_emv_parser_paths[type].index, FSAM_READ, FSOM_OPEN_EXISTING) &&
+           storage_file_seek(file, resource->values_offset + entry->value_offset, true)) {
+            parsed = storage_file_read(file, value, entry->value_size) == entry->value_size;
+        }
+        storage_file_close(file);
+        storage_file_free(file);
+    }
+
+    if(parsed) {
+        value[entry->value_size] = '\0';
+        string_set_str(data, value);
+    }
     return parsed;
 }
 
 bool nfc_emv_parser_get_aid_name(
-    Storage* storage,
+    NfcEmvParser* parser,
     uint8_t* aid,
     uint8_t aid_len,
     string_t aid_name) {
-    furi_assert(storage);
-    bool parsed = false;
-    string_t key;
-    string_init(key);
-    for(uint8_t i = 0; i < aid_len; i++) {
-        string_cat_printf(key, "%02X", aid[i]);
-    }
-    if(nfc_emv_parser_search_data(storage, "/ext/nfc/assets/aid.nfc", key, aid_name)) {
-        parsed = true;
-    }
-    string_clear(key);
-    return parsed;
+    if(aid_len > NFC_EMV_PARSER_KEY_SIZE) return false;
+    return nfc_emv_parser_search_data(parser, NfcEmvParserResourceAid, aid, aid_len, aid_name);
 }
 
 bool nfc_emv_parser_get_country_name(
-    Storage* storage,
+    NfcEmvParser* parser,
     uint16_t country_code,
     string_t country_name) {
-    bool parsed = false;
-    string_t key;
-    string_init_printf(key, "%04X", country_code);
-    if(nfc_emv_parser_search_data(storage, "/ext/nfc/assets/country_code.nfc", key, country_name)) {
-        parsed = true;
-    }
-    string_clear(key);
-    return parsed;
+    uint8_t key[] = {country_code >> 8, country_code & 0xFF};
+    return nfc_emv_parser_search_data(
+        parser, NfcEmvParserResourceCountry, key, sizeof(key), country_name);
 }
 
 bool nfc_emv_parser_get_currency_name(
-    Storage* storage,
+    NfcEmvParser* parser,
     uint16_t currency_code,
     string_t currency_name) {
-    bool parsed = false;
-    string_t key;
-    string_init_printf(key, "%04X", currency_code);
-    if(nfc_emv_parser_search_data(
-           storage, "/ext/nfc/assets/currency_code.nfc", key, currency_name)) {
-        parsed = true;
-    }
-    string_clear(key);
-    return parsed;
+    uint8_t key[] = {currency_code >> 8, currency_code & 0xFF};
+    return nfc_emv_parser_search_data(
+        parser, NfcEmvParserResourceCurrency, key, sizeof(key), currency_name);
 }
@@ -5,37 +5,56 @@
 #include <m-string.h>
 #include <storage/storage.h>
 
-/** Get EMV application name by number
+/** EMV resources parser
+ *
+ * Each resource file is loaded on first lookup: keys are kept in RAM as a sorted index,
+ * names stay in a binary index file next to the resource and are read one at a time.
+ * Index is rebuilt when it does not match the resource file.
+ */
+typedef struct NfcEmvParser NfcEmvParser;
+
+/** Allocate EMV resources parser. Resources are not read until the first lookup.
  * @param storage Storage instance
+ * @return NfcEmvParser instance
+ */
+NfcEmvParser* nfc_emv_parser_alloc(Storage* storage);
+
+/** Free EMV resources parser
+ * @param parser NfcEmvParser instance
+ */
+void nfc_emv_parser_free(NfcEmvParser* parser);
+
+/** Get EMV application name by number
+ * @param parser NfcEmvParser instance
  * @param aid - AID number array
  * @param aid_len - AID length
  * @param aid_name - string to keep AID name
  * @return - true if AID found, false otherwies
  */
 bool nfc_emv_parser_get_aid_name(
-    Storage* storage,
+    NfcEmvParser* parser,
     uint8_t* aid,
     uint8_t aid_len,
     string_t aid_name);
 
 /** Get country name by country code
- * @param storage Storage instance
+ * @param parser NfcEmvParser instance
  * @param country_code - ISO 3166 country code
  * @param country_name - string to keep country name
  * @return - true if country found, false otherwies
  */
 bool nfc_emv_parser_get_country_name(
-    Storage* storage,
+    NfcEmvParser* parser,
     uint16_t country_code,
     string_t country_name);
 
 /** Get currency name by currency code
- * @param storage Storage instance
+ * @param parser NfcEmvParser instance
  * @param currency_code - ISO 3166 currency code
  * @param currency_name - string to keep currency name
  * @return - true if currency found, false otherwies
  */
 bool nfc_emv_parser_get_currency_name(
-    Storage* storage,
+    NfcEmvParser* parser,
     uint16_t currency_code,
     string_t currency_name);
@@ -1,53 +1,201 @@
 #include "nfc_mf_classic_dict.h"
 
-#include <flipper_format/flipper_format.h>
+#include <furi.h>
 #include <lib/toolbox/args.h>
+#include <lib/toolbox/stream/file_stream.h>
+
+#define TAG "NfcMfClassicDict"
 
 #define NFC_MF_CLASSIC_DICT_PATH "/ext/nfc/assets/mf_classic_dict.nfc"
 
 #define NFC_MF_CLASSIC_KEY_LEN (13)
+/* Larger dictionaries are read from the file as the attack goes, 32 KiB of keys */
+#define NFC_MF_CLASSIC_DICT_RAM_KEYS_MAX (4096)
+
+struct NfcMfClassicDict {
+    size_t total_keys;
+    // Keys in RAM, or NULL when streamed
+    uint64_t* keys;
+    // Streamed dictionary, next_index is the key next read from the stream returns
+    Stream* stream;
+    string_t line;
+    size_t next_index;
+};
 
 bool nfc_mf_classic_dict_check_presence(Storage* storage) {
     furi_assert(storage);
     return storage_common_stat(storage, NFC_MF_CLASSIC_DICT_PATH, NULL) == FSE_OK;
 }
 
-bool nfc_mf_classic_dict_open_file(Stream* stream) {
-    furi_assert(stream);
-    return file_stream_open(stream, NFC_MF_CLASSIC_DICT_PATH, FSAM_READ, FSOM_OPEN_EXISTING);
+static bool nfc_mf_classic_dict_parse_key(string_t line, uint64_t* key) {
+    uint8_t key_byte_tmp = 0;
+    *key = 0;
+
+    if(string_get_char(line, 0) == '#') return false;
+    if(string_size(line) != NFC_MF_CLASSIC_KEY_LEN) return false;
+    for(uint8_t i = 0; i < 12; i += 2) {
+        if(!args_char_to_hex(
+               string_get_char(line, i), string_get_char(line, i + 1), &key_byte_tmp)) {
+            return false;
+        }
+        *key |= (uint64_t)key_byte_tmp << 8 * (5 - i / 2);
+    }
+
+    return true;
 }
 
-void nfc_mf_classic_dict_close_file(Stream* stream) {
-    furi_assert(stream);
-    file_stream_close(stream);
+/* Order by key, then by position, so the first copy of a key sorts first */
+static bool nfc_mf_classic_dict_less(const uint64_t* keys, uint16_t a, uint16_t b) {
+    return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
 }
 
-bool nfc_mf_classic_dict_get_next_key(Stream* stream, uint64_t* key) {
-    furi_assert(stream);
-    furi_assert(key);
-    uint8_t key_byte_tmp = 0;
-    string_t next_line;
-    string_init(next_line);
-    *key = 0;
+static void nfc_mf_classic_dict_sift_down(
+    const uint64_t* keys,
+    uint16_t* order,
+    size_t root,
+    size_t count) {
+    while(root * 2 + 1 < count) {
+        size_t child = root * 2 + 1;
+        if(child + 1 < count && nfc_mf_classic_dict_less(keys, order[child], order[child + 1])) {
+            child++;
+        }
+        if(!nfc_mf_classic_dict_less(keys, order[root], order[child])) break;
+        uint16_t tmp = order[root];
+        order[root] = order[child];
+        order[child] = tmp;
+        root = child;
+    }
+}
+
+/* Drop repeated keys in place, first occurrence stays to keep dictionary priority */
+static void nfc_mf_classic_dict_deduplicate(NfcMfClassicDict* dict) {
+    size_t total_keys = dict->total_keys;
+    uint16_t* order = malloc(total_keys * sizeof(uint16_t));
+    uint8_t* dropped = malloc((total_keys + 7) / 8);
+    for(size_t i = 0; i < total_keys; i++) {
+        order[i] = i;
+    }
 
-    bool next_key_read = false;
-    while(!next_key_read) {
-        if(!stream_read_line(stream, next_line)) break;
-        if(string_get_char(next_line, 0) == '#') continue;
-        if(string_size(next_line) != NFC_MF_CLASSIC_KEY_LEN) continue;
-        for(uint8_t i = 0; i < 12; i += 2) {
-            args_char_to_hex(
-                string_get_char(next_line, i), string_get_char(next_line, i + 1), &key_byte_tmp);
-            *key |= (uint64_t)key_byte_tmp << 8 * (5 - i / 2);
+    // Heapsort, no extra memory and no comparator context needed
+    for(size_t i = total_keys / 2; i-- > 0;) {
+        nfc_mf_classic_dict_sift_down(dict->keys, order, i, total_keys);
+    }
+    for(size_t end = total_keys; end-- > 1;) {
+        uint16_t tmp = order[0];
+        order[0] = order[end];
+        order[end] = tmp;
+        nfc_mf_classic_dict_sift_down(dict->keys, order, 0, end);
+    }
+
+    for(size_t i = 1; i < total_keys; i++) {
+        if(dict->keys[order[i]] == dict->keys[order[i - 1]]) {
+            dropped[order[i] / 8] |= 1 << (order[i] % 8);
         }
-        next_key_read = true;
+    }
+    size_t unique_keys = 0;
+    for(size_t i = 0; i < total_keys; i++) {
+        if(dropped[i / 8] & (1 << (i % 8))) continue;
+        dict->keys[unique_keys++] = dict->keys[i];
     }
 
-    string_clear(next_line);
-    return next_key_read;
+    free(dropped);
+    free(order);
+    dict->total_keys = unique_keys;
+}
+
+/* Next valid key of the stream */
+static bool nfc_mf_classic_dict_read_key(Stream* stream, string_t line, uint64_t* key) {
+    while(stream_read_line(stream, line)) {
+        if(nfc_mf_classic_dict_parse_key(line, key)) return true;
+    }
+    return false;
 }
 
-void nfc_mf_classic_dict_reset(Stream* stream) {
-    furi_assert(stream);
+NfcMfClassicDict* nfc_mf_classic_dict_alloc(Storage* storage) {
+    furi_assert(storage);
+
+    Stream* stream = file_stream_alloc(storage);
+    if(!file_stream_open(stream, NFC_MF_CLASSIC_DICT_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        file_stream_close(stream);
+        stream_free(stream);
+        return NULL;
+    }
+
+    NfcMfClassicDict* dict = malloc(sizeof(NfcMfClassicDict));
+    string_init(dict->line);
+    uint64_t key = 0;
+
+    // Count first, keys are allocated once
+    while(nfc_mf_classic_dict_read_key(stream, dict->line, &key)) {
+        dict->total_keys++;
+    }
     stream_rewind(stream);
+
+    if(!dict->total_keys) {
+        file_stream_close(stream);
+        stream_free(stream);
+        string_clear(dict->line);
+        free(dict);
+        dict = NULL;
+    } else if(dict->total_keys > NFC_MF_CLASSIC_DICT_RAM_KEYS_MAX) {
+        dict->stream = stream;
+        FURI_LOG_I(TAG, "Streaming %d keys", dict->total_keys);
+    } else {
+        size_t keys_in_file = dict->total_keys;
+        dict->keys = malloc(keys_in_file * sizeof(uint64_t));
+        size_t keys_read = 0;
+        while(keys_read < keys_in_file &&
+              nfc_mf_classic_dict_read_key(stream, dict->line, &dict->keys[keys_read])) {
+            keys_read++;
+        }
+        dict->total_keys = keys_read;
+        file_stream_close(stream);
+        stream_free(stream);
+
+        nfc_mf_classic_dict_deduplicate(dict);
+        FURI_LOG_I(
+            TAG,
+            "Loaded %d keys, %d duplicates dropped",
+            dict->total_keys,
+            keys_in_file - dict->total_keys);
+    }
+
+    return dict;
+}
+
+void nfc_mf_classic_dict_free(NfcMfClassicDict* dict) {
+    furi_assert(dict);
+    if(dict->stream) {
+        file_stream_close(dict->stream);
+        stream_free(dict->stream);
+    }
+    string_clear(dict->line);
+    free(dict->keys);
+    free(dict);
+}
+
+size_t nfc_mf_classic_dict_get_total_keys(NfcMfClassicDict* dict) {
+    furi_assert(dict);
+    return dict->total_keys;
+}
+
+uint64_t nfc_mf_classic_dict_get_key(NfcMfClassicDict* dict, size_t index) {
+    furi_assert(dict);
+    furi_assert(index < dict->total_keys);
+    if(dict->keys) return dict->keys[index];
+
+    // Attack goes through keys in order, going back means starting over
+    if(index < dict->next_index) {
+        stream_rewind(dict->stream);
+        dict->next_index = 0;
+    }
+    uint64_t key = 0;
+    while(dict->next_index <= index) {
+        if(!nfc_mf_classic_dict_read_key(dict->stream, dict->line, &key)) {
+            FURI_LOG_E(TAG, "Dictionary changed while in use");
+            break;
+        }
+        dict->next_index++;
+    }
+    return key;
 }
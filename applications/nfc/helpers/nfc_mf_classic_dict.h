@@ -1,15 +1,23 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <storage/storage.h>
-#include <lib/toolbox/stream/file_stream.h>
+
+typedef struct NfcMfClassicDict NfcMfClassicDict;
 
 bool nfc_mf_classic_dict_check_presence(Storage* storage);
 
-bool nfc_mf_classic_dict_open_file(Stream* stream);
+/** Open dictionary. Keys keep file order. Dictionaries of up to 4096 keys are loaded
+ * into RAM without duplicates, larger ones are read from the file as keys are requested.
+ * @param storage Storage instance
+ * @return NfcMfClassicDict* or NULL if dictionary is missing or has no keys
+ */
+NfcMfClassicDict* nfc_mf_classic_dict_alloc(Storage* storage);
 
-void nfc_mf_classic_dict_close_file(Stream* stream);
+void nfc_mf_classic_dict_free(NfcMfClassicDict* dict);
 
-bool nfc_mf_classic_dict_get_next_key(Stream* stream, uint64_t* key);
+size_t nfc_mf_classic_dict_get_total_keys(NfcMfClassicDict* dict);
 
-void nfc_mf_classic_dict_reset(Stream* stream);
+uint64_t nfc_mf_classic_dict_get_key(NfcMfClassicDict* dict, size_t index);
@@ -34,6 +34,9 @@ Nfc* nfc_alloc() {
     // Nfc device
     nfc->dev = nfc_device_alloc();
 
+    // EMV resources
+    nfc->emv_parser = nfc_emv_parser_alloc(nfc->dev->storage);
+
     // Open GUI record
     nfc->gui = furi_record_open("gui");
     view_dispatcher_attach_to_gui(nfc->view_dispatcher, nfc->gui, ViewDispatcherTypeFullscreen);
@@ -90,6 +93,9 @@ Nfc* nfc_alloc() {
 void nfc_free(Nfc* nfc) {
     furi_assert(nfc);
 
+    // EMV resources
+    nfc_emv_parser_free(nfc->emv_parser);
+
     // Nfc device
     nfc_device_free(nfc->dev);
 
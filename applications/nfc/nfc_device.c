@@ -758,6 +758,8 @@ bool nfc_device_save_shadow(NfcDevice* dev, const char* dev_name) {
 static bool nfc_device_load_data(NfcDevice* dev, string_t path) {
     bool parsed = false;
     FlipperFormat* file = flipper_format_file_alloc(dev->storage);
+    // DESFire dumps probe a lot of optional keys, don't rescan the file for each of them
+    flipper_format_set_key_index(file, true);
     NfcDeviceCommonData* data = &dev->dev_data.nfc_data;
     uint32_t data_cnt = 0;
     string_t temp_str;
@@ -684,6 +684,13 @@ void nfc_worker_emulate_mifare_ul(NfcWorker* nfc_worker) {
     }
 }
 
+static bool nfc_worker_mf_classic_has_key(const uint64_t* keys, size_t keys_cnt, uint64_t key) {
+    for(size_t i = 0; i < keys_cnt; i++) {
+        if(keys[i] == key) return true;
+    }
+    return false;
+}
+
 void nfc_worker_mifare_classic_dict_attack(NfcWorker* nfc_worker) {
     furi_assert(nfc_worker->callback);
     rfalNfcDevice* dev_list;
@@ -696,17 +703,18 @@ void nfc_worker_mifare_classic_dict_attack(NfcWorker* nfc_worker) {
     uint64_t curr_key = 0;
     uint16_t curr_sector = 0;
     uint8_t total_sectors = 0;
+    uint64_t found_keys[MF_CLASSIC_SECTORS_MAX * 2];
+    size_t found_keys_cnt = 0;
     NfcWorkerEvent event;
 
-    // Open dictionary
-    nfc_worker->dict_stream = file_stream_alloc(nfc_worker->storage);
-    if(!nfc_mf_classic_dict_open_file(nfc_worker->dict_stream)) {
+    // Load dictionary once for all sectors
+    NfcMfClassicDict* dict = nfc_mf_classic_dict_alloc(nfc_worker->storage);
+    if(!dict) {
         event = NfcWorkerEventNoDictFound;
         nfc_worker->callback(event, nfc_worker->context);
-        nfc_mf_classic_dict_close_file(nfc_worker->dict_stream);
-        stream_free(nfc_worker->dict_stream);
         return;
     }
+    size_t total_keys = nfc_mf_classic_dict_get_total_keys(dict);
 
     // Detect Mifare Classic card
     while(nfc_worker->state == NfcWorkerStateReadMifareClassic) {
@@ -737,6 +745,8 @@ void nfc_worker_mifare_classic_dict_attack(NfcWorker* nfc_worker) {
     if(nfc_worker->state == NfcWorkerStateReadMifareClassic) {
         bool card_removed_notified = false;
         bool card_found_notified = false;
+        uint32_t attempts = 0;
+        uint32_t start_tick = osKernelGetTickCount();
         // Seek for mifare classic keys
         for(curr_sector = 0; curr_sector < total_sectors; curr_sector++) {
             FURI_LOG_I(TAG, "Sector: %d ...", curr_sector);
@@ -744,7 +754,16 @@ void nfc_worker_mifare_classic_dict_attack(NfcWorker* nfc_worker) {
             nfc_worker->callback(event, nfc_worker->context);
             mf_classic_auth_init_context(&auth_ctx, reader.cuid, curr_sector);
             bool sector_key_found = false;
-            while(nfc_mf_classic_dict_get_next_key(nfc_worker->dict_stream, &curr_key)) {
+            // Keys found on previous sectors go first, cards often reuse them
+            for(size_t i = 0; i < found_keys_cnt + total_keys; i++) {
+                if(i < found_keys_cnt) {
+                    curr_key = found_keys[i];
+                } else {
+                    curr_key = nfc_mf_classic_dict_get_key(dict, i - found_keys_cnt);
+                    if(nfc_worker_mf_classic_has_key(found_keys, found_keys_cnt, curr_key)) {
+                        continue;
+                    }
+                }
                 furi_hal_nfc_deactivate();
                 if(furi_hal_nfc_activate_nfca(300, &reader.cuid)) {
                     if(!card_found_notified) {
@@ -763,6 +782,7 @@ void nfc_worker_mifare_classic_dict_attack(NfcWorker* nfc_worker) {
                         curr_sector,
                         (uint32_t)(curr_key >> 32),
                         (uint32_t)curr_key);
+                    attempts++;
                     if(mf_classic_auth_attempt(&tx_rx_ctx, &auth_ctx, curr_key)) {
                         sector_key_found = true;
                         if((auth_ctx.key_a != MF_CLASSIC_NO_KEY) &&
@@ -807,9 +827,25 @@ void nfc_worker_mifare_classic_dict_attack(NfcWorker* nfc_worker) {
                 }
                 // Add sectors to read sequence
                 mf_classic_reader_add_sector(&reader, curr_sector, auth_ctx.key_a, auth_ctx.key_b);
+                // Remember keys for the next sectors
+                if((auth_ctx.key_a != MF_CLASSIC_NO_KEY) &&
+                   !nfc_worker_mf_classic_has_key(found_keys, found_keys_cnt, auth_ctx.key_a)) {
+                    found_keys[found_keys_cnt++] = auth_ctx.key_a;
+                }
+                if((auth_ctx.key_b != MF_CLASSIC_NO_KEY) &&
+                   !nfc_worker_mf_classic_has_key(found_keys, found_keys_cnt, auth_ctx.key_b)) {
+                    found_keys[found_keys_cnt++] = auth_ctx.key_b;
+                }
             }
-            nfc_mf_classic_dict_reset(nfc_worker->dict_stream);
         }
+        uint32_t attack_time_ms =
+            (uint64_t)(osKernelGetTickCount() - start_tick) * 1000 / osKernelGetTickFreq();
+        FURI_LOG_I(
+            TAG,
+            "Dictionary attack: %lu attempts in %lu ms, %lu attempts/s",
+            attempts,
+            attack_time_ms,
+            attack_time_ms ? attempts * 1000 / attack_time_ms : attempts);
     }
 
     if(nfc_worker->state == NfcWorkerStateReadMifareClassic) {
@@ -834,8 +870,7 @@ void nfc_worker_mifare_classic_dict_attack(NfcWorker* nfc_worker) {
         nfc_worker->callback(event, nfc_worker->context);
     }
 
-    nfc_mf_classic_dict_close_file(nfc_worker->dict_stream);
-    stream_free(nfc_worker->dict_stream);
+    nfc_mf_classic_dict_free(dict);
 }
 
 ReturnCode nfc_exchange_full(
@@ -20,7 +20,6 @@
 struct NfcWorker {
     FuriThread* thread;
     Storage* storage;
-    Stream* dict_stream;
 
     NfcDeviceData* dev_data;
 
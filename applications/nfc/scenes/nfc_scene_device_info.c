@@ -1,5 +1,4 @@
 #include "../nfc_i.h"
-#include "../helpers/nfc_emv_parser.h"
 
 enum {
     NfcSceneDeviceInfoUid,
@@ -144,7 +143,7 @@ void nfc_scene_device_info_on_enter(void* context) {
             string_t country_name;
             string_init(country_name);
             if(nfc_emv_parser_get_country_name(
-                   nfc->dev->storage, emv_data->country_code, country_name)) {
+                   nfc->emv_parser, emv_data->country_code, country_name)) {
                 string_printf(display_str, "Reg:%s", string_get_cstr(country_name));
                 bank_card_set_country_name(bank_card, string_get_cstr(display_str));
             }
@@ -154,7 +153,7 @@ void nfc_scene_device_info_on_enter(void* context) {
             string_t currency_name;
             string_init(currency_name);
             if(nfc_emv_parser_get_currency_name(
-                   nfc->dev->storage, emv_data->country_code, currency_name)) {
+                   nfc->emv_parser, emv_data->country_code, currency_name)) {
                 string_printf(display_str, "Cur:%s", string_get_cstr(currency_name));
                 bank_card_set_currency_name(bank_card, string_get_cstr(display_str));
             }
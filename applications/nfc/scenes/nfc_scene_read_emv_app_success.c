@@ -1,5 +1,4 @@
 #include "../nfc_i.h"
-#include "../helpers/nfc_emv_parser.h"
 #include <dolphin/dolphin.h>
 
 #define NFC_SCENE_READ_SUCCESS_SHIFT "              "
@@ -26,7 +25,7 @@ void nfc_scene_read_emv_app_success_on_enter(void* context) {
     string_t aid;
     string_init(aid);
     bool aid_found =
-        nfc_emv_parser_get_aid_name(nfc->dev->storage, emv_data->aid, emv_data->aid_len, aid);
+        nfc_emv_parser_get_aid_name(nfc->emv_parser, emv_data->aid, emv_data->aid_len, aid);
     if(!aid_found) {
         for(uint8_t i = 0; i < emv_data->aid_len; i++) {
             string_cat_printf(aid, "%02X", emv_data->aid[i]);
@@ -1,5 +1,4 @@
 #include "../nfc_i.h"
-#include "../helpers/nfc_emv_parser.h"
 #include <dolphin/dolphin.h>
 
 void nfc_scene_read_emv_data_success_widget_callback(
@@ -51,7 +50,7 @@ void nfc_scene_read_emv_data_success_on_enter(void* context) {
     string_t country_name;
     string_init(country_name);
     if((emv_data->country_code) &&
-       nfc_emv_parser_get_country_name(nfc->dev->storage, emv_data->country_code, country_name)) {
+       nfc_emv_parser_get_country_name(nfc->emv_parser, emv_data->country_code, country_name)) {
         string_t disp_country;
         string_init_printf(disp_country, "Reg:%s", country_name);
         widget_add_string_element(
@@ -64,7 +63,7 @@ void nfc_scene_read_emv_data_success_on_enter(void* context) {
     string_init(currency_name);
     if((emv_data->currency_code) &&
        nfc_emv_parser_get_currency_name(
-           nfc->dev->storage, emv_data->currency_code, currency_name)) {
+           nfc->emv_parser, emv_data->currency_code, currency_name)) {
         string_t disp_currency;
         string_init_printf(disp_currency, "Cur:%s", currency_name);
         widget_add_string_element(
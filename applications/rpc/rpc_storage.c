@@ -234,32 +234,52 @@ static void rpc_system_storage_list_process(const PB_Main* request, void* contex
         finish = true;
     }
 
+    // entries are read ahead, a response worth per storage call
+    StorageBatch* batch = storage_batch_alloc(fs_api, COUNT_OF(list->file));
+    FileInfo fileinfo[COUNT_OF(list->file)];
+    char* name[COUNT_OF(list->file)];
+    bool read_result[COUNT_OF(list->file)];
+    size_t read_index = COUNT_OF(list->file);
+
     while(!finish) {
-        FileInfo fileinfo;
-        char* name = malloc(MAX_NAME_LENGTH + 1);
-        if(storage_dir_read(dir, &fileinfo, name, MAX_NAME_LENGTH)) {
+        if(read_index == COUNT_OF(list->file)) {
+            for(size_t j = 0; j < COUNT_OF(list->file); j++) {
+                name[j] = malloc(MAX_NAME_LENGTH + 1);
+                storage_batch_dir_read(
+                    batch, dir, &fileinfo[j], name[j], MAX_NAME_LENGTH, &read_result[j]);
+            }
+            storage_batch_execute(batch);
+            read_index = 0;
+        }
+
+        if(read_result[read_index]) {
             if(i == COUNT_OF(list->file)) {
                 list->file_count = i;
                 response.has_next = true;
                 rpc_send_and_release(session, &response);
                 i = 0;
             }
-            list->file[i].type = (fileinfo.flags & FSF_DIRECTORY) ? PB_Storage_File_FileType_DIR :
-                                                                    PB_Storage_File_FileType_FILE;
-            list->file[i].size = fileinfo.size;
+            list->file[i].type = (fileinfo[read_index].flags & FSF_DIRECTORY) ?
+                                     PB_Storage_File_FileType_DIR :
+                                     PB_Storage_File_FileType_FILE;
+            list->file[i].size = fileinfo[read_index].size;
             list->file[i].data = NULL;
-            list->file[i].name = name;
+            list->file[i].name = name[read_index];
             ++i;
+            ++read_index;
         } else {
             list->file_count = i;
             finish = true;
-            free(name);
+            for(size_t j = read_index; j < COUNT_OF(list->file); j++) {
+                free(name[j]);
+            }
         }
     }
 
     response.has_next = false;
     rpc_send_and_release(session, &response);
 
+    storage_batch_free(batch);
     storage_dir_close(dir);
     storage_file_free(dir);
 
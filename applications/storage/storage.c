@@ -105,6 +105,7 @@ int32_t storage_srv(void* p) {
     while(1) {
         if(osMessageQueueGet(app->message_queue, &message, NULL, STORAGE_TICK) == osOK) {
             storage_process_message(app, &message);
+            app->message_count++;
         } else {
             storage_tick(app);
         }
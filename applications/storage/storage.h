@@ -39,6 +39,14 @@ typedef struct {
  */
 FuriPubSub* storage_get_pubsub(Storage* storage);
 
+/**
+ * Get the number of messages processed by the storage service.
+ * Useful to measure how many round-trips an operation costs.
+ * @param storage 
+ * @return uint32_t message count
+ */
+uint32_t storage_get_message_count(Storage* storage);
+
 /******************* File Functions *******************/
 
 /** Opens an existing file or create a new one.
@@ -210,6 +218,124 @@ FS_Error storage_common_fs_info(
     uint64_t* total_space,
     uint64_t* free_space);
 
+/******************* Batch Functions *******************/
+
+typedef struct StorageBatch StorageBatch;
+
+/** Allocates a batch of storage operations.
+ * A batch is sent to the storage service as one message, its operations run in the order they were added.
+ * @param storage pointer to the api
+ * @param capacity maximum number of operations
+ * @return StorageBatch* batch
+ */
+StorageBatch* storage_batch_alloc(Storage* storage, size_t capacity);
+
+/** Frees the batch
+ * @param batch pointer to the batch
+ */
+void storage_batch_free(StorageBatch* batch);
+
+/** Adds file open, see storage_file_open. Unlike storage_file_open it does not wait for the file to be closed by others.
+ * @param batch pointer to the batch
+ * @param file pointer to file object
+ * @param path path to file
+ * @param access_mode access mode from FS_AccessMode
+ * @param open_mode open mode from FS_OpenMode
+ * @param result pointer to success flag, may be NULL
+ */
+void storage_batch_file_open(
+    StorageBatch* batch,
+    File* file,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode,
+    bool* result);
+
+/** Adds file close, see storage_file_close
+ * @param batch pointer to the batch
+ * @param file pointer to file object
+ * @param result pointer to success flag, may be NULL
+ */
+void storage_batch_file_close(StorageBatch* batch, File* file, bool* result);
+
+/** Adds file read, data goes straight to the buffer. Several reads make a scatter read.
+ * @param batch pointer to the batch
+ * @param file pointer to file object
+ * @param buff pointer to a buffer that stays valid until the batch is executed
+ * @param bytes_to_read how many bytes to read
+ * @param bytes_read pointer to the number of bytes read, may be NULL
+ */
+void storage_batch_file_read(
+    StorageBatch* batch,
+    File* file,
+    void* buff,
+    uint16_t bytes_to_read,
+    uint16_t* bytes_read);
+
+/** Adds file write, data is taken straight from the buffer
+ * @param batch pointer to the batch
+ * @param file pointer to file object
+ * @param buff pointer to data that stays valid until the batch is executed
+ * @param bytes_to_write how many bytes to write
+ * @param bytes_written pointer to the number of bytes written, may be NULL
+ */
+void storage_batch_file_write(
+    StorageBatch* batch,
+    File* file,
+    const void* buff,
+    uint16_t bytes_to_write,
+    uint16_t* bytes_written);
+
+/** Adds file seek, see storage_file_seek
+ * @param batch pointer to the batch
+ * @param file pointer to file object
+ * @param offset offset to move the r/w pointer
+ * @param from_start set the offset from the start of the file
+ * @param result pointer to success flag, may be NULL
+ */
+void storage_batch_file_seek(
+    StorageBatch* batch,
+    File* file,
+    uint32_t offset,
+    bool from_start,
+    bool* result);
+
+/** Adds directory read, see storage_dir_read
+ * @param batch pointer to the batch
+ * @param file pointer to file object
+ * @param fileinfo pointer to the read FileInfo, may be NULL
+ * @param name pointer to name buffer, may be NULL
+ * @param name_length name buffer length
+ * @param result pointer to success flag, may be NULL
+ */
+void storage_batch_dir_read(
+    StorageBatch* batch,
+    File* file,
+    FileInfo* fileinfo,
+    char* name,
+    uint16_t name_length,
+    bool* result);
+
+/** Adds stat, see storage_common_stat
+ * @param batch pointer to the batch
+ * @param path path to file/directory
+ * @param fileinfo pointer to the read FileInfo, may be NULL
+ * @param error pointer to operation result, may be NULL
+ */
+void storage_batch_common_stat(
+    StorageBatch* batch,
+    const char* path,
+    FileInfo* fileinfo,
+    FS_Error* error);
+
+/** Executes all operations in one storage message and empties the batch.
+ * Every operation is run even if a previous one failed.
+ * @param batch pointer to the batch
+ * @return true if every operation succeeded: open, close, seek and dir read returned true,
+ * read and write transferred all bytes, stat returned FSE_OK
+ */
+bool storage_batch_execute(StorageBatch* batch);
+
 /******************* Error Functions *******************/
 
 /** Retrieves the error text from the error id
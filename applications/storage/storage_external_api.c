@@ -7,9 +7,7 @@
 
 #define MAX_NAME_LENGTH 256
 
-#define S_API_PROLOGUE                                      \
-    osSemaphoreId_t semaphore = osSemaphoreNew(1, 0, NULL); \
-    furi_check(semaphore != NULL);
+#define S_API_PROLOGUE osThreadId_t thread_id = osThreadGetId();
 
 #define S_FILE_API_PROLOGUE           \
     Storage* storage = file->storage; \
@@ -17,13 +15,12 @@
 
 #define S_API_EPILOGUE                                                                         \
     furi_check(osMessageQueuePut(storage->message_queue, &message, 0, osWaitForever) == osOK); \
-    osSemaphoreAcquire(semaphore, osWaitForever);                                              \
-    osSemaphoreDelete(semaphore);
+    osThreadFlagsWait(STORAGE_THREAD_FLAG_COMPLETE, osFlagsWaitAny, osWaitForever);
 
 #define S_API_MESSAGE(_command)      \
     SAReturn return_data;            \
     StorageMessage message = {       \
-        .semaphore = semaphore,      \
+        .thread_id = thread_id,      \
         .command = _command,         \
         .data = &data,               \
         .return_data = &return_data, \
@@ -388,6 +385,182 @@ FS_Error storage_common_fs_info(
     return S_RETURN_ERROR;
 }
 
+/****************** BATCH ******************/
+
+struct StorageBatch {
+    Storage* storage;
+    StorageBatchItem* items;
+    size_t count;
+    size_t capacity;
+};
+
+StorageBatch* storage_batch_alloc(Storage* storage, size_t capacity) {
+    furi_assert(storage);
+    furi_assert(capacity);
+    StorageBatch* batch = malloc(sizeof(StorageBatch));
+    batch->storage = storage;
+    batch->items = malloc(sizeof(StorageBatchItem) * capacity);
+    batch->count = 0;
+    batch->capacity = capacity;
+    return batch;
+}
+
+void storage_batch_free(StorageBatch* batch) {
+    furi_assert(batch);
+    free(batch->items);
+    free(batch);
+}
+
+static StorageBatchItem*
+    storage_batch_add(StorageBatch* batch, StorageCommand command, void* result) {
+    furi_assert(batch);
+    furi_check(batch->count < batch->capacity);
+    StorageBatchItem* item = &batch->items[batch->count++];
+    item->command = command;
+    item->result = result;
+    return item;
+}
+
+void storage_batch_file_open(
+    StorageBatch* batch,
+    File* file,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode,
+    bool* result) {
+    furi_assert(file->storage == batch->storage);
+    StorageBatchItem* item = storage_batch_add(batch, StorageCommandFileOpen, result);
+    item->data.fopen.file = file;
+    item->data.fopen.path = path;
+    item->data.fopen.access_mode = access_mode;
+    item->data.fopen.open_mode = open_mode;
+
+    file->file_id = FILE_OPENED_FILE;
+}
+
+void storage_batch_file_close(StorageBatch* batch, File* file, bool* result) {
+    furi_assert(file->storage == batch->storage);
+    StorageBatchItem* item = storage_batch_add(batch, StorageCommandFileClose, result);
+    item->data.file.file = file;
+}
+
+void storage_batch_file_read(
+    StorageBatch* batch,
+    File* file,
+    void* buff,
+    uint16_t bytes_to_read,
+    uint16_t* bytes_read) {
+    furi_assert(file->storage == batch->storage);
+    StorageBatchItem* item = storage_batch_add(batch, StorageCommandFileRead, bytes_read);
+    item->data.fread.file = file;
+    item->data.fread.buff = buff;
+    item->data.fread.bytes_to_read = bytes_to_read;
+}
+
+void storage_batch_file_write(
+    StorageBatch* batch,
+    File* file,
+    const void* buff,
+    uint16_t bytes_to_write,
+    uint16_t* bytes_written) {
+    furi_assert(file->storage == batch->storage);
+    StorageBatchItem* item = storage_batch_add(batch, StorageCommandFileWrite, bytes_written);
+    item->data.fwrite.file = file;
+    item->data.fwrite.buff = buff;
+    item->data.fwrite.bytes_to_write = bytes_to_write;
+}
+
+void storage_batch_file_seek(
+    StorageBatch* batch,
+    File* file,
+    uint32_t offset,
+    bool from_start,
+    bool* result) {
+    furi_assert(file->storage == batch->storage);
+    StorageBatchItem* item = storage_batch_add(batch, StorageCommandFileSeek, result);
+    item->data.fseek.file = file;
+    item->data.fseek.offset = offset;
+    item->data.fseek.from_start = from_start;
+}
+
+void storage_batch_dir_read(
+    StorageBatch* batch,
+    File* file,
+    FileInfo* fileinfo,
+    char* name,
+    uint16_t name_length,
+    bool* result) {
+    furi_assert(file->storage == batch->storage);
+    StorageBatchItem* item = storage_batch_add(batch, StorageCommandDirRead, result);
+    item->data.dread.file = file;
+    item->data.dread.fileinfo = fileinfo;
+    item->data.dread.name = name;
+    item->data.dread.name_length = name_length;
+}
+
+void storage_batch_common_stat(
+    StorageBatch* batch,
+    const char* path,
+    FileInfo* fileinfo,
+    FS_Error* error) {
+    StorageBatchItem* item = storage_batch_add(batch, StorageCommandCommonStat, error);
+    item->data.cstat.path = path;
+    item->data.cstat.fileinfo = fileinfo;
+}
+
+static bool storage_batch_item_complete(StorageBatchItem* item) {
+    bool success = false;
+
+    switch(item->command) {
+    case StorageCommandFileRead:
+        success = (item->return_data.uint16_value == item->data.fread.bytes_to_read);
+        if(item->result) *(uint16_t*)item->result = item->return_data.uint16_value;
+        break;
+    case StorageCommandFileWrite:
+        success = (item->return_data.uint16_value == item->data.fwrite.bytes_to_write);
+        if(item->result) *(uint16_t*)item->result = item->return_data.uint16_value;
+        break;
+    case StorageCommandCommonStat:
+        success = (item->return_data.error_value == FSE_OK);
+        if(item->result) *(FS_Error*)item->result = item->return_data.error_value;
+        break;
+    case StorageCommandFileClose:
+        item->data.file.file->file_id = FILE_CLOSED;
+        // fall through
+    default:
+        success = item->return_data.bool_value;
+        if(item->result) *(bool*)item->result = item->return_data.bool_value;
+        break;
+    }
+
+    return success;
+}
+
+bool storage_batch_execute(StorageBatch* batch) {
+    furi_assert(batch);
+    if(batch->count == 0) return true;
+
+    Storage* storage = batch->storage;
+    S_API_PROLOGUE;
+
+    SAData data = {
+        .batch = {
+            .items = batch->items,
+            .count = batch->count,
+        }};
+
+    S_API_MESSAGE(StorageCommandBatch);
+    S_API_EPILOGUE;
+
+    bool result = true;
+    for(size_t i = 0; i < batch->count; i++) {
+        if(!storage_batch_item_complete(&batch->items[i])) result = false;
+    }
+    batch->count = 0;
+
+    return result;
+}
+
 /****************** ERROR ******************/
 
 const char* storage_error_get_desc(FS_Error error_id) {
@@ -478,6 +651,10 @@ FuriPubSub* storage_get_pubsub(Storage* storage) {
     return storage->pubsub;
 }
 
+uint32_t storage_get_message_count(Storage* storage) {
+    return storage->message_count;
+}
+
 bool storage_simply_remove_recursive(Storage* storage, const char* path) {
     furi_assert(storage);
     furi_assert(path);
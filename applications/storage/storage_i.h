@@ -21,6 +21,7 @@ struct Storage {
     StorageData storage[STORAGE_COUNT];
     StorageSDGui sd_gui;
     FuriPubSub* pubsub;
+    uint32_t message_count;
 };
 
 #ifdef __cplusplus
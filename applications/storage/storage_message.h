@@ -5,6 +5,11 @@
 extern "C" {
 #endif
 
+/** Thread flag the storage service sets on the caller when a message is processed */
+#define STORAGE_THREAD_FLAG_COMPLETE (1UL << 30)
+
+typedef struct StorageBatchItem StorageBatchItem;
+
 typedef struct {
     File* file;
     const char* path;
@@ -69,6 +74,11 @@ typedef struct {
     SDInfo* info;
 } SAInfo;
 
+typedef struct {
+    StorageBatchItem* items;
+    size_t count;
+} SADataBatch;
+
 typedef union {
     SADataFOpen fopen;
     SADataFRead fread;
@@ -87,6 +97,8 @@ typedef union {
     SADataPath path;
 
     SAInfo sdinfo;
+
+    SADataBatch batch;
 } SAData;
 
 typedef union {
@@ -120,10 +132,19 @@ typedef enum {
     StorageCommandSDUnmount,
     StorageCommandSDInfo,
     StorageCommandSDStatus,
+    StorageCommandBatch,
 } StorageCommand;
 
+struct StorageBatchItem {
+    StorageCommand command;
+    SAData data;
+    SAReturn return_data;
+    // caller's return value pointer, filled in by the calling thread
+    void* result;
+};
+
 typedef struct {
-    osSemaphoreId_t semaphore;
+    osThreadId_t thread_id;
     StorageCommand command;
     SAData* data;
     SAReturn* return_data;
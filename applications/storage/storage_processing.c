@@ -460,7 +460,22 @@ static FS_Error storage_process_sd_status(Storage* app) {
 }
 
 /****************** API calls processing ******************/
-void storage_process_message_internal(Storage* app, StorageMessage* message) {
+static void storage_process_message_internal(Storage* app, StorageMessage* message);
+
+static void storage_process_batch(Storage* app, StorageBatchItem* items, size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        // batches do not nest
+        furi_check(items[i].command != StorageCommandBatch);
+        StorageMessage message = {
+            .command = items[i].command,
+            .data = &items[i].data,
+            .return_data = &items[i].return_data,
+        };
+        storage_process_message_internal(app, &message);
+    }
+}
+
+static void storage_process_message_internal(Storage* app, StorageMessage* message) {
     switch(message->command) {
     case StorageCommandFileOpen:
         message->return_data->bool_value = storage_process_file_open(
@@ -567,11 +582,13 @@ void storage_process_message_internal(Storage* app, StorageMessage* message) {
     case StorageCommandSDStatus:
         message->return_data->error_value = storage_process_sd_status(app);
         break;
+    case StorageCommandBatch:
+        storage_process_batch(app, message->data->batch.items, message->data->batch.count);
+        break;
     }
-
-    osSemaphoreRelease(message->semaphore);
 }
 
 void storage_process_message(Storage* app, StorageMessage* message) {
     storage_process_message_internal(app, message);
+    osThreadFlagsSet(message->thread_id, STORAGE_THREAD_FLAG_COMPLETE);
 }
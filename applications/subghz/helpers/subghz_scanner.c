@@ -0,0 +1,221 @@
+#include "subghz_scanner.h"
+
+#include <furi.h>
+
+#define TAG "SubGhzScanner"
+
+/* Channel is busy above this RSSI, dBm */
+#define SUBGHZ_SCANNER_RSSI_THRESHOLD -90.0f
+/* Quiet visits before a busy channel stops being revisited */
+#define SUBGHZ_SCANNER_ACTIVITY_MAX 8
+
+#define SUBGHZ_SCANNER_NO_RECEIVER (-1)
+
+typedef struct {
+    uint8_t activity;
+    int8_t receiver;
+} SubGhzScannerChannel;
+
+typedef struct {
+    SubGhzReceiver* receiver;
+    int16_t channel;
+    uint32_t last_used;
+} SubGhzScannerReceiver;
+
+struct SubGhzScanner {
+    const uint32_t* frequencies;
+    size_t frequencies_count;
+    SubGhzScannerChannel* channels;
+
+    // Busy channels keep their receiver between visits
+    SubGhzScannerReceiver pool[SUBGHZ_SCANNER_RECEIVER_COUNT];
+    // Quiet channels share one receiver that starts clean on every visit
+    SubGhzReceiver* sweep_receiver;
+    size_t sweep_channel;
+
+    size_t sweep_index;
+    size_t revisit_index;
+    bool revisit;
+    uint32_t tick;
+
+    uint32_t hop_count;
+    uint64_t hop_cycles;
+    uint32_t hop_cycles_max;
+    uint32_t receiver_evictions;
+};
+
+static SubGhzReceiver* subghz_scanner_receiver_alloc(SubGhzEnvironment* environment) {
+    SubGhzReceiver* receiver = subghz_receiver_alloc_init(environment);
+    subghz_receiver_set_filter(receiver, SubGhzProtocolFlag_Decodable);
+    return receiver;
+}
+
+SubGhzScanner* subghz_scanner_alloc(
+    SubGhzEnvironment* environment,
+    const uint32_t* frequencies,
+    size_t frequencies_count) {
+    furi_assert(frequencies);
+    furi_assert(frequencies_count);
+    SubGhzScanner* instance = malloc(sizeof(SubGhzScanner));
+
+    instance->frequencies = frequencies;
+    instance->frequencies_count = frequencies_count;
+    instance->channels = malloc(sizeof(SubGhzScannerChannel) * frequencies_count);
+
+    for(size_t i = 0; i < SUBGHZ_SCANNER_RECEIVER_COUNT; i++) {
+        instance->pool[i].receiver = subghz_scanner_receiver_alloc(environment);
+    }
+    instance->sweep_receiver = subghz_scanner_receiver_alloc(environment);
+
+    subghz_scanner_reset(instance);
+
+    return instance;
+}
+
+void subghz_scanner_free(SubGhzScanner* instance) {
+    furi_assert(instance);
+
+    for(size_t i = 0; i < SUBGHZ_SCANNER_RECEIVER_COUNT; i++) {
+        subghz_receiver_free(instance->pool[i].receiver);
+    }
+    subghz_receiver_free(instance->sweep_receiver);
+    free(instance->channels);
+    free(instance);
+}
+
+void subghz_scanner_reset(SubGhzScanner* instance) {
+    furi_assert(instance);
+
+    for(size_t i = 0; i < instance->frequencies_count; i++) {
+        instance->channels[i].activity = 0;
+        instance->channels[i].receiver = SUBGHZ_SCANNER_NO_RECEIVER;
+    }
+    for(size_t i = 0; i < SUBGHZ_SCANNER_RECEIVER_COUNT; i++) {
+        subghz_receiver_reset(instance->pool[i].receiver);
+        instance->pool[i].channel = SUBGHZ_SCANNER_NO_RECEIVER;
+        instance->pool[i].last_used = 0;
+    }
+    subghz_receiver_reset(instance->sweep_receiver);
+    instance->sweep_channel = instance->frequencies_count;
+
+    instance->sweep_index = 0;
+    instance->revisit_index = 0;
+    instance->revisit = false;
+    instance->tick = 0;
+
+    instance->hop_count = 0;
+    instance->hop_cycles = 0;
+    instance->hop_cycles_max = 0;
+    instance->receiver_evictions = 0;
+}
+
+void subghz_scanner_set_rx_callback(
+    SubGhzScanner* instance,
+    SubGhzReceiverCallback callback,
+    void* context) {
+    furi_assert(instance);
+
+    for(size_t i = 0; i < SUBGHZ_SCANNER_RECEIVER_COUNT; i++) {
+        subghz_receiver_set_rx_callback(instance->pool[i].receiver, callback, context);
+    }
+    subghz_receiver_set_rx_callback(instance->sweep_receiver, callback, context);
+}
+
+SubGhzReceiver* subghz_scanner_get_receiver(SubGhzScanner* instance, size_t channel) {
+    furi_assert(instance);
+    furi_assert(channel < instance->frequencies_count);
+
+    instance->tick++;
+    int8_t index = instance->channels[channel].receiver;
+    if(index != SUBGHZ_SCANNER_NO_RECEIVER) {
+        instance->pool[index].last_used = instance->tick;
+        return instance->pool[index].receiver;
+    }
+
+    subghz_receiver_reset(instance->sweep_receiver);
+    instance->sweep_channel = channel;
+    return instance->sweep_receiver;
+}
+
+/** Move the sweep receiver, with its decoder state, into the pool */
+static void subghz_scanner_adopt_sweep_receiver(SubGhzScanner* instance, size_t channel) {
+    size_t index = 0;
+    for(size_t i = 1; i < SUBGHZ_SCANNER_RECEIVER_COUNT; i++) {
+        if(instance->pool[i].last_used < instance->pool[index].last_used) index = i;
+    }
+
+    SubGhzScannerReceiver* slot = &instance->pool[index];
+    if(slot->channel != SUBGHZ_SCANNER_NO_RECEIVER) {
+        instance->channels[slot->channel].receiver = SUBGHZ_SCANNER_NO_RECEIVER;
+        instance->receiver_evictions++;
+    }
+
+    // The evicted channel is not tuned, its receiver is idle and becomes the sweep one
+    SubGhzReceiver* receiver = slot->receiver;
+    slot->receiver = instance->sweep_receiver;
+    slot->channel = channel;
+    slot->last_used = instance->tick;
+    instance->channels[channel].receiver = index;
+
+    subghz_receiver_reset(receiver);
+    instance->sweep_receiver = receiver;
+    instance->sweep_channel = instance->frequencies_count;
+}
+
+bool subghz_scanner_update_rssi(SubGhzScanner* instance, size_t channel, float rssi) {
+    furi_assert(instance);
+    furi_assert(channel < instance->frequencies_count);
+
+    SubGhzScannerChannel* state = &instance->channels[channel];
+    if(rssi > SUBGHZ_SCANNER_RSSI_THRESHOLD) {
+        state->activity = SUBGHZ_SCANNER_ACTIVITY_MAX;
+        if(state->receiver == SUBGHZ_SCANNER_NO_RECEIVER && instance->sweep_channel == channel) {
+            subghz_scanner_adopt_sweep_receiver(instance, channel);
+        }
+        return true;
+    }
+
+    if(state->activity) state->activity--;
+    return false;
+}
+
+size_t subghz_scanner_get_next_channel(SubGhzScanner* instance, size_t channel) {
+    furi_assert(instance);
+    size_t count = instance->frequencies_count;
+
+    // Every other hop goes to the next recently busy channel, if any
+    instance->revisit = !instance->revisit;
+    if(instance->revisit) {
+        for(size_t i = 1; i <= count; i++) {
+            size_t candidate = (instance->revisit_index + i) % count;
+            if(candidate != channel && instance->channels[candidate].activity) {
+                instance->revisit_index = candidate;
+                return candidate;
+            }
+        }
+    }
+
+    size_t next = instance->sweep_index;
+    if(next == channel && count > 1) next = (next + 1) % count;
+    instance->sweep_index = (next + 1) % count;
+    return next;
+}
+
+void subghz_scanner_add_hop_time(SubGhzScanner* instance, uint32_t cycles) {
+    furi_assert(instance);
+    instance->hop_count++;
+    instance->hop_cycles += cycles;
+    if(cycles > instance->hop_cycles_max) instance->hop_cycles_max = cycles;
+}
+
+void subghz_scanner_get_stats(SubGhzScanner* instance, SubGhzScannerStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+    uint32_t cycles_per_us = SystemCoreClock / 1000000;
+
+    stats->hop_count = instance->hop_count;
+    stats->hop_time_avg =
+        instance->hop_count ? instance->hop_cycles / instance->hop_count / cycles_per_us : 0;
+    stats->hop_time_max = instance->hop_cycles_max / cycles_per_us;
+    stats->receiver_evictions = instance->receiver_evictions;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <furi_hal.h>
+#include <lib/subghz/receiver.h>
+
+/** Number of channels that keep their own decoder state
+ *
+ * Every receiver, plus the sweep one, holds a full decoder set: roughly
+ * 1.5 KB of heap each with the current registry. Rainbow tables are shared
+ * through the environment.
+ */
+#define SUBGHZ_SCANNER_RECEIVER_COUNT 3
+
+typedef struct SubGhzScanner SubGhzScanner;
+
+typedef struct {
+    uint32_t hop_count; /**< Hops done */
+    uint32_t hop_time_avg; /**< Average retune time, us */
+    uint32_t hop_time_max; /**< Longest retune time, us */
+    uint32_t receiver_evictions; /**< Decoder states handed over to another channel */
+} SubGhzScannerStats;
+
+/** Allocate SubGhzScanner
+ *
+ * @param environment SubGhzEnvironment instance
+ * @param frequencies Channel frequencies, must outlive the scanner
+ * @param frequencies_count Channel count
+ * @return SubGhzScanner*
+ */
+SubGhzScanner* subghz_scanner_alloc(
+    SubGhzEnvironment* environment,
+    const uint32_t* frequencies,
+    size_t frequencies_count);
+
+/** Free SubGhzScanner
+ *
+ * @param instance SubGhzScanner instance
+ */
+void subghz_scanner_free(SubGhzScanner* instance);
+
+/** Forget channel activity, decoder states and statistics
+ *
+ * @param instance SubGhzScanner instance
+ */
+void subghz_scanner_reset(SubGhzScanner* instance);
+
+/** Set rx callback of every channel receiver
+ *
+ * @param instance SubGhzScanner instance
+ * @param callback SubGhzReceiverCallback callback
+ * @param context
+ */
+void subghz_scanner_set_rx_callback(
+    SubGhzScanner* instance,
+    SubGhzReceiverCallback callback,
+    void* context);
+
+/** Get the receiver holding decoder state of a channel
+ *
+ * Channels share a small receiver pool, the least recently used
+ * receiver is reset and handed over when a channel has none.
+ *
+ * @param instance SubGhzScanner instance
+ * @param channel Channel index
+ * @return SubGhzReceiver*
+ */
+SubGhzReceiver* subghz_scanner_get_receiver(SubGhzScanner* instance, size_t channel);
+
+/** Report RSSI measured on a channel
+ *
+ * @param instance SubGhzScanner instance
+ * @param channel Channel index
+ * @param rssi RSSI, dBm
+ * @return true if the channel is busy and worth dwelling on
+ */
+bool subghz_scanner_update_rssi(SubGhzScanner* instance, size_t channel, float rssi);
+
+/** Pick the channel to hop to
+ *
+ * Channels are swept in order, recently active channels are revisited
+ * between sweep steps.
+ *
+ * @param instance SubGhzScanner instance
+ * @param channel Current channel index
+ * @return size_t next channel index
+ */
+size_t subghz_scanner_get_next_channel(SubGhzScanner* instance, size_t channel);
+
+/** Account time spent retuning
+ *
+ * @param instance SubGhzScanner instance
+ * @param cycles CPU cycles from rx end to rx start
+ */
+void subghz_scanner_add_hop_time(SubGhzScanner* instance, uint32_t cycles);
+
+/** Get scanner statistics
+ *
+ * @param instance SubGhzScanner instance
+ * @param stats SubGhzScannerStats to fill
+ */
+void subghz_scanner_get_stats(SubGhzScanner* instance, SubGhzScannerStats* stats);
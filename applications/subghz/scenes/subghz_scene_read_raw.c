@@ -243,6 +243,9 @@ bool subghz_scene_read_raw_on_event(void* context, SceneManagerEvent event) {
                 scene_manager_next_scene(subghz->scene_manager, SubGhzSceneNeedSaving);
             } else {
                 //subghz_get_preset_name(subghz, subghz->error_str);
+                subghz_protocol_raw_set_save_format(
+                    (SubGhzProtocolDecoderRAW*)subghz->txrx->decoder_result,
+                    subghz->txrx->raw_format);
                 if(subghz_protocol_raw_save_to_file_init(
                        (SubGhzProtocolDecoderRAW*)subghz->txrx->decoder_result,
                        RAW_FILE_NAME,
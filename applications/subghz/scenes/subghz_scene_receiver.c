@@ -1,6 +1,8 @@
 #include "../subghz_i.h"
 #include "../views/receiver.h"
 
+#define TAG "SubGhzSceneReceiver"
+
 static void subghz_scene_receiver_update_statusbar(void* context) {
     SubGhz* subghz = context;
     string_t history_stat_str;
@@ -36,6 +38,23 @@ void subghz_scene_receiver_callback(SubGhzCustomEvent event, void* context) {
     view_dispatcher_send_custom_event(subghz->view_dispatcher, event);
 }
 
+static void subghz_scene_receiver_fill_menu(SubGhz* subghz) {
+    string_t str_buff;
+    string_init(str_buff);
+
+    subghz_view_receiver_exit(subghz->subghz_receiver);
+    for(uint8_t i = 0; i < subghz_history_get_item(subghz->txrx->history); i++) {
+        string_reset(str_buff);
+        subghz_history_get_text_item_menu(subghz->txrx->history, str_buff, i);
+        subghz_view_receiver_add_item_to_menu(
+            subghz->subghz_receiver,
+            string_get_cstr(str_buff),
+            subghz_history_get_type_protocol(subghz->txrx->history, i));
+        subghz->txrx->rx_key_state = SubGhzRxKeyStateAddKey;
+    }
+    string_clear(str_buff);
+}
+
 static void subghz_scene_add_to_history_callback(
     SubGhzReceiver* receiver,
     SubGhzProtocolDecoderBase* decoder_base,
@@ -45,18 +64,28 @@ static void subghz_scene_add_to_history_callback(
     string_t str_buff;
     string_init(str_buff);
 
+    uint16_t item_count = subghz_history_get_item(subghz->txrx->history);
     if(subghz_history_add_to_history(
            subghz->txrx->history, decoder_base, subghz->txrx->frequency, subghz->txrx->preset)) {
         subghz_receiver_reset(receiver);
         string_reset(str_buff);
 
-        subghz_history_get_text_item_menu(
-            subghz->txrx->history, str_buff, subghz_history_get_item(subghz->txrx->history) - 1);
-        subghz_view_receiver_add_item_to_menu(
-            subghz->subghz_receiver,
-            string_get_cstr(str_buff),
-            subghz_history_get_type_protocol(
-                subghz->txrx->history, subghz_history_get_item(subghz->txrx->history) - 1));
+        if(subghz_history_get_item(subghz->txrx->history) == item_count) {
+            // An old record was replaced in place
+            uint16_t idx = subghz_view_receiver_get_idx_menu(subghz->subghz_receiver);
+            subghz_scene_receiver_fill_menu(subghz);
+            subghz_view_receiver_set_idx_menu(subghz->subghz_receiver, idx);
+        } else {
+            subghz_history_get_text_item_menu(
+                subghz->txrx->history,
+                str_buff,
+                subghz_history_get_item(subghz->txrx->history) - 1);
+            subghz_view_receiver_add_item_to_menu(
+                subghz->subghz_receiver,
+                string_get_cstr(str_buff),
+                subghz_history_get_type_protocol(
+                    subghz->txrx->history, subghz_history_get_item(subghz->txrx->history) - 1));
+        }
 
         subghz_scene_receiver_update_statusbar(subghz);
     }
@@ -67,30 +96,21 @@ static void subghz_scene_add_to_history_callback(
 void subghz_scene_receiver_on_enter(void* context) {
     SubGhz* subghz = context;
 
-    string_t str_buff;
-    string_init(str_buff);
-
     if(subghz->txrx->rx_key_state == SubGhzRxKeyStateIDLE) {
         subghz_history_reset(subghz->txrx->history);
     }
 
     //Load history to receiver
-    subghz_view_receiver_exit(subghz->subghz_receiver);
-    for(uint8_t i = 0; i < subghz_history_get_item(subghz->txrx->history); i++) {
-        string_reset(str_buff);
-        subghz_history_get_text_item_menu(subghz->txrx->history, str_buff, i);
-        subghz_view_receiver_add_item_to_menu(
-            subghz->subghz_receiver,
-            string_get_cstr(str_buff),
-            subghz_history_get_type_protocol(subghz->txrx->history, i));
-        subghz->txrx->rx_key_state = SubGhzRxKeyStateAddKey;
-    }
-    string_clear(str_buff);
+    subghz_scene_receiver_fill_menu(subghz);
     subghz_scene_receiver_update_statusbar(subghz);
     subghz_view_receiver_set_callback(
         subghz->subghz_receiver, subghz_scene_receiver_callback, subghz);
     subghz_receiver_set_rx_callback(
         subghz->txrx->receiver, subghz_scene_add_to_history_callback, subghz);
+    if(subghz->txrx->scanner) {
+        subghz_scanner_set_rx_callback(
+            subghz->txrx->scanner, subghz_scene_add_to_history_callback, subghz);
+    }
 
     subghz->state_notifications = SubGhzNotificationStateRX;
     if(subghz->txrx->txrx_state == SubGhzTxRxStateRx) {
@@ -119,7 +139,19 @@ bool subghz_scene_receiver_on_event(void* context, SceneManagerEvent event) {
                 subghz_rx_end(subghz);
                 subghz_sleep(subghz);
             };
+            if(subghz->txrx->hopper_state != SubGhzHopperStateOFF) {
+                SubGhzScannerStats stats;
+                subghz_scanner_get_stats(subghz->txrx->scanner, &stats);
+                FURI_LOG_I(
+                    TAG,
+                    "Hops %lu, hop time avg %lu us, max %lu us, evictions %lu",
+                    stats.hop_count,
+                    stats.hop_time_avg,
+                    stats.hop_time_max,
+                    stats.receiver_evictions);
+            }
             subghz->txrx->hopper_state = SubGhzHopperStateOFF;
+            subghz_hopper_free_scanner(subghz);
             subghz->txrx->frequency = subghz_frequencies[subghz_frequencies_433_92];
             subghz->txrx->preset = FuriHalSubGhzPresetOok650Async;
             subghz->txrx->idx_menu_chosen = 0;
@@ -155,6 +187,7 @@ bool subghz_scene_receiver_on_event(void* context, SceneManagerEvent event) {
             subghz_hopper_update(subghz);
             subghz_scene_receiver_update_statusbar(subghz);
         }
+        subghz_history_flush(subghz->txrx->history);
 
         switch(subghz->state_notifications) {
         case SubGhzNotificationStateRX:
@@ -24,6 +24,16 @@ const uint32_t hopping_value[HOPPING_COUNT] = {
     SubGhzHopperStateRunnig,
 };
 
+#define RAW_FORMAT_COUNT 2
+const char* const raw_format_text[RAW_FORMAT_COUNT] = {
+    "Text",
+    "Binary",
+};
+const uint32_t raw_format_value[RAW_FORMAT_COUNT] = {
+    SubGhzProtocolRAWFormatText,
+    SubGhzProtocolRAWFormatBinary,
+};
+
 uint8_t subghz_scene_receiver_config_uint32_value_index(
     const uint32_t value,
     const uint32_t values[],
@@ -94,6 +104,7 @@ static void subghz_scene_receiver_config_set_hopping_runing(VariableItem* item)
             (VariableItem*)scene_manager_get_scene_state(
                 subghz->scene_manager, SubGhzSceneReceiverConfig),
             subghz_frequencies_433_92);
+        subghz_hopper_free_scanner(subghz);
     } else {
         variable_item_set_current_value_text(
             (VariableItem*)scene_manager_get_scene_state(
@@ -103,11 +114,20 @@ static void subghz_scene_receiver_config_set_hopping_runing(VariableItem* item)
             (VariableItem*)scene_manager_get_scene_state(
                 subghz->scene_manager, SubGhzSceneReceiverConfig),
             subghz_frequencies_433_92);
+        subghz_hopper_alloc_scanner(subghz);
     }
 
     subghz->txrx->hopper_state = hopping_value[index];
 }
 
+static void subghz_scene_receiver_config_set_raw_format(VariableItem* item) {
+    SubGhz* subghz = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    variable_item_set_current_value_text(item, raw_format_text[index]);
+    subghz->txrx->raw_format = raw_format_value[index];
+}
+
 void subghz_scene_receiver_config_on_enter(void* context) {
     SubGhz* subghz = context;
     VariableItem* item;
@@ -138,6 +158,17 @@ void subghz_scene_receiver_config_on_enter(void* context) {
             subghz->txrx->hopper_state, hopping_value, HOPPING_COUNT, subghz);
         variable_item_set_current_value_index(item, value_index);
         variable_item_set_current_value_text(item, hopping_text[value_index]);
+    } else {
+        item = variable_item_list_add(
+            subghz->variable_item_list,
+            "Format:",
+            RAW_FORMAT_COUNT,
+            subghz_scene_receiver_config_set_raw_format,
+            subghz);
+        value_index = subghz_scene_receiver_config_uint32_value_index(
+            subghz->txrx->raw_format, raw_format_value, RAW_FORMAT_COUNT);
+        variable_item_set_current_value_index(item, value_index);
+        variable_item_set_current_value_text(item, raw_format_text[value_index]);
     }
 
     item = variable_item_list_add(
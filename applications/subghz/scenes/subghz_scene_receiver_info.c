@@ -40,6 +40,8 @@ void subghz_scene_receiver_info_on_enter(void* context) {
     SubGhz* subghz = context;
 
     DOLPHIN_DEED(DolphinDeedSubGhzReceiverInfo);
+    // RX goes on, keep the shown record from being replaced
+    subghz_history_set_locked(subghz->txrx->history, subghz->txrx->idx_menu_chosen, true);
     if(subghz_scene_receiver_info_update_parser(subghz)) {
         string_t frequency_str;
         string_t modulation_str;
@@ -155,6 +157,7 @@ bool subghz_scene_receiver_info_on_event(void* context, SceneManagerEvent event)
                 subghz_rx_end(subghz);
                 subghz_sleep(subghz);
             }
+            subghz_hopper_free_scanner(subghz);
             if(!subghz_scene_receiver_info_update_parser(subghz)) {
                 return false;
             }
@@ -170,6 +173,7 @@ bool subghz_scene_receiver_info_on_event(void* context, SceneManagerEvent event)
         if(subghz->txrx->hopper_state != SubGhzHopperStateOFF) {
             subghz_hopper_update(subghz);
         }
+        subghz_history_flush(subghz->txrx->history);
         switch(subghz->state_notifications) {
         case SubGhzNotificationStateTX:
             notification_message(subghz->notifications, &sequence_blink_red_10);
@@ -187,4 +191,5 @@ bool subghz_scene_receiver_info_on_event(void* context, SceneManagerEvent event)
 void subghz_scene_receiver_info_on_exit(void* context) {
     SubGhz* subghz = context;
     widget_reset(subghz->widget);
+    subghz_history_set_locked(subghz->txrx->history, subghz->txrx->idx_menu_chosen, false);
 }
@@ -79,6 +79,8 @@ bool subghz_scene_save_name_on_event(void* context, SceneManagerEvent event) {
                             subghz_history_get_raw_data(
                                 subghz->txrx->history, subghz->txrx->idx_menu_chosen),
                             subghz->file_name);
+                        subghz_history_set_pinned(
+                            subghz->txrx->history, subghz->txrx->idx_menu_chosen, true);
                     }
                 }
 
@@ -225,6 +225,7 @@ SubGhz* subghz_alloc() {
     subghz->txrx = malloc(sizeof(SubGhzTxRx));
     subghz->txrx->frequency = subghz_frequencies[subghz_frequencies_433_92];
     subghz->txrx->preset = FuriHalSubGhzPresetOok650Async;
+    subghz->txrx->raw_format = SubGhzProtocolRAWFormatText;
     subghz->txrx->txrx_state = SubGhzTxRxStateSleep;
     subghz->txrx->hopper_state = SubGhzHopperStateOFF;
     subghz->txrx->rx_key_state = SubGhzRxKeyStateIDLE;
@@ -246,6 +247,9 @@ SubGhz* subghz_alloc() {
         subghz->txrx->worker, (SubGhzWorkerPairCallback)subghz_receiver_decode);
     subghz_worker_set_context(subghz->txrx->worker, subghz->txrx->receiver);
 
+    // Channel receivers are only allocated while hopping
+    subghz->txrx->scanner = NULL;
+
     //Init Error_str
     string_init(subghz->error_str);
 
@@ -317,6 +321,7 @@ void subghz_free(SubGhz* subghz) {
     subghz->gui = NULL;
 
     //Worker & Protocol & History
+    subghz_hopper_free_scanner(subghz);
     subghz_receiver_free(subghz->txrx->receiver);
     subghz_environment_free(subghz->txrx->environment);
     subghz_worker_free(subghz->txrx->worker);
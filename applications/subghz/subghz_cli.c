@@ -9,11 +9,15 @@
 
 #include <lib/subghz/receiver.h>
 #include <lib/subghz/transmitter.h>
+#include <lib/subghz/subghz_worker.h>
+#include <lib/subghz/subghz_file_encoder_worker.h>
+#include <lib/subghz/protocols/raw.h>
 
 #include "helpers/subghz_chat.h"
 
 #include <notification/notification_messages.h>
 #include <flipper_format/flipper_format_i.h>
+#include <storage/storage.h>
 
 #define SUBGHZ_FREQUENCY_RANGE_STR \
     "299999755...348000000 or 386999938...464000000 or 778999847...928000000"
@@ -181,24 +185,21 @@ void subghz_cli_command_tx(Cli* cli, string_t args, void* context) {
 }
 
 typedef struct {
-    volatile bool overrun;
-    StreamBufferHandle_t stream;
+    SubGhzReceiver* receiver;
+    // Decoding runs in the worker thread, output is printed from the cli thread
+    StreamBufferHandle_t output;
     size_t packet_count;
 } SubGhzCliCommandRx;
 
-static void subghz_cli_command_rx_capture_callback(bool level, uint32_t duration, void* context) {
+static void subghz_cli_command_rx_overrun_callback(void* context) {
     SubGhzCliCommandRx* instance = context;
+    xStreamBufferSend(instance->output, ".", 1, 0);
+    subghz_receiver_reset(instance->receiver);
+}
 
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    LevelDuration level_duration = level_duration_make(level, duration);
-    if(instance->overrun) {
-        instance->overrun = false;
-        level_duration = level_duration_reset();
-    }
-    size_t ret = xStreamBufferSendFromISR(
-        instance->stream, &level_duration, sizeof(LevelDuration), &xHigherPriorityTaskWoken);
-    if(sizeof(LevelDuration) != ret) instance->overrun = true;
-    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+static void subghz_cli_command_rx_pair_callback(void* context, bool level, uint32_t duration) {
+    SubGhzCliCommandRx* instance = context;
+    subghz_receiver_decode(instance->receiver, level, duration);
 }
 
 static void subghz_cli_command_rx_callback(
@@ -212,7 +213,7 @@ static void subghz_cli_command_rx_callback(
     string_init(text);
     subghz_protocol_decoder_base_get_string(decoder_base, text);
     subghz_receiver_reset(receiver);
-    printf("%s", string_get_cstr(text));
+    xStreamBufferSend(instance->output, string_get_cstr(text), string_size(text), 0);
     string_clear(text);
 }
 
@@ -236,8 +237,12 @@ void subghz_cli_command_rx(Cli* cli, string_t args, void* context) {
 
     // Allocate context and buffers
     SubGhzCliCommandRx* instance = malloc(sizeof(SubGhzCliCommandRx));
-    instance->stream = xStreamBufferCreate(sizeof(LevelDuration) * 1024, sizeof(LevelDuration));
-    furi_check(instance->stream);
+    instance->output = xStreamBufferCreate(1024, 1);
+    furi_check(instance->output);
+    SubGhzWorker* worker = subghz_worker_alloc();
+    subghz_worker_set_overrun_callback(worker, subghz_cli_command_rx_overrun_callback);
+    subghz_worker_set_pair_callback(worker, subghz_cli_command_rx_pair_callback);
+    subghz_worker_set_context(worker, instance);
 
     SubGhzEnvironment* environment = subghz_environment_alloc();
     subghz_environment_load_keystore(environment, "/ext/subghz/assets/keeloq_mfcodes");
@@ -249,6 +254,7 @@ void subghz_cli_command_rx(Cli* cli, string_t args, void* context) {
     SubGhzReceiver* receiver = subghz_receiver_alloc_init(environment);
     subghz_receiver_set_filter(receiver, SubGhzProtocolFlag_Decodable);
     subghz_receiver_set_rx_callback(receiver, subghz_cli_command_rx_callback, instance);
+    instance->receiver = receiver;
 
     // Configure radio
     furi_hal_subghz_reset();
@@ -259,38 +265,39 @@ void subghz_cli_command_rx(Cli* cli, string_t args, void* context) {
     furi_hal_power_suppress_charge_enter();
 
     // Prepare and start RX
-    furi_hal_subghz_start_async_rx(subghz_cli_command_rx_capture_callback, instance);
+    furi_hal_subghz_start_async_rx(subghz_worker_rx_callback, worker);
+    subghz_worker_start(worker);
 
     // Wait for packets to arrive
     printf("Listening at %lu. Press CTRL+C to stop\r\n", frequency);
-    LevelDuration level_duration;
+    char output[64];
     while(!cli_cmd_interrupt_received(cli)) {
-        int ret =
-            xStreamBufferReceive(instance->stream, &level_duration, sizeof(LevelDuration), 10);
-        if(ret == sizeof(LevelDuration)) {
-            if(level_duration_is_reset(level_duration)) {
-                printf(".");
-                subghz_receiver_reset(receiver);
-            } else {
-                bool level = level_duration_get_level(level_duration);
-                uint32_t duration = level_duration_get_duration(level_duration);
-                subghz_receiver_decode(receiver, level, duration);
-            }
-        }
+        size_t ret = xStreamBufferReceive(instance->output, output, sizeof(output), 10);
+        if(ret) printf("%.*s", (int)ret, output);
     }
 
     // Shutdown radio
     furi_hal_subghz_stop_async_rx();
+    subghz_worker_stop(worker);
     furi_hal_subghz_sleep();
 
     furi_hal_power_suppress_charge_exit();
 
+    SubGhzWorkerStats stats;
+    subghz_worker_get_stats(worker, &stats);
     printf("\r\nPackets recieved %u\r\n", instance->packet_count);
+    printf(
+        "Capture overruns %lu, high water %lu/%lu, batches %lu\r\n",
+        stats.overrun_count,
+        stats.high_water,
+        stats.capacity,
+        stats.batch_count);
 
     // Cleanup
     subghz_receiver_free(receiver);
     subghz_environment_free(environment);
-    vStreamBufferDelete(instance->stream);
+    subghz_worker_free(worker);
+    vStreamBufferDelete(instance->output);
     free(instance);
 }
 
@@ -310,9 +317,13 @@ static void subghz_cli_command_print_usage() {
         printf("\ttx_carrier <frequency:in Hz>\t - Transmit carrier\r\n");
         printf("\trx_carrier <frequency:in Hz>\t - Receiv carrier\r\n");
         printf(
-            "\tencrypt_keeloq <path_decrypted_file> <path_encrypted_file> <IV:16 bytes in hex>\t - Encrypt keeloq manufacture keys\r\n");
+            "\tencrypt_keeloq <path_decrypted_file> <path_encrypted_file> <IV:16 bytes in hex> <bin:optional>\t - Encrypt keeloq manufacture keys\r\n");
         printf(
             "\tencrypt_raw <path_decrypted_file> <path_encrypted_file> <IV:16 bytes in hex>\t - Encrypt RAW data\r\n");
+        printf(
+            "\tconvert_raw <path_source_file> <path_destination_file> <format: text|bin>\t - Convert RAW capture encoding\r\n");
+        printf(
+            "\tdecode_raw <path_file_or_dir>\t - Decode RAW captures and profile decoders\r\n");
     }
 }
 
@@ -321,8 +332,10 @@ static void subghz_cli_command_encrypt_keeloq(Cli* cli, string_t args) {
 
     string_t source;
     string_t destination;
+    string_t format;
     string_init(source);
     string_init(destination);
+    string_init(format);
 
     SubGhzKeystore* keystore = subghz_keystore_alloc();
 
@@ -342,18 +355,33 @@ static void subghz_cli_command_encrypt_keeloq(Cli* cli, string_t args) {
             break;
         }
 
+        bool binary = false;
+        if(args_read_string_and_trim(args, format)) {
+            if(string_cmp_str(format, "bin") != 0) {
+                subghz_cli_command_print_usage();
+                break;
+            }
+            binary = true;
+        }
+
         if(!subghz_keystore_load(keystore, string_get_cstr(source))) {
             printf("Failed to load Keystore");
             break;
         }
 
-        if(!subghz_keystore_save(keystore, string_get_cstr(destination), iv)) {
+        if(binary) {
+            if(!subghz_keystore_save_binary(keystore, string_get_cstr(destination), iv)) {
+                printf("Failed to save Keystore");
+                break;
+            }
+        } else if(!subghz_keystore_save(keystore, string_get_cstr(destination), iv)) {
             printf("Failed to save Keystore");
             break;
         }
     } while(false);
 
     subghz_keystore_free(keystore);
+    string_clear(format);
     string_clear(destination);
     string_clear(source);
 }
@@ -394,6 +422,187 @@ static void subghz_cli_command_encrypt_raw(Cli* cli, string_t args) {
     string_clear(source);
 }
 
+static void subghz_cli_command_convert_raw(Cli* cli, string_t args) {
+    string_t source;
+    string_t destination;
+    string_t format;
+    string_init(source);
+    string_init(destination);
+    string_init(format);
+
+    do {
+        if(!args_read_string_and_trim(args, source)) {
+            subghz_cli_command_print_usage();
+            break;
+        }
+
+        if(!args_read_string_and_trim(args, destination)) {
+            subghz_cli_command_print_usage();
+            break;
+        }
+
+        SubGhzProtocolRAWFormat raw_format;
+        if(!args_read_string_and_trim(args, format)) {
+            subghz_cli_command_print_usage();
+            break;
+        } else if(string_cmp_str(format, "text") == 0) {
+            raw_format = SubGhzProtocolRAWFormatText;
+        } else if(string_cmp_str(format, "bin") == 0) {
+            raw_format = SubGhzProtocolRAWFormatBinary;
+        } else {
+            subghz_cli_command_print_usage();
+            break;
+        }
+
+        if(!subghz_protocol_raw_convert(
+               string_get_cstr(source), string_get_cstr(destination), raw_format)) {
+            printf("Failed to convert RAW file");
+            break;
+        }
+    } while(false);
+
+    string_clear(format);
+    string_clear(destination);
+    string_clear(source);
+}
+
+typedef struct {
+    SubGhzReceiver* receiver;
+    SubGhzFileEncoderWorker* file_worker;
+    size_t packet_count;
+    uint32_t pulse_count;
+    uint64_t cycles;
+} SubGhzCliCommandDecodeRaw;
+
+static void subghz_cli_command_decode_raw_callback(
+    SubGhzReceiver* receiver,
+    SubGhzProtocolDecoderBase* decoder_base,
+    void* context) {
+    SubGhzCliCommandDecodeRaw* instance = context;
+    instance->packet_count++;
+
+    string_t text;
+    string_init(text);
+    subghz_protocol_decoder_base_get_string(decoder_base, text);
+    subghz_receiver_reset(receiver);
+    printf("%s", string_get_cstr(text));
+    string_clear(text);
+}
+
+static void subghz_cli_command_decode_raw_file(
+    Cli* cli,
+    SubGhzCliCommandDecodeRaw* instance,
+    const char* file_name) {
+    printf("%s\r\n", file_name);
+    subghz_receiver_reset(instance->receiver);
+    if(!subghz_file_encoder_worker_start(instance->file_worker, file_name)) {
+        printf("Failed to start playback\r\n");
+        return;
+    }
+
+    // Same level/duration stream as a transmission, only decoding time is counted
+    while(!cli_cmd_interrupt_received(cli)) {
+        LevelDuration level_duration =
+            subghz_file_encoder_worker_get_level_duration(instance->file_worker);
+        if(level_duration_is_reset(level_duration)) break;
+        if(level_duration_is_wait(level_duration)) {
+            osDelay(1);
+            continue;
+        }
+
+        uint32_t start = DWT->CYCCNT;
+        subghz_receiver_decode(
+            instance->receiver,
+            level_duration_get_level(level_duration),
+            level_duration_get_duration(level_duration));
+        instance->cycles += DWT->CYCCNT - start;
+        instance->pulse_count++;
+    }
+
+    subghz_file_encoder_worker_stop(instance->file_worker);
+}
+
+static void subghz_cli_command_decode_raw(Cli* cli, string_t args) {
+    string_t path;
+    string_init(path);
+    if(!args_read_string_and_trim(args, path)) {
+        subghz_cli_command_print_usage();
+        string_clear(path);
+        return;
+    }
+
+    SubGhzCliCommandDecodeRaw* instance = malloc(sizeof(SubGhzCliCommandDecodeRaw));
+    SubGhzEnvironment* environment = subghz_environment_alloc();
+    subghz_environment_load_keystore(environment, "/ext/subghz/assets/keeloq_mfcodes");
+    subghz_environment_set_came_atomo_rainbow_table_file_name(
+        environment, "/ext/subghz/assets/came_atomo");
+    subghz_environment_set_nice_flor_s_rainbow_table_file_name(
+        environment, "/ext/subghz/assets/nice_flor_s");
+
+    instance->receiver = subghz_receiver_alloc_init(environment);
+    subghz_receiver_set_filter(instance->receiver, SubGhzProtocolFlag_Decodable);
+    subghz_receiver_set_rx_callback(
+        instance->receiver, subghz_cli_command_decode_raw_callback, instance);
+    subghz_receiver_set_profiling(instance->receiver, true);
+    instance->file_worker = subghz_file_encoder_worker_alloc();
+
+    Storage* storage = furi_record_open("storage");
+    FileInfo file_info;
+    size_t file_count = 0;
+    if(storage_common_stat(storage, string_get_cstr(path), &file_info) != FSE_OK) {
+        printf("Failed to open %s\r\n", string_get_cstr(path));
+    } else if(file_info.flags & FSF_DIRECTORY) {
+        // Every .sub file of the directory, not recursive
+        File* dir = storage_file_alloc(storage);
+        if(storage_dir_open(dir, string_get_cstr(path))) {
+            char name[256];
+            string_t file_name;
+            string_init(file_name);
+            while(storage_dir_read(dir, &file_info, name, sizeof(name)) &&
+                  !cli_cmd_interrupt_received(cli)) {
+                if(file_info.flags & FSF_DIRECTORY) continue;
+                size_t name_size = strlen(name);
+                if(name_size < 4 || strcmp(&name[name_size - 4], ".sub") != 0) continue;
+                string_printf(file_name, "%s/%s", string_get_cstr(path), name);
+                subghz_cli_command_decode_raw_file(cli, instance, string_get_cstr(file_name));
+                file_count++;
+            }
+            string_clear(file_name);
+        }
+        storage_dir_close(dir);
+        storage_file_free(dir);
+    } else {
+        subghz_cli_command_decode_raw_file(cli, instance, string_get_cstr(path));
+        file_count++;
+    }
+    furi_record_close("storage");
+
+    uint32_t cycles_per_us = SystemCoreClock / 1000000;
+    printf(
+        "\r\nFiles %u, packets %u, pulses %lu, decode time %lu us\r\n",
+        file_count,
+        instance->packet_count,
+        instance->pulse_count,
+        (uint32_t)(instance->cycles / cycles_per_us));
+    SubGhzReceiverProfile profile;
+    for(size_t i = 0; subghz_receiver_get_profile(instance->receiver, i, &profile); i++) {
+        if(!profile.pulses) continue;
+        printf(
+            "%-16s decoded %4lu, pulses %8lu, %8lu us, %8lu pulses/s\r\n",
+            profile.name,
+            profile.decoded,
+            profile.pulses,
+            (uint32_t)(profile.cycles / cycles_per_us),
+            (uint32_t)((uint64_t)profile.pulses * SystemCoreClock / MAX(profile.cycles, 1ULL)));
+    }
+
+    subghz_file_encoder_worker_free(instance->file_worker);
+    subghz_receiver_free(instance->receiver);
+    subghz_environment_free(environment);
+    free(instance);
+    string_clear(path);
+}
+
 static void subghz_cli_command_chat(Cli* cli, string_t args) {
     uint32_t frequency = 433920000;
 
@@ -606,6 +815,16 @@ void subghz_cli_command(Cli* cli, string_t args, void* context) {
                 break;
             }
 
+            if(string_cmp_str(cmd, "convert_raw") == 0) {
+                subghz_cli_command_convert_raw(cli, args);
+                break;
+            }
+
+            if(string_cmp_str(cmd, "decode_raw") == 0) {
+                subghz_cli_command_decode_raw(cli, args);
+                break;
+            }
+
             if(string_cmp_str(cmd, "tx_carrier") == 0) {
                 subghz_cli_command_tx_carrier(cli, args, context);
                 break;
@@ -1,194 +1,434 @@
 #include "subghz_history.h"
 #include <lib/subghz/receiver.h>
-#include <lib/subghz/protocols/came.h>
+#include <lib/subghz/blocks/generic.h>
+#include <lib/flipper_format/flipper_format_i.h>
+#include <lib/toolbox/stream/stream.h>
+#include <storage/storage.h>
+#include <fnv1a-hash.h>
 
 #include <furi.h>
 #include <m-string.h>
 
-#define SUBGHZ_HISTORY_MAX 50
+#define SUBGHZ_HISTORY_MAX 64
+/* Serialized data from the "Protocol" key on, per item */
+#define SUBGHZ_HISTORY_ITEM_DATA_MAX 128
+/* Sized for every item at its largest, so only item count limits the history */
+#define SUBGHZ_HISTORY_ARENA_SIZE (SUBGHZ_HISTORY_MAX * SUBGHZ_HISTORY_ITEM_DATA_MAX)
+/* Open addressing table, power of two, at least twice SUBGHZ_HISTORY_MAX */
+#define SUBGHZ_HISTORY_TABLE_SIZE 128
+#define SUBGHZ_HISTORY_TABLE_MASK (SUBGHZ_HISTORY_TABLE_SIZE - 1)
+#define SUBGHZ_HISTORY_TABLE_EMPTY 0xFF
+#define SUBGHZ_HISTORY_ITEM_STR_SIZE 32
+#define SUBGHZ_HISTORY_LOG_PATH "/ext/subghz/history.log"
+/* Evicted records waiting for subghz_history_flush */
+#define SUBGHZ_HISTORY_SPILL_PENDING_MAX 2048
+/* Hashes of logged records, power of two, cleared when 3/4 full */
+#define SUBGHZ_HISTORY_SPILLED_TABLE_SIZE 256
+#define SUBGHZ_HISTORY_SPILLED_TABLE_MASK (SUBGHZ_HISTORY_SPILLED_TABLE_SIZE - 1)
 #define TAG "SubGhzHistory"
 
 typedef struct {
-    string_t item_str;
-    FlipperFormat* flipper_string;
-    uint8_t type;
-    FuriHalSubGhzPreset preset;
+    char item_str[SUBGHZ_HISTORY_ITEM_STR_SIZE];
+    uint32_t hash;
+    uint32_t last_seen;
     uint32_t frequency;
+    FuriHalSubGhzPreset preset;
+    uint16_t offset;
+    uint16_t size;
+    uint8_t type;
+    bool pinned;
+    bool locked;
 } SubGhzHistoryItem;
 
-ARRAY_DEF(SubGhzHistoryItemArray, SubGhzHistoryItem, M_POD_OPLIST)
-
-#define M_OPL_SubGhzHistoryItemArray_t() ARRAY_OPLIST(SubGhzHistoryItemArray, M_POD_OPLIST)
-
-typedef struct {
-    SubGhzHistoryItemArray_t data;
-} SubGhzHistoryStruct;
-
 struct SubGhzHistory {
-    uint32_t last_update_timestamp;
+    // Items keep their index for life, an evicted item is replaced in place
+    SubGhzHistoryItem items[SUBGHZ_HISTORY_MAX];
     uint16_t last_index_write;
-    uint8_t code_last_hash_data;
+    uint8_t table[SUBGHZ_HISTORY_TABLE_SIZE];
+    // Item data is packed in index order, removal compacts it
+    uint8_t arena[SUBGHZ_HISTORY_ARENA_SIZE];
+    uint16_t arena_used;
+    // Evicted records are logged once, from the GUI thread
+    uint32_t spilled_hashes[SUBGHZ_HISTORY_SPILLED_TABLE_SIZE];
+    uint16_t spilled_count;
+    string_t spill_pending;
+    // Guards everything above: items are added from the worker thread, read from the GUI
+    osMutexId_t mutex;
+
+    // Used by the GUI thread only
     string_t tmp_string;
-    SubGhzHistoryStruct* history;
+    // Handed out by subghz_history_get_raw_data
+    FlipperFormat* raw_data;
+    // Used by the receiver callback only
+    string_t worker_string;
+    FlipperFormat* serialized;
 };
 
 SubGhzHistory* subghz_history_alloc(void) {
     SubGhzHistory* instance = malloc(sizeof(SubGhzHistory));
     string_init(instance->tmp_string);
-    instance->history = malloc(sizeof(SubGhzHistoryStruct));
-    SubGhzHistoryItemArray_init(instance->history->data);
+    string_init(instance->worker_string);
+    string_init(instance->spill_pending);
+    instance->mutex = osMutexNew(NULL);
+    instance->serialized = flipper_format_string_alloc();
+    instance->raw_data = flipper_format_string_alloc();
+    subghz_history_reset(instance);
     return instance;
 }
 
 void subghz_history_free(SubGhzHistory* instance) {
     furi_assert(instance);
+    subghz_history_flush(instance);
+    osMutexDelete(instance->mutex);
+    string_clear(instance->spill_pending);
+    string_clear(instance->worker_string);
     string_clear(instance->tmp_string);
-    for
-        M_EACH(item, instance->history->data, SubGhzHistoryItemArray_t) {
-            string_clear(item->item_str);
-            flipper_format_free(item->flipper_string);
-            item->type = 0;
-        }
-    SubGhzHistoryItemArray_clear(instance->history->data);
-    free(instance->history);
+    flipper_format_free(instance->serialized);
+    flipper_format_free(instance->raw_data);
     free(instance);
 }
 
+static void subghz_history_lock(SubGhzHistory* instance) {
+    furi_check(osMutexAcquire(instance->mutex, osWaitForever) == osOK);
+}
+
+static void subghz_history_unlock(SubGhzHistory* instance) {
+    furi_check(osMutexRelease(instance->mutex) == osOK);
+}
+
 uint32_t subghz_history_get_frequency(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return item->frequency;
+    subghz_history_lock(instance);
+    furi_assert(idx < instance->last_index_write);
+    uint32_t frequency = instance->items[idx].frequency;
+    subghz_history_unlock(instance);
+    return frequency;
 }
 
 FuriHalSubGhzPreset subghz_history_get_preset(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return item->preset;
+    subghz_history_lock(instance);
+    furi_assert(idx < instance->last_index_write);
+    FuriHalSubGhzPreset preset = instance->items[idx].preset;
+    subghz_history_unlock(instance);
+    return preset;
 }
 
 void subghz_history_reset(SubGhzHistory* instance) {
     furi_assert(instance);
+    subghz_history_flush(instance);
+    subghz_history_lock(instance);
     string_reset(instance->tmp_string);
-    for
-        M_EACH(item, instance->history->data, SubGhzHistoryItemArray_t) {
-            string_clear(item->item_str);
-            flipper_format_free(item->flipper_string);
-            item->type = 0;
-        }
-    SubGhzHistoryItemArray_reset(instance->history->data);
+    memset(instance->table, SUBGHZ_HISTORY_TABLE_EMPTY, sizeof(instance->table));
     instance->last_index_write = 0;
-    instance->code_last_hash_data = 0;
+    instance->arena_used = 0;
+    memset(instance->spilled_hashes, 0, sizeof(instance->spilled_hashes));
+    instance->spilled_count = 0;
+    subghz_history_unlock(instance);
 }
 
 uint16_t subghz_history_get_item(SubGhzHistory* instance) {
     furi_assert(instance);
-    return instance->last_index_write;
+    subghz_history_lock(instance);
+    uint16_t count = instance->last_index_write;
+    subghz_history_unlock(instance);
+    return count;
 }
 
 uint8_t subghz_history_get_type_protocol(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return item->type;
+    subghz_history_lock(instance);
+    furi_assert(idx < instance->last_index_write);
+    uint8_t type = instance->items[idx].type;
+    subghz_history_unlock(instance);
+    return type;
+}
+
+/** Serialize an item: header, frequency and preset followed by its stored data */
+static bool subghz_history_write_item(
+    SubGhzHistory* instance,
+    SubGhzHistoryItem* item,
+    FlipperFormat* flipper_format,
+    string_t preset_name) {
+    bool res = false;
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+    do {
+        if(!flipper_format_write_header_cstr(
+               flipper_format, SUBGHZ_KEY_FILE_TYPE, SUBGHZ_KEY_FILE_VERSION)) {
+            break;
+        }
+        if(!flipper_format_write_uint32(flipper_format, "Frequency", &item->frequency, 1)) {
+            break;
+        }
+        if(!subghz_block_generic_get_preset_name(item->preset, preset_name)) {
+            break;
+        }
+        if(!flipper_format_write_string(flipper_format, "Preset", preset_name)) {
+            break;
+        }
+        if(stream_write(stream, &instance->arena[item->offset], item->size) != item->size) {
+            break;
+        }
+        res = true;
+    } while(false);
+    return res;
+}
+
+/** Restore an item into raw_data, called with the lock held */
+static FlipperFormat* subghz_history_restore_item(SubGhzHistory* instance, uint16_t idx) {
+    furi_assert(idx < instance->last_index_write);
+    stream_clean(flipper_format_get_raw_stream(instance->raw_data));
+    if(!subghz_history_write_item(
+           instance, &instance->items[idx], instance->raw_data, instance->tmp_string)) {
+        FURI_LOG_E(TAG, "Unable to restore item");
+    }
+    flipper_format_rewind(instance->raw_data);
+    return instance->raw_data;
+}
+
+FlipperFormat* subghz_history_get_raw_data(SubGhzHistory* instance, uint16_t idx) {
+    furi_assert(instance);
+    subghz_history_lock(instance);
+    FlipperFormat* flipper_format = subghz_history_restore_item(instance, idx);
+    subghz_history_unlock(instance);
+    return flipper_format;
 }
 
 const char* subghz_history_get_protocol_name(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    flipper_format_rewind(item->flipper_string);
-    if(!flipper_format_read_string(item->flipper_string, "Protocol", instance->tmp_string)) {
+    subghz_history_lock(instance);
+    FlipperFormat* flipper_format = subghz_history_restore_item(instance, idx);
+    if(!flipper_format_read_string(flipper_format, "Protocol", instance->tmp_string)) {
         FURI_LOG_E(TAG, "Missing Protocol");
         string_reset(instance->tmp_string);
     }
+    subghz_history_unlock(instance);
     return string_get_cstr(instance->tmp_string);
 }
 
-FlipperFormat* subghz_history_get_raw_data(SubGhzHistory* instance, uint16_t idx) {
-    furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    if(item->flipper_string) {
-        return item->flipper_string;
-    } else {
-        return NULL;
-    }
-}
 bool subghz_history_get_text_space_left(SubGhzHistory* instance, string_t output) {
     furi_assert(instance);
-    if(instance->last_index_write == SUBGHZ_HISTORY_MAX) {
+    subghz_history_lock(instance);
+    uint16_t count = instance->last_index_write;
+    size_t pinned = 0;
+    for(size_t i = 0; i < count; i++) {
+        if(instance->items[i].pinned || instance->items[i].locked) pinned++;
+    }
+    subghz_history_unlock(instance);
+
+    if(pinned == SUBGHZ_HISTORY_MAX) {
         if(output != NULL) string_printf(output, "Memory is FULL");
         return true;
     }
-    if(output != NULL)
-        string_printf(output, "%02u/%02u", instance->last_index_write, SUBGHZ_HISTORY_MAX);
+    if(output != NULL) string_printf(output, "%02u/%02u", count, SUBGHZ_HISTORY_MAX);
     return false;
 }
 
 void subghz_history_get_text_item_menu(SubGhzHistory* instance, string_t output, uint16_t idx) {
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    string_set(output, item->item_str);
+    furi_assert(instance);
+    subghz_history_lock(instance);
+    furi_assert(idx < instance->last_index_write);
+    string_set_str(output, instance->items[idx].item_str);
+    subghz_history_unlock(instance);
 }
 
-bool subghz_history_add_to_history(
+void subghz_history_set_pinned(SubGhzHistory* instance, uint16_t idx, bool pinned) {
+    furi_assert(instance);
+    subghz_history_lock(instance);
+    furi_assert(idx < instance->last_index_write);
+    instance->items[idx].pinned = pinned;
+    subghz_history_unlock(instance);
+}
+
+void subghz_history_set_locked(SubGhzHistory* instance, uint16_t idx, bool locked) {
+    furi_assert(instance);
+    subghz_history_lock(instance);
+    furi_assert(idx < instance->last_index_write);
+    instance->items[idx].locked = locked;
+    subghz_history_unlock(instance);
+}
+
+/** Find the table position of a key, or of the empty slot ending its probe sequence */
+static size_t subghz_history_table_find(
     SubGhzHistory* instance,
-    void* context,
-    uint32_t frequency,
-    FuriHalSubGhzPreset preset) {
+    uint32_t hash,
+    const uint8_t* data,
+    size_t size) {
+    size_t position = hash & SUBGHZ_HISTORY_TABLE_MASK;
+    while(instance->table[position] != SUBGHZ_HISTORY_TABLE_EMPTY) {
+        SubGhzHistoryItem* item = &instance->items[instance->table[position]];
+        // Colliding hashes are told apart by the stored data
+        if(item->hash == hash && item->size == size &&
+           !memcmp(&instance->arena[item->offset], data, size)) {
+            break;
+        }
+        position = (position + 1) & SUBGHZ_HISTORY_TABLE_MASK;
+    }
+    return position;
+}
+
+/** Find the table position of an item */
+static size_t subghz_history_table_find_item(SubGhzHistory* instance, uint16_t idx) {
+    size_t position = instance->items[idx].hash & SUBGHZ_HISTORY_TABLE_MASK;
+    while(instance->table[position] != idx) {
+        furi_assert(instance->table[position] != SUBGHZ_HISTORY_TABLE_EMPTY);
+        position = (position + 1) & SUBGHZ_HISTORY_TABLE_MASK;
+    }
+    return position;
+}
+
+/** Remove a table entry, moving later entries of the cluster back into the hole */
+static void subghz_history_table_remove(SubGhzHistory* instance, size_t position) {
+    size_t hole = position;
+    size_t next = (position + 1) & SUBGHZ_HISTORY_TABLE_MASK;
+    while(instance->table[next] != SUBGHZ_HISTORY_TABLE_EMPTY) {
+        size_t home = instance->items[instance->table[next]].hash & SUBGHZ_HISTORY_TABLE_MASK;
+        // Entry may fill the hole if its home is not cyclically within (hole, next]
+        if(((next - home) & SUBGHZ_HISTORY_TABLE_MASK) >=
+           ((next - hole) & SUBGHZ_HISTORY_TABLE_MASK)) {
+            instance->table[hole] = instance->table[next];
+            hole = next;
+        }
+        next = (next + 1) & SUBGHZ_HISTORY_TABLE_MASK;
+    }
+    instance->table[hole] = SUBGHZ_HISTORY_TABLE_EMPTY;
+}
+
+/** Remember a logged record, false if it was logged before */
+static bool subghz_history_spilled_insert(SubGhzHistory* instance, uint32_t hash) {
+    // 0 marks an empty slot
+    if(!hash) hash = 1;
+    if(instance->spilled_count >= SUBGHZ_HISTORY_SPILLED_TABLE_SIZE / 4 * 3) {
+        // Forget old records rather than probe a full table, they may be logged again
+        memset(instance->spilled_hashes, 0, sizeof(instance->spilled_hashes));
+        instance->spilled_count = 0;
+    }
+    size_t position = hash & SUBGHZ_HISTORY_SPILLED_TABLE_MASK;
+    while(instance->spilled_hashes[position]) {
+        if(instance->spilled_hashes[position] == hash) return false;
+        position = (position + 1) & SUBGHZ_HISTORY_SPILLED_TABLE_MASK;
+    }
+    instance->spilled_hashes[position] = hash;
+    instance->spilled_count++;
+    return true;
+}
+
+/** Queue an evicted item for the log on SD card, written by subghz_history_flush */
+static void subghz_history_spill(SubGhzHistory* instance, SubGhzHistoryItem* item) {
+    if(!subghz_history_spilled_insert(instance, item->hash)) return;
+
+    // Records are complete key files separated by an empty line
+    Stream* record = flipper_format_get_raw_stream(instance->serialized);
+    stream_clean(record);
+    if(!subghz_history_write_item(
+           instance, item, instance->serialized, instance->worker_string) ||
+       !stream_write_cstring(record, "\n")) {
+        FURI_LOG_E(TAG, "Unable to restore item");
+        return;
+    }
+    stream_rewind(record);
+
+    if(string_size(instance->spill_pending) + stream_size(record) >
+       SUBGHZ_HISTORY_SPILL_PENDING_MAX) {
+        FURI_LOG_E(TAG, "History log queue is full");
+    } else {
+        char chunk[65];
+        size_t chunk_size;
+        while((chunk_size = stream_read(record, (uint8_t*)chunk, sizeof(chunk) - 1)) > 0) {
+            chunk[chunk_size] = '\0';
+            string_cat_str(instance->spill_pending, chunk);
+        }
+    }
+}
+
+void subghz_history_flush(SubGhzHistory* instance) {
     furi_assert(instance);
-    furi_assert(context);
+    string_t pending;
+    string_init(pending);
+    subghz_history_lock(instance);
+    string_swap(pending, instance->spill_pending);
+    subghz_history_unlock(instance);
 
-    if(instance->last_index_write >= SUBGHZ_HISTORY_MAX) return false;
+    if(string_size(pending)) {
+        Storage* storage = furi_record_open("storage");
+        File* file = storage_file_alloc(storage);
+        if(!storage_file_open(file, SUBGHZ_HISTORY_LOG_PATH, FSAM_WRITE, FSOM_OPEN_APPEND) ||
+           storage_file_write(file, string_get_cstr(pending), string_size(pending)) !=
+               string_size(pending)) {
+            FURI_LOG_E(TAG, "Unable to write history log");
+        }
+        storage_file_close(file);
+        storage_file_free(file);
+        furi_record_close("storage");
+    }
+    string_clear(pending);
+}
 
-    SubGhzProtocolDecoderBase* decoder_base = context;
-    if((instance->code_last_hash_data ==
-        subghz_protocol_decoder_base_get_hash_data(decoder_base)) &&
-       ((furi_hal_get_tick() - instance->last_update_timestamp) < 500)) {
-        instance->last_update_timestamp = furi_hal_get_tick();
-        return false;
+/** Drop an item's data and hash, the item slot is reused by the caller */
+static void subghz_history_evict(SubGhzHistory* instance, uint16_t idx) {
+    SubGhzHistoryItem* item = &instance->items[idx];
+    subghz_history_spill(instance, item);
+    subghz_history_table_remove(instance, subghz_history_table_find_item(instance, idx));
+
+    uint16_t end = item->offset + item->size;
+    memmove(&instance->arena[item->offset], &instance->arena[end], instance->arena_used - end);
+    for(size_t i = 0; i < instance->last_index_write; i++) {
+        if(instance->items[i].offset >= end) instance->items[i].offset -= item->size;
     }
+    instance->arena_used -= item->size;
+    item->size = 0;
+}
 
-    instance->code_last_hash_data = subghz_protocol_decoder_base_get_hash_data(decoder_base);
-    instance->last_update_timestamp = furi_hal_get_tick();
+/** Least recently seen item that is not pinned */
+static bool subghz_history_find_lru(SubGhzHistory* instance, uint16_t* idx) {
+    bool found = false;
+    for(uint16_t i = 0; i < instance->last_index_write; i++) {
+        SubGhzHistoryItem* item = &instance->items[i];
+        if(item->pinned || item->locked) continue;
+        if(!found || item->last_seen < instance->items[*idx].last_seen) {
+            *idx = i;
+            found = true;
+        }
+    }
+    return found;
+}
 
+static void subghz_history_make_item_str(SubGhzHistory* instance, char* item_str) {
+    FlipperFormat* flipper_format = instance->serialized;
     string_t text;
     string_init(text);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_push_raw(instance->history->data);
-    item->type = decoder_base->protocol->type;
-    item->frequency = frequency;
-    item->preset = preset;
-
-    string_init(item->item_str);
-    item->flipper_string = flipper_format_string_alloc();
-    subghz_protocol_decoder_base_serialize(decoder_base, item->flipper_string, frequency, preset);
+    item_str[0] = '\0';
 
     do {
-        if(!flipper_format_rewind(item->flipper_string)) {
+        if(!flipper_format_rewind(flipper_format)) {
             FURI_LOG_E(TAG, "Rewind error");
             break;
         }
-        if(!flipper_format_read_string(item->flipper_string, "Protocol", instance->tmp_string)) {
+        if(!flipper_format_read_string(flipper_format, "Protocol", instance->worker_string)) {
             FURI_LOG_E(TAG, "Missing Protocol");
             break;
         }
-        if(!strcmp(string_get_cstr(instance->tmp_string), "KeeLoq")) {
-            string_set(instance->tmp_string, "KL ");
-            if(!flipper_format_read_string(item->flipper_string, "Manufacture", text)) {
+        if(!strcmp(string_get_cstr(instance->worker_string), "KeeLoq")) {
+            string_set_str(instance->worker_string, "KL ");
+            if(!flipper_format_read_string(flipper_format, "Manufacture", text)) {
                 FURI_LOG_E(TAG, "Missing Protocol");
                 break;
             }
-            string_cat(instance->tmp_string, text);
-        } else if(!strcmp(string_get_cstr(instance->tmp_string), "Star Line")) {
-            string_set(instance->tmp_string, "SL ");
-            if(!flipper_format_read_string(item->flipper_string, "Manufacture", text)) {
+            string_cat(instance->worker_string, text);
+        } else if(!strcmp(string_get_cstr(instance->worker_string), "Star Line")) {
+            string_set_str(instance->worker_string, "SL ");
+            if(!flipper_format_read_string(flipper_format, "Manufacture", text)) {
                 FURI_LOG_E(TAG, "Missing Protocol");
                 break;
             }
-            string_cat(instance->tmp_string, text);
+            string_cat(instance->worker_string, text);
         }
-        if(!flipper_format_rewind(item->flipper_string)) {
+        if(!flipper_format_rewind(flipper_format)) {
             FURI_LOG_E(TAG, "Rewind error");
             break;
         }
         uint8_t key_data[sizeof(uint64_t)] = {0};
-        if(!flipper_format_read_hex(item->flipper_string, "Key", key_data, sizeof(uint64_t))) {
+        if(!flipper_format_read_hex(flipper_format, "Key", key_data, sizeof(uint64_t))) {
             FURI_LOG_E(TAG, "Missing Key");
             break;
         }
@@ -197,22 +437,95 @@ bool subghz_history_add_to_history(
             data = (data << 8) | key_data[i];
         }
         if(!(uint32_t)(data >> 32)) {
-            string_printf(
-                item->item_str,
+            snprintf(
+                item_str,
+                SUBGHZ_HISTORY_ITEM_STR_SIZE,
                 "%s %lX",
-                string_get_cstr(instance->tmp_string),
+                string_get_cstr(instance->worker_string),
                 (uint32_t)(data & 0xFFFFFFFF));
         } else {
-            string_printf(
-                item->item_str,
+            snprintf(
+                item_str,
+                SUBGHZ_HISTORY_ITEM_STR_SIZE,
                 "%s %lX%08lX",
-                string_get_cstr(instance->tmp_string),
+                string_get_cstr(instance->worker_string),
                 (uint32_t)(data >> 32),
                 (uint32_t)(data & 0xFFFFFFFF));
         }
     } while(false);
 
     string_clear(text);
-    instance->last_index_write++;
-    return true;
+}
+
+bool subghz_history_add_to_history(
+    SubGhzHistory* instance,
+    void* context,
+    uint32_t frequency,
+    FuriHalSubGhzPreset preset) {
+    furi_assert(instance);
+    furi_assert(context);
+
+    SubGhzProtocolDecoderBase* decoder_base = context;
+    subghz_protocol_decoder_base_serialize(decoder_base, instance->serialized, frequency, preset);
+
+    // Keep and hash everything from the protocol on: frequency and preset do not make a new key
+    Stream* stream = flipper_format_get_raw_stream(instance->serialized);
+    flipper_format_rewind(instance->serialized);
+    if(!flipper_format_read_string(instance->serialized, "Preset", instance->worker_string)) {
+        FURI_LOG_E(TAG, "Missing Preset");
+        return false;
+    }
+    //skip the end of the previous line "\n"
+    stream_seek(stream, 1, StreamOffsetFromCurrent);
+    size_t size = stream_size(stream) - stream_tell(stream);
+    if(size > SUBGHZ_HISTORY_ITEM_DATA_MAX) {
+        FURI_LOG_E(TAG, "Item too large");
+        return false;
+    }
+    uint8_t data[SUBGHZ_HISTORY_ITEM_DATA_MAX];
+    stream_read(stream, data, size);
+    uint32_t hash = fnv1a_buffer_hash(data, size, FNV_1A_INIT);
+
+    bool res = false;
+    subghz_history_lock(instance);
+    size_t position = subghz_history_table_find(instance, hash, data, size);
+    do {
+        if(instance->table[position] != SUBGHZ_HISTORY_TABLE_EMPTY) {
+            instance->items[instance->table[position]].last_seen = furi_hal_get_tick();
+            break;
+        }
+
+        // Spilling an evicted item reuses the serialization buffer
+        char item_str[SUBGHZ_HISTORY_ITEM_STR_SIZE];
+        subghz_history_make_item_str(instance, item_str);
+
+        // Append while there is room, then replace the least recently seen item
+        uint16_t idx = instance->last_index_write;
+        if(idx == SUBGHZ_HISTORY_MAX) {
+            if(!subghz_history_find_lru(instance, &idx)) break;
+            subghz_history_evict(instance, idx);
+        }
+
+        SubGhzHistoryItem* item = &instance->items[idx];
+        item->hash = hash;
+        item->last_seen = furi_hal_get_tick();
+        item->frequency = frequency;
+        item->preset = preset;
+        item->type = decoder_base->protocol->type;
+        item->pinned = false;
+        item->locked = false;
+        item->offset = instance->arena_used;
+        item->size = size;
+        memcpy(&instance->arena[item->offset], data, size);
+        instance->arena_used += size;
+
+        // Evictions may have reshaped the probe sequence
+        instance->table[subghz_history_table_find(instance, hash, data, size)] = idx;
+        memcpy(item->item_str, item_str, SUBGHZ_HISTORY_ITEM_STR_SIZE);
+        if(idx == instance->last_index_write) instance->last_index_write++;
+        res = true;
+    } while(false);
+    subghz_history_unlock(instance);
+
+    return res;
 }
@@ -61,7 +61,7 @@ uint8_t subghz_history_get_type_protocol(SubGhzHistory* instance, uint16_t idx);
  * 
  * @param instance  - SubGhzHistory instance
  * @param idx       - record index  
- * @return name      - const char* name protocol  
+ * @return name      - const char* name protocol, valid until the next call from the GUI thread
  */
 const char* subghz_history_get_protocol_name(SubGhzHistory* instance, uint16_t idx);
 
@@ -82,12 +82,17 @@ void subghz_history_get_text_item_menu(SubGhzHistory* instance, string_t output,
 bool subghz_history_get_text_space_left(SubGhzHistory* instance, string_t output);
 
 /** Add protocol to history
+ * 
+ * Records are deduplicated by protocol and data. When history is full the
+ * least recently seen record that is neither pinned nor locked is queued for
+ * the log on SD card and its index is reused for the new record. Called from
+ * the receiver callback, the other functions take the same lock.
  * 
  * @param instance  - SubGhzHistory instance
  * @param context    - SubGhzProtocolCommon context
  * @param frequency - frequency Hz
  * @param preset    - FuriHalSubGhzPreset preset
- * @return bool;
+ * @return bool - true if a new record was stored
  */
 bool subghz_history_add_to_history(
     SubGhzHistory* instance,
@@ -95,6 +100,28 @@ bool subghz_history_add_to_history(
     uint32_t frequency,
     FuriHalSubGhzPreset preset);
 
+/** Pin history[idx], pinned records are never evicted
+ * 
+ * @param instance  - SubGhzHistory instance
+ * @param idx       - record index
+ * @param pinned    - true to pin
+ */
+void subghz_history_set_pinned(SubGhzHistory* instance, uint16_t idx, bool pinned);
+
+/** Lock history[idx] while it is shown, locked records are never evicted
+ * 
+ * @param instance  - SubGhzHistory instance
+ * @param idx       - record index
+ * @param locked    - true to lock
+ */
+void subghz_history_set_locked(SubGhzHistory* instance, uint16_t idx, bool locked);
+
+/** Write evicted records to the log on SD card, call outside of the receiver callback
+ * 
+ * @param instance  - SubGhzHistory instance
+ */
+void subghz_history_flush(SubGhzHistory* instance);
+
 /** Get SubGhzProtocolCommonLoad to load into the protocol decoder bin data
  * 
  * @param instance  - SubGhzHistory instance
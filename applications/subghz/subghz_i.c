@@ -81,6 +81,15 @@ uint32_t subghz_rx(SubGhz* subghz, uint32_t frequency) {
     furi_hal_subghz_flush_rx();
     furi_hal_subghz_rx();
 
+    // While hopping each channel decodes with its own receiver
+    if(subghz->txrx->hopper_state != SubGhzHopperStateOFF) {
+        subghz_worker_set_context(
+            subghz->txrx->worker,
+            subghz_scanner_get_receiver(
+                subghz->txrx->scanner, subghz->txrx->hopper_idx_frequency));
+    } else {
+        subghz_worker_set_context(subghz->txrx->worker, subghz->txrx->receiver);
+    }
     furi_hal_subghz_start_async_rx(subghz_worker_rx_callback, subghz->txrx->worker);
     subghz_worker_start(subghz->txrx->worker);
     subghz->txrx->txrx_state = SubGhzTxRxStateRx;
@@ -113,8 +122,8 @@ void subghz_rx_end(SubGhz* subghz) {
     furi_assert(subghz);
     furi_assert(subghz->txrx->txrx_state == SubGhzTxRxStateRx);
     if(subghz_worker_is_running(subghz->txrx->worker)) {
-        subghz_worker_stop(subghz->txrx->worker);
         furi_hal_subghz_stop_async_rx();
+        subghz_worker_stop(subghz->txrx->worker);
     }
     furi_hal_subghz_idle();
     subghz->txrx->txrx_state = SubGhzTxRxStateIDLE;
@@ -180,6 +189,42 @@ bool subghz_tx_start(SubGhz* subghz, FlipperFormat* flipper_format) {
     return ret;
 }
 
+/**
+ * Dynamic protocols only change the key on transmit, so it is updated in the saved
+ * file in place instead of writing the whole file anew
+ */
+static bool subghz_save_key_to_file(SubGhz* subghz, const char* dev_name) {
+    uint8_t key_data[sizeof(uint64_t)] = {0};
+    Storage* storage = furi_record_open("storage");
+    FlipperFormat* fff_data_file = flipper_format_file_alloc(storage);
+
+    string_t dev_file_name;
+    string_init_printf(
+        dev_file_name, "%s/%s%s", SUBGHZ_APP_FOLDER, dev_name, SUBGHZ_APP_EXTENSION);
+    bool saved = false;
+
+    do {
+        if(!flipper_format_rewind(subghz->txrx->fff_data)) break;
+        if(!flipper_format_read_hex(subghz->txrx->fff_data, "Key", key_data, sizeof(key_data))) {
+            break;
+        }
+
+        if(!flipper_format_file_open_existing(fff_data_file, string_get_cstr(dev_file_name))) {
+            break;
+        }
+        flipper_format_set_update_mode(fff_data_file, FlipperFormatUpdateModeInPlace);
+        if(!flipper_format_update_hex(fff_data_file, "Key", key_data, sizeof(key_data))) break;
+        if(!flipper_format_file_close(fff_data_file)) break;
+
+        saved = true;
+    } while(0);
+
+    flipper_format_free(fff_data_file);
+    string_clear(dev_file_name);
+    furi_record_close("storage");
+    return saved;
+}
+
 void subghz_tx_stop(SubGhz* subghz) {
     furi_assert(subghz);
     furi_assert(subghz->txrx->txrx_state == SubGhzTxRxStateTx);
@@ -191,7 +236,9 @@ void subghz_tx_stop(SubGhz* subghz) {
     //if protocol dynamic then we save the last upload
     if((subghz->txrx->decoder_result->protocol->type == SubGhzProtocolTypeDynamic) &&
        (strcmp(subghz->file_name, ""))) {
-        subghz_save_protocol_to_file(subghz, subghz->txrx->fff_data, subghz->file_name);
+        if(!subghz_save_key_to_file(subghz, subghz->file_name)) {
+            subghz_save_protocol_to_file(subghz, subghz->txrx->fff_data, subghz->file_name);
+        }
     }
     subghz_idle(subghz);
     notification_message(subghz->notifications, &sequence_reset_red);
@@ -481,6 +528,26 @@ uint32_t subghz_random_serial(void) {
     return (uint32_t)rand();
 }
 
+void subghz_hopper_alloc_scanner(SubGhz* subghz) {
+    furi_assert(subghz);
+    if(subghz->txrx->scanner) return;
+
+    subghz->txrx->scanner = subghz_scanner_alloc(
+        subghz->txrx->environment, subghz_hopper_frequencies, subghz_hopper_frequencies_count);
+}
+
+void subghz_hopper_free_scanner(SubGhz* subghz) {
+    furi_assert(subghz);
+    if(!subghz->txrx->scanner) return;
+
+    // Worker may still be feeding one of the scanner receivers
+    if(subghz->txrx->txrx_state == SubGhzTxRxStateRx) {
+        subghz_rx_end(subghz);
+    }
+    subghz_scanner_free(subghz->txrx->scanner);
+    subghz->txrx->scanner = NULL;
+}
+
 void subghz_hopper_update(SubGhz* subghz) {
     furi_assert(subghz);
 
@@ -506,7 +573,8 @@ void subghz_hopper_update(SubGhz* subghz) {
         rssi = furi_hal_subghz_get_rssi();
 
         // Stay if RSSI is high enough
-        if(rssi > -90.0f) {
+        if(subghz_scanner_update_rssi(
+               subghz->txrx->scanner, subghz->txrx->hopper_idx_frequency, rssi)) {
             subghz->txrx->hopper_timeout = 10;
             subghz->txrx->hopper_state = SubGhzHopperStateRSSITimeOut;
             return;
@@ -516,18 +584,16 @@ void subghz_hopper_update(SubGhz* subghz) {
     }
 
     // Select next frequency
-    if(subghz->txrx->hopper_idx_frequency < subghz_hopper_frequencies_count - 1) {
-        subghz->txrx->hopper_idx_frequency++;
-    } else {
-        subghz->txrx->hopper_idx_frequency = 0;
-    }
+    subghz->txrx->hopper_idx_frequency = subghz_scanner_get_next_channel(
+        subghz->txrx->scanner, subghz->txrx->hopper_idx_frequency);
 
+    uint32_t hop_start = DWT->CYCCNT;
     if(subghz->txrx->txrx_state == SubGhzTxRxStateRx) {
         subghz_rx_end(subghz);
     };
     if(subghz->txrx->txrx_state == SubGhzTxRxStateIDLE) {
-        subghz_receiver_reset(subghz->txrx->receiver);
         subghz->txrx->frequency = subghz_hopper_frequencies[subghz->txrx->hopper_idx_frequency];
         subghz_rx(subghz, subghz->txrx->frequency);
+        subghz_scanner_add_hop_time(subghz->txrx->scanner, DWT->CYCCNT - hop_start);
     }
 }
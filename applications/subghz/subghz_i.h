@@ -28,8 +28,10 @@
 
 #include <lib/subghz/receiver.h>
 #include <lib/subghz/transmitter.h>
+#include <lib/subghz/protocols/raw.h>
 
 #include "subghz_history.h"
+#include "helpers/subghz_scanner.h"
 
 #include <gui/modules/variable_item_list.h>
 
@@ -98,7 +100,9 @@ struct SubGhzTxRx {
 
     uint32_t frequency;
     FuriHalSubGhzPreset preset;
+    SubGhzProtocolRAWFormat raw_format;
     SubGhzHistory* history;
+    SubGhzScanner* scanner;
     uint16_t idx_menu_chosen;
     SubGhzTxRxState txrx_state;
     SubGhzHopperState hopper_state;
@@ -176,3 +180,5 @@ bool subghz_delete_file(SubGhz* subghz);
 void subghz_file_name_clear(SubGhz* subghz);
 uint32_t subghz_random_serial(void);
 void subghz_hopper_update(SubGhz* subghz);
+void subghz_hopper_alloc_scanner(SubGhz* subghz);
+void subghz_hopper_free_scanner(SubGhz* subghz);
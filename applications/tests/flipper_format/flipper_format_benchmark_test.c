@@ -0,0 +1,448 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <flipper_format/flipper_format.h>
+#include <flipper_format/flipper_format_i.h>
+#include <flipper_format/flipper_format_cursor.h>
+#include <flipper_format/flipper_format_stream.h>
+#include <toolbox/stream/stream.h>
+#include <storage/storage.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsFlipperFormatBenchmark"
+
+#define BENCHMARK_PATH "/ext/flipper_format_benchmark.test"
+#define BENCHMARK_UPDATES 16
+
+#define CORPUS_RAW_LINES 64
+#define CORPUS_RAW_VALUES 256
+#define CORPUS_IR_RECORDS 128
+#define CORPUS_IR_RAW_VALUES 68
+#define CORPUS_NFC_BLOCKS 256
+#define CORPUS_NFC_BLOCK_SIZE 16
+
+#define FUZZ_ITERATIONS 256
+#define FUZZ_MUTATIONS 8
+/** Fuzzed files are small, to keep them in memory and the test short */
+#define FUZZ_CORPUS_COUNT 4
+
+typedef struct {
+    const char* name;
+    bool (*write)(FlipperFormat* flipper_format, size_t count);
+    bool (*read)(FlipperFormat* flipper_format, size_t count);
+    size_t count;
+    const char* update_key;
+} FlipperFormatCorpus;
+
+static int32_t corpus_raw_timing(size_t line, size_t i) {
+    return (i & 1) ? -(int32_t)(400 + ((line * 31 + i * 7) % 2000)) : 300 + (i * 13) % 1500;
+}
+
+/* Sub-GHz RAW capture */
+static bool corpus_raw_write(FlipperFormat* flipper_format, size_t count) {
+    uint32_t frequency = 433920000;
+    int32_t* data = malloc(CORPUS_RAW_VALUES * sizeof(int32_t));
+    bool result = false;
+
+    do {
+        if(!flipper_format_write_header_cstr(flipper_format, "Flipper SubGhz RAW File", 1)) break;
+        if(!flipper_format_write_uint32(flipper_format, "Frequency", &frequency, 1)) break;
+        if(!flipper_format_write_string_cstr(
+               flipper_format, "Preset", "FuriHalSubGhzPresetOok650Async"))
+            break;
+        if(!flipper_format_write_string_cstr(flipper_format, "Protocol", "RAW")) break;
+
+        result = true;
+        for(size_t line = 0; line < count && result; line++) {
+            for(size_t i = 0; i < CORPUS_RAW_VALUES; i++) {
+                data[i] = corpus_raw_timing(line, i);
+            }
+            result =
+                flipper_format_write_int32(flipper_format, "RAW_Data", data, CORPUS_RAW_VALUES);
+        }
+    } while(false);
+
+    free(data);
+    return result;
+}
+
+static bool corpus_raw_read(FlipperFormat* flipper_format, size_t count) {
+    string_t temp_str;
+    string_init(temp_str);
+    uint32_t temp_data32;
+    int32_t* data = malloc(CORPUS_RAW_VALUES * sizeof(int32_t));
+    size_t lines = 0;
+
+    do {
+        if(!flipper_format_read_header(flipper_format, temp_str, &temp_data32)) break;
+        if(!flipper_format_read_uint32(flipper_format, "Frequency", &temp_data32, 1)) break;
+        if(!flipper_format_read_string(flipper_format, "Preset", temp_str)) break;
+        if(!flipper_format_read_string(flipper_format, "Protocol", temp_str)) break;
+
+        // Same loop as the RAW protocol uses
+        while(flipper_format_get_value_count(flipper_format, "RAW_Data", &temp_data32)) {
+            if(temp_data32 > CORPUS_RAW_VALUES) break;
+            if(!flipper_format_read_int32(flipper_format, "RAW_Data", data, temp_data32)) break;
+            lines++;
+        }
+    } while(false);
+
+    free(data);
+    string_clear(temp_str);
+    return lines == count;
+}
+
+/* Infrared library, parsed and raw signals */
+static bool corpus_ir_write(FlipperFormat* flipper_format, size_t count) {
+    uint32_t frequency = 38000;
+    float duty_cycle = 0.33f;
+    uint32_t timings[CORPUS_IR_RAW_VALUES];
+    uint8_t address[4] = {0x04, 0x00, 0x00, 0x00};
+    uint8_t command[4] = {0x08, 0x00, 0x00, 0x00};
+    string_t name;
+    string_init(name);
+    bool result = false;
+
+    do {
+        if(!flipper_format_write_header_cstr(flipper_format, "IR library file", 1)) break;
+        if(!flipper_format_write_comment_cstr(flipper_format, "Benchmark library")) break;
+
+        result = true;
+        for(size_t record = 0; record < count && result; record++) {
+            string_printf(name, "Signal_%u", record);
+            command[0] = record;
+            result = false;
+
+            if(!flipper_format_write_comment_cstr(flipper_format, "")) break;
+            if(!flipper_format_write_string(flipper_format, "name", name)) break;
+            if(record & 1) {
+                for(size_t i = 0; i < CORPUS_IR_RAW_VALUES; i++) {
+                    timings[i] = 500 + (record * 17 + i * 29) % 1200;
+                }
+                if(!flipper_format_write_string_cstr(flipper_format, "type", "raw")) break;
+                if(!flipper_format_write_uint32(flipper_format, "frequency", &frequency, 1))
+                    break;
+                if(!flipper_format_write_float(flipper_format, "duty_cycle", &duty_cycle, 1))
+                    break;
+                if(!flipper_format_write_uint32(
+                       flipper_format, "data", timings, CORPUS_IR_RAW_VALUES))
+                    break;
+            } else {
+                if(!flipper_format_write_string_cstr(flipper_format, "type", "parsed")) break;
+                if(!flipper_format_write_string_cstr(flipper_format, "protocol", "NEC")) break;
+                if(!flipper_format_write_hex(flipper_format, "address", address, 4)) break;
+                if(!flipper_format_write_hex(flipper_format, "command", command, 4)) break;
+            }
+            result = true;
+        }
+    } while(false);
+
+    string_clear(name);
+    return result;
+}
+
+static bool corpus_ir_read(FlipperFormat* flipper_format, size_t count) {
+    FlipperFormatCursor* cursor = flipper_format_cursor_alloc(flipper_format, "name");
+    char name[32];
+    char key[16];
+    char value[16];
+    uint32_t timings[CORPUS_IR_RAW_VALUES];
+    uint8_t bytes[4];
+    float duty_cycle;
+    size_t records = 0;
+    size_t values = 0;
+
+    while(flipper_format_cursor_next_record(cursor, name, sizeof(name))) {
+        records++;
+        while(flipper_format_cursor_next_key(cursor, key, sizeof(key))) {
+            bool read = false;
+            size_t read_count = 0;
+            if(!strcmp(key, "type") || !strcmp(key, "protocol")) {
+                read = flipper_format_cursor_read_string(cursor, value, sizeof(value));
+                read_count = 1;
+            } else if(!strcmp(key, "frequency") || !strcmp(key, "data")) {
+                read = flipper_format_cursor_read_uint32(
+                    cursor, timings, CORPUS_IR_RAW_VALUES, &read_count);
+            } else if(!strcmp(key, "duty_cycle")) {
+                read = flipper_format_cursor_read_float(cursor, &duty_cycle, 1, &read_count);
+            } else if(!strcmp(key, "address") || !strcmp(key, "command")) {
+                read = flipper_format_cursor_read_hex(cursor, bytes, sizeof(bytes), &read_count);
+            }
+            if(read) values += read_count;
+        }
+    }
+
+    flipper_format_cursor_free(cursor);
+    return records == count && values > records;
+}
+
+/* NFC Mifare Classic 4K dump */
+static bool corpus_nfc_write(FlipperFormat* flipper_format, size_t count) {
+    uint8_t uid[7] = {0x04, 0x85, 0x92, 0x8A, 0xA0, 0x61, 0x81};
+    uint8_t atqa[2] = {0x00, 0x44};
+    uint8_t sak = 0x18;
+    uint8_t block[CORPUS_NFC_BLOCK_SIZE];
+    string_t temp_str;
+    string_init(temp_str);
+    bool result = false;
+
+    do {
+        if(!flipper_format_write_header_cstr(flipper_format, "Flipper NFC device", 2)) break;
+        if(!flipper_format_write_string_cstr(flipper_format, "Device type", "Mifare Classic"))
+            break;
+        if(!flipper_format_write_hex(flipper_format, "UID", uid, sizeof(uid))) break;
+        if(!flipper_format_write_hex(flipper_format, "ATQA", atqa, sizeof(atqa))) break;
+        if(!flipper_format_write_hex(flipper_format, "SAK", &sak, 1)) break;
+        if(!flipper_format_write_string_cstr(flipper_format, "Mifare Classic type", "4K")) break;
+
+        result = true;
+        for(size_t i = 0; i < count && result; i++) {
+            for(size_t j = 0; j < CORPUS_NFC_BLOCK_SIZE; j++) {
+                block[j] = i * 7 + j * 13;
+            }
+            string_printf(temp_str, "Block %u", i);
+            result = flipper_format_write_hex(
+                flipper_format, string_get_cstr(temp_str), block, sizeof(block));
+        }
+    } while(false);
+
+    string_clear(temp_str);
+    return result;
+}
+
+static bool corpus_nfc_read(FlipperFormat* flipper_format, size_t count) {
+    uint8_t data[CORPUS_NFC_BLOCK_SIZE];
+    string_t temp_str;
+    string_init(temp_str);
+    uint32_t temp_data32;
+    size_t blocks = 0;
+
+    do {
+        if(!flipper_format_read_header(flipper_format, temp_str, &temp_data32)) break;
+        if(!flipper_format_read_string(flipper_format, "Device type", temp_str)) break;
+        if(!flipper_format_read_hex(flipper_format, "UID", data, 7)) break;
+        if(!flipper_format_read_hex(flipper_format, "ATQA", data, 2)) break;
+        if(!flipper_format_read_hex(flipper_format, "SAK", data, 1)) break;
+        if(!flipper_format_read_string(flipper_format, "Mifare Classic type", temp_str)) break;
+
+        for(; blocks < count; blocks++) {
+            string_printf(temp_str, "Block %u", blocks);
+            if(!flipper_format_read_hex(
+                   flipper_format, string_get_cstr(temp_str), data, sizeof(data)))
+                break;
+        }
+    } while(false);
+
+    string_clear(temp_str);
+    return blocks == count;
+}
+
+static const FlipperFormatCorpus corpora[] = {
+    {.name = "SubGhz RAW",
+     .write = corpus_raw_write,
+     .read = corpus_raw_read,
+     .count = CORPUS_RAW_LINES,
+     .update_key = "Frequency"},
+    {.name = "IR library",
+     .write = corpus_ir_write,
+     .read = corpus_ir_read,
+     .count = CORPUS_IR_RECORDS,
+     .update_key = "command"},
+    {.name = "NFC dump",
+     .write = corpus_nfc_write,
+     .read = corpus_nfc_read,
+     .count = CORPUS_NFC_BLOCKS,
+     .update_key = "UID"},
+};
+
+static float flipper_format_benchmark_mb_per_second(size_t bytes, uint32_t cycles) {
+    return (float)bytes * SystemCoreClock / cycles / 1000000.0f;
+}
+
+static float flipper_format_benchmark_per_second(uint32_t count, uint32_t cycles) {
+    return (float)count * SystemCoreClock / cycles;
+}
+
+static void flipper_format_benchmark_update(
+    FlipperFormat* flipper_format,
+    const FlipperFormatCorpus* corpus,
+    FlipperFormatUpdateMode mode) {
+    uint8_t data[sizeof(uint32_t)];
+
+    mu_check(flipper_format_file_open_existing(flipper_format, BENCHMARK_PATH));
+    flipper_format_set_update_mode(flipper_format, mode);
+
+    // Values of the same length, the common case for counters and keys
+    uint32_t cycles = DWT->CYCCNT;
+    for(size_t i = 0; i < BENCHMARK_UPDATES; i++) {
+        uint32_t value = 433920000 + i;
+        memcpy(data, &value, sizeof(data));
+        if(!strcmp(corpus->update_key, "Frequency")) {
+            mu_check(flipper_format_update_uint32(flipper_format, corpus->update_key, &value, 1));
+        } else {
+            mu_check(flipper_format_update_hex(
+                flipper_format, corpus->update_key, data, sizeof(data)));
+        }
+    }
+    mu_check(flipper_format_file_close(flipper_format));
+    cycles = DWT->CYCCNT - cycles;
+
+    FURI_LOG_I(
+        TAG,
+        "%s: %s update %0.1f updates/s",
+        corpus->name,
+        mode == FlipperFormatUpdateModeInPlace ? "in place" : "rewrite",
+        (double)flipper_format_benchmark_per_second(BENCHMARK_UPDATES, cycles));
+}
+
+MU_TEST_1(flipper_format_corpus_benchmark, const FlipperFormatCorpus* corpus) {
+    Storage* storage = furi_record_open("storage");
+    FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
+
+    uint32_t cycles = DWT->CYCCNT;
+    mu_check(flipper_format_file_open_always(flipper_format, BENCHMARK_PATH));
+    mu_check(corpus->write(flipper_format, corpus->count));
+    size_t size = stream_size(flipper_format_get_raw_stream(flipper_format));
+    mu_check(flipper_format_file_close(flipper_format));
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "%s: %u bytes, write %0.3f MB/s",
+        corpus->name,
+        size,
+        (double)flipper_format_benchmark_mb_per_second(size, cycles));
+
+    cycles = DWT->CYCCNT;
+    mu_check(flipper_format_file_open_existing(flipper_format, BENCHMARK_PATH));
+    mu_check(corpus->read(flipper_format, corpus->count));
+    mu_check(flipper_format_file_close(flipper_format));
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "%s: read %0.3f MB/s",
+        corpus->name,
+        (double)flipper_format_benchmark_mb_per_second(size, cycles));
+
+    flipper_format_benchmark_update(flipper_format, corpus, FlipperFormatUpdateModeRewrite);
+    flipper_format_benchmark_update(flipper_format, corpus, FlipperFormatUpdateModeInPlace);
+
+    // File is still readable after both kinds of updates
+    mu_check(flipper_format_file_open_existing(flipper_format, BENCHMARK_PATH));
+    mu_check(corpus->read(flipper_format, corpus->count));
+    mu_check(flipper_format_file_close(flipper_format));
+
+    flipper_format_free(flipper_format);
+    storage_simply_remove(storage, BENCHMARK_PATH);
+    furi_record_close("storage");
+}
+
+MU_TEST(flipper_format_benchmark_test) {
+    for(size_t i = 0; i < COUNT_OF(corpora); i++) {
+        MU_RUN_TEST_1(flipper_format_corpus_benchmark, &corpora[i]);
+    }
+}
+
+/* xorshift32, fuzz runs have to be reproducible */
+static uint32_t flipper_format_fuzz_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void flipper_format_fuzz_mutate(Stream* stream, uint32_t* state) {
+    // Symbols the parser cares about are more interesting than random bytes
+    static const char symbols[] = {':', ' ', '\n', '\r', '#', '@', '-', '.', '0', '9', 'A'};
+    size_t size = stream_size(stream);
+    if(size == 0) return;
+
+    size_t position = flipper_format_fuzz_random(state) % size;
+    uint32_t value = flipper_format_fuzz_random(state);
+    char symbol = (value & 0x100) ? symbols[(value >> 9) % sizeof(symbols)] : (char)value;
+    stream_seek(stream, position, StreamOffsetFromStart);
+
+    switch(value % 4) {
+    case 0:
+        stream_write(stream, (uint8_t*)&symbol, 1);
+        break;
+    case 1:
+        stream_insert(stream, (uint8_t*)&symbol, 1);
+        break;
+    case 2:
+        stream_delete(stream, 1 + (value >> 16) % 8);
+        break;
+    default:
+        // Truncate
+        stream_delete(stream, size - position);
+        break;
+    }
+}
+
+MU_TEST_1(flipper_format_corpus_fuzz, const FlipperFormatCorpus* corpus) {
+    FlipperFormat* reference = flipper_format_string_alloc();
+    FlipperFormat* flipper_format = flipper_format_string_alloc();
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+    uint32_t state = 0x12345678;
+    uint32_t value_count;
+    string_t value;
+    string_init(value);
+
+    mu_check(corpus->write(reference, FUZZ_CORPUS_COUNT));
+
+    for(size_t i = 0; i < FUZZ_ITERATIONS; i++) {
+        stream_clean(stream);
+        stream_copy_full(flipper_format_get_raw_stream(reference), stream);
+
+        size_t mutations = 1 + flipper_format_fuzz_random(&state) % FUZZ_MUTATIONS;
+        for(size_t j = 0; j < mutations; j++) {
+            flipper_format_fuzz_mutate(stream, &state);
+        }
+
+        // Whatever the data, parsing has to end
+        flipper_format_rewind(flipper_format);
+        corpus->read(flipper_format, FUZZ_CORPUS_COUNT);
+        flipper_format_rewind(flipper_format);
+        flipper_format_get_value_count(flipper_format, corpus->update_key, &value_count);
+        flipper_format_read_string(flipper_format, corpus->update_key, value);
+
+        // Updated value reads back, with and without the journal
+        uint32_t data = flipper_format_fuzz_random(&state) % 1000;
+        uint32_t read_data = 0;
+        flipper_format_set_update_mode(flipper_format, FlipperFormatUpdateModeInPlace);
+        if(flipper_format_update_uint32(flipper_format, corpus->update_key, &data, 1)) {
+            mu_check(flipper_format_rewind(flipper_format));
+            mu_check(
+                flipper_format_read_uint32(flipper_format, corpus->update_key, &read_data, 1));
+            mu_check(read_data == data);
+
+            mu_check(flipper_format_compact(flipper_format));
+            mu_check(!flipper_format_stream_has_journal(stream));
+            mu_check(flipper_format_rewind(flipper_format));
+            mu_check(
+                flipper_format_read_uint32(flipper_format, corpus->update_key, &read_data, 1));
+            mu_check(read_data == data);
+        }
+        flipper_format_set_update_mode(flipper_format, FlipperFormatUpdateModeRewrite);
+    }
+
+    string_clear(value);
+    flipper_format_free(flipper_format);
+    flipper_format_free(reference);
+}
+
+MU_TEST(flipper_format_fuzz_test) {
+    for(size_t i = 0; i < COUNT_OF(corpora); i++) {
+        MU_RUN_TEST_1(flipper_format_corpus_fuzz, &corpora[i]);
+    }
+}
+
+MU_TEST_SUITE(flipper_format_benchmark_suite) {
+    MU_RUN_TEST(flipper_format_fuzz_test);
+    MU_RUN_TEST(flipper_format_benchmark_test);
+}
+
+int run_minunit_test_flipper_format_benchmark() {
+    MU_RUN_SUITE(flipper_format_benchmark_suite);
+    return MU_EXIT_CODE;
+}
@@ -1,10 +1,17 @@
 #include <furi.h>
+#include <furi_hal.h>
+#include <inttypes.h>
 #include <flipper_format/flipper_format.h>
 #include <flipper_format/flipper_format_i.h>
 #include <toolbox/stream/stream.h>
 #include <storage/storage.h>
 #include "../minunit.h"
 
+#define TAG "UnitTestsFlipperFormat"
+
+#define BENCHMARK_LINES 64
+#define BENCHMARK_VALUES 512
+
 static const char* test_filetype = "Flipper Format test";
 static const uint32_t test_version = 666;
 
@@ -326,9 +333,72 @@ MU_TEST(flipper_format_file_test) {
     furi_record_close("storage");
 }
 
+static float flipper_format_per_second(uint32_t count, uint32_t cycles) {
+    return (float)count * SystemCoreClock / cycles;
+}
+
+MU_TEST(flipper_format_numbers_benchmark_test) {
+    FlipperFormat* flipper_format = flipper_format_string_alloc();
+    uint32_t* data = malloc(BENCHMARK_VALUES * sizeof(uint32_t));
+    uint32_t* read_data = malloc(BENCHMARK_VALUES * sizeof(uint32_t));
+    const uint32_t value_count = BENCHMARK_LINES * BENCHMARK_VALUES;
+
+    // RAW timings look like this
+    for(size_t i = 0; i < BENCHMARK_VALUES; i++) {
+        data[i] = (i & 1) ? -(int32_t)(400 + i * 7) : 300 + i * 13;
+    }
+
+    // Reference: value by value through a string and stdio, as the stream used to do it
+    string_t value;
+    string_init(value);
+    uint32_t cycles = DWT->CYCCNT;
+    for(size_t line = 0; line < BENCHMARK_LINES; line++) {
+        for(size_t i = 0; i < BENCHMARK_VALUES; i++) {
+            string_printf(value, "%" PRId32, data[i]);
+            sscanf(string_get_cstr(value), "%" PRId32, &read_data[i]);
+        }
+    }
+    cycles = DWT->CYCCNT - cycles;
+    string_clear(value);
+    mu_check(memcmp(data, read_data, BENCHMARK_VALUES * sizeof(uint32_t)) == 0);
+    FURI_LOG_I(
+        TAG,
+        "stdio format+parse: %0.0f values/s",
+        (double)flipper_format_per_second(value_count, cycles));
+
+    cycles = DWT->CYCCNT;
+    for(size_t line = 0; line < BENCHMARK_LINES; line++) {
+        mu_check(flipper_format_write_uint32(flipper_format, "RAW_Data", data, BENCHMARK_VALUES));
+    }
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "write_uint32: %0.0f values/s",
+        (double)flipper_format_per_second(value_count, cycles));
+
+    mu_check(flipper_format_rewind(flipper_format));
+    cycles = DWT->CYCCNT;
+    for(size_t line = 0; line < BENCHMARK_LINES; line++) {
+        memset(read_data, 0, BENCHMARK_VALUES * sizeof(uint32_t));
+        mu_check(
+            flipper_format_read_uint32(flipper_format, "RAW_Data", read_data, BENCHMARK_VALUES));
+        mu_check(memcmp(data, read_data, BENCHMARK_VALUES * sizeof(uint32_t)) == 0);
+    }
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "read_uint32: %0.0f values/s",
+        (double)flipper_format_per_second(value_count, cycles));
+
+    free(read_data);
+    free(data);
+    flipper_format_free(flipper_format);
+}
+
 MU_TEST_SUITE(flipper_format_string_suite) {
     MU_RUN_TEST(flipper_format_string_test);
     MU_RUN_TEST(flipper_format_file_test);
+    MU_RUN_TEST(flipper_format_numbers_benchmark_test);
 }
 
 int run_minunit_test_flipper_format_string() {
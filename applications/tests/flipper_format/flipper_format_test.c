@@ -1,6 +1,8 @@
 #include <furi.h>
 #include <flipper_format/flipper_format.h>
 #include <flipper_format/flipper_format_i.h>
+#include <flipper_format/flipper_format_cursor.h>
+#include <flipper_format/flipper_format_stream.h>
 #include <toolbox/stream/stream.h>
 #include "../minunit.h"
 
@@ -58,6 +60,22 @@ static const char* test_data_win = "Filetype: Flipper File test\r\n"
 
 #define READ_TEST_FLP "ff_flp.test"
 
+#define READ_TEST_RECORDS "ff_records.test"
+static const char* test_data_records = "Filetype: Flipper File test\n"
+                                       "Version: 666\n"
+                                       "# \n"
+                                       "name: First\n"
+                                       "data: 1 2 3\r\n"
+                                       "unused: 1\n"
+                                       "# \n"
+                                       "name: Second\n"
+                                       "hex: DE AD\n"
+                                       "float: 1.5\n"
+                                       "# \n"
+                                       "name: First\n"
+                                       "data: 4 5 6 7 8\n"
+                                       "hex: BE EF";
+
 // data created by user on linux machine
 static const char* test_file_linux = TEST_DIR READ_TEST_NIX;
 // data created by user on windows machine
@@ -237,6 +255,72 @@ static bool test_read_updated(const char* file_name) {
     return result;
 }
 
+static bool test_read_indexed(const char* file_name) {
+    Storage* storage = furi_record_open("storage");
+    bool result = false;
+
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    flipper_format_set_key_index(file, true);
+    string_t string_value;
+    string_init(string_value);
+    uint32_t uint32_value;
+    void* scratchpad = malloc(512);
+
+    do {
+        if(!flipper_format_file_open_existing(file, file_name)) break;
+
+        // Backward order, every lookup starts from the beginning of the file
+        if(!flipper_format_get_value_count(file, test_hex_key, &uint32_value)) break;
+        if(uint32_value != COUNT_OF(test_hex_data)) break;
+        if(!flipper_format_read_hex(file, test_hex_key, scratchpad, uint32_value)) break;
+        if(memcmp(scratchpad, test_hex_data, sizeof(uint8_t) * COUNT_OF(test_hex_data)) != 0)
+            break;
+
+        if(!flipper_format_rewind(file)) break;
+        if(!flipper_format_get_value_count(file, test_float_key, &uint32_value)) break;
+        if(uint32_value != COUNT_OF(test_float_data)) break;
+        if(!flipper_format_read_float(file, test_float_key, scratchpad, uint32_value)) break;
+        if(memcmp(scratchpad, test_float_data, sizeof(float) * COUNT_OF(test_float_data)) != 0)
+            break;
+
+        if(!flipper_format_rewind(file)) break;
+        if(!flipper_format_key_exist(file, test_int_key)) break;
+        if(!flipper_format_rewind(file)) break;
+        if(flipper_format_key_exist(file, "Missing key")) break;
+
+        // Key behind the current position is not visible, same as without the index
+        if(!flipper_format_rewind(file)) break;
+        if(!flipper_format_read_string(file, test_string_key, string_value)) break;
+        if(string_cmp_str(string_value, test_string_data) != 0) break;
+        if(!flipper_format_read_uint32(file, test_uint_key, scratchpad, 1)) break;
+        if(flipper_format_read_string(file, test_string_key, string_value)) break;
+
+        // Update changes the file, index must follow
+        if(!flipper_format_update_string_cstr(file, test_string_key, test_string_updated_data))
+            break;
+        if(!flipper_format_rewind(file)) break;
+        if(!flipper_format_read_hex(file, test_hex_key, scratchpad, COUNT_OF(test_hex_data)))
+            break;
+        if(memcmp(scratchpad, test_hex_data, sizeof(uint8_t) * COUNT_OF(test_hex_data)) != 0)
+            break;
+        if(!flipper_format_rewind(file)) break;
+        if(!flipper_format_read_string(file, test_string_key, string_value)) break;
+        if(string_cmp_str(string_value, test_string_updated_data) != 0) break;
+        if(!flipper_format_update_string_cstr(file, test_string_key, test_string_data)) break;
+
+        result = true;
+    } while(false);
+
+    free(scratchpad);
+    string_clear(string_value);
+
+    flipper_format_free(file);
+
+    furi_record_close("storage");
+
+    return result;
+}
+
 static bool test_write(const char* file_name) {
     Storage* storage = furi_record_open("storage");
     bool result = false;
@@ -304,13 +388,14 @@ static bool test_append_key(const char* file_name) {
     return result;
 }
 
-static bool test_update(const char* file_name) {
+static bool test_update(const char* file_name, FlipperFormatUpdateMode mode) {
     Storage* storage = furi_record_open("storage");
     bool result = false;
     FlipperFormat* file = flipper_format_file_alloc(storage);
 
     do {
         if(!flipper_format_file_open_existing(file, file_name)) break;
+        flipper_format_set_update_mode(file, mode);
         if(!flipper_format_update_string_cstr(file, test_string_key, test_string_updated_data))
             break;
         if(!flipper_format_update_int32(
@@ -338,13 +423,14 @@ static bool test_update(const char* file_name) {
     return result;
 }
 
-static bool test_update_backward(const char* file_name) {
+static bool test_update_backward(const char* file_name, FlipperFormatUpdateMode mode) {
     Storage* storage = furi_record_open("storage");
     bool result = false;
     FlipperFormat* file = flipper_format_file_alloc(storage);
 
     do {
         if(!flipper_format_file_open_existing(file, file_name)) break;
+        flipper_format_set_update_mode(file, mode);
         if(!flipper_format_update_string_cstr(file, test_string_key, test_string_data)) break;
         if(!flipper_format_update_int32(file, test_int_key, test_int_data, COUNT_OF(test_int_data)))
             break;
@@ -369,6 +455,33 @@ static bool test_update_backward(const char* file_name) {
     return result;
 }
 
+static bool test_compact(const char* file_name) {
+    Storage* storage = furi_record_open("storage");
+    bool result = false;
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+
+    do {
+        if(!flipper_format_file_open_existing(file, file_name)) break;
+        if(!flipper_format_compact(file)) break;
+        if(flipper_format_stream_has_journal(flipper_format_get_raw_stream(file))) break;
+
+        result = true;
+    } while(false);
+
+    flipper_format_free(file);
+    furi_record_close("storage");
+
+    return result;
+}
+
+static bool test_update_in_place(const char* file_name) {
+    // Some values fit into the old ones, others go to the journal
+    return test_update(file_name, FlipperFormatUpdateModeInPlace) &&
+           test_read_updated(file_name) &&
+           test_update_backward(file_name, FlipperFormatUpdateModeInPlace) &&
+           test_read(file_name) && test_compact(file_name) && test_read(file_name);
+}
+
 static bool test_write_multikey(const char* file_name) {
     Storage* storage = furi_record_open("storage");
     bool result = false;
@@ -396,7 +509,7 @@ static bool test_write_multikey(const char* file_name) {
     return result;
 }
 
-static bool test_read_multikey(const char* file_name) {
+static bool test_read_multikey(const char* file_name, bool indexed) {
     Storage* storage = furi_record_open("storage");
     bool result = false;
     FlipperFormat* file = flipper_format_file_alloc(storage);
@@ -407,6 +520,7 @@ static bool test_read_multikey(const char* file_name) {
 
     do {
         if(!flipper_format_file_open_existing(file, file_name)) break;
+        flipper_format_set_key_index(file, indexed);
         if(!flipper_format_read_header(file, string_value, &uint32_value)) break;
         if(string_cmp_str(string_value, test_filetype) != 0) break;
         if(uint32_value != test_version) break;
@@ -437,6 +551,80 @@ static bool test_read_multikey(const char* file_name) {
     return result;
 }
 
+static bool test_cursor(const char* file_name) {
+    Storage* storage = furi_record_open("storage");
+    bool result = false;
+
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    FlipperFormatCursor* cursor = NULL;
+    char name[16];
+    char key[16];
+    uint32_t uint32_data[4];
+    uint8_t hex_data[2];
+    float float_value;
+    size_t count;
+
+    do {
+        if(!flipper_format_file_open_existing(file, file_name)) break;
+        cursor = flipper_format_cursor_alloc(file, "name");
+
+        // Header keys come before the first record
+        if(!flipper_format_cursor_next_record(cursor, name, sizeof(name))) break;
+        if(strcmp(name, "First") != 0) break;
+        if(!flipper_format_cursor_next_key(cursor, key, sizeof(key))) break;
+        if(strcmp(key, "data") != 0) break;
+        if(!flipper_format_cursor_read_uint32(
+               cursor, uint32_data, COUNT_OF(uint32_data), &count))
+            break;
+        if(count != 3 || uint32_data[0] != 1 || uint32_data[2] != 3) break;
+        // Unread value is skipped
+        if(!flipper_format_cursor_next_key(cursor, key, sizeof(key))) break;
+        if(strcmp(key, "unused") != 0) break;
+        if(flipper_format_cursor_next_key(cursor, key, sizeof(key))) break;
+
+        if(!flipper_format_cursor_next_record(cursor, name, sizeof(name))) break;
+        if(strcmp(name, "Second") != 0) break;
+        if(!flipper_format_cursor_next_key(cursor, key, sizeof(key))) break;
+        if(!flipper_format_cursor_read_hex(cursor, hex_data, sizeof(hex_data), &count)) break;
+        if(count != 2 || hex_data[0] != 0xDE || hex_data[1] != 0xAD) break;
+        if(!flipper_format_cursor_next_key(cursor, key, sizeof(key))) break;
+        if(!flipper_format_cursor_read_float(cursor, &float_value, 1, NULL)) break;
+        if(float_value != 1.5f) break;
+
+        // Values that don't fit are an error, record is still walked through
+        if(!flipper_format_cursor_next_record(cursor, name, sizeof(name))) break;
+        if(strcmp(name, "First") != 0) break;
+        if(!flipper_format_cursor_next_key(cursor, key, sizeof(key))) break;
+        if(flipper_format_cursor_read_uint32(cursor, uint32_data, COUNT_OF(uint32_data), NULL))
+            break;
+        if(!flipper_format_cursor_next_key(cursor, key, sizeof(key))) break;
+        if(strcmp(key, "hex") != 0) break;
+        if(!flipper_format_cursor_read_hex(cursor, hex_data, sizeof(hex_data), NULL)) break;
+        if(hex_data[0] != 0xBE || hex_data[1] != 0xEF) break;
+
+        if(flipper_format_cursor_next_key(cursor, key, sizeof(key))) break;
+        if(flipper_format_cursor_next_record(cursor, name, sizeof(name))) break;
+
+        // Records only
+        flipper_format_cursor_free(cursor);
+        if(!flipper_format_rewind(file)) break;
+        cursor = flipper_format_cursor_alloc(file, "name");
+        count = 0;
+        while(flipper_format_cursor_next_record(cursor, name, sizeof(name))) {
+            count++;
+        }
+        if(count != 3) break;
+
+        result = true;
+    } while(false);
+
+    if(cursor) flipper_format_cursor_free(cursor);
+    flipper_format_free(file);
+    furi_record_close("storage");
+
+    return result;
+}
+
 MU_TEST(flipper_format_write_test) {
     mu_assert(storage_write_string(test_file_linux, test_data_nix), "Write test error [Linux]");
     mu_assert(
@@ -450,6 +638,13 @@ MU_TEST(flipper_format_read_test) {
     mu_assert(test_read(test_file_flipper), "Read test error [Flipper]");
 }
 
+MU_TEST(flipper_format_read_indexed_test) {
+    mu_assert(test_read_indexed(test_file_linux), "Indexed read test error [Linux]");
+    mu_assert(test_read_indexed(test_file_windows), "Indexed read test error [Windows]");
+    mu_assert(test_read_indexed(test_file_flipper), "Indexed read test error [Flipper]");
+    mu_assert(test_read(test_file_linux), "Data changed by indexed read test [Linux]");
+}
+
 MU_TEST(flipper_format_delete_test) {
     mu_assert(test_delete_last_key(test_file_linux), "Cannot delete key [Linux]");
     mu_assert(test_delete_last_key(test_file_windows), "Cannot delete key [Windows]");
@@ -475,9 +670,15 @@ MU_TEST(flipper_format_append_result_test) {
 }
 
 MU_TEST(flipper_format_update_1_test) {
-    mu_assert(test_update(test_file_linux), "Cannot update data #1 [Linux]");
-    mu_assert(test_update(test_file_windows), "Cannot update data #1 [Windows]");
-    mu_assert(test_update(test_file_flipper), "Cannot update data #1 [Flipper]");
+    mu_assert(
+        test_update(test_file_linux, FlipperFormatUpdateModeRewrite),
+        "Cannot update data #1 [Linux]");
+    mu_assert(
+        test_update(test_file_windows, FlipperFormatUpdateModeRewrite),
+        "Cannot update data #1 [Windows]");
+    mu_assert(
+        test_update(test_file_flipper, FlipperFormatUpdateModeRewrite),
+        "Cannot update data #1 [Flipper]");
 }
 
 MU_TEST(flipper_format_update_1_result_test) {
@@ -487,9 +688,15 @@ MU_TEST(flipper_format_update_1_result_test) {
 }
 
 MU_TEST(flipper_format_update_2_test) {
-    mu_assert(test_update_backward(test_file_linux), "Cannot update data #2 [Linux]");
-    mu_assert(test_update_backward(test_file_windows), "Cannot update data #2 [Windows]");
-    mu_assert(test_update_backward(test_file_flipper), "Cannot update data #2 [Flipper]");
+    mu_assert(
+        test_update_backward(test_file_linux, FlipperFormatUpdateModeRewrite),
+        "Cannot update data #2 [Linux]");
+    mu_assert(
+        test_update_backward(test_file_windows, FlipperFormatUpdateModeRewrite),
+        "Cannot update data #2 [Windows]");
+    mu_assert(
+        test_update_backward(test_file_flipper, FlipperFormatUpdateModeRewrite),
+        "Cannot update data #2 [Flipper]");
 }
 
 MU_TEST(flipper_format_update_2_result_test) {
@@ -498,15 +705,33 @@ MU_TEST(flipper_format_update_2_result_test) {
     mu_assert(test_read(test_file_flipper), "Data #2 updated incorrectly [Flipper]");
 }
 
+MU_TEST(flipper_format_update_in_place_test) {
+    mu_assert(test_update_in_place(test_file_linux), "In place update test error [Linux]");
+    mu_assert(test_update_in_place(test_file_windows), "In place update test error [Windows]");
+    mu_assert(test_update_in_place(test_file_flipper), "In place update test error [Flipper]");
+}
+
 MU_TEST(flipper_format_multikey_test) {
     mu_assert(test_write_multikey(TEST_DIR "ff_multiline.test"), "Multikey write test error");
-    mu_assert(test_read_multikey(TEST_DIR "ff_multiline.test"), "Multikey read test error");
+    mu_assert(
+        test_read_multikey(TEST_DIR "ff_multiline.test", false), "Multikey read test error");
+    mu_assert(
+        test_read_multikey(TEST_DIR "ff_multiline.test", true),
+        "Multikey indexed read test error");
+}
+
+MU_TEST(flipper_format_cursor_test) {
+    mu_assert(
+        storage_write_string(TEST_DIR READ_TEST_RECORDS, test_data_records),
+        "Cursor test write error");
+    mu_assert(test_cursor(TEST_DIR READ_TEST_RECORDS), "Cursor test error");
 }
 
 MU_TEST_SUITE(flipper_format) {
     tests_setup();
     MU_RUN_TEST(flipper_format_write_test);
     MU_RUN_TEST(flipper_format_read_test);
+    MU_RUN_TEST(flipper_format_read_indexed_test);
     MU_RUN_TEST(flipper_format_delete_test);
     MU_RUN_TEST(flipper_format_delete_result_test);
     MU_RUN_TEST(flipper_format_append_test);
@@ -515,7 +740,9 @@ MU_TEST_SUITE(flipper_format) {
     MU_RUN_TEST(flipper_format_update_1_result_test);
     MU_RUN_TEST(flipper_format_update_2_test);
     MU_RUN_TEST(flipper_format_update_2_result_test);
+    MU_RUN_TEST(flipper_format_update_in_place_test);
     MU_RUN_TEST(flipper_format_multikey_test);
+    MU_RUN_TEST(flipper_format_cursor_test);
     tests_teardown();
 }
 
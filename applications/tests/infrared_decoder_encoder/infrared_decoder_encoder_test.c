@@ -1,4 +1,5 @@
 #include <furi.h>
+#include <furi_hal.h>
 #include "../minunit.h"
 #include "infrared.h"
 #include "common/infrared_common_i.h"
@@ -9,6 +10,10 @@
 #include "test_data/infrared_rc5_test_data.srcdata"
 #include "test_data/infrared_sirc_test_data.srcdata"
 
+#define TAG "UnitTestsInfrared"
+
+#define BENCHMARK_LOOPS 64
+
 #define RUN_ENCODER(data, expected) \
     run_encoder((data), COUNT_OF(data), (expected), COUNT_OF(expected))
 
@@ -305,6 +310,45 @@ MU_TEST(test_encoder_decoder_all) {
     RUN_ENCODER_DECODER(test_sirc);
 }
 
+/* Replays decoder test data and measures edges per second for the whole decoder chain */
+MU_TEST(test_decoder_benchmark) {
+    const struct {
+        const uint32_t* timings;
+        uint32_t timings_len;
+    } input[] = {
+        {test_decoder_nec_input1, COUNT_OF(test_decoder_nec_input1)},
+        {test_decoder_necext_input1, COUNT_OF(test_decoder_necext_input1)},
+        {test_decoder_samsung32_input1, COUNT_OF(test_decoder_samsung32_input1)},
+        {test_decoder_rc6_input1, COUNT_OF(test_decoder_rc6_input1)},
+        {test_decoder_rc5_input1, COUNT_OF(test_decoder_rc5_input1)},
+        {test_decoder_sirc_input1, COUNT_OF(test_decoder_sirc_input1)},
+    };
+    uint32_t edges = 0;
+    uint32_t messages = 0;
+    bool level = false;
+
+    infrared_reset_decoder(decoder_handler);
+    uint32_t cycles = DWT->CYCCNT;
+    for(uint32_t loop = 0; loop < BENCHMARK_LOOPS; ++loop) {
+        for(size_t i = 0; i < COUNT_OF(input); ++i) {
+            for(uint32_t j = 0; j < input[i].timings_len; ++j) {
+                if(infrared_decode(decoder_handler, level, input[i].timings[j])) ++messages;
+                level = !level;
+            }
+            edges += input[i].timings_len;
+        }
+    }
+    cycles = DWT->CYCCNT - cycles;
+
+    mu_check(messages > 0);
+    FURI_LOG_I(
+        TAG,
+        "Decoder: %lu edges, %lu messages, %lu edges/s",
+        edges,
+        messages,
+        (uint32_t)((uint64_t)edges * SystemCoreClock / cycles));
+}
+
 MU_TEST_SUITE(test_infrared_decoder_encoder) {
     MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 
@@ -322,6 +366,7 @@ MU_TEST_SUITE(test_infrared_decoder_encoder) {
     MU_RUN_TEST(test_decoder_necext1);
     MU_RUN_TEST(test_mix);
     MU_RUN_TEST(test_encoder_decoder_all);
+    MU_RUN_TEST(test_decoder_benchmark);
 }
 
 int run_minunit_test_infrared_decoder_encoder() {
@@ -0,0 +1,106 @@
+#include <furi.h>
+#include <storage/storage.h>
+#include <infrared/infrared_app_remote_manager.h>
+#include "../minunit.h"
+
+#define TEST_DIR_NAME "/ext/unit_tests_tmp"
+#define TEST_REMOTE_NAME "remote_manager"
+#define TEST_REMOTE_PATH TEST_DIR_NAME "/" TEST_REMOTE_NAME ".ir"
+
+static const char* test_remote_data = "Filetype: IR signals file\n"
+                                      "Version: 1\n"
+                                      "# \n"
+                                      "name: Power\n"
+                                      "type: parsed\n"
+                                      "protocol: NEC\n"
+                                      "address: 01 00 00 00\n"
+                                      "command: 11 00 00 00\n"
+                                      "# \n"
+                                      "name: Vol_up\n"
+                                      "type: parsed\n"
+                                      "protocol: NEC\n"
+                                      "address: 01 00 00 00\n"
+                                      "command: 22 00 00 00\n"
+                                      "# \n"
+                                      "name: Vol_dn\n"
+                                      "type: parsed\n"
+                                      "protocol: NEC\n"
+                                      "address: 01 00 00 00\n"
+                                      "command: 33 00 00 00\n";
+
+static bool infrared_remote_test_write_file(const char* path, const char* data) {
+    Storage* storage = static_cast<Storage*>(furi_record_open("storage"));
+    File* file = storage_file_alloc(storage);
+    bool result = storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                  storage_file_write(file, data, strlen(data)) == strlen(data);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close("storage");
+    return result;
+}
+
+static void infrared_remote_test_setup() {
+    Storage* storage = static_cast<Storage*>(furi_record_open("storage"));
+    mu_assert(storage_simply_remove_recursive(storage, TEST_DIR_NAME), "Cannot clean data");
+    mu_assert(storage_simply_mkdir(storage, TEST_DIR_NAME), "Cannot create dir");
+    furi_record_close("storage");
+}
+
+static void infrared_remote_test_teardown() {
+    Storage* storage = static_cast<Storage*>(furi_record_open("storage"));
+    mu_assert(storage_simply_remove_recursive(storage, TEST_DIR_NAME), "Cannot clean data");
+    furi_record_close("storage");
+}
+
+static bool infrared_remote_test_check_button(
+    InfraredAppRemoteManager& manager,
+    size_t index,
+    const char* name,
+    uint32_t command) {
+    InfraredAppSignal signal;
+    return manager.get_button_name(index) == name && manager.get_button_data(index, signal) &&
+           !signal.is_raw() && signal.get_message().command == command;
+}
+
+MU_TEST(infrared_remote_manager_edit_test) {
+    mu_assert(
+        infrared_remote_test_write_file(TEST_REMOTE_PATH, test_remote_data),
+        "Cannot write remote");
+
+    // Signals are not loaded, every edit copies them from the file
+    InfraredAppRemoteManager manager;
+    mu_assert(manager.load(TEST_DIR_NAME, TEST_REMOTE_NAME), "Load error");
+    mu_assert_int_eq(3, manager.get_number_of_buttons());
+
+    mu_assert(manager.rename_button(1, "Louder"), "Rename error");
+    mu_assert(infrared_remote_test_check_button(manager, 1, "Louder", 0x22), "Renamed button");
+
+    mu_assert(manager.delete_button(0), "Delete error");
+    mu_assert_int_eq(2, manager.get_number_of_buttons());
+
+    InfraredMessage message = {InfraredProtocolNEC, 0x01, 0x44, false};
+    mu_assert(manager.add_button("Mute", InfraredAppSignal(&message)), "Add error");
+
+    mu_assert(manager.rename_button(2, "Silence"), "Rename added button error");
+
+    // Stored file has all the changes
+    InfraredAppRemoteManager reloaded;
+    mu_assert(reloaded.load(TEST_DIR_NAME, TEST_REMOTE_NAME), "Reload error");
+    mu_assert_int_eq(3, reloaded.get_number_of_buttons());
+    mu_assert(infrared_remote_test_check_button(reloaded, 0, "Louder", 0x22), "Button 0");
+    mu_assert(infrared_remote_test_check_button(reloaded, 1, "Vol_dn", 0x33), "Button 1");
+    mu_assert(infrared_remote_test_check_button(reloaded, 2, "Silence", 0x44), "Button 2");
+    mu_assert(infrared_remote_test_check_button(manager, 0, "Louder", 0x22), "Edited button 0");
+}
+
+MU_TEST_SUITE(infrared_remote_manager) {
+    infrared_remote_test_setup();
+    MU_RUN_TEST(infrared_remote_manager_edit_test);
+    infrared_remote_test_teardown();
+}
+
+extern "C" int run_minunit_test_infrared_remote_manager() {
+    MU_RUN_SUITE(infrared_remote_manager);
+    return MU_EXIT_CODE;
+}
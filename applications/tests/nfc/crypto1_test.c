@@ -0,0 +1,123 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <lib/nfc_protocols/crypto1.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsCrypto1"
+
+#define CRYPTO1_TEST_ITERATIONS 256
+#define CRYPTO1_BENCHMARK_WORDS 4096
+
+/* xorshift32, runs have to be reproducible */
+static uint32_t crypto1_test_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static uint64_t crypto1_test_random_key(uint32_t* state) {
+    uint64_t key = crypto1_test_random(state);
+    return (key << 16 ^ crypto1_test_random(state)) & 0xFFFFFFFFFFFF;
+}
+
+MU_TEST(crypto1_stepping_test) {
+    uint32_t random = 0x12345678;
+
+    for(size_t i = 0; i < CRYPTO1_TEST_ITERATIONS; i++) {
+        uint64_t key = crypto1_test_random_key(&random);
+        uint32_t word = crypto1_test_random(&random);
+        uint8_t byte = word >> 8;
+        int is_encrypted = word & 1;
+        Crypto1 fast;
+        Crypto1 reference;
+        crypto1_init(&fast, key);
+        crypto1_init(&reference, key);
+
+        // Word and byte stepping give the same as bit by bit stepping
+        uint32_t word_out = crypto1_word(&fast, word, is_encrypted);
+        uint32_t word_reference = 0;
+        for(uint8_t j = 0; j < 32; j++) {
+            uint8_t bit = FURI_BIT(word, j ^ 24);
+            word_reference |= (uint32_t)crypto1_bit(&reference, bit, is_encrypted) << (j ^ 24);
+        }
+        mu_assert_int_eq(word_reference, word_out);
+
+        uint8_t byte_out = crypto1_byte(&fast, byte, is_encrypted);
+        uint8_t byte_reference = 0;
+        for(uint8_t j = 0; j < 8; j++) {
+            byte_reference |= crypto1_bit(&reference, FURI_BIT(byte, j), is_encrypted) << j;
+        }
+        mu_assert_int_eq(byte_reference, byte_out);
+        mu_check(fast.odd == reference.odd && fast.even == reference.even);
+
+        // Rollback gives the same keystream and ends at the key
+        mu_assert_int_eq(byte_out, crypto1_rollback_byte(&fast, byte, is_encrypted));
+        mu_assert_int_eq(word_out, crypto1_rollback_word(&fast, word, is_encrypted));
+        mu_check(crypto1_get_key(&fast) == key);
+    }
+}
+
+MU_TEST(crypto1_auth_test) {
+    // Authentication generated with scripts/flipper/crypto1.py simulate_auth
+    const uint64_t key = 0xA0A1A2A3A4A5;
+    const uint32_t uid = 0x04A1B2C3;
+    const uint32_t nt = 0x01200145;
+    const uint32_t nr = 0x12345678;
+    Crypto1 crypto;
+
+    crypto1_init(&crypto, key);
+    crypto1_word(&crypto, uid ^ nt, 0);
+    uint32_t nr_enc = nr ^ crypto1_word(&crypto, nr, 0);
+    uint32_t ar_enc = prng_successor(nt, 64) ^ crypto1_word(&crypto, 0, 0);
+    mu_assert_int_eq(0x70F39727, nr_enc);
+    mu_assert_int_eq(0xA814EB74, ar_enc);
+
+    // What key recovery does with a found state
+    crypto1_rollback_word(&crypto, 0, 0);
+    crypto1_rollback_word(&crypto, nr_enc, 1);
+    crypto1_rollback_word(&crypto, uid ^ nt, 0);
+    mu_check(crypto1_get_key(&crypto) == key);
+}
+
+MU_TEST(crypto1_benchmark_test) {
+    Crypto1 crypto;
+    uint32_t out = 0;
+    crypto1_init(&crypto, 0xFFFFFFFFFFFF);
+
+    uint32_t cycles = DWT->CYCCNT;
+    for(uint32_t i = 0; i < CRYPTO1_BENCHMARK_WORDS; i++) {
+        out ^= crypto1_word(&crypto, i, 0);
+    }
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "Word stepping: %lu bits/s",
+        (uint32_t)((uint64_t)CRYPTO1_BENCHMARK_WORDS * 32 * SystemCoreClock / cycles));
+
+    cycles = DWT->CYCCNT;
+    for(uint32_t i = 0; i < CRYPTO1_BENCHMARK_WORDS; i++) {
+        out ^= crypto1_rollback_word(&crypto, i, 0);
+    }
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "Word rollback: %lu bits/s",
+        (uint32_t)((uint64_t)CRYPTO1_BENCHMARK_WORDS * 32 * SystemCoreClock / cycles));
+
+    // Keep the keystream used
+    FURI_LOG_D(TAG, "Keystream: %08lX", out);
+}
+
+MU_TEST_SUITE(crypto1_suite) {
+    MU_RUN_TEST(crypto1_stepping_test);
+    MU_RUN_TEST(crypto1_auth_test);
+    MU_RUN_TEST(crypto1_benchmark_test);
+}
+
+int run_minunit_test_crypto1() {
+    MU_RUN_SUITE(crypto1_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,135 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <lib/nfc_protocols/mifare_ultralight.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsMfUltralight"
+
+#define MF_UL_TEST_NTAG213_SIZE (180)
+#define MF_UL_TEST_BENCHMARK_ROUNDS (64)
+
+typedef struct {
+    const char* name;
+    uint8_t cmd[6];
+    uint16_t cmd_len;
+} MfUlTestCommand;
+
+/* What a phone does with an NTAG213: identify, read everything, authenticate, write */
+static const MfUlTestCommand mf_ul_test_trace[] = {
+    {"GET_VERSION", {MF_UL_GET_VERSION_CMD}, 1},
+    {"READ_SIG", {MF_UL_READ_SIG, 0x00}, 2},
+    {"READ", {MF_UL_READ_CMD, 0x04}, 2},
+    {"READ tail", {MF_UL_READ_CMD, 0x2B}, 2},
+    {"FAST_READ", {MF_UL_FAST_READ_CMD, 0x00, 0x2C}, 3},
+    {"READ_CNT", {MF_UL_READ_CNT, 0x02}, 2},
+    {"AUTH", {MF_UL_AUTH, 0x01, 0x02, 0x03, 0x04}, 5},
+    {"WRITE", {MF_UL_WRITE, 0x2A, 0xDE, 0xAD, 0xBE, 0xEF}, 6},
+    {"INC_CNT", {MF_UL_INC_CNT, 0x02, 0x01, 0x00, 0x00, 0x00}, 6},
+};
+
+static void mf_ul_test_prepare(MifareUlDevice* mf_ul_emulate) {
+    MifareUlData* data = malloc(sizeof(MifareUlData));
+    data->version.storage_size = 0x0F;
+    data->data_size = MF_UL_TEST_NTAG213_SIZE;
+    for(uint16_t i = 0; i < data->data_size; i++) {
+        data->data[i] = i;
+    }
+    // PWD 01020304, PACK 8080
+    const uint8_t auth[] = {0x01, 0x02, 0x03, 0x04, 0x80, 0x80};
+    memcpy(&data->data[data->data_size - 8], auth, sizeof(auth));
+    data->counter[2] = 0x000102;
+    mf_ul_prepare_emulation(mf_ul_emulate, data);
+    free(data);
+}
+
+static uint16_t mf_ul_test_exchange(
+    MifareUlDevice* mf_ul_emulate,
+    const uint8_t* cmd,
+    uint16_t cmd_len,
+    uint8_t* buff_tx) {
+    uint8_t buff_rx[16] = {};
+    uint16_t buff_tx_len = 0;
+    uint32_t data_type = 0;
+    memcpy(buff_rx, cmd, cmd_len);
+    mf_ul_prepare_emulation_response(
+        buff_rx, cmd_len, buff_tx, &buff_tx_len, &data_type, mf_ul_emulate);
+    return buff_tx_len;
+}
+
+MU_TEST(mf_ul_emulation_test) {
+    MifareUlDevice* mf_ul_emulate = malloc(sizeof(MifareUlDevice));
+    uint8_t* buff_tx = malloc(MF_UL_TEST_NTAG213_SIZE);
+    mf_ul_test_prepare(mf_ul_emulate);
+
+    // Read on the last pages rolls over to page 0, password and pack are hidden
+    const uint8_t read_tail[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xB2, 0xB3,
+                                 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+    const uint8_t read_tail_cmd[] = {MF_UL_READ_CMD, 0x2B};
+    mu_assert_int_eq(128, mf_ul_test_exchange(mf_ul_emulate, read_tail_cmd, 2, buff_tx));
+    mu_check(memcmp(read_tail, buff_tx, sizeof(read_tail)) == 0);
+
+    const uint8_t fast_read_cmd[] = {MF_UL_FAST_READ_CMD, 0x00, 0x2C};
+    uint16_t fast_read_bits = mf_ul_test_exchange(mf_ul_emulate, fast_read_cmd, 3, buff_tx);
+    mu_assert_int_eq(MF_UL_TEST_NTAG213_SIZE * 8, fast_read_bits);
+    mu_check(memcmp(&read_tail[0], &buff_tx[0x2B * 4], 8) == 0);
+
+    // Written page shows in the prepared responses
+    const uint8_t write_cmd[] = {MF_UL_WRITE, 0x2A, 0xDE, 0xAD, 0xBE, 0xEF};
+    mu_assert_int_eq(4, mf_ul_test_exchange(mf_ul_emulate, write_cmd, 6, buff_tx));
+    mu_assert_int_eq(0x0A, buff_tx[0]);
+    const uint8_t read_written_cmd[] = {MF_UL_READ_CMD, 0x29};
+    mu_assert_int_eq(128, mf_ul_test_exchange(mf_ul_emulate, read_written_cmd, 2, buff_tx));
+    mu_check(memcmp(&write_cmd[2], &buff_tx[4], 4) == 0);
+    mu_check(memcmp(read_tail, &buff_tx[8], 8) == 0);
+    mu_check(mf_ul_emulate->data_changed);
+
+    // Counter response follows increments
+    const uint8_t inc_cnt_cmd[] = {MF_UL_INC_CNT, 0x02, 0x01, 0x00, 0x00, 0x00};
+    mu_assert_int_eq(4, mf_ul_test_exchange(mf_ul_emulate, inc_cnt_cmd, 6, buff_tx));
+    const uint8_t read_cnt_cmd[] = {MF_UL_READ_CNT, 0x02};
+    const uint8_t read_cnt[] = {0x00, 0x01, 0x03};
+    mu_assert_int_eq(24, mf_ul_test_exchange(mf_ul_emulate, read_cnt_cmd, 2, buff_tx));
+    mu_check(memcmp(read_cnt, buff_tx, sizeof(read_cnt)) == 0);
+
+    const uint8_t auth_cmd[] = {MF_UL_AUTH, 0x01, 0x02, 0x03, 0x04};
+    mu_assert_int_eq(16, mf_ul_test_exchange(mf_ul_emulate, auth_cmd, 5, buff_tx));
+    mu_assert_int_eq(0x80, buff_tx[0]);
+
+    free(buff_tx);
+    free(mf_ul_emulate);
+}
+
+MU_TEST(mf_ul_emulation_benchmark_test) {
+    MifareUlDevice* mf_ul_emulate = malloc(sizeof(MifareUlDevice));
+    uint8_t* buff_tx = malloc(MF_UL_TEST_NTAG213_SIZE);
+    mf_ul_test_prepare(mf_ul_emulate);
+
+    // Response has to be ready within the frame delay time, about 90 us
+    for(size_t i = 0; i < COUNT_OF(mf_ul_test_trace); i++) {
+        const MfUlTestCommand* command = &mf_ul_test_trace[i];
+        uint32_t cycles = DWT->CYCCNT;
+        for(uint32_t j = 0; j < MF_UL_TEST_BENCHMARK_ROUNDS; j++) {
+            mf_ul_test_exchange(mf_ul_emulate, command->cmd, command->cmd_len, buff_tx);
+        }
+        cycles = DWT->CYCCNT - cycles;
+        FURI_LOG_I(
+            TAG,
+            "%s: %lu ns",
+            command->name,
+            (uint32_t)((uint64_t)cycles * 1000000000 / MF_UL_TEST_BENCHMARK_ROUNDS /
+                       SystemCoreClock));
+    }
+
+    free(buff_tx);
+    free(mf_ul_emulate);
+}
+
+MU_TEST_SUITE(mf_ultralight_suite) {
+    MU_RUN_TEST(mf_ul_emulation_test);
+    MU_RUN_TEST(mf_ul_emulation_benchmark_test);
+}
+
+int run_minunit_test_mf_ultralight() {
+    MU_RUN_SUITE(mf_ultralight_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,106 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <lib/nfc_protocols/nfc_util.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsNfcUtil"
+
+#define NFC_UTIL_TEST_ITERATIONS 256
+#define NFC_UTIL_BENCHMARK_FRAMES 1024
+
+/* xorshift32, runs have to be reproducible */
+static uint32_t nfc_util_test_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+MU_TEST(nfc_util_data_and_parity_test) {
+    uint32_t random = 0x12345678;
+    uint8_t data[FURI_HAL_NFC_DATA_BUFF_SIZE];
+    uint8_t parity[FURI_HAL_NFC_PARITY_BUFF_SIZE];
+    uint8_t bitstream[FURI_HAL_NFC_BITSTREAM_BUFF_SIZE];
+    uint8_t reference[FURI_HAL_NFC_BITSTREAM_BUFF_SIZE];
+    uint8_t out_data[FURI_HAL_NFC_DATA_BUFF_SIZE];
+    uint8_t out_parity[FURI_HAL_NFC_PARITY_BUFF_SIZE];
+
+    for(size_t i = 0; i < NFC_UTIL_TEST_ITERATIONS; i++) {
+        uint16_t data_len = nfc_util_test_random(&random) % (FURI_HAL_NFC_DATA_BUFF_SIZE + 1);
+        for(uint16_t j = 0; j < sizeof(data); j++) {
+            data[j] = nfc_util_test_random(&random);
+        }
+        for(uint16_t j = 0; j < sizeof(parity); j++) {
+            parity[j] = nfc_util_test_random(&random);
+        }
+
+        // Bit by bit: each byte LSB first, followed by its parity bit
+        memset(reference, 0, sizeof(reference));
+        for(uint16_t j = 0; j < data_len * 9; j++) {
+            uint16_t byte = j / 9;
+            uint8_t bit = j % 9 < 8 ? FURI_BIT(data[byte], j % 9) :
+                                      FURI_BIT(parity[byte / 8], 7 - byte % 8);
+            reference[j / 8] |= bit << (j % 8);
+        }
+
+        uint16_t bits = nfc_util_merge_data_and_parity(data, data_len, parity, bitstream);
+        mu_assert_int_eq(data_len * 9, bits);
+        mu_check(memcmp(reference, bitstream, (bits + 7) / 8) == 0);
+
+        // Unused parity bits come back cleared
+        memset(out_parity, 0xFF, sizeof(out_parity));
+        uint16_t out_len = nfc_util_split_data_and_parity(bitstream, bits, out_data, out_parity);
+        mu_assert_int_eq(data_len, out_len);
+        mu_check(memcmp(data, out_data, data_len) == 0);
+        for(uint16_t j = 0; j < data_len; j++) {
+            mu_assert_int_eq(
+                FURI_BIT(parity[j / 8], 7 - j % 8), FURI_BIT(out_parity[j / 8], 7 - j % 8));
+        }
+        if(data_len % 8) {
+            mu_assert_int_eq(0, out_parity[data_len / 8] & (0xFF >> data_len % 8));
+        }
+    }
+
+    mu_assert_int_eq(0, nfc_util_split_data_and_parity(bitstream, 4, out_data, out_parity));
+}
+
+MU_TEST(nfc_util_data_and_parity_benchmark_test) {
+    uint8_t data[FURI_HAL_NFC_DATA_BUFF_SIZE] = {};
+    uint8_t parity[FURI_HAL_NFC_PARITY_BUFF_SIZE] = {};
+    uint8_t bitstream[FURI_HAL_NFC_BITSTREAM_BUFF_SIZE] = {};
+    uint16_t bits = 0;
+
+    uint32_t cycles = DWT->CYCCNT;
+    for(uint32_t i = 0; i < NFC_UTIL_BENCHMARK_FRAMES; i++) {
+        data[0] = i;
+        bits = nfc_util_merge_data_and_parity(data, sizeof(data), parity, bitstream);
+    }
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "Merge: %lu bits/s",
+        (uint32_t)((uint64_t)NFC_UTIL_BENCHMARK_FRAMES * bits * SystemCoreClock / cycles));
+
+    cycles = DWT->CYCCNT;
+    for(uint32_t i = 0; i < NFC_UTIL_BENCHMARK_FRAMES; i++) {
+        bitstream[0] = i;
+        nfc_util_split_data_and_parity(bitstream, bits, data, parity);
+    }
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "Split: %lu bits/s",
+        (uint32_t)((uint64_t)NFC_UTIL_BENCHMARK_FRAMES * bits * SystemCoreClock / cycles));
+}
+
+MU_TEST_SUITE(nfc_util_suite) {
+    MU_RUN_TEST(nfc_util_data_and_parity_test);
+    MU_RUN_TEST(nfc_util_data_and_parity_benchmark_test);
+}
+
+int run_minunit_test_nfc_util() {
+    MU_RUN_SUITE(nfc_util_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,278 @@
+#include "sd_card_sim.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SD_CARD_SIM_QUEUE_SIZE 8
+#define SD_CARD_SIM_COMMAND_LENGTH 6
+#define SD_CARD_SIM_BUSY_BYTES 3
+
+/* Read stream layout: Nac gap, start token, data, CRC */
+#define SD_CARD_SIM_READ_TOKEN_POS 1
+#define SD_CARD_SIM_READ_DATA_POS 2
+#define SD_CARD_SIM_READ_CRC_POS (SD_CARD_SIM_READ_DATA_POS + SD_CARD_SIM_BLOCK_SIZE)
+#define SD_CARD_SIM_READ_END_POS (SD_CARD_SIM_READ_CRC_POS + 2)
+
+#define SD_CARD_SIM_R1_OK 0x00
+#define SD_CARD_SIM_R1_ILLEGAL_COMMAND 0x04
+#define SD_CARD_SIM_R1_ADDRESS_ERROR 0x20
+#define SD_CARD_SIM_R1_PARAMETER_ERROR 0x40
+
+#define SD_CARD_SIM_TOKEN_READ 0xFE
+#define SD_CARD_SIM_TOKEN_WRITE_SINGLE 0xFE
+#define SD_CARD_SIM_TOKEN_WRITE_MULTIPLE 0xFC
+#define SD_CARD_SIM_TOKEN_STOP 0xFD
+#define SD_CARD_SIM_DATA_ACCEPTED 0x05
+
+typedef enum {
+    SdCardSimStateIdle,
+    SdCardSimStateRead,
+    SdCardSimStateWriteToken,
+    SdCardSimStateWriteData,
+} SdCardSimState;
+
+struct SdCardSim {
+    uint8_t* data;
+    uint32_t block_count;
+    bool block_addressing;
+    bool selected;
+
+    SdCardSimState state;
+    bool multiple;
+    uint32_t block;
+    uint32_t position;
+
+    uint8_t command[SD_CARD_SIM_COMMAND_LENGTH];
+    uint8_t command_length;
+
+    uint8_t queue[SD_CARD_SIM_QUEUE_SIZE];
+    uint8_t queue_head;
+    uint8_t queue_count;
+
+    uint32_t command_count[64];
+    uint32_t error_count;
+};
+
+SdCardSim* sd_card_sim_alloc(uint32_t block_count) {
+    SdCardSim* sim = malloc(sizeof(SdCardSim));
+    memset(sim, 0, sizeof(SdCardSim));
+    sim->data = malloc(block_count * SD_CARD_SIM_BLOCK_SIZE);
+    memset(sim->data, 0, block_count * SD_CARD_SIM_BLOCK_SIZE);
+    sim->block_count = block_count;
+    sim->block_addressing = true;
+    return sim;
+}
+
+void sd_card_sim_free(SdCardSim* sim) {
+    free(sim->data);
+    free(sim);
+}
+
+void sd_card_sim_set_block_addressing(SdCardSim* sim, bool block_addressing) {
+    sim->block_addressing = block_addressing;
+}
+
+uint8_t* sd_card_sim_get_data(SdCardSim* sim) {
+    return sim->data;
+}
+
+uint32_t sd_card_sim_get_command_count(SdCardSim* sim, uint8_t command) {
+    return sim->command_count[command & 0x3F];
+}
+
+uint32_t sd_card_sim_get_error_count(SdCardSim* sim) {
+    return sim->error_count;
+}
+
+void sd_card_sim_reset_counters(SdCardSim* sim) {
+    memset(sim->command_count, 0, sizeof(sim->command_count));
+    sim->error_count = 0;
+}
+
+static void sd_card_sim_push(SdCardSim* sim, uint8_t value) {
+    if(sim->queue_count < SD_CARD_SIM_QUEUE_SIZE) {
+        sim->queue[(sim->queue_head + sim->queue_count) % SD_CARD_SIM_QUEUE_SIZE] = value;
+        sim->queue_count++;
+    } else {
+        sim->error_count++;
+    }
+}
+
+static void sd_card_sim_push_busy(SdCardSim* sim) {
+    for(size_t i = 0; i < SD_CARD_SIM_BUSY_BYTES; i++) {
+        sd_card_sim_push(sim, 0x00);
+    }
+}
+
+static bool sd_card_sim_address_to_block(SdCardSim* sim, uint32_t address, uint32_t* block) {
+    if(!sim->block_addressing) {
+        if(address % SD_CARD_SIM_BLOCK_SIZE) return false;
+        address /= SD_CARD_SIM_BLOCK_SIZE;
+    }
+    *block = address;
+    return address < sim->block_count;
+}
+
+static void sd_card_sim_execute(SdCardSim* sim) {
+    uint8_t index = sim->command[0] & 0x3F;
+    uint32_t argument = (uint32_t)sim->command[1] << 24 | (uint32_t)sim->command[2] << 16 |
+                        (uint32_t)sim->command[3] << 8 | sim->command[4];
+    uint8_t r1 = SD_CARD_SIM_R1_OK;
+
+    sim->command_count[index]++;
+
+    switch(index) {
+    case 12:
+        if(sim->state == SdCardSimStateRead && sim->multiple) {
+            // Stuff byte, Ncr byte that is not 0xFF but has bit 7 set, R1, then busy
+            sim->state = SdCardSimStateIdle;
+            sd_card_sim_push(sim, 0xFF);
+            sd_card_sim_push(sim, 0xBF);
+            sd_card_sim_push(sim, r1);
+            sd_card_sim_push_busy(sim);
+            return;
+        }
+        sim->error_count++;
+        r1 = SD_CARD_SIM_R1_ILLEGAL_COMMAND;
+        break;
+    case 13:
+        sd_card_sim_push(sim, 0xFF);
+        sd_card_sim_push(sim, r1);
+        sd_card_sim_push(sim, 0x00);
+        return;
+    case 16:
+        if(argument != SD_CARD_SIM_BLOCK_SIZE) r1 = SD_CARD_SIM_R1_PARAMETER_ERROR;
+        break;
+    case 17:
+    case 18:
+    case 24:
+    case 25:
+        if(!sd_card_sim_address_to_block(sim, argument, &sim->block)) {
+            r1 = SD_CARD_SIM_R1_ADDRESS_ERROR;
+            break;
+        }
+        sim->multiple = (index == 18 || index == 25);
+        sim->position = 0;
+        sim->state = (index == 17 || index == 18) ? SdCardSimStateRead :
+                                                    SdCardSimStateWriteToken;
+        break;
+    default:
+        r1 = SD_CARD_SIM_R1_ILLEGAL_COMMAND;
+        break;
+    }
+
+    // Ncr gap, then R1
+    sd_card_sim_push(sim, 0xFF);
+    sd_card_sim_push(sim, r1);
+}
+
+static uint8_t sd_card_sim_output(SdCardSim* sim) {
+    if(sim->queue_count) {
+        uint8_t value = sim->queue[sim->queue_head];
+        sim->queue_head = (sim->queue_head + 1) % SD_CARD_SIM_QUEUE_SIZE;
+        sim->queue_count--;
+        return value;
+    }
+
+    // Multiple block read past the last block idles until CMD12
+    if(sim->state != SdCardSimStateRead || sim->block == sim->block_count) return 0xFF;
+
+    uint8_t value = 0x00;
+    if(sim->position < SD_CARD_SIM_READ_TOKEN_POS) {
+        value = 0xFF;
+    } else if(sim->position == SD_CARD_SIM_READ_TOKEN_POS) {
+        value = SD_CARD_SIM_TOKEN_READ;
+    } else if(sim->position < SD_CARD_SIM_READ_CRC_POS) {
+        value = sim->data
+                    [sim->block * SD_CARD_SIM_BLOCK_SIZE + sim->position -
+                     SD_CARD_SIM_READ_DATA_POS];
+    }
+
+    sim->position++;
+    if(sim->position == SD_CARD_SIM_READ_END_POS) {
+        sim->position = 0;
+        if(sim->multiple) {
+            sim->block++;
+        } else {
+            sim->state = SdCardSimStateIdle;
+        }
+    }
+
+    return value;
+}
+
+static void sd_card_sim_input(SdCardSim* sim, uint8_t value) {
+    if(sim->state == SdCardSimStateWriteToken) {
+        if(value == 0xFF) return;
+        if(value == (sim->multiple ? SD_CARD_SIM_TOKEN_WRITE_MULTIPLE :
+                                     SD_CARD_SIM_TOKEN_WRITE_SINGLE) &&
+           sim->block < sim->block_count) {
+            sim->state = SdCardSimStateWriteData;
+            sim->position = 0;
+        } else if(sim->multiple && value == SD_CARD_SIM_TOKEN_STOP) {
+            // Nbr, then busy
+            sim->state = SdCardSimStateIdle;
+            sd_card_sim_push(sim, 0xFF);
+            sd_card_sim_push_busy(sim);
+        } else {
+            sim->error_count++;
+        }
+        return;
+    }
+
+    if(sim->state == SdCardSimStateWriteData) {
+        if(sim->position < SD_CARD_SIM_BLOCK_SIZE) {
+            sim->data[sim->block * SD_CARD_SIM_BLOCK_SIZE + sim->position] = value;
+        }
+        sim->position++;
+        if(sim->position == SD_CARD_SIM_BLOCK_SIZE + 2) {
+            sd_card_sim_push(sim, SD_CARD_SIM_DATA_ACCEPTED);
+            sd_card_sim_push_busy(sim);
+            sim->block++;
+            if(sim->multiple) {
+                sim->state = SdCardSimStateWriteToken;
+            } else {
+                sim->state = SdCardSimStateIdle;
+            }
+        }
+        return;
+    }
+
+    // Command framing, only CMD12 is expected while a read is streaming
+    if(sim->command_length == 0) {
+        if((value & 0xC0) != 0x40) return;
+        if(sim->state == SdCardSimStateRead && (value & 0x3F) != 12) {
+            sim->error_count++;
+            return;
+        }
+    }
+    sim->command[sim->command_length++] = value;
+    if(sim->command_length == SD_CARD_SIM_COMMAND_LENGTH) {
+        sim->command_length = 0;
+        sd_card_sim_execute(sim);
+    }
+}
+
+void sd_card_sim_cs_state(void* context, uint8_t state) {
+    SdCardSim* sim = context;
+    sim->selected = (state == 0);
+    // Deselect aborts partially received command
+    if(!sim->selected) sim->command_length = 0;
+}
+
+void sd_card_sim_write_read(
+    void* context,
+    const uint8_t* data_in,
+    uint8_t* data_out,
+    uint16_t length) {
+    SdCardSim* sim = context;
+
+    for(uint16_t i = 0; i < length; i++) {
+        uint8_t out = 0xFF;
+        if(sim->selected) {
+            // MISO is shifted out while MOSI is shifted in
+            out = sd_card_sim_output(sim);
+            sd_card_sim_input(sim, data_in ? data_in[i] : 0xFF);
+        }
+        if(data_out) data_out[i] = out;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * SD card SPI mode protocol simulator over a RAM disk.
+ *
+ * Understands CMD12/13/16/17/18/24/25 and the data tokens, counts commands
+ * and protocol violations. Has no furi dependencies, so it can be plugged
+ * into the SD_IO_* link functions on device or built on host as is.
+ */
+typedef struct SdCardSim SdCardSim;
+
+/** Block size of the simulated card */
+#define SD_CARD_SIM_BLOCK_SIZE 512
+
+/**
+ * Allocate simulated card
+ * @param block_count card size in blocks
+ * @return SdCardSim*
+ */
+SdCardSim* sd_card_sim_alloc(uint32_t block_count);
+
+/**
+ * Free simulated card
+ * @param sim SdCardSim instance
+ */
+void sd_card_sim_free(SdCardSim* sim);
+
+/**
+ * Select addressing mode
+ * @param sim SdCardSim instance
+ * @param block_addressing true for SDHC block addressing, false for byte addressing
+ */
+void sd_card_sim_set_block_addressing(SdCardSim* sim, bool block_addressing);
+
+/**
+ * Get card contents
+ * @param sim SdCardSim instance
+ * @return pointer to block_count * SD_CARD_SIM_BLOCK_SIZE bytes
+ */
+uint8_t* sd_card_sim_get_data(SdCardSim* sim);
+
+/**
+ * Get how many times a command was received
+ * @param sim SdCardSim instance
+ * @param command command index, 0..63
+ * @return uint32_t
+ */
+uint32_t sd_card_sim_get_command_count(SdCardSim* sim, uint8_t command);
+
+/**
+ * Get protocol violations count
+ * @param sim SdCardSim instance
+ * @return uint32_t
+ */
+uint32_t sd_card_sim_get_error_count(SdCardSim* sim);
+
+/**
+ * Reset counters
+ * @param sim SdCardSim instance
+ */
+void sd_card_sim_reset_counters(SdCardSim* sim);
+
+/**
+ * Chip select line, matches SD_IO_Override.cs_state
+ * @param context SdCardSim instance
+ * @param state 0 (selected) or 1 (deselected)
+ */
+void sd_card_sim_cs_state(void* context, uint8_t state);
+
+/**
+ * Full duplex exchange, matches SD_IO_Override.write_read
+ * @param context SdCardSim instance
+ * @param data_in bytes sent to the card, NULL for 0xFF
+ * @param data_out bytes received from the card, NULL to discard
+ * @param length transaction size
+ */
+void sd_card_sim_write_read(
+    void* context,
+    const uint8_t* data_in,
+    uint8_t* data_out,
+    uint16_t length);
+
+#ifdef __cplusplus
+}
+#endif
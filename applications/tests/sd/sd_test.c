@@ -0,0 +1,158 @@
+#include "../minunit.h"
+#include <furi.h>
+#include <furi_hal.h>
+#include <stm32_adafruit_sd.h>
+#include "sd_card_sim.h"
+
+#define SD_TEST_BLOCK_COUNT 64
+#define SD_TEST_MAX_BLOCKS 8
+
+extern uint16_t flag_SDHC;
+
+static SdCardSim* sim;
+static SD_IO_Override sd_test_override;
+static uint16_t sd_test_flag_sdhc;
+static uint8_t* sd_test_buffer;
+
+static void sd_test_setup() {
+    sim = sd_card_sim_alloc(SD_TEST_BLOCK_COUNT);
+    uint8_t* data = sd_card_sim_get_data(sim);
+    for(size_t i = 0; i < SD_TEST_BLOCK_COUNT * SD_CARD_SIM_BLOCK_SIZE; i++) {
+        data[i] = (i * 7) ^ (i >> 9);
+    }
+    sd_test_buffer = malloc(SD_TEST_MAX_BLOCKS * SD_CARD_SIM_BLOCK_SIZE);
+
+    // Keep storage away from the driver while it talks to the simulated card
+    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_sd_fast);
+    sd_test_flag_sdhc = flag_SDHC;
+    flag_SDHC = 1;
+
+    sd_test_override.cs_state = sd_card_sim_cs_state;
+    sd_test_override.write_read = sd_card_sim_write_read;
+    sd_test_override.context = sim;
+    SD_IO_SetOverride(&sd_test_override);
+}
+
+static void sd_test_teardown() {
+    SD_IO_SetOverride(NULL);
+    flag_SDHC = sd_test_flag_sdhc;
+    furi_hal_spi_release(&furi_hal_spi_bus_handle_sd_fast);
+
+    free(sd_test_buffer);
+    sd_card_sim_free(sim);
+}
+
+MU_TEST(sd_read_single_block) {
+    uint8_t* data = sd_card_sim_get_data(sim);
+
+    mu_check(BSP_SD_ReadBlocks((uint32_t*)sd_test_buffer, 5, 1, 0) == MSD_OK);
+    mu_check(
+        memcmp(sd_test_buffer, data + 5 * SD_CARD_SIM_BLOCK_SIZE, SD_CARD_SIM_BLOCK_SIZE) == 0);
+    mu_assert_int_eq(1, sd_card_sim_get_command_count(sim, 17));
+    mu_assert_int_eq(0, sd_card_sim_get_command_count(sim, 18));
+    mu_assert_int_eq(0, sd_card_sim_get_command_count(sim, 12));
+    mu_assert_int_eq(0, sd_card_sim_get_error_count(sim));
+}
+
+MU_TEST(sd_read_multiple_blocks) {
+    uint8_t* data = sd_card_sim_get_data(sim);
+
+    mu_check(
+        BSP_SD_ReadBlocks((uint32_t*)sd_test_buffer, 3, SD_TEST_MAX_BLOCKS, 0) == MSD_OK);
+    mu_check(
+        memcmp(
+            sd_test_buffer,
+            data + 3 * SD_CARD_SIM_BLOCK_SIZE,
+            SD_TEST_MAX_BLOCKS * SD_CARD_SIM_BLOCK_SIZE) == 0);
+    // One command for the whole transfer
+    mu_assert_int_eq(0, sd_card_sim_get_command_count(sim, 17));
+    mu_assert_int_eq(1, sd_card_sim_get_command_count(sim, 18));
+    mu_assert_int_eq(1, sd_card_sim_get_command_count(sim, 12));
+    mu_assert_int_eq(0, sd_card_sim_get_error_count(sim));
+
+    // Up to the last block of the card
+    mu_check(
+        BSP_SD_ReadBlocks(
+            (uint32_t*)sd_test_buffer, SD_TEST_BLOCK_COUNT - 2, 2, 0) == MSD_OK);
+    mu_check(
+        memcmp(
+            sd_test_buffer,
+            data + (SD_TEST_BLOCK_COUNT - 2) * SD_CARD_SIM_BLOCK_SIZE,
+            2 * SD_CARD_SIM_BLOCK_SIZE) == 0);
+    mu_assert_int_eq(0, sd_card_sim_get_error_count(sim));
+}
+
+MU_TEST(sd_write_multiple_blocks) {
+    uint8_t* data = sd_card_sim_get_data(sim);
+    uint8_t before = data[10 * SD_CARD_SIM_BLOCK_SIZE - 1];
+    uint8_t after = data[(10 + SD_TEST_MAX_BLOCKS) * SD_CARD_SIM_BLOCK_SIZE];
+
+    for(size_t i = 0; i < SD_TEST_MAX_BLOCKS * SD_CARD_SIM_BLOCK_SIZE; i++) {
+        sd_test_buffer[i] = ~i;
+    }
+
+    mu_check(
+        BSP_SD_WriteBlocks((uint32_t*)sd_test_buffer, 10, SD_TEST_MAX_BLOCKS, 0) == MSD_OK);
+    mu_check(
+        memcmp(
+            sd_test_buffer,
+            data + 10 * SD_CARD_SIM_BLOCK_SIZE,
+            SD_TEST_MAX_BLOCKS * SD_CARD_SIM_BLOCK_SIZE) == 0);
+    mu_assert_int_eq(before, data[10 * SD_CARD_SIM_BLOCK_SIZE - 1]);
+    mu_assert_int_eq(after, data[(10 + SD_TEST_MAX_BLOCKS) * SD_CARD_SIM_BLOCK_SIZE]);
+    mu_assert_int_eq(0, sd_card_sim_get_command_count(sim, 24));
+    mu_assert_int_eq(1, sd_card_sim_get_command_count(sim, 25));
+    mu_assert_int_eq(0, sd_card_sim_get_error_count(sim));
+
+    mu_check(BSP_SD_WriteBlocks((uint32_t*)sd_test_buffer, 40, 1, 0) == MSD_OK);
+    mu_check(
+        memcmp(sd_test_buffer, data + 40 * SD_CARD_SIM_BLOCK_SIZE, SD_CARD_SIM_BLOCK_SIZE) == 0);
+    mu_assert_int_eq(1, sd_card_sim_get_command_count(sim, 24));
+    mu_assert_int_eq(0, sd_card_sim_get_error_count(sim));
+}
+
+MU_TEST(sd_byte_addressing) {
+    uint8_t* data = sd_card_sim_get_data(sim);
+    flag_SDHC = 0;
+    sd_card_sim_set_block_addressing(sim, false);
+
+    for(size_t i = 0; i < 4 * SD_CARD_SIM_BLOCK_SIZE; i++) {
+        sd_test_buffer[i] = i;
+    }
+    mu_check(BSP_SD_WriteBlocks((uint32_t*)sd_test_buffer, 20, 4, 0) == MSD_OK);
+    mu_check(
+        memcmp(sd_test_buffer, data + 20 * SD_CARD_SIM_BLOCK_SIZE, 4 * SD_CARD_SIM_BLOCK_SIZE) ==
+        0);
+
+    mu_check(BSP_SD_ReadBlocks((uint32_t*)sd_test_buffer, 30, 4, 0) == MSD_OK);
+    mu_check(
+        memcmp(sd_test_buffer, data + 30 * SD_CARD_SIM_BLOCK_SIZE, 4 * SD_CARD_SIM_BLOCK_SIZE) ==
+        0);
+    mu_assert_int_eq(0, sd_card_sim_get_error_count(sim));
+}
+
+MU_TEST(sd_out_of_range) {
+    mu_check(
+        BSP_SD_ReadBlocks((uint32_t*)sd_test_buffer, SD_TEST_BLOCK_COUNT, 2, 0) != MSD_OK);
+    mu_check(
+        BSP_SD_WriteBlocks((uint32_t*)sd_test_buffer, SD_TEST_BLOCK_COUNT, 2, 0) != MSD_OK);
+
+    // Card is back to idle after rejected commands
+    mu_check(BSP_SD_ReadBlocks((uint32_t*)sd_test_buffer, 0, 2, 0) == MSD_OK);
+    mu_assert_int_eq(0, sd_card_sim_get_error_count(sim));
+}
+
+MU_TEST_SUITE(sd_multiple_block) {
+    MU_SUITE_CONFIGURE(&sd_test_setup, &sd_test_teardown);
+
+    MU_RUN_TEST(sd_read_single_block);
+    MU_RUN_TEST(sd_read_multiple_blocks);
+    MU_RUN_TEST(sd_write_multiple_blocks);
+    MU_RUN_TEST(sd_byte_addressing);
+    MU_RUN_TEST(sd_out_of_range);
+}
+
+int run_minunit_test_sd() {
+    MU_RUN_SUITE(sd_multiple_block);
+    return MU_EXIT_CODE;
+}
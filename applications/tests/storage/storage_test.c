@@ -88,10 +88,51 @@ MU_TEST(storage_file_open_close) {
     furi_record_close("storage");
 }
 
+MU_TEST(storage_file_batch) {
+    Storage* storage = furi_record_open("storage");
+    StorageBatch* batch = storage_batch_alloc(storage, 4);
+    File* file = storage_file_alloc(storage);
+
+    // open, scatter read and close in one call
+    char head[2];
+    char tail[3];
+    uint16_t head_size = 0;
+    uint16_t tail_size = 0;
+    storage_batch_file_open(batch, file, STORAGE_LOCKED_FILE, FSAM_READ, FSOM_OPEN_EXISTING, NULL);
+    storage_batch_file_read(batch, file, head, sizeof(head), &head_size);
+    storage_batch_file_read(batch, file, tail, sizeof(tail), &tail_size);
+    storage_batch_file_close(batch, file, NULL);
+    // tail read is short
+    mu_check(!storage_batch_execute(batch));
+    mu_assert_int_eq(2, head_size);
+    mu_assert_int_eq(2, tail_size);
+    mu_check(memcmp(head, "01", 2) == 0);
+    mu_check(memcmp(tail, "23", 2) == 0);
+    mu_check(!storage_file_is_open(file));
+
+    // stat of several paths
+    FileInfo fileinfo;
+    FS_Error error[2];
+    storage_batch_common_stat(batch, STORAGE_LOCKED_FILE, &fileinfo, &error[0]);
+    storage_batch_common_stat(batch, STORAGE_LOCKED_FILE ".missing", NULL, &error[1]);
+    mu_check(!storage_batch_execute(batch));
+    mu_assert_int_eq(FSE_OK, error[0]);
+    mu_assert_int_eq(4, fileinfo.size);
+    mu_assert_int_eq(FSE_NOT_EXIST, error[1]);
+
+    // empty batch
+    mu_check(storage_batch_execute(batch));
+
+    storage_file_free(file);
+    storage_batch_free(batch);
+    furi_record_close("storage");
+}
+
 MU_TEST_SUITE(storage_file) {
     storage_file_open_lock_setup();
     MU_RUN_TEST(storage_file_open_close);
     MU_RUN_TEST(storage_file_open_lock);
+    MU_RUN_TEST(storage_file_batch);
     storage_file_open_lock_teardown();
 }
 
@@ -1,10 +1,17 @@
 #include <furi.h>
+#include <furi_hal.h>
 #include <toolbox/stream/stream.h>
 #include <toolbox/stream/string_stream.h>
 #include <toolbox/stream/file_stream.h>
+#include <toolbox/stream/buffered_file_stream.h>
 #include <storage/storage.h>
 #include "../minunit.h"
 
+#define TAG "UnitTestsStream"
+
+#define STREAM_BENCHMARK_PATH "/ext/stream_benchmark.sub"
+#define STREAM_BENCHMARK_LINES 500
+
 static const char* stream_test_data = "I write differently from what I speak, "
                                       "I speak differently from what I think, "
                                       "I think differently from the way I ought to think, "
@@ -282,6 +289,20 @@ MU_TEST(stream_composite_test) {
     mu_check(file_stream_open(stream, "/ext/filestream.str", FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
     MU_RUN_TEST_1(stream_composite_subtest, stream);
     stream_free(stream);
+
+    // test buffered file stream
+    stream = buffered_file_stream_alloc(storage);
+    mu_check(buffered_file_stream_open(
+        stream, "/ext/filestream.str", FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    MU_RUN_TEST_1(stream_composite_subtest, stream);
+    stream_free(stream);
+
+    // test buffered file stream with buffer smaller than the test data
+    stream = buffered_file_stream_alloc_ex(storage, 16);
+    mu_check(buffered_file_stream_open(
+        stream, "/ext/filestream.str", FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    MU_RUN_TEST_1(stream_composite_subtest, stream);
+    stream_free(stream);
     furi_record_close("storage");
 }
 
@@ -366,6 +387,93 @@ MU_TEST(stream_split_test) {
     mu_check(file_stream_open(stream, "/ext/filestream.str", FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
     MU_RUN_TEST_1(stream_split_subtest, stream);
     stream_free(stream);
+
+    // test buffered file stream
+    stream = buffered_file_stream_alloc(storage);
+    mu_check(buffered_file_stream_open(
+        stream, "/ext/filestream.str", FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    MU_RUN_TEST_1(stream_split_subtest, stream);
+    stream_free(stream);
+    furi_record_close("storage");
+}
+
+MU_TEST_1(stream_benchmark_subtest, Stream* stream) {
+    string_t line;
+    string_init(line);
+
+    size_t lines = 0;
+    while(stream_read_line(stream, line)) {
+        lines++;
+    }
+    mu_assert_int_eq(STREAM_BENCHMARK_LINES, lines);
+
+    string_clear(line);
+}
+
+MU_TEST(stream_buffered_file_benchmark_test) {
+    Storage* storage = furi_record_open("storage");
+    Stream* stream;
+
+    // RAW .sub sized file
+    stream = buffered_file_stream_alloc(storage);
+    mu_check(buffered_file_stream_open(
+        stream, STREAM_BENCHMARK_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    for(size_t i = 0; i < STREAM_BENCHMARK_LINES; i++) {
+        stream_write_format(
+            stream,
+            "RAW_Data: %u -%u %u -%u %u -%u %u -%u %u -%u %u -%u %u -%u %u -%u\n",
+            400 + i,
+            1200 + i,
+            410 + i,
+            1190 + i,
+            1210 + i,
+            380 + i,
+            420 + i,
+            1180 + i,
+            1220 + i,
+            390 + i,
+            400 + i,
+            1200 + i,
+            1200 + i,
+            400 + i,
+            410 + i,
+            12000 + i);
+    }
+    mu_check(buffered_file_stream_close(stream));
+    stream_free(stream);
+
+    uint32_t messages[2];
+    uint32_t cycles[2];
+    for(size_t i = 0; i < 2; i++) {
+        if(i == 0) {
+            stream = file_stream_alloc(storage);
+            mu_check(
+                file_stream_open(stream, STREAM_BENCHMARK_PATH, FSAM_READ, FSOM_OPEN_EXISTING));
+        } else {
+            stream = buffered_file_stream_alloc(storage);
+            mu_check(buffered_file_stream_open(
+                stream, STREAM_BENCHMARK_PATH, FSAM_READ, FSOM_OPEN_EXISTING));
+        }
+
+        messages[i] = storage_get_message_count(storage);
+        cycles[i] = DWT->CYCCNT;
+        MU_RUN_TEST_1(stream_benchmark_subtest, stream);
+        cycles[i] = DWT->CYCCNT - cycles[i];
+        messages[i] = storage_get_message_count(storage) - messages[i];
+
+        stream_free(stream);
+    }
+
+    uint32_t cycles_per_ms = SystemCoreClock / 1000;
+    FURI_LOG_I(TAG, "file_stream: %lu messages, %lu ms", messages[0], cycles[0] / cycles_per_ms);
+    FURI_LOG_I(
+        TAG,
+        "buffered_file_stream: %lu messages, %lu ms",
+        messages[1],
+        cycles[1] / cycles_per_ms);
+    mu_check(messages[1] < messages[0]);
+
+    storage_common_remove(storage, STREAM_BENCHMARK_PATH);
     furi_record_close("storage");
 }
 
@@ -373,6 +481,7 @@ MU_TEST_SUITE(stream_suite) {
     MU_RUN_TEST(stream_write_read_save_load_test);
     MU_RUN_TEST(stream_composite_test);
     MU_RUN_TEST(stream_split_test);
+    MU_RUN_TEST(stream_buffered_file_benchmark_test);
 }
 
 int run_minunit_test_stream() {
@@ -0,0 +1,675 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <lib/subghz/protocols/keeloq_common.h>
+#include <lib/subghz/subghz_keystore.h>
+#include <lib/subghz/receiver.h>
+#include <lib/subghz/transmitter.h>
+#include <lib/subghz/protocols/registry.h>
+#include <lib/subghz/protocols/raw.h>
+#include <lib/subghz/subghz_raw_binary.h>
+#include <lib/subghz/subghz_file_encoder_worker.h>
+#include <flipper_format/flipper_format_i.h>
+#include <storage/storage.h>
+#include "../minunit.h"
+
+#define TAG "SubGhzTest"
+
+#define SUBGHZ_TEST_KEELOQ_KEY_COUNT 256
+#define SUBGHZ_TEST_KEELOQ_ROUNDS 4
+#define SUBGHZ_TEST_KEYSTORE_TEXT_PATH "/ext/unit_tests_keystore.txt"
+#define SUBGHZ_TEST_KEYSTORE_BINARY_PATH "/ext/unit_tests_keystore.bin"
+#define SUBGHZ_TEST_RAW_TABLE_SIZE 256
+#define SUBGHZ_TEST_RAW_TABLE_LOOKUPS 256
+#define SUBGHZ_TEST_RAW_TABLE_PATH "/ext/unit_tests_raw_table.txt"
+#define SUBGHZ_TEST_RAW_TABLE_ENCRYPTED_PATH "/ext/unit_tests_raw_table.bin"
+#define SUBGHZ_TEST_RAW_CAPTURE_PATH "/ext/unit_tests_raw_capture.sub"
+#define SUBGHZ_TEST_RAW_CAPTURE_PACKETS 8
+#define SUBGHZ_TEST_RAW_CAPTURE_NOISE 256
+#define SUBGHZ_TEST_RAW_CAPTURE_LINE 512
+#define SUBGHZ_TEST_RAW_CAPTURE_SIZE_MAX 8192
+#define SUBGHZ_TEST_RAW_CAPTURE_BINARY_PATH "/ext/unit_tests_raw_capture_bin.sub"
+#define SUBGHZ_TEST_RAW_CAPTURE_TEXT_PATH "/ext/unit_tests_raw_capture_text.sub"
+
+static uint64_t subghz_test_random_key() {
+    return ((uint64_t)furi_hal_random_get() << 32) | furi_hal_random_get();
+}
+
+static bool subghz_test_keeloq_check(uint32_t decrypt, void* context) {
+    uint32_t* fix = context;
+    return (decrypt >> 28 == *fix >> 28) && (((decrypt >> 16) & 0xFF) == (*fix & 0xFF));
+}
+
+static float subghz_test_per_second(uint32_t count, uint32_t cycles) {
+    return (float)count * SystemCoreClock / cycles;
+}
+
+MU_TEST(subghz_keeloq_decrypt_batch_test) {
+    uint64_t keys[KEELOQ_BATCH_LANES];
+    uint32_t result[KEELOQ_BATCH_LANES];
+
+    for(size_t count = 1; count <= KEELOQ_BATCH_LANES; count++) {
+        uint32_t data = furi_hal_random_get();
+        for(size_t i = 0; i < count; i++) {
+            keys[i] = subghz_test_random_key();
+        }
+        subghz_protocol_keeloq_common_decrypt_batch(data, keys, count, result);
+        for(size_t i = 0; i < count; i++) {
+            mu_assert_int_eq(subghz_protocol_keeloq_common_decrypt(data, keys[i]), result[i]);
+        }
+    }
+}
+
+MU_TEST(subghz_keeloq_search_test) {
+    SubGhzKeyArray_t keys;
+    SubGhzKeyArray_init(keys);
+    for(size_t i = 0; i < SUBGHZ_TEST_KEELOQ_KEY_COUNT; i++) {
+        SubGhzKey* manufacture_code = SubGhzKeyArray_push_raw(keys);
+        manufacture_code->name = "Test";
+        manufacture_code->key = subghz_test_random_key();
+        manufacture_code->type = i % (KEELOQ_LEARNING_MAGIC_XOR_TYPE_1 + 1);
+    }
+
+    SubGhzKeeloqKeySearch* search = subghz_protocol_keeloq_common_search_alloc();
+    subghz_protocol_keeloq_common_search_load(search, &keys);
+
+    // Every learning type of the last keys in the keystore is found
+    for(size_t i = SUBGHZ_TEST_KEELOQ_KEY_COUNT - 5; i < SUBGHZ_TEST_KEELOQ_KEY_COUNT; i++) {
+        SubGhzKey* expected = SubGhzKeyArray_get(keys, i);
+        uint32_t fix = (furi_hal_random_get() & 0x0FFFFF00) | 0x30000000 | 0x5A;
+        uint64_t man = expected->key;
+        if(expected->type == KEELOQ_LEARNING_NORMAL) {
+            man = subghz_protocol_keeloq_common_normal_learning(fix, man);
+        } else if(expected->type == KEELOQ_LEARNING_SECURE) {
+            man = subghz_protocol_keeloq_common_secure_learning(
+                fix, KEELOQ_SECURE_LEARNING_SEED, man);
+        } else if(expected->type == KEELOQ_LEARNING_MAGIC_XOR_TYPE_1) {
+            man = subghz_protocol_keeloq_common_magic_xor_type1_learning(fix, man);
+        }
+        uint32_t hop = subghz_protocol_keeloq_common_encrypt(0x305A1234, man);
+
+        uint32_t decrypt = 0;
+        SubGhzKey* found = subghz_protocol_keeloq_common_search(
+            search, fix, hop, KEELOQ_SEARCH_ALL, subghz_test_keeloq_check, &fix, &decrypt);
+        mu_check(found != NULL);
+        if(found) {
+            // Random keys may collide with an earlier entry, but never with a later one
+            mu_check(found <= expected);
+            if(found == expected) mu_assert_int_eq(0x305A1234, decrypt);
+        }
+    }
+
+    // Benchmark: whole keystore against parcel that matches nothing
+    uint32_t fix = 0xF0000000;
+    uint32_t cycles = DWT->CYCCNT;
+    volatile uint32_t sink = 0;
+    for(size_t round = 0; round < SUBGHZ_TEST_KEELOQ_ROUNDS; round++) {
+        for
+            M_EACH(manufacture_code, keys, SubGhzKeyArray_t) {
+                sink += subghz_protocol_keeloq_common_decrypt(round, manufacture_code->key);
+            }
+    }
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "KeeLoq scalar: %0.0f keys/s",
+        (double)subghz_test_per_second(
+            SUBGHZ_TEST_KEELOQ_KEY_COUNT * SUBGHZ_TEST_KEELOQ_ROUNDS, cycles));
+
+    // Simple search decrypts only simple and unknown keys, so every key gets one decrypt
+    for
+        M_EACH(manufacture_code, keys, SubGhzKeyArray_t) {
+            manufacture_code->type = KEELOQ_LEARNING_SIMPLE;
+        }
+    subghz_protocol_keeloq_common_search_load(search, &keys);
+
+    cycles = DWT->CYCCNT;
+    for(size_t round = 0; round < SUBGHZ_TEST_KEELOQ_ROUNDS; round++) {
+        subghz_protocol_keeloq_common_search(
+            search, fix, round, KEELOQ_SEARCH_SIMPLE, subghz_test_keeloq_check, &fix, NULL);
+    }
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "KeeLoq batched: %0.0f keys/s",
+        (double)subghz_test_per_second(
+            SUBGHZ_TEST_KEELOQ_KEY_COUNT * SUBGHZ_TEST_KEELOQ_ROUNDS, cycles));
+
+    subghz_protocol_keeloq_common_search_free(search);
+    SubGhzKeyArray_clear(keys);
+}
+
+MU_TEST(subghz_keystore_binary_test) {
+    Storage* storage = furi_record_open("storage");
+    FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
+    mu_check(flipper_format_file_open_always(flipper_format, SUBGHZ_TEST_KEYSTORE_TEXT_PATH));
+    mu_check(flipper_format_write_header_cstr(flipper_format, "Flipper SubGhz Keystore File", 0));
+    uint32_t encryption = 0;
+    mu_check(flipper_format_write_uint32(flipper_format, "Encryption", &encryption, 1));
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+    for(size_t i = 0; i < SUBGHZ_TEST_KEELOQ_KEY_COUNT; i++) {
+        stream_write_format(
+            stream,
+            "%08lX%08lX:%u:Name_%u\n",
+            furi_hal_random_get(),
+            furi_hal_random_get(),
+            i % 5,
+            i % 64);
+    }
+    flipper_format_free(flipper_format);
+    furi_record_close("storage");
+
+    SubGhzKeystore* keystore = subghz_keystore_alloc();
+    uint32_t cycles = DWT->CYCCNT;
+    mu_check(subghz_keystore_load(keystore, SUBGHZ_TEST_KEYSTORE_TEXT_PATH));
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(TAG, "Text keystore load: %lu us", cycles / (SystemCoreClock / 1000000));
+    SubGhzKeyArray_t* keys = subghz_keystore_get_data(keystore);
+    mu_assert_int_eq(SUBGHZ_TEST_KEELOQ_KEY_COUNT, SubGhzKeyArray_size(*keys));
+
+    uint8_t iv[16] = {0};
+    mu_check(subghz_keystore_save_binary(keystore, SUBGHZ_TEST_KEYSTORE_BINARY_PATH, iv));
+
+    SubGhzKeystore* keystore_binary = subghz_keystore_alloc();
+    cycles = DWT->CYCCNT;
+    mu_check(subghz_keystore_load(keystore_binary, SUBGHZ_TEST_KEYSTORE_BINARY_PATH));
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(TAG, "Binary keystore load: %lu us", cycles / (SystemCoreClock / 1000000));
+    SubGhzKeyArray_t* keys_binary = subghz_keystore_get_data(keystore_binary);
+    mu_assert_int_eq(SubGhzKeyArray_size(*keys), SubGhzKeyArray_size(*keys_binary));
+
+    for(size_t i = 0; i < SubGhzKeyArray_size(*keys); i++) {
+        SubGhzKey* key = SubGhzKeyArray_get(*keys, i);
+        SubGhzKey* key_binary = SubGhzKeyArray_get(*keys_binary, i);
+        mu_check(key->key == key_binary->key);
+        mu_assert_int_eq(key->type, key_binary->type);
+        mu_assert_string_eq(key->name, key_binary->name);
+        // Names are deduplicated and lookup returns the first key with the name
+        SubGhzKey* named = subghz_keystore_get_key_by_name(keystore_binary, key->name);
+        mu_check(named && named->name == key_binary->name);
+    }
+    mu_check(
+        subghz_keystore_get_key_by_name(keystore_binary, "Name_5") ==
+        SubGhzKeyArray_get(*keys_binary, 5));
+    mu_check(subghz_keystore_get_key_by_name(keystore_binary, "Unknown") == NULL);
+
+    subghz_keystore_free(keystore_binary);
+    subghz_keystore_free(keystore);
+
+    storage = furi_record_open("storage");
+    storage_simply_remove(storage, SUBGHZ_TEST_KEYSTORE_TEXT_PATH);
+    storage_simply_remove(storage, SUBGHZ_TEST_KEYSTORE_BINARY_PATH);
+    furi_record_close("storage");
+}
+
+MU_TEST(subghz_keystore_raw_reader_test) {
+    uint8_t table[SUBGHZ_TEST_RAW_TABLE_SIZE];
+    furi_hal_random_fill_buf(table, sizeof(table));
+
+    Storage* storage = furi_record_open("storage");
+    FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
+    mu_check(flipper_format_file_open_always(flipper_format, SUBGHZ_TEST_RAW_TABLE_PATH));
+    mu_check(
+        flipper_format_write_header_cstr(flipper_format, "Flipper SubGhz Keystore RAW File", 0));
+    uint32_t encryption = 0;
+    mu_check(flipper_format_write_uint32(flipper_format, "Encryption", &encryption, 1));
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+    for(size_t i = 0; i < sizeof(table); i++) {
+        stream_write_format(stream, "%02X", table[i]);
+    }
+    flipper_format_free(flipper_format);
+    furi_record_close("storage");
+
+    uint8_t iv[16] = {0};
+    mu_check(subghz_keystore_raw_encrypted_save(
+        SUBGHZ_TEST_RAW_TABLE_PATH, SUBGHZ_TEST_RAW_TABLE_ENCRYPTED_PATH, iv));
+
+    uint16_t offsets[SUBGHZ_TEST_RAW_TABLE_LOOKUPS];
+    for(size_t i = 0; i < SUBGHZ_TEST_RAW_TABLE_LOOKUPS; i++) {
+        offsets[i] = furi_hal_random_get() % (SUBGHZ_TEST_RAW_TABLE_SIZE - sizeof(uint64_t));
+    }
+
+    uint8_t data[sizeof(uint64_t)];
+    uint32_t cycles = DWT->CYCCNT;
+    for(size_t i = 0; i < SUBGHZ_TEST_RAW_TABLE_LOOKUPS; i++) {
+        mu_check(subghz_keystore_raw_get_data(
+            SUBGHZ_TEST_RAW_TABLE_ENCRYPTED_PATH, offsets[i], data, sizeof(data)));
+        mu_check(memcmp(data, &table[offsets[i]], sizeof(data)) == 0);
+    }
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "RAW lookups without reader: %0.0f/s",
+        (double)subghz_test_per_second(SUBGHZ_TEST_RAW_TABLE_LOOKUPS, cycles));
+
+    SubGhzKeystoreRawReader* reader = subghz_keystore_raw_reader_alloc();
+    mu_check(!subghz_keystore_raw_reader_get_data(reader, 0, data, sizeof(data)));
+    mu_check(subghz_keystore_raw_reader_open(reader, SUBGHZ_TEST_RAW_TABLE_ENCRYPTED_PATH));
+    cycles = DWT->CYCCNT;
+    for(size_t i = 0; i < SUBGHZ_TEST_RAW_TABLE_LOOKUPS; i++) {
+        mu_check(subghz_keystore_raw_reader_get_data(reader, offsets[i], data, sizeof(data)));
+        mu_check(memcmp(data, &table[offsets[i]], sizeof(data)) == 0);
+    }
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "RAW lookups with reader: %0.0f/s",
+        (double)subghz_test_per_second(SUBGHZ_TEST_RAW_TABLE_LOOKUPS, cycles));
+
+    // Reads crossing block boundaries and past the end of the table
+    uint8_t span[40];
+    mu_check(subghz_keystore_raw_reader_get_data(reader, 12, span, sizeof(span)));
+    mu_check(memcmp(span, &table[12], sizeof(span)) == 0);
+    mu_check(!subghz_keystore_raw_reader_get_data(
+        reader, SUBGHZ_TEST_RAW_TABLE_SIZE - 4, data, sizeof(data)));
+
+    // An open reader does not lock the file for other readers
+    SubGhzKeystoreRawReader* second_reader = subghz_keystore_raw_reader_alloc();
+    mu_check(
+        subghz_keystore_raw_reader_open(second_reader, SUBGHZ_TEST_RAW_TABLE_ENCRYPTED_PATH));
+    mu_check(subghz_keystore_raw_reader_get_data(second_reader, 100, data, sizeof(data)));
+    mu_check(memcmp(data, &table[100], sizeof(data)) == 0);
+    subghz_keystore_raw_reader_free(second_reader);
+    mu_check(subghz_keystore_raw_get_data(
+        SUBGHZ_TEST_RAW_TABLE_ENCRYPTED_PATH, 200, data, sizeof(data)));
+    mu_check(memcmp(data, &table[200], sizeof(data)) == 0);
+
+    subghz_keystore_raw_reader_close(reader);
+    mu_check(!subghz_keystore_raw_reader_get_data(reader, 0, data, sizeof(data)));
+    subghz_keystore_raw_reader_free(reader);
+
+    storage = furi_record_open("storage");
+    storage_simply_remove(storage, SUBGHZ_TEST_RAW_TABLE_PATH);
+    storage_simply_remove(storage, SUBGHZ_TEST_RAW_TABLE_ENCRYPTED_PATH);
+    furi_record_close("storage");
+}
+
+static void subghz_test_raw_capture_flush(
+    FlipperFormat* flipper_format,
+    int32_t* line,
+    size_t* line_size,
+    bool force) {
+    if(*line_size == SUBGHZ_TEST_RAW_CAPTURE_LINE || (force && *line_size)) {
+        mu_check(flipper_format_write_int32(flipper_format, "RAW_Data", line, *line_size));
+        *line_size = 0;
+    }
+}
+
+/** Write the keys subghz_protocol_raw_save_to_file_init puts before RAW data */
+static void subghz_test_raw_write_header(FlipperFormat* flipper_format) {
+    uint32_t frequency = 433920000;
+    mu_check(flipper_format_write_header_cstr(flipper_format, SUBGHZ_RAW_FILE_TYPE, 1));
+    mu_check(flipper_format_write_uint32(flipper_format, "Frequency", &frequency, 1));
+    mu_check(flipper_format_write_string_cstr(
+        flipper_format, "Preset", "FuriHalSubGhzPresetOok650Async"));
+    mu_check(flipper_format_write_string_cstr(flipper_format, "Protocol", "RAW"));
+}
+
+/** Record noise around Princeton packets the way the RAW decoder stores them */
+static void subghz_test_raw_capture_generate(SubGhzEnvironment* environment) {
+    FlipperFormat* packet = flipper_format_string_alloc();
+    uint32_t temp = 24;
+    mu_check(flipper_format_write_string_cstr(packet, "Protocol", "Princeton"));
+    mu_check(flipper_format_write_uint32(packet, "Bit", &temp, 1));
+    uint8_t key[sizeof(uint64_t)] = {0, 0, 0, 0, 0, 0x5A, 0xA5, 0x3C};
+    mu_check(flipper_format_write_hex(packet, "Key", key, sizeof(key)));
+    temp = 400;
+    mu_check(flipper_format_write_uint32(packet, "TE", &temp, 1));
+    temp = 3;
+    mu_check(flipper_format_write_uint32(packet, "Repeat", &temp, 1));
+
+    Storage* storage = furi_record_open("storage");
+    FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
+    mu_check(flipper_format_file_open_always(flipper_format, SUBGHZ_TEST_RAW_CAPTURE_PATH));
+    subghz_test_raw_write_header(flipper_format);
+
+    int32_t* line = malloc(sizeof(int32_t) * SUBGHZ_TEST_RAW_CAPTURE_LINE);
+    size_t line_size = 0;
+    bool level = true;
+    for(size_t i = 0; i < SUBGHZ_TEST_RAW_CAPTURE_PACKETS; i++) {
+        for(size_t j = 0; j < SUBGHZ_TEST_RAW_CAPTURE_NOISE; j++) {
+            int32_t duration = 50 + furi_hal_random_get() % 3000;
+            line[line_size++] = level ? duration : -duration;
+            level = !level;
+            subghz_test_raw_capture_flush(flipper_format, line, &line_size, false);
+        }
+
+        SubGhzTransmitter* transmitter = subghz_transmitter_alloc_init(environment, "Princeton");
+        mu_check(subghz_transmitter_deserialize(transmitter, packet));
+        while(true) {
+            LevelDuration level_duration = subghz_transmitter_yield(transmitter);
+            if(level_duration_is_reset(level_duration)) break;
+            int32_t duration = level_duration_get_duration(level_duration);
+            level = level_duration_get_level(level_duration);
+            line[line_size++] = level ? duration : -duration;
+            level = !level;
+            subghz_test_raw_capture_flush(flipper_format, line, &line_size, false);
+        }
+        subghz_transmitter_free(transmitter);
+    }
+    subghz_test_raw_capture_flush(flipper_format, line, &line_size, true);
+
+    free(line);
+    flipper_format_free(flipper_format);
+    furi_record_close("storage");
+    flipper_format_free(packet);
+}
+
+static void
+    subghz_test_raw_capture_load(const char* file_name, int32_t* capture, size_t* capture_size) {
+    *capture_size = 0;
+    Storage* storage = furi_record_open("storage");
+    FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
+    mu_check(flipper_format_file_open_existing(flipper_format, file_name));
+
+    uint32_t count = 0;
+    while(flipper_format_get_value_count(flipper_format, "RAW_Data", &count)) {
+        mu_check(*capture_size + count <= SUBGHZ_TEST_RAW_CAPTURE_SIZE_MAX);
+        mu_check(flipper_format_read_int32(
+            flipper_format, "RAW_Data", &capture[*capture_size], count));
+        *capture_size += count;
+    }
+
+    flipper_format_free(flipper_format);
+    furi_record_close("storage");
+}
+
+static void subghz_test_receiver_callback(
+    SubGhzReceiver* receiver,
+    SubGhzProtocolDecoderBase* decoder_base,
+    void* context) {
+    UNUSED(receiver);
+    UNUSED(decoder_base);
+    uint32_t* decoded = context;
+    (*decoded)++;
+}
+
+static void subghz_test_decoder_callback(SubGhzProtocolDecoderBase* decoder_base, void* context) {
+    subghz_test_receiver_callback(NULL, decoder_base, context);
+}
+
+MU_TEST(subghz_receiver_dispatch_test) {
+    SubGhzEnvironment* environment = subghz_environment_alloc();
+    subghz_test_raw_capture_generate(environment);
+
+    int32_t* capture = malloc(sizeof(int32_t) * SUBGHZ_TEST_RAW_CAPTURE_SIZE_MAX);
+    size_t capture_size = 0;
+    subghz_test_raw_capture_load(SUBGHZ_TEST_RAW_CAPTURE_PATH, capture, &capture_size);
+    mu_check(capture_size > SUBGHZ_TEST_RAW_CAPTURE_PACKETS * SUBGHZ_TEST_RAW_CAPTURE_NOISE);
+
+    // Reference: every decoder sees every pulse
+    size_t decoder_count = subghz_protocol_registry_count();
+    void* decoders[decoder_count];
+    uint32_t decoded_all = 0;
+    for(size_t i = 0; i < decoder_count; i++) {
+        const SubGhzProtocol* protocol = subghz_protocol_registry_get_by_index(i);
+        decoders[i] = NULL;
+        if(protocol->decoder && protocol->decoder->alloc) {
+            decoders[i] = protocol->decoder->alloc(environment);
+            subghz_protocol_decoder_base_set_decoder_callback(
+                decoders[i], subghz_test_decoder_callback, &decoded_all);
+        }
+    }
+    uint32_t cycles = DWT->CYCCNT;
+    for(size_t i = 0; i < capture_size; i++) {
+        bool level = capture[i] > 0;
+        uint32_t duration = level ? capture[i] : -capture[i];
+        for(size_t j = 0; j < decoder_count; j++) {
+            if(decoders[j]) {
+                subghz_protocol_registry_get_by_index(j)->decoder->feed(
+                    decoders[j], level, duration);
+            }
+        }
+    }
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "Receiver without dispatch: %0.0f pulses/s",
+        (double)subghz_test_per_second(capture_size, cycles));
+    for(size_t i = 0; i < decoder_count; i++) {
+        if(decoders[i]) subghz_protocol_registry_get_by_index(i)->decoder->free(decoders[i]);
+    }
+
+    SubGhzReceiver* receiver = subghz_receiver_alloc_init(environment);
+    uint32_t decoded = 0;
+    subghz_receiver_set_rx_callback(receiver, subghz_test_receiver_callback, &decoded);
+    subghz_receiver_set_filter(receiver, SubGhzProtocolFlag_Decodable);
+    cycles = DWT->CYCCNT;
+    for(size_t i = 0; i < capture_size; i++) {
+        bool level = capture[i] > 0;
+        subghz_receiver_decode(receiver, level, level ? capture[i] : -capture[i]);
+    }
+    cycles = DWT->CYCCNT - cycles;
+    FURI_LOG_I(
+        TAG,
+        "Receiver with dispatch: %0.0f pulses/s",
+        (double)subghz_test_per_second(capture_size, cycles));
+    subghz_receiver_free(receiver);
+
+    // Every decodable protocol is fed exactly the pulses it would act on
+    mu_assert_int_eq(decoded_all, decoded);
+    mu_check(decoded >= SUBGHZ_TEST_RAW_CAPTURE_PACKETS);
+
+    free(capture);
+    subghz_environment_free(environment);
+
+    Storage* storage = furi_record_open("storage");
+    storage_simply_remove(storage, SUBGHZ_TEST_RAW_CAPTURE_PATH);
+    furi_record_close("storage");
+}
+
+/** Write the capture in 512 sample chunks the way the RAW decoder does */
+static void subghz_test_raw_capture_save(
+    const char* file_name,
+    const int32_t* capture,
+    size_t capture_size,
+    SubGhzProtocolRAWFormat format,
+    size_t* file_size) {
+    Storage* storage = furi_record_open("storage");
+    FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
+    mu_check(flipper_format_file_open_always(flipper_format, file_name));
+    subghz_test_raw_write_header(flipper_format);
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+    SubGhzRawBinary* raw_binary = subghz_raw_binary_alloc();
+    if(format == SubGhzProtocolRAWFormatBinary) {
+        mu_check(subghz_raw_binary_write_marker(stream));
+    }
+
+    uint32_t cycles = DWT->CYCCNT;
+    for(size_t i = 0; i < capture_size; i += SUBGHZ_RAW_BINARY_SAMPLES_MAX) {
+        size_t count = MIN(capture_size - i, (size_t)SUBGHZ_RAW_BINARY_SAMPLES_MAX);
+        if(format == SubGhzProtocolRAWFormatBinary) {
+            mu_check(subghz_raw_binary_write(raw_binary, stream, &capture[i], count));
+        } else {
+            mu_check(flipper_format_write_int32(flipper_format, "RAW_Data", &capture[i], count));
+        }
+    }
+    cycles = DWT->CYCCNT - cycles;
+    *file_size = stream_size(stream);
+    FURI_LOG_I(
+        TAG,
+        "RAW %s write: %0.0f samples/s, %u bytes",
+        format == SubGhzProtocolRAWFormatBinary ? "binary" : "text",
+        (double)subghz_test_per_second(capture_size, cycles),
+        *file_size);
+
+    subghz_raw_binary_free(raw_binary);
+    flipper_format_free(flipper_format);
+    furi_record_close("storage");
+}
+
+MU_TEST(subghz_raw_binary_codec_test) {
+    const size_t samples_size = sizeof(int32_t) * SUBGHZ_RAW_BINARY_SAMPLES_MAX;
+    int32_t* samples = malloc(samples_size);
+    int32_t* decoded = malloc(samples_size);
+    uint8_t* block = malloc(SUBGHZ_RAW_BINARY_BLOCK_SIZE_MAX);
+
+    for(size_t i = 0; i < SUBGHZ_RAW_BINARY_SAMPLES_MAX; i++) {
+        samples[i] = (int32_t)furi_hal_random_get();
+    }
+    samples[0] = INT32_MIN;
+    samples[1] = INT32_MAX;
+    samples[2] = INT32_MAX;
+    samples[3] = INT32_MIN;
+
+    size_t count = 0;
+    size_t size = subghz_raw_binary_encode(samples, SUBGHZ_RAW_BINARY_SAMPLES_MAX, block);
+    mu_check(size <= SUBGHZ_RAW_BINARY_BLOCK_SIZE_MAX);
+    mu_check(subghz_raw_binary_decode(block, size, decoded, &count));
+    mu_assert_int_eq(SUBGHZ_RAW_BINARY_SAMPLES_MAX, count);
+    mu_check(memcmp(samples, decoded, samples_size) == 0);
+
+    // Damaged payload and truncated block are rejected
+    block[size - 1] ^= 0x01;
+    mu_check(!subghz_raw_binary_decode(block, size, decoded, &count));
+    mu_check(!subghz_raw_binary_decode(block, size - 1, decoded, &count));
+
+    size = subghz_raw_binary_encode(samples, 0, block);
+    mu_check(subghz_raw_binary_decode(block, size, decoded, &count));
+    mu_assert_int_eq(0, count);
+
+    free(block);
+    free(decoded);
+    free(samples);
+}
+
+MU_TEST(subghz_raw_binary_file_test) {
+    SubGhzEnvironment* environment = subghz_environment_alloc();
+    subghz_test_raw_capture_generate(environment);
+    subghz_environment_free(environment);
+
+    int32_t* capture = malloc(sizeof(int32_t) * SUBGHZ_TEST_RAW_CAPTURE_SIZE_MAX);
+    int32_t* converted = malloc(sizeof(int32_t) * SUBGHZ_TEST_RAW_CAPTURE_SIZE_MAX);
+    size_t capture_size = 0;
+    size_t converted_size = 0;
+    subghz_test_raw_capture_load(SUBGHZ_TEST_RAW_CAPTURE_PATH, capture, &capture_size);
+
+    size_t text_size = 0;
+    size_t binary_size = 0;
+    subghz_test_raw_capture_save(
+        SUBGHZ_TEST_RAW_CAPTURE_TEXT_PATH,
+        capture,
+        capture_size,
+        SubGhzProtocolRAWFormatText,
+        &text_size);
+    subghz_test_raw_capture_save(
+        SUBGHZ_TEST_RAW_CAPTURE_BINARY_PATH,
+        capture,
+        capture_size,
+        SubGhzProtocolRAWFormatBinary,
+        &binary_size);
+    mu_check(binary_size < text_size);
+
+    // Text to binary and back again keeps every sample
+    mu_check(subghz_protocol_raw_convert(
+        SUBGHZ_TEST_RAW_CAPTURE_PATH,
+        SUBGHZ_TEST_RAW_CAPTURE_BINARY_PATH,
+        SubGhzProtocolRAWFormatBinary));
+    mu_check(subghz_protocol_raw_convert(
+        SUBGHZ_TEST_RAW_CAPTURE_BINARY_PATH,
+        SUBGHZ_TEST_RAW_CAPTURE_TEXT_PATH,
+        SubGhzProtocolRAWFormatText));
+    subghz_test_raw_capture_load(SUBGHZ_TEST_RAW_CAPTURE_TEXT_PATH, converted, &converted_size);
+    mu_assert_int_eq(capture_size, converted_size);
+    mu_check(memcmp(capture, converted, capture_size * sizeof(int32_t)) == 0);
+
+    free(converted);
+    free(capture);
+
+    Storage* storage = furi_record_open("storage");
+    storage_simply_remove(storage, SUBGHZ_TEST_RAW_CAPTURE_PATH);
+    storage_simply_remove(storage, SUBGHZ_TEST_RAW_CAPTURE_BINARY_PATH);
+    storage_simply_remove(storage, SUBGHZ_TEST_RAW_CAPTURE_TEXT_PATH);
+    furi_record_close("storage");
+}
+
+/** Drain the file encoder worker the way the radio ISR does */
+static void subghz_test_file_encoder_play(
+    const char* file_name,
+    const int32_t* capture,
+    size_t capture_size,
+    uint32_t* cycles) {
+    SubGhzFileEncoderWorker* worker = subghz_file_encoder_worker_alloc();
+    mu_check(subghz_file_encoder_worker_start(worker, file_name));
+
+    uint32_t start = DWT->CYCCNT;
+    size_t played = 0;
+    size_t waits = 0;
+    while(waits < 1000) {
+        LevelDuration level_duration = subghz_file_encoder_worker_get_level_duration(worker);
+        if(level_duration_is_reset(level_duration)) break;
+        if(level_duration_is_wait(level_duration)) {
+            waits++;
+            osDelay(1);
+            continue;
+        }
+        int32_t duration = level_duration_get_duration(level_duration);
+        if(!level_duration_get_level(level_duration)) duration = -duration;
+        mu_check(played < capture_size);
+        mu_assert_int_eq(capture[played], duration);
+        played++;
+    }
+    *cycles = DWT->CYCCNT - start;
+    mu_assert_int_eq(capture_size, played);
+
+    SubGhzFileEncoderWorkerStats stats;
+    subghz_file_encoder_worker_get_stats(worker, &stats);
+    FURI_LOG_I(
+        TAG,
+        "Playback: %u samples, %lu waits, %lu refills",
+        played,
+        stats.underrun_count,
+        stats.refill_count);
+
+    subghz_file_encoder_worker_stop(worker);
+    subghz_file_encoder_worker_free(worker);
+}
+
+MU_TEST(subghz_file_encoder_worker_test) {
+    SubGhzEnvironment* environment = subghz_environment_alloc();
+    subghz_test_raw_capture_generate(environment);
+    subghz_environment_free(environment);
+
+    int32_t* capture = malloc(sizeof(int32_t) * SUBGHZ_TEST_RAW_CAPTURE_SIZE_MAX);
+    size_t capture_size = 0;
+    subghz_test_raw_capture_load(SUBGHZ_TEST_RAW_CAPTURE_PATH, capture, &capture_size);
+    mu_check(subghz_protocol_raw_convert(
+        SUBGHZ_TEST_RAW_CAPTURE_PATH,
+        SUBGHZ_TEST_RAW_CAPTURE_BINARY_PATH,
+        SubGhzProtocolRAWFormatBinary));
+
+    uint32_t cycles = 0;
+    subghz_test_file_encoder_play(SUBGHZ_TEST_RAW_CAPTURE_PATH, capture, capture_size, &cycles);
+    FURI_LOG_I(
+        TAG,
+        "Text playback: %.0f samples/s",
+        (double)subghz_test_per_second(capture_size, cycles));
+    subghz_test_file_encoder_play(
+        SUBGHZ_TEST_RAW_CAPTURE_BINARY_PATH, capture, capture_size, &cycles);
+    FURI_LOG_I(
+        TAG,
+        "Binary playback: %.0f samples/s",
+        (double)subghz_test_per_second(capture_size, cycles));
+
+    free(capture);
+
+    Storage* storage = furi_record_open("storage");
+    storage_simply_remove(storage, SUBGHZ_TEST_RAW_CAPTURE_PATH);
+    storage_simply_remove(storage, SUBGHZ_TEST_RAW_CAPTURE_BINARY_PATH);
+    furi_record_close("storage");
+}
+
+MU_TEST_SUITE(subghz) {
+    MU_RUN_TEST(subghz_keeloq_decrypt_batch_test);
+    MU_RUN_TEST(subghz_keeloq_search_test);
+    MU_RUN_TEST(subghz_keystore_binary_test);
+    MU_RUN_TEST(subghz_keystore_raw_reader_test);
+    MU_RUN_TEST(subghz_receiver_dispatch_test);
+    MU_RUN_TEST(subghz_raw_binary_codec_test);
+    MU_RUN_TEST(subghz_raw_binary_file_test);
+    MU_RUN_TEST(subghz_file_encoder_worker_test);
+}
+
+int run_minunit_test_subghz() {
+    MU_RUN_SUITE(subghz);
+    return MU_EXIT_CODE;
+}
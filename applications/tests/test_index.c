@@ -12,11 +12,18 @@
 
 int run_minunit();
 int run_minunit_test_infrared_decoder_encoder();
+int run_minunit_test_infrared_remote_manager();
+int run_minunit_test_crypto1();
+int run_minunit_test_mf_ultralight();
+int run_minunit_test_nfc_util();
 int run_minunit_test_rpc();
 int run_minunit_test_flipper_format();
 int run_minunit_test_flipper_format_string();
+int run_minunit_test_flipper_format_benchmark();
 int run_minunit_test_stream();
 int run_minunit_test_storage();
+int run_minunit_test_subghz();
+int run_minunit_test_sd();
 
 void minunit_print_progress(void) {
     static char progress[] = {'\\', '|', '/', '-'};
@@ -58,8 +65,15 @@ void unit_tests_cli(Cli* cli, string_t args, void* context) {
         test_result |= run_minunit_test_stream();
         test_result |= run_minunit_test_flipper_format();
         test_result |= run_minunit_test_flipper_format_string();
+        test_result |= run_minunit_test_flipper_format_benchmark();
         test_result |= run_minunit_test_infrared_decoder_encoder();
+        test_result |= run_minunit_test_infrared_remote_manager();
+        test_result |= run_minunit_test_crypto1();
+        test_result |= run_minunit_test_mf_ultralight();
+        test_result |= run_minunit_test_nfc_util();
         test_result |= run_minunit_test_rpc();
+        test_result |= run_minunit_test_subghz();
+        test_result |= run_minunit_test_sd();
         cycle_counter = (DWT->CYCCNT - cycle_counter);
 
         FURI_LOG_I(TAG, "Consumed: %0.2fs", (float)cycle_counter / (SystemCoreClock));
@@ -1,10 +1,13 @@
 #include <furi_hal.h>
 #include <furi.h>
+#include "stm32_adafruit_sd.h"
 
 #define SD_DUMMY_BYTE 0xFF
+/* Shorter transfers are cheaper to clock out than to set DMA up and wait for it */
+#define SD_SPI_DMA_MIN_LENGTH 32
 
 const uint32_t SpiTimeout = 1000;
-uint8_t SD_IO_WriteByte(uint8_t Data);
+static const SD_IO_Override* sd_io_override = NULL;
 
 /******************************************************************************
                             BUS OPERATIONS
@@ -12,14 +15,28 @@ uint8_t SD_IO_WriteByte(uint8_t Data);
 
 /**
  * @brief  SPI Write byte(s) to device
- * @param  DataIn: Pointer to data buffer to write
- * @param  DataOut: Pointer to data buffer for read data
+ * @param  DataIn: Pointer to data buffer to write, NULL to send dummy bytes
+ * @param  DataOut: Pointer to data buffer for read data, NULL to discard
  * @param  DataLength: number of bytes to write
  * @retval None
  */
 static void SPIx_WriteReadData(const uint8_t* DataIn, uint8_t* DataOut, uint16_t DataLength) {
-    furi_check(furi_hal_spi_bus_trx(
-        furi_hal_sd_spi_handle, (uint8_t*)DataIn, DataOut, DataLength, SpiTimeout));
+    if(sd_io_override) {
+        sd_io_override->write_read(sd_io_override->context, DataIn, DataOut, DataLength);
+    } else if(DataLength < SD_SPI_DMA_MIN_LENGTH) {
+        uint8_t dummy[SD_SPI_DMA_MIN_LENGTH];
+        uint8_t discard[SD_SPI_DMA_MIN_LENGTH];
+        if(!DataIn) memset(dummy, SD_DUMMY_BYTE, DataLength);
+        furi_check(furi_hal_spi_bus_trx(
+            furi_hal_sd_spi_handle,
+            DataIn ? (uint8_t*)DataIn : dummy,
+            DataOut ? DataOut : discard,
+            DataLength,
+            SpiTimeout));
+    } else {
+        furi_check(furi_hal_spi_bus_trx_dma(
+            furi_hal_sd_spi_handle, DataIn, DataOut, DataLength, SpiTimeout));
+    }
 }
 
 /**
@@ -62,6 +79,11 @@ void SD_IO_Init(void) {
  * @retval None
  */
 void SD_IO_CSState(uint8_t val) {
+    if(sd_io_override) {
+        sd_io_override->cs_state(sd_io_override->context, val);
+        return;
+    }
+
     /* Some SD Cards are prone to fail if CLK-ed too soon after CS transition. Worst case found: 8us */
     if(val == 1) {
         furi_hal_delay_us(10); // Exit guard time for some SD cards
@@ -74,8 +96,8 @@ void SD_IO_CSState(uint8_t val) {
 
 /**
  * @brief  Write byte(s) on the SD
- * @param  DataIn: Pointer to data buffer to write
- * @param  DataOut: Pointer to data buffer for read data
+ * @param  DataIn: Pointer to data buffer to write, NULL to send dummy bytes
+ * @param  DataOut: Pointer to data buffer for read data, NULL to discard
  * @param  DataLength: number of bytes to write
  * @retval None
  */
@@ -96,3 +118,12 @@ uint8_t SD_IO_WriteByte(uint8_t Data) {
     SPIx_WriteReadData(&Data, &tmp, 1);
     return tmp;
 }
+
+/**
+ * @brief  Route SD link operations to a simulated card.
+ * @param  override: Override to use, NULL to restore the SPI bus
+ * @retval None
+ */
+void SD_IO_SetOverride(const SD_IO_Override* override) {
+    sd_io_override = override;
+}
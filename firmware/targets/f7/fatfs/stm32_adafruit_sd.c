@@ -161,7 +161,7 @@ typedef enum {
 #define SD_TOKEN_START_DATA_SINGLE_BLOCK_WRITE \
     0xFE /* Data token start byte, Start Single Block Write */
 #define SD_TOKEN_START_DATA_MULTIPLE_BLOCK_WRITE \
-    0xFD /* Data token start byte, Start Multiple Block Write */
+    0xFC /* Data token start byte, Start Multiple Block Write */
 #define SD_TOKEN_STOP_DATA_MULTIPLE_BLOCK_WRITE \
     0xFD /* Data toke stop byte, Stop Multiple Block Write */
 
@@ -269,6 +269,8 @@ static uint8_t SD_GoIdleState(void);
 static SD_CmdAnswer_typedef SD_SendCmd(uint8_t Cmd, uint32_t Arg, uint8_t Crc, uint8_t Answer);
 static uint8_t SD_WaitData(uint8_t data);
 static uint8_t SD_ReadData(void);
+static uint8_t SD_StopTransmission(void);
+static void SD_StopWriteTransmission(void);
 /** @defgroup STM32_ADAFRUIT_SD_Private_Function_Prototypes
   * @{
   */
@@ -419,10 +421,10 @@ uint8_t BSP_SD_GetCardInfo(SD_CardInfo* pCardInfo) {
   */
 uint8_t
     BSP_SD_ReadBlocks(uint32_t* pData, uint32_t ReadAddr, uint32_t NumOfBlocks, uint32_t Timeout) {
-    uint32_t offset = 0;
+    uint8_t* ptr = (uint8_t*)pData;
     uint32_t addr;
     uint8_t retr = BSP_SD_ERROR;
-    uint8_t* ptr = NULL;
+    uint8_t multiple = (NumOfBlocks > 1);
     SD_CmdAnswer_typedef response;
     uint16_t BlockSize = 512;
 
@@ -435,52 +437,48 @@ uint8_t
         goto error;
     }
 
-    ptr = malloc(sizeof(uint8_t) * BlockSize);
-    if(ptr == NULL) {
-        goto error;
-    }
-    memset(ptr, SD_DUMMY_BYTE, sizeof(uint8_t) * BlockSize);
-
     /* Initialize the address */
     addr = (ReadAddr * ((flag_SDHC == 1) ? 1 : BlockSize));
 
-    /* Data transfer */
-    while(NumOfBlocks--) {
-        /* Send CMD17 (SD_CMD_READ_SINGLE_BLOCK) to read one block */
-        /* Check if the SD acknowledged the read block command: R1 response (0x00: no errors) */
-        response = SD_SendCmd(SD_CMD_READ_SINGLE_BLOCK, addr, 0xFF, SD_ANSWER_R1_EXPECTED);
-        if(response.r1 != SD_R1_NO_ERROR) {
-            goto error;
-        }
+    /* Send CMD18 (SD_CMD_READ_MULT_BLOCK) or CMD17 (SD_CMD_READ_SINGLE_BLOCK) once, 
+     Check if the SD acknowledged the read block command: R1 response (0x00: no errors) */
+    response = SD_SendCmd(
+        multiple ? SD_CMD_READ_MULT_BLOCK : SD_CMD_READ_SINGLE_BLOCK,
+        addr,
+        0xFF,
+        SD_ANSWER_R1_EXPECTED);
+    if(response.r1 != SD_R1_NO_ERROR) {
+        goto error;
+    }
 
+    /* Data transfer: the card streams blocks until CMD12 */
+    while(NumOfBlocks--) {
         /* Now look for the data token to signify the start of the data */
-        if(SD_WaitData(SD_TOKEN_START_DATA_SINGLE_BLOCK_READ) == BSP_SD_OK) {
-            /* Read the SD block data : read NumByteToRead data */
-            SD_IO_WriteReadData(ptr, (uint8_t*)pData + offset, BlockSize);
-
-            /* Set next read address*/
-            offset += BlockSize;
-            addr = ((flag_SDHC == 1) ? (addr + 1) : (addr + BlockSize));
-
-            /* get CRC bytes (not really needed by us, but required by SD) */
-            SD_IO_WriteByte(SD_DUMMY_BYTE);
-            SD_IO_WriteByte(SD_DUMMY_BYTE);
-        } else {
+        if(SD_WaitData(SD_TOKEN_START_DATA_MULTIPLE_BLOCK_READ) != BSP_SD_OK) {
+            if(multiple) SD_StopTransmission();
             goto error;
         }
 
-        /* End the command data read cycle */
-        SD_IO_CSState(1);
+        /* Read the SD block data : read NumByteToRead data */
+        SD_IO_WriteReadData(NULL, ptr, BlockSize);
+        ptr += BlockSize;
+
+        /* get CRC bytes (not really needed by us, but required by SD) */
+        SD_IO_WriteByte(SD_DUMMY_BYTE);
         SD_IO_WriteByte(SD_DUMMY_BYTE);
     }
 
+    /* End the multiple block read */
+    if(multiple && SD_StopTransmission() != SD_R1_NO_ERROR) {
+        goto error;
+    }
+
     retr = BSP_SD_OK;
 
 error:
     /* Send dummy byte: 8 Clock pulses of delay */
     SD_IO_CSState(1);
     SD_IO_WriteByte(SD_DUMMY_BYTE);
-    if(ptr != NULL) free(ptr);
 
     /* Return the reponse */
     return retr;
@@ -500,10 +498,10 @@ uint8_t BSP_SD_WriteBlocks(
     uint32_t WriteAddr,
     uint32_t NumOfBlocks,
     uint32_t Timeout) {
-    uint32_t offset = 0;
+    const uint8_t* ptr = (const uint8_t*)pData;
     uint32_t addr;
     uint8_t retr = BSP_SD_ERROR;
-    uint8_t* ptr = NULL;
+    uint8_t multiple = (NumOfBlocks > 1);
     SD_CmdAnswer_typedef response;
     uint16_t BlockSize = 512;
 
@@ -516,36 +514,34 @@ uint8_t BSP_SD_WriteBlocks(
         goto error;
     }
 
-    ptr = malloc(sizeof(uint8_t) * BlockSize);
-    if(ptr == NULL) {
-        goto error;
-    }
-
     /* Initialize the address */
     addr = (WriteAddr * ((flag_SDHC == 1) ? 1 : BlockSize));
 
+    /* Send CMD25 (SD_CMD_WRITE_MULT_BLOCK) or CMD24 (SD_CMD_WRITE_SINGLE_BLOCK) once, 
+     Check if the SD acknowledged the write block command: R1 response (0x00: no errors) */
+    response = SD_SendCmd(
+        multiple ? SD_CMD_WRITE_MULT_BLOCK : SD_CMD_WRITE_SINGLE_BLOCK,
+        addr,
+        0xFF,
+        SD_ANSWER_R1_EXPECTED);
+    if(response.r1 != SD_R1_NO_ERROR) {
+        goto error;
+    }
+
     /* Data transfer */
     while(NumOfBlocks--) {
-        /* Send CMD24 (SD_CMD_WRITE_SINGLE_BLOCK) to write blocks  and
-       Check if the SD acknowledged the write block command: R1 response (0x00: no errors) */
-        response = SD_SendCmd(SD_CMD_WRITE_SINGLE_BLOCK, addr, 0xFF, SD_ANSWER_R1_EXPECTED);
-        if(response.r1 != SD_R1_NO_ERROR) {
-            goto error;
-        }
-
         /* Send dummy byte for NWR timing : one byte between CMDWRITE and TOKEN */
         SD_IO_WriteByte(SD_DUMMY_BYTE);
         SD_IO_WriteByte(SD_DUMMY_BYTE);
 
         /* Send the data token to signify the start of the data */
-        SD_IO_WriteByte(SD_TOKEN_START_DATA_SINGLE_BLOCK_WRITE);
+        SD_IO_WriteByte(
+            multiple ? SD_TOKEN_START_DATA_MULTIPLE_BLOCK_WRITE :
+                       SD_TOKEN_START_DATA_SINGLE_BLOCK_WRITE);
 
         /* Write the block data to SD */
-        SD_IO_WriteReadData((uint8_t*)pData + offset, ptr, BlockSize);
-
-        /* Set next write address */
-        offset += BlockSize;
-        addr = ((flag_SDHC == 1) ? (addr + 1) : (addr + BlockSize));
+        SD_IO_WriteReadData(ptr, NULL, BlockSize);
+        ptr += BlockSize;
 
         /* Put CRC bytes (not really needed by us, but required by SD) */
         SD_IO_WriteByte(SD_DUMMY_BYTE);
@@ -553,17 +549,20 @@ uint8_t BSP_SD_WriteBlocks(
 
         /* Read data response */
         if(SD_GetDataResponse() != SD_DATA_OK) {
-            /* Set response value to failure */
+            /* Abort the multiple block write, card discards the rejected block */
+            if(multiple) SD_StopWriteTransmission();
             goto error;
         }
+    }
 
-        SD_IO_CSState(1);
-        SD_IO_WriteByte(SD_DUMMY_BYTE);
+    /* End the multiple block write */
+    if(multiple) {
+        SD_StopWriteTransmission();
     }
+
     retr = BSP_SD_OK;
 
 error:
-    if(ptr != NULL) free(ptr);
     /* Send dummy byte: 8 Clock pulses of delay */
     SD_IO_CSState(1);
     SD_IO_WriteByte(SD_DUMMY_BYTE);
@@ -1039,6 +1038,47 @@ uint8_t SD_GoIdleState(void) {
     return BSP_SD_OK;
 }
 
+/**
+  * @brief  Ends a multiple block read with CMD12 (SD_CMD_STOP_TRANSMISSION).
+  * @param  None
+  * @retval R1 response
+  */
+uint8_t SD_StopTransmission(void) {
+    uint8_t frame[SD_CMD_LENGTH] = {SD_CMD_STOP_TRANSMISSION | 0x40, 0, 0, 0, 0, 0xFF};
+    uint8_t timeout = 0x08;
+    uint8_t r1;
+
+    /* CS is already low, the card is streaming the next block while the command is sent */
+    SD_IO_WriteReadData(frame, NULL, SD_CMD_LENGTH);
+
+    /* Skip the stuff byte that follows CMD12, then get R1b: the first byte with bit 7 clear */
+    SD_IO_WriteByte(SD_DUMMY_BYTE);
+    do {
+        r1 = SD_IO_WriteByte(SD_DUMMY_BYTE);
+        timeout--;
+    } while((r1 & 0x80) && timeout);
+
+    /* Wait IO line return 0xFF */
+    while(SD_IO_WriteByte(SD_DUMMY_BYTE) != 0xFF)
+        ;
+
+    return r1;
+}
+
+/**
+  * @brief  Ends a multiple block write with the stop token.
+  * @param  None
+  * @retval None
+  */
+void SD_StopWriteTransmission(void) {
+    SD_IO_WriteByte(SD_TOKEN_STOP_DATA_MULTIPLE_BLOCK_WRITE);
+
+    /* Skip one byte (Nbr), then wait IO line return 0xFF */
+    SD_IO_WriteByte(SD_DUMMY_BYTE);
+    while(SD_IO_WriteByte(SD_DUMMY_BYTE) != 0xFF)
+        ;
+}
+
 /**
   * @brief  Waits a data until a value different from SD_DUMMY_BITE
   * @param  None
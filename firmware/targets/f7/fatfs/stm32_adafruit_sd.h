@@ -207,6 +207,19 @@ uint8_t BSP_SD_Erase(uint32_t StartAddr, uint32_t EndAddr);
 uint8_t BSP_SD_GetCardState(void);
 uint8_t BSP_SD_GetCardInfo(SD_CardInfo* pCardInfo);
 
+/**
+  * @brief  SD link operations override, used to run the driver against a simulated card
+  */
+typedef struct {
+    void (*cs_state)(void* context, uint8_t state);
+    void (*write_read)(
+        void* context,
+        const uint8_t* data_in,
+        uint8_t* data_out,
+        uint16_t length);
+    void* context;
+} SD_IO_Override;
+
 /* Link functions for SD Card peripheral*/
 void SD_SPI_Slow_Init(void);
 void SD_SPI_Fast_Init(void);
@@ -214,6 +227,7 @@ void SD_IO_Init(void);
 void SD_IO_CSState(uint8_t state);
 void SD_IO_WriteReadData(const uint8_t* DataIn, uint8_t* DataOut, uint16_t DataLength);
 uint8_t SD_IO_WriteByte(uint8_t Data);
+void SD_IO_SetOverride(const SD_IO_Override* override);
 
 /* Link function for HAL delay */
 void HAL_Delay(__IO uint32_t Delay);
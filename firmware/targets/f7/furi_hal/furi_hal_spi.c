@@ -1,17 +1,36 @@
 #include "furi_hal_spi.h"
 #include "furi_hal_resources.h"
+#include "furi_hal_interrupt.h"
 
 #include <stdbool.h>
 #include <string.h>
 #include <furi.h>
 
+#include <stm32wbxx_ll_dma.h>
 #include <stm32wbxx_ll_spi.h>
 #include <stm32wbxx_ll_utils.h>
 #include <stm32wbxx_ll_cortex.h>
 
 #define TAG "FuriHalSpi"
 
+#define SPI_DMA DMA2
+#define SPI_DMA_RX_CHANNEL LL_DMA_CHANNEL_6
+#define SPI_DMA_TX_CHANNEL LL_DMA_CHANNEL_7
+#define SPI_DMA_RX_IRQ FuriHalInterruptIdDma2Ch6
+#define SPI_DMA_RX_DEF SPI_DMA, SPI_DMA_RX_CHANNEL
+#define SPI_DMA_TX_DEF SPI_DMA, SPI_DMA_TX_CHANNEL
+
+static osMutexId_t spi_dma_lock = NULL;
+static osSemaphoreId_t spi_dma_completed = NULL;
+
+// Source of idle bytes and sink of ignored ones for transfers without a buffer
+static const uint8_t spi_dma_dummy_tx = 0xFF;
+static uint8_t spi_dma_dummy_rx;
+
 void furi_hal_spi_init() {
+    spi_dma_lock = osMutexNew(NULL);
+    spi_dma_completed = osSemaphoreNew(1, 0, NULL);
+
     furi_hal_spi_bus_init(&furi_hal_spi_bus_r);
     furi_hal_spi_bus_init(&furi_hal_spi_bus_d);
 
@@ -153,3 +172,101 @@ bool furi_hal_spi_bus_trx(
 
     return ret;
 }
+
+static void spi_dma_isr(void* context) {
+    UNUSED(context);
+    if(LL_DMA_IsActiveFlag_TC6(SPI_DMA) && LL_DMA_IsEnabledIT_TC(SPI_DMA_RX_DEF)) {
+        LL_DMA_ClearFlag_TC6(SPI_DMA);
+        furi_check(osSemaphoreRelease(spi_dma_completed) == osOK);
+    }
+}
+
+static void furi_hal_spi_bus_trx_poll(
+    FuriHalSpiBusHandle* handle,
+    const uint8_t* tx_buffer,
+    uint8_t* rx_buffer,
+    size_t size) {
+    SPI_TypeDef* spi = handle->bus->spi;
+    while(size > 0) {
+        while(!LL_SPI_IsActiveFlag_TXE(spi))
+            ;
+        LL_SPI_TransmitData8(spi, tx_buffer ? *tx_buffer++ : spi_dma_dummy_tx);
+        while(!LL_SPI_IsActiveFlag_RXNE(spi))
+            ;
+        uint8_t data = LL_SPI_ReceiveData8(spi);
+        if(rx_buffer) *rx_buffer++ = data;
+        size--;
+    }
+}
+
+bool furi_hal_spi_bus_trx_dma(
+    FuriHalSpiBusHandle* handle,
+    const uint8_t* tx_buffer,
+    uint8_t* rx_buffer,
+    size_t size,
+    uint32_t timeout) {
+    furi_assert(handle);
+    furi_assert(handle->bus->current_handle == handle);
+    furi_assert(size > 0 && size <= UINT16_MAX);
+
+    // Waiting for DMA needs the scheduler
+    if(FURI_IS_ISR() || osKernelGetState() != osKernelRunning) {
+        furi_hal_spi_bus_trx_poll(handle, tx_buffer, rx_buffer, size);
+        furi_hal_spi_bus_end_txrx(handle, timeout);
+        return true;
+    }
+
+    SPI_TypeDef* spi = handle->bus->spi;
+    bool spi1 = (spi == SPI1);
+    furi_check(osMutexAcquire(spi_dma_lock, osWaitForever) == osOK);
+
+    LL_DMA_InitTypeDef dma_config = {0};
+    dma_config.PeriphOrM2MSrcAddress = LL_SPI_DMA_GetRegAddr(spi);
+    dma_config.Mode = LL_DMA_MODE_NORMAL;
+    dma_config.PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT;
+    dma_config.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+    dma_config.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+    dma_config.NbData = size;
+    dma_config.Priority = LL_DMA_PRIORITY_HIGH;
+
+    dma_config.MemoryOrM2MDstAddress = (uint32_t)(rx_buffer ? rx_buffer : &spi_dma_dummy_rx);
+    dma_config.Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+    dma_config.MemoryOrM2MDstIncMode =
+        rx_buffer ? LL_DMA_MEMORY_INCREMENT : LL_DMA_MEMORY_NOINCREMENT;
+    dma_config.PeriphRequest = spi1 ? LL_DMAMUX_REQ_SPI1_RX : LL_DMAMUX_REQ_SPI2_RX;
+    LL_DMA_Init(SPI_DMA_RX_DEF, &dma_config);
+
+    dma_config.MemoryOrM2MDstAddress = (uint32_t)(tx_buffer ? tx_buffer : &spi_dma_dummy_tx);
+    dma_config.Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+    dma_config.MemoryOrM2MDstIncMode =
+        tx_buffer ? LL_DMA_MEMORY_INCREMENT : LL_DMA_MEMORY_NOINCREMENT;
+    dma_config.PeriphRequest = spi1 ? LL_DMAMUX_REQ_SPI1_TX : LL_DMAMUX_REQ_SPI2_TX;
+    LL_DMA_Init(SPI_DMA_TX_DEF, &dma_config);
+
+    LL_DMA_ClearFlag_TC6(SPI_DMA);
+    LL_DMA_EnableIT_TC(SPI_DMA_RX_DEF);
+    furi_hal_interrupt_set_isr(SPI_DMA_RX_IRQ, spi_dma_isr, NULL);
+
+    // RX request goes first so no byte is missed, TX request starts the transfer
+    LL_SPI_EnableDMAReq_RX(spi);
+    LL_DMA_EnableChannel(SPI_DMA_RX_DEF);
+    LL_DMA_EnableChannel(SPI_DMA_TX_DEF);
+    LL_SPI_EnableDMAReq_TX(spi);
+
+    bool ret = (osSemaphoreAcquire(spi_dma_completed, timeout) == osOK);
+
+    LL_SPI_DisableDMAReq_TX(spi);
+    LL_SPI_DisableDMAReq_RX(spi);
+    LL_DMA_DisableChannel(SPI_DMA_TX_DEF);
+    LL_DMA_DisableChannel(SPI_DMA_RX_DEF);
+    LL_DMA_DisableIT_TC(SPI_DMA_RX_DEF);
+    furi_hal_interrupt_set_isr(SPI_DMA_RX_IRQ, NULL, NULL);
+
+    furi_hal_spi_bus_end_txrx(handle, timeout);
+    // Completion may have been signalled after the timeout
+    osSemaphoreAcquire(spi_dma_completed, 0);
+
+    furi_check(osMutexRelease(spi_dma_lock) == osOK);
+
+    return ret;
+}
@@ -17,6 +17,8 @@ extern "C" {
 #define FURI_HAL_NFC_UID_MAX_LEN 10
 #define FURI_HAL_NFC_DATA_BUFF_SIZE (64)
 #define FURI_HAL_NFC_PARITY_BUFF_SIZE (FURI_HAL_NFC_DATA_BUFF_SIZE / 8)
+#define FURI_HAL_NFC_BITSTREAM_BUFF_SIZE \
+    (FURI_HAL_NFC_DATA_BUFF_SIZE + FURI_HAL_NFC_PARITY_BUFF_SIZE)
 
 #define FURI_HAL_NFC_TXRX_DEFAULT                                                    \
     ((uint32_t)RFAL_TXRX_FLAGS_CRC_TX_AUTO | (uint32_t)RFAL_TXRX_FLAGS_CRC_RX_REMV | \
@@ -58,6 +60,8 @@ typedef struct {
     uint8_t rx_parity[FURI_HAL_NFC_PARITY_BUFF_SIZE];
     uint16_t rx_bits;
     uint32_t tx_rx_type;
+    // Raw frame with data and parity interleaved, used by furi_hal_nfc_tx_rx
+    uint8_t tx_bitstream[FURI_HAL_NFC_BITSTREAM_BUFF_SIZE];
 } FuriHalNfcTxRxContext;
 
 /** Init nfc
@@ -165,6 +169,8 @@ ReturnCode furi_hal_nfc_data_exchange(
     bool deactivate);
 
 /** NFC data exchange
+ *
+ * Context is reused between exchanges, raw frames are built in its own buffer.
  *
  * @param       tx_rx_ctx   FuriHalNfcTxRxContext instance
  *
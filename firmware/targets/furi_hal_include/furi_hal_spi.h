@@ -97,6 +97,26 @@ bool furi_hal_spi_bus_trx(
     size_t size,
     uint32_t timeout);
 
+/** SPI Transmit and Receive with DMA
+ *
+ * Blocks the calling thread until the transfer is done, falls back to
+ * polling when called from ISR or before the scheduler is started.
+ *
+ * @param      handle     pointer to FuriHalSpiBusHandle instance
+ * @param      tx_buffer  pointer to tx buffer, NULL to transmit 0xFF
+ * @param      rx_buffer  pointer to rx buffer, NULL to discard received data
+ * @param      size       transaction size (buffer size), up to 65535 bytes
+ * @param      timeout    operation timeout in ms
+ *
+ * @return     true on success
+ */
+bool furi_hal_spi_bus_trx_dma(
+    FuriHalSpiBusHandle* handle,
+    const uint8_t* tx_buffer,
+    uint8_t* rx_buffer,
+    size_t size,
+    uint32_t timeout);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
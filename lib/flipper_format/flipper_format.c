@@ -1,51 +1,260 @@
 #include <furi/check.h>
 #include <toolbox/stream/stream.h>
 #include <toolbox/stream/string_stream.h>
-#include <toolbox/stream/file_stream.h>
+#include <toolbox/stream/buffered_file_stream.h>
 #include "flipper_format.h"
 #include "flipper_format_i.h"
 #include "flipper_format_stream.h"
 #include "flipper_format_stream_i.h"
+#include "flipper_format_index.h"
 
 /********************************** Private **********************************/
+typedef enum {
+    FlipperFormatJournalUnknown, /* Stream was opened or handed out since the last check */
+    FlipperFormatJournalAbsent,
+    FlipperFormatJournalPresent,
+} FlipperFormatJournal;
+
 struct FlipperFormat {
     Stream* stream;
+    Storage* storage;
+    string_t path;
     bool strict_mode;
+    FlipperFormatUpdateMode update_mode;
+    FlipperFormatIndex* index;
+    FlipperFormatJournal journal;
+    // Stream size when the journal state was recorded, a changed size means unknown state
+    size_t journal_stream_size;
 };
 
 static const char* const flipper_format_filetype_key = "Filetype";
 static const char* const flipper_format_version_key = "Version";
+static const char* const flipper_format_temp_extension = ".tmp";
+
+static void
+    flipper_format_set_journal(FlipperFormat* flipper_format, FlipperFormatJournal journal) {
+    flipper_format->journal = journal;
+    flipper_format->journal_stream_size = stream_size(flipper_format->stream);
+}
 
 Stream* flipper_format_get_raw_stream(FlipperFormat* flipper_format) {
+    // Raw writes may bring a journal in
+    flipper_format->journal = FlipperFormatJournalUnknown;
     return flipper_format->stream;
 }
 
+static void flipper_format_invalidate_index(FlipperFormat* flipper_format) {
+    if(flipper_format->index) {
+        flipper_format_index_reset(flipper_format->index);
+    }
+}
+
+static bool flipper_format_file_open(
+    FlipperFormat* flipper_format,
+    const char* path,
+    FS_OpenMode open_mode) {
+    flipper_format_invalidate_index(flipper_format);
+    flipper_format->journal = FlipperFormatJournalUnknown;
+    string_set_str(flipper_format->path, path);
+    return buffered_file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, open_mode);
+}
+
+/* Compacted file is written next to the original and renamed over it, RAM use stays flat */
+static bool flipper_format_compact_file(FlipperFormat* flipper_format) {
+    bool result = false;
+    string_t temp_path;
+    string_init_printf(
+        temp_path, "%s%s", string_get_cstr(flipper_format->path), flipper_format_temp_extension);
+    Stream* compacted = buffered_file_stream_alloc(flipper_format->storage);
+
+    if(buffered_file_stream_open(
+           compacted, string_get_cstr(temp_path), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        result = flipper_format_stream_compact(flipper_format->stream, compacted);
+        if(!buffered_file_stream_close(compacted)) result = false;
+    }
+    stream_free(compacted);
+
+    if(result) {
+        const char* path = string_get_cstr(flipper_format->path);
+        buffered_file_stream_close(flipper_format->stream);
+        result = storage_simply_remove(flipper_format->storage, path) &&
+                 (storage_common_rename(
+                      flipper_format->storage, string_get_cstr(temp_path), path) == FSE_OK);
+        // Reopened either way, the original is still there if remove failed
+        if(!buffered_file_stream_open(
+               flipper_format->stream, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING) ||
+           !stream_seek(flipper_format->stream, 0, StreamOffsetFromEnd)) {
+            result = false;
+        }
+    } else {
+        storage_simply_remove(flipper_format->storage, string_get_cstr(temp_path));
+    }
+
+    string_clear(temp_path);
+    return result;
+}
+
+static bool flipper_format_compact_stream(FlipperFormat* flipper_format) {
+    bool result = false;
+    flipper_format_invalidate_index(flipper_format);
+    if(flipper_format->storage) {
+        result = flipper_format_compact_file(flipper_format);
+    } else {
+        Stream* compacted = string_stream_alloc();
+        result = flipper_format_stream_compact(flipper_format->stream, compacted);
+        if(result) {
+            stream_clean(flipper_format->stream);
+            result =
+                stream_copy_full(compacted, flipper_format->stream) == stream_size(compacted);
+        }
+        stream_free(compacted);
+    }
+
+    flipper_format_set_journal(
+        flipper_format, result ? FlipperFormatJournalAbsent : FlipperFormatJournalUnknown);
+    return result;
+}
+
+/** Journal presence, the stream is scanned at most once after it is opened */
+static bool flipper_format_has_journal(FlipperFormat* flipper_format) {
+    if(flipper_format->journal == FlipperFormatJournalUnknown ||
+       flipper_format->journal_stream_size != stream_size(flipper_format->stream)) {
+        bool journal = false;
+        if(!flipper_format->index ||
+           !flipper_format_index_get_journal(
+               flipper_format->index, flipper_format->stream, &journal)) {
+            journal = flipper_format_stream_has_journal(flipper_format->stream);
+        }
+        flipper_format_set_journal(
+            flipper_format, journal ? FlipperFormatJournalPresent : FlipperFormatJournalAbsent);
+    }
+    return flipper_format->journal == FlipperFormatJournalPresent;
+}
+
+/**
+ * Moves the stream to the line with the key, if index is enabled.
+ * @return false if the key is known to be missing, stream is at the end then
+ */
+static bool flipper_format_seek_to_key_indexed(
+    FlipperFormat* flipper_format,
+    const char* key,
+    bool strict_mode,
+    uint16_t* value_count) {
+    // Strict mode only looks at the next key, nothing to speed up
+    if(!flipper_format->index || strict_mode) return true;
+
+    FlipperFormatIndexResult result = flipper_format_index_seek_to_key(
+        flipper_format->index, flipper_format->stream, key, value_count);
+
+    // Index build has just seen the whole stream
+    bool journal;
+    if(flipper_format->journal == FlipperFormatJournalUnknown &&
+       flipper_format_index_get_journal(flipper_format->index, flipper_format->stream, &journal)) {
+        flipper_format_set_journal(
+            flipper_format, journal ? FlipperFormatJournalPresent : FlipperFormatJournalAbsent);
+    }
+
+    return result != FlipperFormatIndexMissing;
+}
+
+static bool flipper_format_read_value_line(
+    FlipperFormat* flipper_format,
+    const char* key,
+    FlipperStreamValue type,
+    void* data,
+    size_t data_size) {
+    if(!flipper_format_seek_to_key_indexed(
+           flipper_format, key, flipper_format->strict_mode, NULL)) {
+        return false;
+    }
+
+    return flipper_format_stream_read_value_line(
+        flipper_format->stream, key, type, data, data_size, flipper_format->strict_mode);
+}
+
+static bool flipper_format_write_value_line(
+    FlipperFormat* flipper_format,
+    FlipperStreamWriteData* write_data) {
+    flipper_format_invalidate_index(flipper_format);
+    bool result = flipper_format_stream_write_value_line(flipper_format->stream, write_data);
+    flipper_format->journal_stream_size = stream_size(flipper_format->stream);
+    return result;
+}
+
+static bool flipper_format_delete_key_and_write(
+    FlipperFormat* flipper_format,
+    FlipperStreamWriteData* write_data) {
+    bool result = false;
+
+    // Rewrite moves lines, journal keys are line offsets
+    if(flipper_format->update_mode == FlipperFormatUpdateModeRewrite &&
+       flipper_format_has_journal(flipper_format)) {
+        if(!flipper_format_compact_stream(flipper_format)) return false;
+    }
+
+    // Key is searched from the beginning of the file
+    if(stream_rewind(flipper_format->stream) &&
+       flipper_format_seek_to_key_indexed(
+           flipper_format, write_data->key, flipper_format->strict_mode, NULL)) {
+        if(flipper_format->update_mode == FlipperFormatUpdateModeInPlace) {
+            size_t size = stream_size(flipper_format->stream);
+            result = flipper_format_stream_update_key_in_place(
+                flipper_format->stream, write_data, flipper_format->strict_mode);
+            // Only a value that fits its line is written without tombstone and journal line
+            if(!result) {
+                flipper_format_set_journal(flipper_format, FlipperFormatJournalUnknown);
+            } else if(
+                write_data->type == FlipperStreamValueIgnore ||
+                stream_size(flipper_format->stream) != size) {
+                flipper_format_set_journal(flipper_format, FlipperFormatJournalPresent);
+            }
+        } else {
+            result = flipper_format_stream_delete_key_and_write(
+                flipper_format->stream, write_data, flipper_format->strict_mode);
+        }
+    }
+
+    // Own writes keep the recorded journal state
+    flipper_format->journal_stream_size = stream_size(flipper_format->stream);
+    flipper_format_invalidate_index(flipper_format);
+    return result;
+}
+
 /********************************** Public **********************************/
 
 FlipperFormat* flipper_format_string_alloc() {
     FlipperFormat* flipper_format = malloc(sizeof(FlipperFormat));
     flipper_format->stream = string_stream_alloc();
+    flipper_format->storage = NULL;
+    string_init(flipper_format->path);
     flipper_format->strict_mode = false;
+    flipper_format->update_mode = FlipperFormatUpdateModeRewrite;
+    flipper_format->index = NULL;
+    flipper_format->journal = FlipperFormatJournalUnknown;
     return flipper_format;
 }
 
 FlipperFormat* flipper_format_file_alloc(Storage* storage) {
     FlipperFormat* flipper_format = malloc(sizeof(FlipperFormat));
-    flipper_format->stream = file_stream_alloc(storage);
+    flipper_format->stream = buffered_file_stream_alloc(storage);
+    flipper_format->storage = storage;
+    string_init(flipper_format->path);
     flipper_format->strict_mode = false;
+    flipper_format->update_mode = FlipperFormatUpdateModeRewrite;
+    flipper_format->index = NULL;
+    flipper_format->journal = FlipperFormatJournalUnknown;
     return flipper_format;
 }
 
 bool flipper_format_file_open_existing(FlipperFormat* flipper_format, const char* path) {
     furi_assert(flipper_format);
-    return file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING);
+    return flipper_format_file_open(flipper_format, path, FSOM_OPEN_EXISTING);
 }
 
 bool flipper_format_file_open_append(FlipperFormat* flipper_format, const char* path) {
     furi_assert(flipper_format);
 
-    bool result =
-        file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_OPEN_APPEND);
+    bool result = flipper_format_file_open(flipper_format, path, FSOM_OPEN_APPEND);
 
     // Add EOL if it is not there
     if(stream_size(flipper_format->stream) >= 1) {
@@ -74,22 +283,28 @@ bool flipper_format_file_open_append(FlipperFormat* flipper_format, const char*
 
 bool flipper_format_file_open_always(FlipperFormat* flipper_format, const char* path) {
     furi_assert(flipper_format);
-    return file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS);
+    return flipper_format_file_open(flipper_format, path, FSOM_CREATE_ALWAYS);
 }
 
 bool flipper_format_file_open_new(FlipperFormat* flipper_format, const char* path) {
     furi_assert(flipper_format);
-    return file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_CREATE_NEW);
+    return flipper_format_file_open(flipper_format, path, FSOM_CREATE_NEW);
 }
 
 bool flipper_format_file_close(FlipperFormat* flipper_format) {
     furi_assert(flipper_format);
-    return file_stream_close(flipper_format->stream);
+    flipper_format_invalidate_index(flipper_format);
+    flipper_format->journal = FlipperFormatJournalUnknown;
+    return buffered_file_stream_close(flipper_format->stream);
 }
 
 void flipper_format_free(FlipperFormat* flipper_format) {
     furi_assert(flipper_format);
     stream_free(flipper_format->stream);
+    string_clear(flipper_format->path);
+    if(flipper_format->index) {
+        flipper_format_index_free(flipper_format->index);
+    }
     free(flipper_format);
 }
 
@@ -97,6 +312,26 @@ void flipper_format_set_strict_mode(FlipperFormat* flipper_format, bool strict_m
     flipper_format->strict_mode = strict_mode;
 }
 
+void flipper_format_set_key_index(FlipperFormat* flipper_format, bool enabled) {
+    furi_assert(flipper_format);
+    if(enabled && !flipper_format->index) {
+        flipper_format->index = flipper_format_index_alloc();
+    } else if(!enabled && flipper_format->index) {
+        flipper_format_index_free(flipper_format->index);
+        flipper_format->index = NULL;
+    }
+}
+
+void flipper_format_set_update_mode(FlipperFormat* flipper_format, FlipperFormatUpdateMode mode) {
+    furi_assert(flipper_format);
+    flipper_format->update_mode = mode;
+}
+
+bool flipper_format_compact(FlipperFormat* flipper_format) {
+    furi_assert(flipper_format);
+    return flipper_format_compact_stream(flipper_format);
+}
+
 bool flipper_format_rewind(FlipperFormat* flipper_format) {
     furi_assert(flipper_format);
     return stream_rewind(flipper_format->stream);
@@ -110,7 +345,8 @@ bool flipper_format_seek_to_end(FlipperFormat* flipper_format) {
 bool flipper_format_key_exist(FlipperFormat* flipper_format, const char* key) {
     size_t pos = stream_tell(flipper_format->stream);
     stream_seek(flipper_format->stream, 0, StreamOffsetFromStart);
-    bool result = flipper_format_stream_seek_to_key(flipper_format->stream, key, false);
+    bool result = flipper_format_seek_to_key_indexed(flipper_format, key, false, NULL) &&
+                  flipper_format_stream_seek_to_key(flipper_format->stream, key, false);
     stream_seek(flipper_format->stream, pos, StreamOffsetFromStart);
 
     return result;
@@ -148,14 +384,35 @@ bool flipper_format_get_value_count(
     const char* key,
     uint32_t* count) {
     furi_assert(flipper_format);
-    return flipper_format_stream_get_value_count(
-        flipper_format->stream, key, count, flipper_format->strict_mode);
+    if(!flipper_format->index || flipper_format->strict_mode) {
+        return flipper_format_stream_get_value_count(
+            flipper_format->stream, key, count, flipper_format->strict_mode);
+    }
+
+    bool result = false;
+    size_t position = stream_tell(flipper_format->stream);
+    uint16_t value_count = 0;
+
+    if(flipper_format_seek_to_key_indexed(flipper_format, key, false, &value_count)) {
+        if(value_count) {
+            *count = value_count;
+            result = true;
+        } else {
+            result =
+                flipper_format_stream_get_value_count(flipper_format->stream, key, count, false);
+        }
+    }
+
+    if(!stream_seek(flipper_format->stream, position, StreamOffsetFromStart)) {
+        result = false;
+    }
+
+    return result;
 }
 
 bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key, string_t data) {
     furi_assert(flipper_format);
-    return flipper_format_stream_read_value_line(
-        flipper_format->stream, key, FlipperStreamValueStr, data, 1, flipper_format->strict_mode);
+    return flipper_format_read_value_line(flipper_format, key, FlipperStreamValueStr, data, 1);
 }
 
 bool flipper_format_write_string(FlipperFormat* flipper_format, const char* key, string_t data) {
@@ -166,7 +423,7 @@ bool flipper_format_write_string(FlipperFormat* flipper_format, const char* key,
         .data = string_get_cstr(data),
         .data_size = 1,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -181,7 +438,7 @@ bool flipper_format_write_string_cstr(
         .data = data,
         .data_size = 1,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -191,13 +448,8 @@ bool flipper_format_read_uint32(
     uint32_t* data,
     const uint16_t data_size) {
     furi_assert(flipper_format);
-    return flipper_format_stream_read_value_line(
-        flipper_format->stream,
-        key,
-        FlipperStreamValueUint32,
-        data,
-        data_size,
-        flipper_format->strict_mode);
+    return flipper_format_read_value_line(
+        flipper_format, key, FlipperStreamValueUint32, data, data_size);
 }
 
 bool flipper_format_write_uint32(
@@ -212,7 +464,7 @@ bool flipper_format_write_uint32(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -221,13 +473,8 @@ bool flipper_format_read_int32(
     const char* key,
     int32_t* data,
     const uint16_t data_size) {
-    return flipper_format_stream_read_value_line(
-        flipper_format->stream,
-        key,
-        FlipperStreamValueInt32,
-        data,
-        data_size,
-        flipper_format->strict_mode);
+    return flipper_format_read_value_line(
+        flipper_format, key, FlipperStreamValueInt32, data, data_size);
 }
 
 bool flipper_format_write_int32(
@@ -242,7 +489,7 @@ bool flipper_format_write_int32(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -251,13 +498,8 @@ bool flipper_format_read_bool(
     const char* key,
     bool* data,
     const uint16_t data_size) {
-    return flipper_format_stream_read_value_line(
-        flipper_format->stream,
-        key,
-        FlipperStreamValueBool,
-        data,
-        data_size,
-        flipper_format->strict_mode);
+    return flipper_format_read_value_line(
+        flipper_format, key, FlipperStreamValueBool, data, data_size);
 }
 
 bool flipper_format_write_bool(
@@ -272,7 +514,7 @@ bool flipper_format_write_bool(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -281,13 +523,8 @@ bool flipper_format_read_float(
     const char* key,
     float* data,
     const uint16_t data_size) {
-    return flipper_format_stream_read_value_line(
-        flipper_format->stream,
-        key,
-        FlipperStreamValueFloat,
-        data,
-        data_size,
-        flipper_format->strict_mode);
+    return flipper_format_read_value_line(
+        flipper_format, key, FlipperStreamValueFloat, data, data_size);
 }
 
 bool flipper_format_write_float(
@@ -302,7 +539,7 @@ bool flipper_format_write_float(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -311,13 +548,8 @@ bool flipper_format_read_hex(
     const char* key,
     uint8_t* data,
     const uint16_t data_size) {
-    return flipper_format_stream_read_value_line(
-        flipper_format->stream,
-        key,
-        FlipperStreamValueHex,
-        data,
-        data_size,
-        flipper_format->strict_mode);
+    return flipper_format_read_value_line(
+        flipper_format, key, FlipperStreamValueHex, data, data_size);
 }
 
 bool flipper_format_write_hex(
@@ -332,7 +564,7 @@ bool flipper_format_write_hex(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_write_value_line(flipper_format->stream, &write_data);
+    bool result = flipper_format_write_value_line(flipper_format, &write_data);
     return result;
 }
 
@@ -343,6 +575,7 @@ bool flipper_format_write_comment(FlipperFormat* flipper_format, string_t data)
 
 bool flipper_format_write_comment_cstr(FlipperFormat* flipper_format, const char* data) {
     furi_assert(flipper_format);
+    flipper_format_invalidate_index(flipper_format);
     return flipper_format_stream_write_comment_cstr(flipper_format->stream, data);
 }
 
@@ -354,8 +587,7 @@ bool flipper_format_delete_key(FlipperFormat* flipper_format, const char* key) {
         .data = NULL,
         .data_size = 0,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -367,8 +599,7 @@ bool flipper_format_update_string(FlipperFormat* flipper_format, const char* key
         .data = string_get_cstr(data),
         .data_size = 1,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -383,8 +614,7 @@ bool flipper_format_update_string_cstr(
         .data = data,
         .data_size = 1,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -400,8 +630,7 @@ bool flipper_format_update_uint32(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -416,8 +645,7 @@ bool flipper_format_update_int32(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -432,8 +660,7 @@ bool flipper_format_update_bool(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -448,8 +675,7 @@ bool flipper_format_update_float(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
@@ -464,8 +690,7 @@ bool flipper_format_update_hex(
         .data = data,
         .data_size = data_size,
     };
-    bool result = flipper_format_stream_delete_key_and_write(
-        flipper_format->stream, &write_data, flipper_format->strict_mode);
+    bool result = flipper_format_delete_key_and_write(flipper_format, &write_data);
     return result;
 }
 
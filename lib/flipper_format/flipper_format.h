@@ -103,6 +103,11 @@ extern "C" {
 
 typedef struct FlipperFormat FlipperFormat;
 
+typedef enum {
+    FlipperFormatUpdateModeRewrite, /**< Updated line is replaced, rest of the file is moved */
+    FlipperFormatUpdateModeInPlace, /**< Updated line is overwritten or journaled */
+} FlipperFormatUpdateMode;
+
 /**
  * Allocate FlipperFormat as string.
  * @return FlipperFormat* pointer to a FlipperFormat instance
@@ -172,6 +177,37 @@ void flipper_format_free(FlipperFormat* flipper_format);
  */
 void flipper_format_set_strict_mode(FlipperFormat* flipper_format, bool strict_mode);
 
+/**
+ * Enable key offset index.
+ * Index is built with one pass over the file on the first key lookup and dropped on any write,
+ * after that reads, value counts and key checks seek straight to the key instead of scanning.
+ * Lookup semantics are the same: first key after the current position. Not used in strict mode.
+ * Do not write to the raw stream while the index is enabled.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @param enabled True to build and use the index. False by default.
+ */
+void flipper_format_set_key_index(FlipperFormat* flipper_format, bool enabled);
+
+/**
+ * Set the way update and delete functions change the file.
+ * In place mode writes a value that fits over the old one, padded with spaces, string values
+ * have to be of the same length. Other values go to a journal at the end of the file and the
+ * old line is marked as replaced, deleted lines are only marked. Files stay readable with the
+ * usual read functions, use flipper_format_compact to merge the journal back.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @param mode Update mode. FlipperFormatUpdateModeRewrite by default.
+ */
+void flipper_format_set_update_mode(FlipperFormat* flipper_format, FlipperFormatUpdateMode mode);
+
+/**
+ * Merge the journal left by in place updates back into the file.
+ * Files are compacted into a temporary file next to the original that then replaces it, the
+ * file stays open. Sets the RW pointer to the end of the file.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @return True on success
+ */
+bool flipper_format_compact(FlipperFormat* flipper_format);
+
 /**
  * Rewind the RW pointer.
  * @param flipper_format Pointer to a FlipperFormat instance
@@ -0,0 +1,350 @@
+#include <string.h>
+#include <stdlib.h>
+#include <furi/check.h>
+#include <toolbox/hex.h>
+#include "flipper_format_cursor.h"
+#include "flipper_format_i.h"
+#include "flipper_format_stream.h"
+#include "flipper_format_stream_i.h"
+
+#define FLIPPER_FORMAT_CURSOR_BUFFER_SIZE 64
+#define FLIPPER_FORMAT_CURSOR_TOKEN_SIZE 24
+
+typedef enum {
+    FlipperFormatCursorStateLineStart, /**< At the start of a line */
+    FlipperFormatCursorStateValue, /**< At the value of a key of the current record */
+    FlipperFormatCursorStateRecord, /**< At the value of the next record key */
+} FlipperFormatCursorState;
+
+struct FlipperFormatCursor {
+    Stream* stream;
+    const char* record_key;
+    FlipperFormatCursorState state;
+    char key[FLIPPER_FORMAT_CURSOR_KEY_SIZE];
+
+    uint8_t buffer[FLIPPER_FORMAT_CURSOR_BUFFER_SIZE];
+    size_t buffer_offset;
+    size_t buffer_size;
+    size_t buffer_position;
+
+    size_t line_offset;
+    size_t record_offset;
+};
+
+FlipperFormatCursor*
+    flipper_format_cursor_alloc(FlipperFormat* flipper_format, const char* record_key) {
+    furi_assert(flipper_format);
+    furi_assert(record_key);
+    furi_check(strlen(record_key) < FLIPPER_FORMAT_CURSOR_KEY_SIZE);
+
+    FlipperFormatCursor* cursor = malloc(sizeof(FlipperFormatCursor));
+    cursor->stream = flipper_format_get_raw_stream(flipper_format);
+    cursor->record_key = record_key;
+    cursor->state = FlipperFormatCursorStateLineStart;
+    cursor->buffer_offset = stream_tell(cursor->stream);
+    cursor->buffer_size = 0;
+    cursor->buffer_position = 0;
+    cursor->line_offset = cursor->buffer_offset;
+    cursor->record_offset = cursor->buffer_offset;
+    return cursor;
+}
+
+void flipper_format_cursor_free(FlipperFormatCursor* cursor) {
+    furi_assert(cursor);
+    // Give back what was read ahead
+    size_t unread = cursor->buffer_size - cursor->buffer_position;
+    if(unread) {
+        stream_seek(cursor->stream, -(int32_t)unread, StreamOffsetFromCurrent);
+    }
+    free(cursor);
+}
+
+static bool flipper_format_cursor_peek(FlipperFormatCursor* cursor, uint8_t* data) {
+    if(cursor->buffer_position == cursor->buffer_size) {
+        cursor->buffer_offset += cursor->buffer_size;
+        cursor->buffer_size =
+            stream_read(cursor->stream, cursor->buffer, FLIPPER_FORMAT_CURSOR_BUFFER_SIZE);
+        cursor->buffer_position = 0;
+        if(cursor->buffer_size == 0) return false;
+    }
+
+    *data = cursor->buffer[cursor->buffer_position];
+    return true;
+}
+
+static bool flipper_format_cursor_get(FlipperFormatCursor* cursor, uint8_t* data) {
+    if(!flipper_format_cursor_peek(cursor, data)) return false;
+    cursor->buffer_position++;
+    return true;
+}
+
+static inline size_t flipper_format_cursor_tell(FlipperFormatCursor* cursor) {
+    return cursor->buffer_offset + cursor->buffer_position;
+}
+
+static void flipper_format_cursor_skip_line(FlipperFormatCursor* cursor) {
+    uint8_t data;
+    while(flipper_format_cursor_get(cursor, &data)) {
+        if(data == flipper_format_eoln) break;
+    }
+    cursor->state = FlipperFormatCursorStateLineStart;
+}
+
+/*
+ * Reads the key of the next line that has one, same rules as flipper_format_stream:
+ * comment lines and lines starting with the delimiter have no key, CR is ignored.
+ * Cursor is left at the value, single space after the delimiter is skipped.
+ */
+static bool
+    flipper_format_cursor_read_key(FlipperFormatCursor* cursor, char* key, size_t key_size) {
+    uint8_t data;
+    size_t length = 0;
+    bool overflow = false;
+    cursor->line_offset = flipper_format_cursor_tell(cursor);
+
+    while(flipper_format_cursor_get(cursor, &data)) {
+        if(data == flipper_format_eoln) {
+            length = 0;
+            overflow = false;
+            cursor->line_offset = flipper_format_cursor_tell(cursor);
+        } else if(data == flipper_format_eolr) {
+            // Ignore
+        } else if(length == 0 && !overflow &&
+                  (data == flipper_format_comment || data == flipper_format_delimiter)) {
+            flipper_format_cursor_skip_line(cursor);
+            cursor->line_offset = flipper_format_cursor_tell(cursor);
+        } else if(data == flipper_format_delimiter) {
+            if(overflow) {
+                flipper_format_cursor_skip_line(cursor);
+                length = 0;
+                overflow = false;
+                cursor->line_offset = flipper_format_cursor_tell(cursor);
+                continue;
+            }
+
+            key[length] = '\0';
+            if(flipper_format_cursor_peek(cursor, &data) && data == ' ') {
+                cursor->buffer_position++;
+            }
+            return true;
+        } else if(length + 1 < key_size) {
+            key[length++] = data;
+        } else {
+            overflow = true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Reads one space separated value of the current line into a zero terminated buffer.
+ * Returns false when the line is over, EOL itself is not consumed.
+ */
+static bool flipper_format_cursor_read_token(
+    FlipperFormatCursor* cursor,
+    char* token,
+    size_t token_size,
+    bool* overflow) {
+    uint8_t data;
+    size_t length = 0;
+    *overflow = false;
+
+    while(flipper_format_cursor_peek(cursor, &data)) {
+        if(data == flipper_format_eoln) {
+            break;
+        } else if(data == ' ') {
+            cursor->buffer_position++;
+            if(length) break;
+        } else if(data == flipper_format_eolr) {
+            cursor->buffer_position++;
+        } else {
+            cursor->buffer_position++;
+            if(length + 1 < token_size) {
+                token[length++] = data;
+            } else {
+                *overflow = true;
+            }
+        }
+    }
+
+    token[length] = '\0';
+    return length > 0;
+}
+
+static bool flipper_format_cursor_parse_token(
+    const char* token,
+    FlipperStreamValue type,
+    void* data,
+    size_t index) {
+    char* end = NULL;
+    bool result = false;
+
+    switch(type) {
+    case FlipperStreamValueHex:
+        result = (strlen(token) == 2) &&
+                 hex_chars_to_uint8(token[0], token[1], &((uint8_t*)data)[index]);
+        break;
+    case FlipperStreamValueFloat:
+        ((float*)data)[index] = strtof(token, &end);
+        result = (*end == '\0');
+        break;
+    case FlipperStreamValueInt32:
+        ((int32_t*)data)[index] = strtol(token, &end, 10);
+        result = (*end == '\0');
+        break;
+    case FlipperStreamValueUint32:
+        ((uint32_t*)data)[index] = strtoul(token, &end, 10);
+        result = (token[0] != '-') && (*end == '\0');
+        break;
+    default:
+        furi_crash("Unknown FF type");
+    }
+
+    return result;
+}
+
+static bool flipper_format_cursor_read_values(
+    FlipperFormatCursor* cursor,
+    FlipperStreamValue type,
+    void* data,
+    size_t data_size,
+    size_t* count) {
+    furi_assert(cursor);
+    if(count) *count = 0;
+    if(cursor->state != FlipperFormatCursorStateValue) return false;
+
+    char token[FLIPPER_FORMAT_CURSOR_TOKEN_SIZE];
+    bool overflow = false;
+    bool result = true;
+    size_t index = 0;
+
+    while(flipper_format_cursor_read_token(cursor, token, sizeof(token), &overflow)) {
+        if(overflow || index == data_size ||
+           !flipper_format_cursor_parse_token(token, type, data, index)) {
+            result = false;
+            break;
+        }
+        index++;
+    }
+
+    flipper_format_cursor_skip_line(cursor);
+    if(count) *count = index;
+    return result && index > 0;
+}
+
+bool flipper_format_cursor_next_record(
+    FlipperFormatCursor* cursor,
+    char* value,
+    size_t value_size) {
+    furi_assert(cursor);
+
+    while(true) {
+        if(cursor->state == FlipperFormatCursorStateRecord) {
+            cursor->state = FlipperFormatCursorStateValue;
+            if(flipper_format_cursor_read_string(cursor, value, value_size)) return true;
+        } else if(cursor->state == FlipperFormatCursorStateValue) {
+            flipper_format_cursor_skip_line(cursor);
+        }
+
+        if(!flipper_format_cursor_read_key(cursor, cursor->key, sizeof(cursor->key))) break;
+        if(strcmp(cursor->key, cursor->record_key) == 0) {
+            cursor->state = FlipperFormatCursorStateRecord;
+            cursor->record_offset = cursor->line_offset;
+        } else {
+            cursor->state = FlipperFormatCursorStateValue;
+        }
+    }
+
+    cursor->state = FlipperFormatCursorStateLineStart;
+    return false;
+}
+
+bool flipper_format_cursor_next_key(FlipperFormatCursor* cursor, char* key, size_t key_size) {
+    furi_assert(cursor);
+    furi_assert(key);
+
+    if(cursor->state == FlipperFormatCursorStateRecord) return false;
+    if(cursor->state == FlipperFormatCursorStateValue) flipper_format_cursor_skip_line(cursor);
+
+    if(!flipper_format_cursor_read_key(cursor, key, key_size)) return false;
+
+    if(strcmp(key, cursor->record_key) == 0) {
+        cursor->state = FlipperFormatCursorStateRecord;
+        cursor->record_offset = cursor->line_offset;
+        return false;
+    }
+
+    cursor->state = FlipperFormatCursorStateValue;
+    return true;
+}
+
+size_t flipper_format_cursor_get_record_offset(FlipperFormatCursor* cursor) {
+    furi_assert(cursor);
+    return cursor->record_offset;
+}
+
+bool flipper_format_cursor_read_string(
+    FlipperFormatCursor* cursor,
+    char* value,
+    size_t value_size) {
+    furi_assert(cursor);
+    furi_assert(value);
+    furi_assert(value_size);
+    if(cursor->state != FlipperFormatCursorStateValue) return false;
+
+    uint8_t data;
+    size_t length = 0;
+    bool overflow = false;
+
+    while(flipper_format_cursor_get(cursor, &data)) {
+        if(data == flipper_format_eoln) break;
+        if(data == flipper_format_eolr) continue;
+
+        if(length + 1 < value_size) {
+            value[length++] = data;
+        } else {
+            overflow = true;
+        }
+    }
+
+    value[length] = '\0';
+    cursor->state = FlipperFormatCursorStateLineStart;
+    return !overflow && length > 0;
+}
+
+bool flipper_format_cursor_read_uint32(
+    FlipperFormatCursor* cursor,
+    uint32_t* data,
+    size_t data_size,
+    size_t* count) {
+    return flipper_format_cursor_read_values(
+        cursor, FlipperStreamValueUint32, data, data_size, count);
+}
+
+bool flipper_format_cursor_read_int32(
+    FlipperFormatCursor* cursor,
+    int32_t* data,
+    size_t data_size,
+    size_t* count) {
+    return flipper_format_cursor_read_values(
+        cursor, FlipperStreamValueInt32, data, data_size, count);
+}
+
+bool flipper_format_cursor_read_float(
+    FlipperFormatCursor* cursor,
+    float* data,
+    size_t data_size,
+    size_t* count) {
+    return flipper_format_cursor_read_values(
+        cursor, FlipperStreamValueFloat, data, data_size, count);
+}
+
+bool flipper_format_cursor_read_hex(
+    FlipperFormatCursor* cursor,
+    uint8_t* data,
+    size_t data_size,
+    size_t* count) {
+    return flipper_format_cursor_read_values(
+        cursor, FlipperStreamValueHex, data, data_size, count);
+}
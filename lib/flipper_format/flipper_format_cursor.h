@@ -0,0 +1,168 @@
+/**
+ * @file flipper_format_cursor.h
+ * Flipper File Format record cursor
+ *
+ * Forward-only reader for files made of repeated records, like infrared
+ * remotes and libraries. A record starts with a line holding the record
+ * key ("name" for infrared) and lasts until the next such line.
+ *
+ * Cursor does not allocate after creation: keys and values are decoded
+ * straight into caller buffers and values that are not read are skipped
+ * without parsing. Journal left by in place updates is not resolved, compact
+ * the file first.
+ *
+ * @code
+ * FlipperFormatCursor* cursor = flipper_format_cursor_alloc(flipper_format, "name");
+ * char name[32];
+ * char key[16];
+ * while(flipper_format_cursor_next_record(cursor, name, sizeof(name))) {
+ *     if(strcmp(name, wanted_name)) continue;
+ *     while(flipper_format_cursor_next_key(cursor, key, sizeof(key))) {
+ *         if(!strcmp(key, "frequency")) {
+ *             flipper_format_cursor_read_uint32(cursor, &frequency, 1, NULL);
+ *         }
+ *     }
+ * }
+ * flipper_format_cursor_free(cursor);
+ * @endcode
+ */
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "flipper_format.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum length of the record key, including the terminating zero */
+#define FLIPPER_FORMAT_CURSOR_KEY_SIZE 32
+
+typedef struct FlipperFormatCursor FlipperFormatCursor;
+
+/**
+ * Allocate cursor. Cursor starts at the current position of the FlipperFormat.
+ * Do not use the FlipperFormat instance until the cursor is freed.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @param record_key Key that starts a record, must outlive the cursor
+ * @return FlipperFormatCursor*
+ */
+FlipperFormatCursor*
+    flipper_format_cursor_alloc(FlipperFormat* flipper_format, const char* record_key);
+
+/**
+ * Free cursor. FlipperFormat is left at the cursor position.
+ * @param cursor
+ */
+void flipper_format_cursor_free(FlipperFormatCursor* cursor);
+
+/**
+ * Move to the next record, the rest of the current one is skipped without parsing.
+ * Records with a value that does not fit into the buffer are skipped too.
+ * @param cursor
+ * @param value Buffer for the record key value
+ * @param value_size Buffer size, including the terminating zero
+ * @return true record found
+ * @return false end of file
+ */
+bool flipper_format_cursor_next_record(
+    FlipperFormatCursor* cursor,
+    char* value,
+    size_t value_size);
+
+/**
+ * Move to the next key of the current record. Value of the previous key is skipped if it was
+ * not read. Lines with keys that do not fit into the buffer are skipped.
+ * @param cursor
+ * @param key Buffer for the key
+ * @param key_size Buffer size, including the terminating zero
+ * @return true key found
+ * @return false end of the record or end of file
+ */
+bool flipper_format_cursor_next_key(FlipperFormatCursor* cursor, char* key, size_t key_size);
+
+/**
+ * Get offset of the line holding the record key of the current record. Seeking the raw
+ * stream there and reading the record key with FlipperFormat gives the same record.
+ * @param cursor
+ * @return size_t offset from the start of the stream
+ */
+size_t flipper_format_cursor_get_record_offset(FlipperFormatCursor* cursor);
+
+/**
+ * Read the value of the current key as a string
+ * @param cursor
+ * @param value Buffer for the value
+ * @param value_size Buffer size, including the terminating zero
+ * @return true on success
+ * @return false value is empty, too long or already read
+ */
+bool flipper_format_cursor_read_string(
+    FlipperFormatCursor* cursor,
+    char* value,
+    size_t value_size);
+
+/**
+ * Read the values of the current key as uint32
+ * @param cursor
+ * @param data Buffer for the values
+ * @param data_size Buffer size in values
+ * @param count Number of values read, can be NULL
+ * @return true on success
+ * @return false values are malformed, there are more values than fit, or already read
+ */
+bool flipper_format_cursor_read_uint32(
+    FlipperFormatCursor* cursor,
+    uint32_t* data,
+    size_t data_size,
+    size_t* count);
+
+/**
+ * Read the values of the current key as int32
+ * @param cursor
+ * @param data Buffer for the values
+ * @param data_size Buffer size in values
+ * @param count Number of values read, can be NULL
+ * @return true on success
+ * @return false values are malformed, there are more values than fit, or already read
+ */
+bool flipper_format_cursor_read_int32(
+    FlipperFormatCursor* cursor,
+    int32_t* data,
+    size_t data_size,
+    size_t* count);
+
+/**
+ * Read the values of the current key as float
+ * @param cursor
+ * @param data Buffer for the values
+ * @param data_size Buffer size in values
+ * @param count Number of values read, can be NULL
+ * @return true on success
+ * @return false values are malformed, there are more values than fit, or already read
+ */
+bool flipper_format_cursor_read_float(
+    FlipperFormatCursor* cursor,
+    float* data,
+    size_t data_size,
+    size_t* count);
+
+/**
+ * Read the values of the current key as hex bytes
+ * @param cursor
+ * @param data Buffer for the values
+ * @param data_size Buffer size in bytes
+ * @param count Number of bytes read, can be NULL
+ * @return true on success
+ * @return false values are malformed, there are more values than fit, or already read
+ */
+bool flipper_format_cursor_read_hex(
+    FlipperFormatCursor* cursor,
+    uint8_t* data,
+    size_t data_size,
+    size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,277 @@
+#include <string.h>
+#include <furi/check.h>
+#include <fnv1a-hash.h>
+#include "flipper_format_index.h"
+#include "flipper_format_stream_i.h"
+
+#define FLIPPER_FORMAT_INDEX_READ_SIZE 64
+#define FLIPPER_FORMAT_INDEX_INITIAL_CAPACITY 16
+
+typedef struct {
+    uint32_t offset;
+    uint16_t hash;
+    uint16_t value_count;
+} FlipperFormatIndexEntry;
+
+struct FlipperFormatIndex {
+    FlipperFormatIndexEntry* entries;
+    size_t count;
+    size_t capacity;
+    size_t stream_size;
+    bool valid;
+    bool overflow;
+    bool journal;
+};
+
+typedef enum {
+    FlipperFormatIndexScanLineStart,
+    FlipperFormatIndexScanKey,
+    FlipperFormatIndexScanDelimiter,
+    FlipperFormatIndexScanValue,
+    FlipperFormatIndexScanSkip,
+} FlipperFormatIndexScan;
+
+FlipperFormatIndex* flipper_format_index_alloc() {
+    FlipperFormatIndex* index = malloc(sizeof(FlipperFormatIndex));
+    index->entries = NULL;
+    index->count = 0;
+    index->capacity = 0;
+    index->stream_size = 0;
+    index->valid = false;
+    index->overflow = false;
+    index->journal = false;
+    return index;
+}
+
+void flipper_format_index_free(FlipperFormatIndex* index) {
+    furi_assert(index);
+    free(index->entries);
+    free(index);
+}
+
+void flipper_format_index_reset(FlipperFormatIndex* index) {
+    furi_assert(index);
+    index->count = 0;
+    index->valid = false;
+}
+
+static inline uint32_t flipper_format_index_hash_step(uint32_t hash, uint8_t data) {
+    return fnv1a_buffer_hash(&data, 1, hash);
+}
+
+static inline uint16_t flipper_format_index_hash_fold(uint32_t hash) {
+    return (hash >> 16) ^ (hash & 0xFFFF);
+}
+
+static uint16_t flipper_format_index_hash(const char* key) {
+    return flipper_format_index_hash_fold(
+        fnv1a_buffer_hash((const uint8_t*)key, strlen(key), FNV_1A_INIT));
+}
+
+static bool flipper_format_index_push(FlipperFormatIndex* index, uint32_t offset, uint16_t hash) {
+    if(index->count == FLIPPER_FORMAT_INDEX_MAX_ENTRIES) {
+        index->overflow = true;
+        return false;
+    }
+
+    if(index->count == index->capacity) {
+        index->capacity = index->capacity ? index->capacity * 2 :
+                                            FLIPPER_FORMAT_INDEX_INITIAL_CAPACITY;
+        index->entries =
+            realloc(index->entries, index->capacity * sizeof(FlipperFormatIndexEntry));
+    }
+
+    FlipperFormatIndexEntry* entry = &index->entries[index->count++];
+    entry->offset = offset;
+    entry->hash = hash;
+    entry->value_count = 0;
+    return true;
+}
+
+static int flipper_format_index_compare(const void* a, const void* b) {
+    const FlipperFormatIndexEntry* entry_a = a;
+    const FlipperFormatIndexEntry* entry_b = b;
+    if(entry_a->hash != entry_b->hash) return entry_a->hash < entry_b->hash ? -1 : 1;
+    if(entry_a->offset != entry_b->offset) return entry_a->offset < entry_b->offset ? -1 : 1;
+    return 0;
+}
+
+/*
+ * One pass over the stream, follows the same rules as flipper_format_stream_seek_to_key:
+ * a key is everything from the line start up to the delimiter, comment lines and lines
+ * starting with a delimiter are skipped, CR is ignored. Value count follows the
+ * flipper_format_stream_get_value_count rules, lines it would fail on are stored with 0.
+ * Streams with a journal left by in place updates are not indexed.
+ */
+static void flipper_format_index_build(FlipperFormatIndex* index, Stream* stream) {
+    uint8_t buffer[FLIPPER_FORMAT_INDEX_READ_SIZE];
+    FlipperFormatIndexScan scan = FlipperFormatIndexScanLineStart;
+    FlipperFormatIndexEntry* entry = NULL;
+    uint32_t offset = 0;
+    uint32_t line_start = 0;
+    uint32_t hash = FNV_1A_INIT;
+    uint32_t value_count = 0;
+    bool in_value = false;
+
+    index->count = 0;
+    index->overflow = false;
+    index->journal = false;
+    index->stream_size = stream_size(stream);
+    index->valid = true;
+
+    if(!stream_rewind(stream)) {
+        index->valid = false;
+        return;
+    }
+
+    while(!index->overflow) {
+        size_t was_read = stream_read(stream, buffer, FLIPPER_FORMAT_INDEX_READ_SIZE);
+        if(was_read == 0) break;
+
+        for(size_t i = 0; i < was_read; i++, offset++) {
+            uint8_t data = buffer[i];
+
+            if(data == flipper_format_eoln) {
+                if(scan == FlipperFormatIndexScanValue) {
+                    // Spaces before EOL are padding left by in place update
+                    if(in_value) value_count++;
+                    if(value_count <= UINT16_MAX) entry->value_count = value_count;
+                }
+                scan = FlipperFormatIndexScanLineStart;
+                line_start = offset + 1;
+                continue;
+            }
+
+            if(scan == FlipperFormatIndexScanDelimiter) {
+                // seek_to_key skips the symbol after the delimiter, whatever it is
+                scan = FlipperFormatIndexScanValue;
+                value_count = 0;
+                in_value = false;
+                continue;
+            }
+
+            if(data == flipper_format_eolr) continue;
+
+            switch(scan) {
+            case FlipperFormatIndexScanLineStart:
+                if(data == flipper_format_tombstone) {
+                    // Journal is resolved by the stream scan only, don't use the index
+                    index->journal = true;
+                    index->overflow = true;
+                } else if(data == flipper_format_comment || data == flipper_format_delimiter) {
+                    scan = FlipperFormatIndexScanSkip;
+                } else {
+                    hash = flipper_format_index_hash_step(FNV_1A_INIT, data);
+                    scan = FlipperFormatIndexScanKey;
+                }
+                break;
+            case FlipperFormatIndexScanKey:
+                if(data == flipper_format_tombstone) {
+                    index->journal = true;
+                    index->overflow = true;
+                } else if(data == flipper_format_delimiter) {
+                    if(!flipper_format_index_push(
+                           index, line_start, flipper_format_index_hash_fold(hash))) {
+                        break;
+                    }
+                    entry = &index->entries[index->count - 1];
+                    scan = FlipperFormatIndexScanDelimiter;
+                } else {
+                    hash = flipper_format_index_hash_step(hash, data);
+                }
+                break;
+            case FlipperFormatIndexScanValue:
+                if(data == ' ') {
+                    if(in_value) value_count++;
+                    in_value = false;
+                } else {
+                    in_value = true;
+                }
+                break;
+            default:
+                break;
+            }
+
+            if(index->overflow) break;
+        }
+    }
+
+    // Last value may end with EOF instead of EOL
+    if(scan == FlipperFormatIndexScanValue && !index->overflow) {
+        if(in_value) value_count++;
+        if(value_count <= UINT16_MAX) entry->value_count = value_count;
+    }
+
+    if(!index->overflow) {
+        if(index->count) {
+            qsort(
+                index->entries,
+                index->count,
+                sizeof(FlipperFormatIndexEntry),
+                flipper_format_index_compare);
+        }
+    } else {
+        // Not going to be used until the stream changes
+        free(index->entries);
+        index->entries = NULL;
+        index->count = 0;
+        index->capacity = 0;
+    }
+}
+
+FlipperFormatIndexResult flipper_format_index_seek_to_key(
+    FlipperFormatIndex* index,
+    Stream* stream,
+    const char* key,
+    uint16_t* value_count) {
+    furi_assert(index);
+    size_t position = stream_tell(stream);
+
+    if(!index->valid || index->stream_size != stream_size(stream)) {
+        flipper_format_index_build(index, stream);
+        if(!index->valid || index->overflow) {
+            stream_seek(stream, position, StreamOffsetFromStart);
+            return FlipperFormatIndexUnavailable;
+        }
+    } else if(index->overflow) {
+        return FlipperFormatIndexUnavailable;
+    }
+
+    // Lower bound of (hash, position)
+    FlipperFormatIndexEntry target = {.offset = position, .hash = flipper_format_index_hash(key)};
+    size_t left = 0;
+    size_t right = index->count;
+    while(left < right) {
+        size_t middle = left + (right - left) / 2;
+        if(flipper_format_index_compare(&index->entries[middle], &target) < 0) {
+            left = middle + 1;
+        } else {
+            right = middle;
+        }
+    }
+
+    // Check the key itself, different keys may share the hash
+    for(size_t i = left; i < index->count && index->entries[i].hash == target.hash; i++) {
+        if(!stream_seek(stream, index->entries[i].offset, StreamOffsetFromStart)) break;
+        if(flipper_format_stream_seek_to_key(stream, key, true)) {
+            stream_seek(stream, index->entries[i].offset, StreamOffsetFromStart);
+            if(value_count) *value_count = index->entries[i].value_count;
+            return FlipperFormatIndexFound;
+        }
+    }
+
+    stream_seek(stream, 0, StreamOffsetFromEnd);
+    return FlipperFormatIndexMissing;
+}
+
+bool flipper_format_index_get_journal(FlipperFormatIndex* index, Stream* stream, bool* journal) {
+    furi_assert(index);
+    // Build stops at the key limit before it can tell
+    if(!index->valid || index->stream_size != stream_size(stream) ||
+       (index->overflow && !index->journal)) {
+        return false;
+    }
+
+    *journal = index->journal;
+    return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <stdlib.h>
+#include <stdbool.h>
+#include <toolbox/stream/stream.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Index does not grow beyond this number of keys, larger files are scanned */
+#define FLIPPER_FORMAT_INDEX_MAX_ENTRIES 4096
+
+typedef struct FlipperFormatIndex FlipperFormatIndex;
+
+typedef enum {
+    FlipperFormatIndexFound, /**< Stream is at the start of the key line */
+    FlipperFormatIndexMissing, /**< No such key after current position, stream is at the end */
+    FlipperFormatIndexUnavailable, /**< Index can't be used, stream position is unchanged */
+} FlipperFormatIndexResult;
+
+/**
+ * Allocate key offset index
+ * @return FlipperFormatIndex*
+ */
+FlipperFormatIndex* flipper_format_index_alloc();
+
+/**
+ * Free key offset index
+ * @param index
+ */
+void flipper_format_index_free(FlipperFormatIndex* index);
+
+/**
+ * Drop index contents, next lookup will rebuild it
+ * @param index
+ */
+void flipper_format_index_reset(FlipperFormatIndex* index);
+
+/**
+ * Moves the stream to the first line at or after the current position that holds the key.
+ * Builds the index with one pass over the stream if it is not built yet or the stream size
+ * has changed.
+ * @param index
+ * @param stream
+ * @param key
+ * @param value_count value count of the found key, 0 if it can't be known without parsing
+ * @return FlipperFormatIndexResult
+ */
+FlipperFormatIndexResult flipper_format_index_seek_to_key(
+    FlipperFormatIndex* index,
+    Stream* stream,
+    const char* key,
+    uint16_t* value_count);
+
+/**
+ * Tells if the stream has a journal left by in place updates, as seen by the last index build
+ * @param index
+ * @param stream
+ * @param journal
+ * @return false if the index is not built for the stream or could not tell
+ */
+bool flipper_format_index_get_journal(FlipperFormatIndex* index, Stream* stream, bool* journal);
+
+#ifdef __cplusplus
+}
+#endif
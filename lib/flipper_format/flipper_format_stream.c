@@ -1,9 +1,17 @@
 #include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <strings.h>
 #include <toolbox/hex.h>
 #include <furi/check.h>
 #include "flipper_format_stream.h"
 #include "flipper_format_stream_i.h"
 
+#define FLIPPER_FORMAT_STREAM_READ_SIZE 64
+#define FLIPPER_FORMAT_STREAM_WRITE_SIZE 128
+/** Longest value: "%f" of -FLT_MAX is 47 symbols */
+#define FLIPPER_FORMAT_STREAM_TOKEN_SIZE 48
+
 static bool flipper_format_stream_write(Stream* stream, const void* data, size_t data_size) {
     size_t bytes_written = stream_write(stream, data, data_size);
     return bytes_written == data_size;
@@ -26,8 +34,10 @@ bool flipper_format_stream_write_eol(Stream* stream) {
     return flipper_format_stream_write(stream, &flipper_format_eoln, 1);
 }
 
-static bool flipper_format_stream_read_valid_key(Stream* stream, string_t key) {
+static bool
+    flipper_format_stream_read_valid_key(Stream* stream, string_t key, bool* tombstone) {
     string_reset(key);
+    *tombstone = false;
     const size_t buffer_size = 32;
     uint8_t buffer[buffer_size];
 
@@ -77,6 +87,16 @@ static bool flipper_format_stream_read_valid_key(Stream* stream, string_t key) {
                         break;
                     }
                 }
+            } else if(data == flipper_format_tombstone && accumulate && string_size(key)) {
+                // key of the line that was replaced or deleted in place, stop at the tombstone
+                if(!stream_seek(stream, i - was_read, StreamOffsetFromCurrent)) {
+                    error = true;
+                    break;
+                }
+
+                *tombstone = true;
+                found = true;
+                break;
             } else {
                 // just new symbol, reset the new_line flag
                 new_line = false;
@@ -93,17 +113,73 @@ static bool flipper_format_stream_read_valid_key(Stream* stream, string_t key) {
     return found;
 }
 
-bool flipper_format_stream_seek_to_key(Stream* stream, const char* key, bool strict_mode) {
+static bool flipper_format_stream_seek_to_next_line(Stream* stream);
+static size_t flipper_format_stream_format_uint32(char* buffer, uint32_t value);
+
+static void flipper_format_stream_journal_key(char* journal_key, size_t tombstone) {
+    journal_key[0] = flipper_format_tombstone;
+    size_t length = flipper_format_stream_format_uint32(journal_key + 1, tombstone);
+    journal_key[length + 1] = '\0';
+}
+
+/*
+ * Looks up the journal line of the replaced line, journal is at the end of the stream.
+ * Stream is left at the journal value if it is found, at the resume position otherwise.
+ */
+static bool flipper_format_stream_seek_to_journal(
+    Stream* stream,
+    size_t tombstone,
+    FlipperFormatStreamKey* key_position) {
+    size_t resume = stream_tell(stream);
+    char journal_key[FLIPPER_FORMAT_STREAM_JOURNAL_KEY_SIZE];
+    flipper_format_stream_journal_key(journal_key, tombstone);
+
+    if(flipper_format_stream_seek_to_key_ex(stream, journal_key, false, key_position)) {
+        key_position->tombstone = tombstone;
+        key_position->resume = resume;
+        key_position->journal = true;
+        return true;
+    }
+
+    // No journal line, key is deleted
+    stream_seek(stream, resume, StreamOffsetFromStart);
+    return false;
+}
+
+bool flipper_format_stream_seek_to_key_ex(
+    Stream* stream,
+    const char* key,
+    bool strict_mode,
+    FlipperFormatStreamKey* key_position) {
     bool found = false;
+    bool tombstone = false;
+    size_t key_length = strlen(key);
     string_t read_key;
 
     string_init(read_key);
 
     while(!stream_eof(stream)) {
-        if(flipper_format_stream_read_valid_key(stream, read_key)) {
-            if(string_cmp_str(read_key, key) == 0) {
+        if(flipper_format_stream_read_valid_key(stream, read_key, &tombstone)) {
+            bool match = (string_cmp_str(read_key, key) == 0);
+            if(tombstone) {
+                // Replaced or deleted lines are skipped like comments, even in strict mode.
+                // Replaced journal lines are superseded by a later line with the same key.
+                size_t line_start = stream_tell(stream) - key_length;
+                if(!flipper_format_stream_seek_to_next_line(stream)) break;
+                if(!stream_eof(stream) && !stream_seek(stream, 1, StreamOffsetFromCurrent)) break;
+
+                if(match && key[0] != flipper_format_tombstone &&
+                   flipper_format_stream_seek_to_journal(stream, line_start, key_position)) {
+                    found = true;
+                    break;
+                }
+            } else if(match) {
                 if(!stream_seek(stream, 2, StreamOffsetFromCurrent)) break;
 
+                key_position->line_start = stream_tell(stream) - key_length - 2;
+                key_position->tombstone = 0;
+                key_position->resume = 0;
+                key_position->journal = false;
                 found = true;
                 break;
             } else if(strict_mode) {
@@ -117,60 +193,204 @@ bool flipper_format_stream_seek_to_key(Stream* stream, const char* key, bool str
     return found;
 }
 
-static bool flipper_format_stream_read_value(Stream* stream, string_t value, bool* last) {
-    string_reset(value);
-    const size_t buffer_size = 32;
-    uint8_t buffer[buffer_size];
-    bool result = false;
-    bool error = false;
+bool flipper_format_stream_seek_to_key(Stream* stream, const char* key, bool strict_mode) {
+    FlipperFormatStreamKey key_position;
+    return flipper_format_stream_seek_to_key_ex(stream, key, strict_mode, &key_position);
+}
 
-    while(true) {
-        size_t was_read = stream_read(stream, buffer, buffer_size);
+typedef struct {
+    Stream* stream;
+    uint8_t buffer[FLIPPER_FORMAT_STREAM_READ_SIZE];
+    size_t size;
+    size_t position;
+} FlipperFormatStreamReader;
+
+static void flipper_format_stream_reader_init(FlipperFormatStreamReader* reader, Stream* stream) {
+    reader->stream = stream;
+    reader->size = 0;
+    reader->position = 0;
+}
 
-        if(was_read == 0) {
-            // check EOF
-            if(stream_eof(stream) && string_size(value) > 0) {
-                result = true;
-                *last = true;
+static bool flipper_format_stream_reader_peek(FlipperFormatStreamReader* reader, uint8_t* data) {
+    if(reader->position == reader->size) {
+        reader->size =
+            stream_read(reader->stream, reader->buffer, FLIPPER_FORMAT_STREAM_READ_SIZE);
+        reader->position = 0;
+        if(reader->size == 0) return false;
+    }
+
+    *data = reader->buffer[reader->position];
+    return true;
+}
+
+/** Puts the stream right after the last consumed symbol */
+static bool flipper_format_stream_reader_done(FlipperFormatStreamReader* reader) {
+    size_t unread = reader->size - reader->position;
+    reader->size = 0;
+    reader->position = 0;
+    if(unread == 0) return true;
+    return stream_seek(reader->stream, -(int32_t)unread, StreamOffsetFromCurrent);
+}
+
+/*
+ * Reads one space separated value into a zero terminated buffer, the separator itself is
+ * not consumed. Leading spaces are skipped and CR is ignored. Value that does not fit is
+ * truncated and reported with the overflow flag.
+ */
+static bool flipper_format_stream_read_token(
+    FlipperFormatStreamReader* reader,
+    char* token,
+    size_t token_size,
+    bool* last,
+    bool* overflow) {
+    size_t length = 0;
+    uint8_t data;
+    *overflow = false;
+
+    while(true) {
+        if(!flipper_format_stream_reader_peek(reader, &data)) {
+            // EOF
+            *last = true;
+            break;
+        } else if(data == flipper_format_eoln) {
+            *last = true;
+            break;
+        } else if(data == ' ') {
+            if(length > 0) {
+                *last = false;
                 break;
             }
+        } else if(data != flipper_format_eolr) {
+            if(length + 1 < token_size) {
+                token[length++] = data;
+            } else {
+                *overflow = true;
+            }
         }
+        reader->position++;
+    }
 
-        for(uint16_t i = 0; i < was_read; i++) {
-            uint8_t data = buffer[i];
-            if(data == flipper_format_eoln) {
-                if(string_size(value) > 0) {
-                    if(!stream_seek(stream, i - was_read, StreamOffsetFromCurrent)) {
-                        error = true;
-                        break;
-                    }
+    token[length] = '\0';
+    return length > 0;
+}
 
-                    result = true;
-                    *last = true;
-                    break;
-                } else {
-                    error = true;
-                }
-            } else if(data == ' ') {
-                if(string_size(value) > 0) {
-                    if(!stream_seek(stream, i - was_read, StreamOffsetFromCurrent)) {
-                        error = true;
-                        break;
-                    }
+static inline bool flipper_format_stream_is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
 
-                    result = true;
-                    *last = false;
-                    break;
-                }
+/** Same as sscanf "%ld" into uint32: optional sign, digits, the rest is ignored */
+static bool flipper_format_stream_parse_uint32(const char* token, uint32_t* value) {
+    bool negative = (*token == '-');
+    if(*token == '-' || *token == '+') token++;
+    if(!flipper_format_stream_is_digit(*token)) return false;
 
-            } else if(data == flipper_format_eolr) {
-                // Ignore
-            } else {
-                string_push_back(value, data);
+    uint32_t result = 0;
+    while(flipper_format_stream_is_digit(*token)) {
+        result = result * 10 + (*token++ - '0');
+    }
+
+    *value = negative ? -result : result;
+    return true;
+}
+
+/** Same as sscanf "%li": decimal fast path, prefixed octal and hex are left to strtol */
+static bool flipper_format_stream_parse_int32(const char* token, int32_t* value) {
+    const char* digits = token;
+    if(*digits == '-' || *digits == '+') digits++;
+
+    if(*digits >= '1' && *digits <= '9') {
+        uint32_t result;
+        flipper_format_stream_parse_uint32(token, &result);
+        *value = result;
+        return true;
+    }
+
+    char* end;
+    *value = strtol(token, &end, 0);
+    return end != token;
+}
+
+static const double flipper_format_stream_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/*
+ * Plain decimals ("-12.345000", as written by the formatter) are converted with one exact
+ * division, anything else (exponents, nan, very long mantissas) goes to strtof.
+ */
+static bool flipper_format_stream_parse_float(const char* token, float* value) {
+    const char* cursor = token;
+    bool negative = (*cursor == '-');
+    if(*cursor == '-' || *cursor == '+') cursor++;
+
+    uint64_t mantissa = 0;
+    size_t digits = 0;
+    size_t fraction_digits = 0;
+    bool fraction = false;
+    bool simple = true;
+
+    for(; *cursor; cursor++) {
+        if(flipper_format_stream_is_digit(*cursor)) {
+            // 2^53, mantissa still fits double exactly
+            if(mantissa >= 900719925474099ULL) {
+                simple = false;
+                break;
             }
+            mantissa = mantissa * 10 + (*cursor - '0');
+            digits++;
+            if(fraction) fraction_digits++;
+        } else if(*cursor == '.' && !fraction) {
+            fraction = true;
+        } else {
+            simple = false;
+            break;
         }
+    }
 
-        if(error || result) break;
+    if(simple && digits > 0 && fraction_digits < COUNT_OF(flipper_format_stream_pow10)) {
+        double result = (double)mantissa / flipper_format_stream_pow10[fraction_digits];
+        *value = negative ? -(float)result : (float)result;
+        return true;
+    }
+
+    // newlib-nano does not have sscanf for floats
+    char* end_char;
+    *value = strtof(token, &end_char);
+    return *end_char == 0;
+}
+
+static bool flipper_format_stream_parse_value(
+    const char* token,
+    FlipperStreamValue type,
+    void* _data,
+    size_t index) {
+    bool result = false;
+
+    switch(type) {
+    case FlipperStreamValueHex: {
+        uint8_t* data = _data;
+        // sscanf "%02X" does not work here
+        result = token[0] && token[1] && hex_chars_to_uint8(token[0], token[1], &data[index]);
+    }; break;
+    case FlipperStreamValueFloat: {
+        float* data = _data;
+        result = flipper_format_stream_parse_float(token, &data[index]);
+    }; break;
+    case FlipperStreamValueInt32: {
+        int32_t* data = _data;
+        result = flipper_format_stream_parse_int32(token, &data[index]);
+    }; break;
+    case FlipperStreamValueUint32: {
+        uint32_t* data = _data;
+        result = flipper_format_stream_parse_uint32(token, &data[index]);
+    }; break;
+    case FlipperStreamValueBool: {
+        bool* data = _data;
+        data[index] = !strcasecmp(token, "true");
+        result = true;
+    }; break;
+    default:
+        furi_crash("Unknown FF type");
     }
 
     return result;
@@ -248,68 +468,153 @@ static bool flipper_format_stream_seek_to_next_line(Stream* stream) {
     return result;
 }
 
+static size_t flipper_format_stream_format_uint32(char* buffer, uint32_t value) {
+    char digits[10];
+    size_t length = 0;
+    do {
+        digits[length++] = '0' + value % 10;
+        value /= 10;
+    } while(value);
+
+    for(size_t i = 0; i < length; i++) {
+        buffer[i] = digits[length - 1 - i];
+    }
+    return length;
+}
+
+static size_t flipper_format_stream_format_int32(char* buffer, int32_t value) {
+    if(value < 0) {
+        buffer[0] = '-';
+        return flipper_format_stream_format_uint32(buffer + 1, -(uint32_t)value) + 1;
+    }
+    return flipper_format_stream_format_uint32(buffer, value);
+}
+
+/** Same output as printf "%f" */
+static size_t flipper_format_stream_format_float(char* buffer, size_t buffer_size, float value) {
+    double absolute = fabs(value);
+    // float * 10^6 is always exact in double, integer part has to fit uint32
+    if(!(absolute < 4294967295.0)) {
+        return snprintf(buffer, buffer_size, "%f", (double)value);
+    }
+
+    double scaled = absolute * 1e6;
+    uint64_t integer = (uint64_t)scaled;
+    double remainder = scaled - (double)integer;
+    // round half to even, as printf does
+    if(remainder > 0.5 || (remainder == 0.5 && (integer & 1))) integer++;
+
+    size_t length = 0;
+    if(signbit(value)) buffer[length++] = '-';
+    length += flipper_format_stream_format_uint32(buffer + length, integer / 1000000);
+    buffer[length++] = '.';
+
+    uint32_t fraction = integer % 1000000;
+    for(size_t i = 6; i > 0; i--) {
+        buffer[length + i - 1] = '0' + fraction % 10;
+        fraction /= 10;
+    }
+    return length + 6;
+}
+
+static size_t flipper_format_stream_format_value(
+    char* buffer,
+    size_t buffer_size,
+    FlipperStreamValue type,
+    const void* _data,
+    size_t index) {
+    size_t length = 0;
+
+    switch(type) {
+    case FlipperStreamValueHex: {
+        const uint8_t* data = _data;
+        static const char hex[] = "0123456789ABCDEF";
+        buffer[0] = hex[data[index] >> 4];
+        buffer[1] = hex[data[index] & 0x0F];
+        length = 2;
+    }; break;
+    case FlipperStreamValueFloat: {
+        const float* data = _data;
+        length = flipper_format_stream_format_float(buffer, buffer_size, data[index]);
+    }; break;
+    case FlipperStreamValueInt32: {
+        const int32_t* data = _data;
+        length = flipper_format_stream_format_int32(buffer, data[index]);
+    }; break;
+    case FlipperStreamValueUint32: {
+        const uint32_t* data = _data;
+        // Files have always had uint32 written as "%ld", keep them readable by older firmware
+        length = flipper_format_stream_format_int32(buffer, (int32_t)data[index]);
+    }; break;
+    case FlipperStreamValueBool: {
+        const bool* data = _data;
+        length = data[index] ? 4 : 5;
+        memcpy(buffer, data[index] ? "true" : "false", length);
+    }; break;
+    default:
+        furi_crash("Unknown FF type");
+    }
+
+    return length;
+}
+
+static bool
+    flipper_format_stream_write_values(Stream* stream, const FlipperStreamWriteData* write_data) {
+    if(write_data->type == FlipperStreamValueStr) {
+        const char* data = write_data->data;
+        return flipper_format_stream_write(stream, data, strlen(data));
+    }
+
+    // Values are formatted in place and written in chunks
+    char buffer[FLIPPER_FORMAT_STREAM_WRITE_SIZE];
+    size_t length = 0;
+
+    for(size_t i = 0; i < write_data->data_size; i++) {
+        length += flipper_format_stream_format_value(
+            buffer + length, sizeof(buffer) - length, write_data->type, write_data->data, i);
+
+        if((i + 1) < write_data->data_size) {
+            buffer[length++] = ' ';
+        }
+
+        if(sizeof(buffer) - length < FLIPPER_FORMAT_STREAM_TOKEN_SIZE ||
+           (i + 1) == write_data->data_size) {
+            if(!flipper_format_stream_write(stream, buffer, length)) return false;
+            length = 0;
+        }
+    }
+
+    return true;
+}
+
+/* Length of the values as flipper_format_stream_write_values would write them */
+static size_t flipper_format_stream_values_length(const FlipperStreamWriteData* write_data) {
+    if(write_data->type == FlipperStreamValueStr) {
+        return strlen(write_data->data);
+    }
+
+    char buffer[FLIPPER_FORMAT_STREAM_TOKEN_SIZE];
+    size_t length = 0;
+    for(size_t i = 0; i < write_data->data_size; i++) {
+        length += flipper_format_stream_format_value(
+            buffer, sizeof(buffer), write_data->type, write_data->data, i);
+        if((i + 1) < write_data->data_size) length++;
+    }
+    return length;
+}
+
 bool flipper_format_stream_write_value_line(Stream* stream, FlipperStreamWriteData* write_data) {
     bool result = false;
 
     if(write_data->type == FlipperStreamValueIgnore) {
         result = true;
     } else {
-        string_t value;
-        string_init(value);
-
         do {
             if(!flipper_format_stream_write_key(stream, write_data->key)) break;
-
-            if(write_data->type == FlipperStreamValueStr) write_data->data_size = 1;
-
-            bool cycle_error = false;
-            for(uint16_t i = 0; i < write_data->data_size; i++) {
-                switch(write_data->type) {
-                case FlipperStreamValueStr: {
-                    const char* data = write_data->data;
-                    string_printf(value, "%s", data);
-                }; break;
-                case FlipperStreamValueHex: {
-                    const uint8_t* data = write_data->data;
-                    string_printf(value, "%02X", data[i]);
-                }; break;
-                case FlipperStreamValueFloat: {
-                    const float* data = write_data->data;
-                    string_printf(value, "%f", data[i]);
-                }; break;
-                case FlipperStreamValueInt32: {
-                    const int32_t* data = write_data->data;
-                    string_printf(value, "%" PRIi32, data[i]);
-                }; break;
-                case FlipperStreamValueUint32: {
-                    const uint32_t* data = write_data->data;
-                    string_printf(value, "%" PRId32, data[i]);
-                }; break;
-                case FlipperStreamValueBool: {
-                    const bool* data = write_data->data;
-                    string_printf(value, data[i] ? "true" : "false");
-                }; break;
-                default:
-                    furi_crash("Unknown FF type");
-                }
-
-                if((i + 1) < write_data->data_size) {
-                    string_cat(value, " ");
-                }
-
-                if(!flipper_format_stream_write(
-                       stream, string_get_cstr(value), string_size(value))) {
-                    cycle_error = true;
-                    break;
-                }
-            }
-            if(cycle_error) break;
-
+            if(!flipper_format_stream_write_values(stream, write_data)) break;
             if(!flipper_format_stream_write_eol(stream)) break;
             result = true;
         } while(false);
-
-        string_clear(value);
     }
 
     return result;
@@ -323,9 +628,10 @@ bool flipper_format_stream_read_value_line(
     size_t data_size,
     bool strict_mode) {
     bool result = false;
+    FlipperFormatStreamKey key_position;
 
     do {
-        if(!flipper_format_stream_seek_to_key(stream, key, strict_mode)) break;
+        if(!flipper_format_stream_seek_to_key_ex(stream, key, strict_mode, &key_position)) break;
 
         if(type == FlipperStreamValueStr) {
             string_ptr data = (string_ptr)_data;
@@ -334,62 +640,18 @@ bool flipper_format_stream_read_value_line(
                 break;
             }
         } else {
-            result = true;
-            string_t value;
-            string_init(value);
+            FlipperFormatStreamReader reader;
+            flipper_format_stream_reader_init(&reader, stream);
+            char token[FLIPPER_FORMAT_STREAM_TOKEN_SIZE];
 
-            for(uint16_t i = 0; i < data_size; i++) {
+            result = true;
+            for(size_t i = 0; i < data_size; i++) {
                 bool last = false;
-                result = flipper_format_stream_read_value(stream, value, &last);
-                if(result) {
-                    int scan_values = 0;
-
-                    switch(type) {
-                    case FlipperStreamValueHex: {
-                        uint8_t* data = _data;
-                        if(string_size(value) >= 2) {
-                            // sscanf "%02X" does not work here
-                            if(hex_chars_to_uint8(
-                                   string_get_char(value, 0),
-                                   string_get_char(value, 1),
-                                   &data[i])) {
-                                scan_values = 1;
-                            }
-                        }
-                    }; break;
-                    case FlipperStreamValueFloat: {
-                        float* data = _data;
-                        // newlib-nano does not have sscanf for floats
-                        // scan_values = sscanf(string_get_cstr(value), "%f", &data[i]);
-                        char* end_char;
-                        data[i] = strtof(string_get_cstr(value), &end_char);
-                        if(*end_char == 0) {
-                            // most likely ok
-                            scan_values = 1;
-                        }
-                    }; break;
-                    case FlipperStreamValueInt32: {
-                        int32_t* data = _data;
-                        scan_values = sscanf(string_get_cstr(value), "%" PRIi32, &data[i]);
-                    }; break;
-                    case FlipperStreamValueUint32: {
-                        uint32_t* data = _data;
-                        scan_values = sscanf(string_get_cstr(value), "%" PRId32, &data[i]);
-                    }; break;
-                    case FlipperStreamValueBool: {
-                        bool* data = _data;
-                        data[i] = !string_cmpi_str(value, "true");
-                        scan_values = 1;
-                    }; break;
-                    default:
-                        furi_crash("Unknown FF type");
-                    }
-
-                    if(scan_values != 1) {
-                        result = false;
-                        break;
-                    }
-                } else {
+                bool overflow = false;
+                if(!flipper_format_stream_read_token(
+                       &reader, token, sizeof(token), &last, &overflow) ||
+                   overflow || !flipper_format_stream_parse_value(token, type, _data, i)) {
+                    result = false;
                     break;
                 }
 
@@ -399,10 +661,15 @@ bool flipper_format_stream_read_value_line(
                 }
             }
 
-            string_clear(value);
+            if(!flipper_format_stream_reader_done(&reader)) result = false;
         }
     } while(false);
 
+    // Value came from the journal, continue after the line it replaces
+    if(result && key_position.journal) {
+        if(!stream_seek(stream, key_position.resume, StreamOffsetFromStart)) result = false;
+    }
+
     return result;
 }
 
@@ -412,34 +679,36 @@ bool flipper_format_stream_get_value_count(
     uint32_t* count,
     bool strict_mode) {
     bool result = false;
-    bool last = false;
-
-    string_t value;
-    string_init(value);
 
     uint32_t position = stream_tell(stream);
     do {
         if(!flipper_format_stream_seek_to_key(stream, key, strict_mode)) break;
         *count = 0;
 
+        // Values are only counted, their contents do not matter
+        FlipperFormatStreamReader reader;
+        flipper_format_stream_reader_init(&reader, stream);
+        char token[FLIPPER_FORMAT_STREAM_TOKEN_SIZE];
+        bool last = false;
+        bool overflow = false;
+
         result = true;
-        while(true) {
-            if(!flipper_format_stream_read_value(stream, value, &last)) {
-                result = false;
+        while(!last) {
+            if(!flipper_format_stream_read_token(
+                   &reader, token, sizeof(token), &last, &overflow)) {
+                // Spaces before EOL are padding left by in place update
+                result = (*count > 0);
                 break;
             }
 
             *count = *count + 1;
-            if(last) break;
         }
-
     } while(false);
 
     if(!stream_seek(stream, position, StreamOffsetFromStart)) {
         result = false;
     }
 
-    string_clear(value);
     return result;
 }
 
@@ -448,24 +717,16 @@ bool flipper_format_stream_delete_key_and_write(
     FlipperStreamWriteData* write_data,
     bool strict_mode) {
     bool result = false;
+    FlipperFormatStreamKey key_position;
 
     do {
         size_t size = stream_size(stream);
         if(size == 0) break;
 
-        if(!stream_rewind(stream)) break;
-
         // find key
-        if(!flipper_format_stream_seek_to_key(stream, write_data->key, strict_mode)) break;
-
-        // get key start position
-        size_t start_position = stream_tell(stream) - strlen(write_data->key);
-        if(start_position >= 2) {
-            start_position -= 2;
-        } else {
-            // something wrong
+        if(!flipper_format_stream_seek_to_key_ex(
+               stream, write_data->key, strict_mode, &key_position))
             break;
-        }
 
         // get value end position
         if(!flipper_format_stream_seek_to_next_line(stream)) break;
@@ -475,6 +736,10 @@ bool flipper_format_stream_delete_key_and_write(
             end_position += 1;
         }
 
+        // Line offsets are the journal keys, they must not move under it
+        if(key_position.journal) break;
+
+        size_t start_position = key_position.line_start;
         if(!stream_seek(stream, start_position, StreamOffsetFromStart)) break;
         if(!stream_delete_and_insert(
                stream,
@@ -489,6 +754,228 @@ bool flipper_format_stream_delete_key_and_write(
     return result;
 }
 
+/* Makes sure that a line appended to the stream starts on its own line */
+static bool flipper_format_stream_seek_to_end_of_lines(Stream* stream) {
+    if(stream_size(stream) == 0) return stream_rewind(stream);
+
+    char last_char;
+    if(!stream_seek(stream, -1, StreamOffsetFromEnd)) return false;
+    if(stream_read(stream, (uint8_t*)&last_char, 1) != 1) return false;
+    if(last_char != flipper_format_eoln) return flipper_format_stream_write_eol(stream);
+    return true;
+}
+
+bool flipper_format_stream_update_key_in_place(
+    Stream* stream,
+    FlipperStreamWriteData* write_data,
+    bool strict_mode) {
+    bool result = false;
+    FlipperFormatStreamKey key_position;
+
+    do {
+        if(!flipper_format_stream_seek_to_key_ex(
+               stream, write_data->key, strict_mode, &key_position))
+            break;
+
+        // Old value spans up to EOL, CR is kept
+        size_t value_start = stream_tell(stream);
+        if(!flipper_format_stream_seek_to_next_line(stream)) break;
+        size_t value_end = stream_tell(stream);
+        if(value_end > value_start) {
+            char last_char;
+            if(!stream_seek(stream, -1, StreamOffsetFromCurrent)) break;
+            if(stream_read(stream, (uint8_t*)&last_char, 1) != 1) break;
+            if(last_char == flipper_format_eolr) value_end--;
+        }
+
+        // Padding spaces would become a part of the string
+        size_t space = value_end - value_start;
+        size_t length = 0;
+        bool fits = false;
+        if(write_data->type != FlipperStreamValueIgnore) {
+            length = flipper_format_stream_values_length(write_data);
+            fits = (write_data->type == FlipperStreamValueStr) ? (length == space) :
+                                                                 (length <= space);
+        }
+
+        if(fits) {
+            if(!stream_seek(stream, value_start, StreamOffsetFromStart)) break;
+            if(!flipper_format_stream_write_values(stream, write_data)) break;
+
+            bool padding_error = false;
+            for(size_t i = length; i < space; i++) {
+                if(!flipper_format_stream_write(stream, " ", 1)) {
+                    padding_error = true;
+                    break;
+                }
+            }
+            if(padding_error) break;
+
+            result = true;
+            break;
+        }
+
+        // Nothing is moved: the line gets a tombstone instead of the delimiter and the new
+        // value is appended to the journal, keyed by the offset of the original line
+        char journal_key[FLIPPER_FORMAT_STREAM_JOURNAL_KEY_SIZE];
+        size_t tombstone = key_position.line_start;
+        if(key_position.journal) {
+            flipper_format_stream_journal_key(journal_key, key_position.tombstone);
+            tombstone += strlen(journal_key);
+        } else {
+            flipper_format_stream_journal_key(journal_key, key_position.line_start);
+            tombstone += strlen(write_data->key);
+        }
+
+        if(!stream_seek(stream, tombstone, StreamOffsetFromStart)) break;
+        if(!flipper_format_stream_write(stream, &flipper_format_tombstone, 1)) break;
+
+        if(write_data->type != FlipperStreamValueIgnore) {
+            FlipperStreamWriteData journal_data = *write_data;
+            journal_data.key = journal_key;
+
+            if(!flipper_format_stream_seek_to_end_of_lines(stream)) break;
+            if(!flipper_format_stream_write_value_line(stream, &journal_data)) break;
+        }
+
+        result = true;
+    } while(false);
+
+    return result;
+}
+
+bool flipper_format_stream_has_journal(Stream* stream) {
+    uint8_t buffer[FLIPPER_FORMAT_STREAM_READ_SIZE];
+    size_t position = stream_tell(stream);
+    bool line_start = true;
+    bool found = false;
+
+    if(!stream_rewind(stream)) return false;
+
+    while(!found) {
+        size_t was_read = stream_read(stream, buffer, sizeof(buffer));
+        if(was_read == 0) break;
+
+        for(size_t i = 0; i < was_read; i++) {
+            if(buffer[i] == flipper_format_tombstone && line_start) {
+                found = true;
+                break;
+            }
+            line_start = (buffer[i] == flipper_format_eoln);
+        }
+    }
+
+    stream_seek(stream, position, StreamOffsetFromStart);
+    return found;
+}
+
+/* Reads a line as is, EOL included */
+static bool flipper_format_stream_read_raw_line(Stream* stream, string_t line) {
+    uint8_t buffer[FLIPPER_FORMAT_STREAM_READ_SIZE];
+    bool found = false;
+    string_reset(line);
+
+    while(!found) {
+        size_t was_read = stream_read(stream, buffer, sizeof(buffer));
+        if(was_read == 0) break;
+
+        for(size_t i = 0; i < was_read; i++) {
+            string_push_back(line, buffer[i]);
+            if(buffer[i] == flipper_format_eoln) {
+                stream_seek(stream, i + 1 - was_read, StreamOffsetFromCurrent);
+                found = true;
+                break;
+            }
+        }
+    }
+
+    return string_size(line) != 0;
+}
+
+/*
+ * Gets the key of a replaced or deleted line, same rules as
+ * flipper_format_stream_read_valid_key. Journal lines are reported with an empty key.
+ */
+static bool flipper_format_stream_get_tombstone_key(string_t line, string_t key) {
+    string_reset(key);
+
+    for(size_t i = 0; i < string_size(line); i++) {
+        char data = string_get_char(line, i);
+        if(data == flipper_format_eolr) {
+            continue;
+        } else if(string_size(key) == 0 && data == flipper_format_tombstone) {
+            return true;
+        } else if(
+            data == flipper_format_eoln || data == flipper_format_delimiter ||
+            (string_size(key) == 0 && data == flipper_format_comment)) {
+            break;
+        } else if(data == flipper_format_tombstone) {
+            return true;
+        }
+        string_push_back(key, data);
+    }
+
+    return false;
+}
+
+bool flipper_format_stream_compact(Stream* stream, Stream* compacted) {
+    bool result = false;
+    string_t line;
+    string_t key;
+    string_t value;
+    string_init(line);
+    string_init(key);
+    string_init(value);
+
+    do {
+        if(!stream_rewind(stream)) break;
+
+        bool error = false;
+        while(true) {
+            size_t line_start = stream_tell(stream);
+            if(!flipper_format_stream_read_raw_line(stream, line)) break;
+
+            // Lines are copied byte to byte, values depend on their exact layout
+            if(!flipper_format_stream_get_tombstone_key(line, key)) {
+                if(stream_write_string(compacted, line) != string_size(line)) {
+                    error = true;
+                    break;
+                }
+                continue;
+            }
+
+            // Journal line, its value is merged into the line it replaces
+            if(string_size(key) == 0) continue;
+
+            // Replaced or deleted line
+            size_t resume = stream_tell(stream);
+            FlipperFormatStreamKey key_position;
+            if(flipper_format_stream_seek_to_journal(stream, line_start, &key_position)) {
+                if(!flipper_format_stream_read_line(stream, value) ||
+                   !stream_seek(stream, resume, StreamOffsetFromStart)) {
+                    error = true;
+                    break;
+                }
+                if(stream_write_string(compacted, key) != string_size(key) ||
+                   stream_write_cstring(compacted, ": ") != 2 ||
+                   stream_write_string(compacted, value) != string_size(value) ||
+                   stream_write_char(compacted, flipper_format_eoln) != 1) {
+                    error = true;
+                    break;
+                }
+            }
+        }
+        if(error) break;
+
+        result = true;
+    } while(false);
+
+    string_clear(value);
+    string_clear(key);
+    string_clear(line);
+    return result;
+}
+
 bool flipper_format_stream_write_comment_cstr(Stream* stream, const char* data) {
     bool result = false;
     do {
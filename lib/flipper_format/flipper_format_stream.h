@@ -70,6 +70,8 @@ bool flipper_format_stream_get_value_count(
 
 /**
  * Removes a key and the corresponding value string from the stream and inserts a new key/value pair.
+ * Key is searched from the current position of the stream. Fails if the stream has a journal,
+ * compact it first.
  * @param stream 
  * @param write_data 
  * @param strict_mode 
@@ -81,6 +83,42 @@ bool flipper_format_stream_delete_key_and_write(
     FlipperStreamWriteData* write_data,
     bool strict_mode);
 
+/**
+ * Updates the value of a key without moving the rest of the stream.
+ * Value that fits into the old one is written over it and padded with spaces, string
+ * values have to be of the same length. Otherwise the old line is marked with a tombstone
+ * and the value is appended to the journal at the end of the stream. Deleted key is only
+ * marked with a tombstone. Nothing already in the stream is moved.
+ * Key is searched from the current position of the stream.
+ * @param stream 
+ * @param write_data 
+ * @param strict_mode 
+ * @return true 
+ * @return false 
+ */
+bool flipper_format_stream_update_key_in_place(
+    Stream* stream,
+    FlipperStreamWriteData* write_data,
+    bool strict_mode);
+
+/**
+ * Checks if the stream has a journal left by in place updates. Stream position is kept.
+ * @param stream 
+ * @return true 
+ * @return false 
+ */
+bool flipper_format_stream_has_journal(Stream* stream);
+
+/**
+ * Writes the stream to another one with the journal merged back into the lines it replaces
+ * and deleted lines dropped. Source stream position is not kept.
+ * @param stream 
+ * @param compacted 
+ * @return true 
+ * @return false 
+ */
+bool flipper_format_stream_compact(Stream* stream, Stream* compacted);
+
 /**
  * Writes a comment string to the stream.
  * @param stream 
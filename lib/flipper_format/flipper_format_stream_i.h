@@ -5,6 +5,17 @@ static const char flipper_format_delimiter = ':';
 static const char flipper_format_comment = '#';
 static const char flipper_format_eoln = '\n';
 static const char flipper_format_eolr = '\r';
+static const char flipper_format_tombstone = '@';
+
+/** Journal key is the tombstone symbol and the offset of the replaced line */
+#define FLIPPER_FORMAT_STREAM_JOURNAL_KEY_SIZE 12
+
+typedef struct {
+    size_t line_start; /**< Start of the line the value is on */
+    size_t tombstone; /**< Start of the replaced line, if the value comes from the journal */
+    size_t resume; /**< End of the replaced line, sequential reading continues there */
+    bool journal; /**< Value comes from the journal */
+} FlipperFormatStreamKey;
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,6 +40,23 @@ bool flipper_format_stream_write_eol(Stream* stream);
  */
 bool flipper_format_stream_seek_to_key(Stream* stream, const char* key, bool strict_mode);
 
+/**
+ * Seek to the key from the current position of the stream, same as
+ * flipper_format_stream_seek_to_key, and report where the value was found.
+ * Lines replaced in place mode are resolved through the journal, deleted ones are skipped.
+ * @param stream 
+ * @param key 
+ * @param strict_mode 
+ * @param key_position where the value was found, valid if the key is found
+ * @return true key is found
+ * @return false key is not found
+ */
+bool flipper_format_stream_seek_to_key_ex(
+    Stream* stream,
+    const char* key,
+    bool strict_mode,
+    FlipperFormatStreamKey* key_position);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
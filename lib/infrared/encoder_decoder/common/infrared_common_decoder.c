@@ -309,6 +309,19 @@ void infrared_common_decoder_reset_state(InfraredCommonDecoder* decoder) {
     }
 }
 
+/*
+ * Decoder waits for a preamble and has nothing buffered: any mark that doesn't match
+ * the preamble mark is consumed together with the following space without changing
+ * the state, so such edges don't have to be passed to this decoder at all.
+ */
+bool infrared_common_decoder_is_idle(InfraredCommonDecoder* decoder) {
+    furi_assert(decoder);
+
+    return (decoder->state == InfraredCommonDecoderStateWaitPreamble) &&
+           (decoder->timings_cnt == 0) && (decoder->databit_cnt == 0) && !decoder->level &&
+           (decoder->protocol->timings.preamble_mark != 0);
+}
+
 void infrared_common_decoder_reset(InfraredCommonDecoder* decoder) {
     furi_assert(decoder);
 
@@ -74,6 +74,7 @@ InfraredStatus
 void* infrared_common_decoder_alloc(const InfraredCommonProtocolSpec* protocol);
 void infrared_common_decoder_free(InfraredCommonDecoder* decoder);
 void infrared_common_decoder_reset(InfraredCommonDecoder* decoder);
+bool infrared_common_decoder_is_idle(InfraredCommonDecoder* decoder);
 InfraredMessage* infrared_common_decoder_check_ready(InfraredCommonDecoder* decoder);
 
 InfraredStatus
@@ -5,16 +5,21 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <furi.h>
 #include "infrared_i.h"
 #include <furi_hal_infrared.h>
 
+#define INFRARED_DECODERS_COUNT 5
+
 typedef struct {
     InfraredAlloc alloc;
     InfraredDecode decode;
     InfraredDecoderReset reset;
     InfraredFree free;
     InfraredDecoderCheckReady check_ready;
+    InfraredDecoderIsIdle is_idle;
+    const InfraredCommonProtocolSpec* protocol;
 } InfraredDecoders;
 
 typedef struct {
@@ -24,8 +29,23 @@ typedef struct {
     InfraredFree free;
 } InfraredEncoders;
 
+/* Range of mark durations that can start a preamble of some decoders */
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint32_t decoders;
+} InfraredPreambleWindow;
+
+/*
+ * Decoders in 'idle' mask are waiting for a preamble and get edges only when
+ * a mark can be a preamble mark for them (see infrared_common_decoder_is_idle()).
+ */
 struct InfraredDecoderHandler {
     void** ctx;
+    uint32_t idle;
+    bool level;
+    InfraredPreambleWindow windows[INFRARED_DECODERS_COUNT];
+    size_t windows_count;
 };
 
 struct InfraredEncoderHandler {
@@ -39,13 +59,15 @@ typedef struct {
     InfraredGetProtocolSpec get_protocol_spec;
 } InfraredEncoderDecoder;
 
-static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
+static const InfraredEncoderDecoder infrared_encoder_decoder[INFRARED_DECODERS_COUNT] = {
     {
         .decoder =
             {.alloc = infrared_decoder_nec_alloc,
              .decode = infrared_decoder_nec_decode,
              .reset = infrared_decoder_nec_reset,
              .check_ready = infrared_decoder_nec_check_ready,
+             .is_idle = infrared_decoder_nec_is_idle,
+             .protocol = &protocol_nec,
              .free = infrared_decoder_nec_free},
         .encoder =
             {.alloc = infrared_encoder_nec_alloc,
@@ -60,6 +82,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_samsung32_decode,
              .reset = infrared_decoder_samsung32_reset,
              .check_ready = infrared_decoder_samsung32_check_ready,
+             .is_idle = infrared_decoder_samsung32_is_idle,
+             .protocol = &protocol_samsung32,
              .free = infrared_decoder_samsung32_free},
         .encoder =
             {.alloc = infrared_encoder_samsung32_alloc,
@@ -74,6 +98,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_rc5_decode,
              .reset = infrared_decoder_rc5_reset,
              .check_ready = infrared_decoder_rc5_check_ready,
+             .is_idle = infrared_decoder_rc5_is_idle,
+             .protocol = &protocol_rc5,
              .free = infrared_decoder_rc5_free},
         .encoder =
             {.alloc = infrared_encoder_rc5_alloc,
@@ -88,6 +114,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_rc6_decode,
              .reset = infrared_decoder_rc6_reset,
              .check_ready = infrared_decoder_rc6_check_ready,
+             .is_idle = infrared_decoder_rc6_is_idle,
+             .protocol = &protocol_rc6,
              .free = infrared_decoder_rc6_free},
         .encoder =
             {.alloc = infrared_encoder_rc6_alloc,
@@ -102,6 +130,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_sirc_decode,
              .reset = infrared_decoder_sirc_reset,
              .check_ready = infrared_decoder_sirc_check_ready,
+             .is_idle = infrared_decoder_sirc_is_idle,
+             .protocol = &protocol_sirc,
              .free = infrared_decoder_sirc_free},
         .encoder =
             {.alloc = infrared_encoder_sirc_alloc,
@@ -116,6 +146,19 @@ static int infrared_find_index_by_protocol(InfraredProtocol protocol);
 static const InfraredProtocolSpecification*
     infrared_get_spec_by_protocol(InfraredProtocol protocol);
 
+/* Mask of idle decoders that have to get this mark */
+static uint32_t infrared_classify_mark(InfraredDecoderHandler* handler, uint32_t duration) {
+    uint32_t decoders = 0;
+
+    for(size_t i = 0; i < handler->windows_count; ++i) {
+        const InfraredPreambleWindow* window = &handler->windows[i];
+        if(duration <= window->min) break;
+        if(duration < window->max) decoders |= window->decoders;
+    }
+
+    return decoders;
+}
+
 const InfraredMessage*
     infrared_decode(InfraredDecoderHandler* handler, bool level, uint32_t duration) {
     furi_assert(handler);
@@ -123,18 +166,69 @@ const InfraredMessage*
     InfraredMessage* message = NULL;
     InfraredMessage* result = NULL;
 
-    for(int i = 0; i < COUNT_OF(infrared_encoder_decoder); ++i) {
-        if(infrared_encoder_decoder[i].decoder.decode) {
-            message = infrared_encoder_decoder[i].decoder.decode(handler->ctx[i], level, duration);
-            if(!result && message) {
-                result = message;
+    if(handler->idle) {
+        if(handler->level == level) {
+            /* decoders reset themselves on repeated level, do it for idle ones too */
+            for(int i = 0; i < COUNT_OF(infrared_encoder_decoder); ++i) {
+                if(handler->idle & (1UL << i)) {
+                    infrared_encoder_decoder[i].decoder.reset(handler->ctx[i]);
+                }
             }
         }
+        if(level) {
+            handler->idle &= ~infrared_classify_mark(handler, duration);
+        }
+    }
+    handler->level = level;
+
+    for(int i = 0; i < COUNT_OF(infrared_encoder_decoder); ++i) {
+        const InfraredDecoders* decoder = &infrared_encoder_decoder[i].decoder;
+        if(!decoder->decode || (handler->idle & (1UL << i))) continue;
+
+        message = decoder->decode(handler->ctx[i], level, duration);
+        if(!result && message) {
+            result = message;
+        }
+        if(!level && decoder->is_idle && decoder->is_idle(handler->ctx[i])) {
+            handler->idle |= (1UL << i);
+        }
     }
 
     return result;
 }
 
+/* Preamble mark windows sorted by lower bound, same bounds as MATCH_TIMING() */
+static void infrared_build_preamble_windows(InfraredDecoderHandler* handler) {
+    handler->windows_count = 0;
+
+    for(int i = 0; i < COUNT_OF(infrared_encoder_decoder); ++i) {
+        const InfraredCommonProtocolSpec* protocol = infrared_encoder_decoder[i].decoder.protocol;
+        if(!protocol || !protocol->timings.preamble_mark) continue;
+
+        uint32_t mark = protocol->timings.preamble_mark;
+        uint32_t tolerance = protocol->timings.preamble_tolerance;
+        InfraredPreambleWindow window = {
+            .min = (mark > tolerance) ? (mark - tolerance) : 0,
+            .max = mark + tolerance,
+            .decoders = (1UL << i),
+        };
+
+        size_t j = 0;
+        while((j < handler->windows_count) && (handler->windows[j].min < window.min)) ++j;
+        if((j < handler->windows_count) && (handler->windows[j].min == window.min) &&
+           (handler->windows[j].max == window.max)) {
+            handler->windows[j].decoders |= window.decoders;
+            continue;
+        }
+        memmove(
+            &handler->windows[j + 1],
+            &handler->windows[j],
+            (handler->windows_count - j) * sizeof(InfraredPreambleWindow));
+        handler->windows[j] = window;
+        ++handler->windows_count;
+    }
+}
+
 InfraredDecoderHandler* infrared_alloc_decoder(void) {
     InfraredDecoderHandler* handler = malloc(sizeof(InfraredDecoderHandler));
     handler->ctx = malloc(sizeof(void*) * COUNT_OF(infrared_encoder_decoder));
@@ -145,6 +239,7 @@ InfraredDecoderHandler* infrared_alloc_decoder(void) {
             handler->ctx[i] = infrared_encoder_decoder[i].decoder.alloc();
     }
 
+    infrared_build_preamble_windows(handler);
     infrared_reset_decoder(handler);
     return handler;
 }
@@ -163,6 +258,9 @@ void infrared_free_decoder(InfraredDecoderHandler* handler) {
 }
 
 void infrared_reset_decoder(InfraredDecoderHandler* handler) {
+    handler->idle = 0;
+    handler->level = true;
+
     for(int i = 0; i < COUNT_OF(infrared_encoder_decoder); ++i) {
         if(infrared_encoder_decoder[i].decoder.reset)
             infrared_encoder_decoder[i].decoder.reset(handler->ctx[i]);
@@ -176,6 +274,8 @@ const InfraredMessage* infrared_check_decoder_ready(InfraredDecoderHandler* hand
     InfraredMessage* result = NULL;
 
     for(int i = 0; i < COUNT_OF(infrared_encoder_decoder); ++i) {
+        /* idle decoders have no bits to check */
+        if(handler->idle & (1UL << i)) continue;
         if(infrared_encoder_decoder[i].decoder.check_ready) {
             message = infrared_encoder_decoder[i].decoder.check_ready(handler->ctx[i]);
             if(!result && message) {
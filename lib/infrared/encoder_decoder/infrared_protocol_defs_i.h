@@ -38,6 +38,7 @@
 
 void* infrared_decoder_nec_alloc(void);
 void infrared_decoder_nec_reset(void* decoder);
+bool infrared_decoder_nec_is_idle(void* decoder);
 void infrared_decoder_nec_free(void* decoder);
 InfraredMessage* infrared_decoder_nec_check_ready(void* decoder);
 InfraredMessage* infrared_decoder_nec_decode(void* decoder, bool level, uint32_t duration);
@@ -93,6 +94,7 @@ extern const InfraredCommonProtocolSpec protocol_nec;
 
 void* infrared_decoder_samsung32_alloc(void);
 void infrared_decoder_samsung32_reset(void* decoder);
+bool infrared_decoder_samsung32_is_idle(void* decoder);
 void infrared_decoder_samsung32_free(void* decoder);
 InfraredMessage* infrared_decoder_samsung32_check_ready(void* ctx);
 InfraredMessage* infrared_decoder_samsung32_decode(void* decoder, bool level, uint32_t duration);
@@ -146,6 +148,7 @@ extern const InfraredCommonProtocolSpec protocol_samsung32;
 
 void* infrared_decoder_rc6_alloc(void);
 void infrared_decoder_rc6_reset(void* decoder);
+bool infrared_decoder_rc6_is_idle(void* decoder);
 void infrared_decoder_rc6_free(void* decoder);
 InfraredMessage* infrared_decoder_rc6_check_ready(void* ctx);
 InfraredMessage* infrared_decoder_rc6_decode(void* decoder, bool level, uint32_t duration);
@@ -202,6 +205,7 @@ extern const InfraredCommonProtocolSpec protocol_rc6;
 
 void* infrared_decoder_rc5_alloc(void);
 void infrared_decoder_rc5_reset(void* decoder);
+bool infrared_decoder_rc5_is_idle(void* decoder);
 void infrared_decoder_rc5_free(void* decoder);
 InfraredMessage* infrared_decoder_rc5_check_ready(void* ctx);
 InfraredMessage* infrared_decoder_rc5_decode(void* decoder, bool level, uint32_t duration);
@@ -251,6 +255,7 @@ extern const InfraredCommonProtocolSpec protocol_rc5;
 
 void* infrared_decoder_sirc_alloc(void);
 void infrared_decoder_sirc_reset(void* decoder);
+bool infrared_decoder_sirc_is_idle(void* decoder);
 InfraredMessage* infrared_decoder_sirc_check_ready(void* decoder);
 uint32_t infrared_decoder_sirc_get_timeout(void* decoder);
 void infrared_decoder_sirc_free(void* decoder);
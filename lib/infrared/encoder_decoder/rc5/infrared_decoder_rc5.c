@@ -80,3 +80,8 @@ void infrared_decoder_rc5_reset(void* decoder) {
     InfraredRc5Decoder* decoder_rc5 = decoder;
     infrared_common_decoder_reset(decoder_rc5->common_decoder);
 }
+
+bool infrared_decoder_rc5_is_idle(void* decoder) {
+    InfraredRc5Decoder* decoder_rc5 = decoder;
+    return infrared_common_decoder_is_idle(decoder_rc5->common_decoder);
+}
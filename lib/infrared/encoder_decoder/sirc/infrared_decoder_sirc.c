@@ -58,3 +58,7 @@ void infrared_decoder_sirc_free(void* decoder) {
 void infrared_decoder_sirc_reset(void* decoder) {
     infrared_common_decoder_reset(decoder);
 }
+
+bool infrared_decoder_sirc_is_idle(void* decoder) {
+    return infrared_common_decoder_is_idle(decoder);
+}
@@ -1,5 +1,4 @@
 #include "crypto1.h"
-#include "nfc_util.h"
 #include <furi.h>
 
 // Algorithm from https://github.com/RfidResearchGroup/proxmark3.git
@@ -10,6 +9,46 @@
 
 #define BEBIT(x, n) FURI_BIT(x, (n) ^ 24)
 
+/* Filter inputs of bits 0-7 and 8-15 of the odd register, same as the nibble functions of
+ * crypto1_filter would give for them. Bits 16-19 are looked up in a constant. */
+static const uint8_t crypto1_filter_low[256] = {
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+};
+
+static const uint8_t crypto1_filter_high[256] = {
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+};
+
 void crypto1_reset(Crypto1* crypto1) {
     furi_assert(crypto1);
     crypto1->even = 0;
@@ -26,47 +65,129 @@ void crypto1_init(Crypto1* crypto1, uint64_t key) {
     }
 }
 
-uint32_t crypto1_filter(uint32_t in) {
-    uint32_t out = 0;
-    out = 0xf22c0 >> (in & 0xf) & 16;
-    out |= 0x6c9c0 >> (in >> 4 & 0xf) & 8;
-    out |= 0x3c8b0 >> (in >> 8 & 0xf) & 4;
-    out |= 0x1e458 >> (in >> 12 & 0xf) & 2;
+static inline uint8_t crypto1_filter_inline(uint32_t in) {
+    uint32_t out = crypto1_filter_low[in & 0xff] | crypto1_filter_high[in >> 8 & 0xff];
     out |= 0x0d938 >> (in >> 16 & 0xf) & 1;
     return FURI_BIT(0xEC57E80A, out);
 }
 
+uint32_t crypto1_filter(uint32_t in) {
+    return crypto1_filter_inline(in);
+}
+
+/* Feedback of the LFSR, without the input and the keystream bit */
+static inline uint32_t crypto1_feedback(uint32_t odd, uint32_t even) {
+    return __builtin_parity((LF_POLY_ODD & odd) ^ (LF_POLY_EVEN & even));
+}
+
 uint8_t crypto1_bit(Crypto1* crypto1, uint8_t in, int is_encrypted) {
     furi_assert(crypto1);
-    uint8_t out = crypto1_filter(crypto1->odd);
+    uint8_t out = crypto1_filter_inline(crypto1->odd);
     uint32_t feed = out & (!!is_encrypted);
     feed ^= !!in;
-    feed ^= LF_POLY_ODD & crypto1->odd;
-    feed ^= LF_POLY_EVEN & crypto1->even;
-    crypto1->even = crypto1->even << 1 | (nfc_util_even_parity32(feed));
+    feed ^= crypto1_feedback(crypto1->odd, crypto1->even);
+    crypto1->even = crypto1->even << 1 | feed;
 
     FURI_SWAP(crypto1->odd, crypto1->even);
     return out;
 }
 
+/*
+ * Byte and word stepping work on local copies of the halves and make two steps per
+ * iteration: after the first one the halves swap roles, after the second one they are
+ * back in place, so no swap is needed.
+ */
 uint8_t crypto1_byte(Crypto1* crypto1, uint8_t in, int is_encrypted) {
     furi_assert(crypto1);
+    uint32_t odd = crypto1->odd;
+    uint32_t even = crypto1->even;
+    uint8_t encrypted = !!is_encrypted;
     uint8_t out = 0;
-    for(uint8_t i = 0; i < 8; i++) {
-        out |= crypto1_bit(crypto1, FURI_BIT(in, i), is_encrypted) << i;
+
+    for(uint8_t i = 0; i < 8; i += 2) {
+        uint8_t bit = crypto1_filter_inline(odd);
+        even = even << 1 | (crypto1_feedback(odd, even) ^ (bit & encrypted) ^ FURI_BIT(in, i));
+        out |= bit << i;
+
+        bit = crypto1_filter_inline(even);
+        odd = odd << 1 |
+              (crypto1_feedback(even, odd) ^ (bit & encrypted) ^ FURI_BIT(in, i + 1));
+        out |= bit << (i + 1);
     }
+
+    crypto1->odd = odd;
+    crypto1->even = even;
     return out;
 }
 
-uint8_t crypto1_word(Crypto1* crypto1, uint32_t in, int is_encrypted) {
+uint32_t crypto1_word(Crypto1* crypto1, uint32_t in, int is_encrypted) {
     furi_assert(crypto1);
+    uint32_t odd = crypto1->odd;
+    uint32_t even = crypto1->even;
+    uint32_t encrypted = !!is_encrypted;
     uint32_t out = 0;
-    for(uint8_t i = 0; i < 32; i++) {
-        out |= crypto1_bit(crypto1, BEBIT(in, i), is_encrypted) << (24 ^ i);
+
+    for(uint8_t i = 0; i < 32; i += 2) {
+        uint32_t bit = crypto1_filter_inline(odd);
+        even = even << 1 | (crypto1_feedback(odd, even) ^ (bit & encrypted) ^ BEBIT(in, i));
+        out |= bit << (24 ^ i);
+
+        bit = crypto1_filter_inline(even);
+        odd = odd << 1 |
+              (crypto1_feedback(even, odd) ^ (bit & encrypted) ^ BEBIT(in, i + 1));
+        out |= bit << (24 ^ (i + 1));
     }
+
+    crypto1->odd = odd;
+    crypto1->even = even;
     return out;
 }
 
+uint8_t crypto1_rollback_bit(Crypto1* crypto1, uint8_t in, int is_encrypted) {
+    furi_assert(crypto1);
+    crypto1->odd &= 0xffffff;
+    FURI_SWAP(crypto1->odd, crypto1->even);
+
+    // Bit shifted out of the even half is the one the feedback was computed with
+    uint32_t feed = crypto1->even & 1;
+    crypto1->even >>= 1;
+    feed ^= crypto1_feedback(crypto1->odd, crypto1->even);
+    feed ^= !!in;
+    uint8_t out = crypto1_filter_inline(crypto1->odd);
+    feed ^= out & (!!is_encrypted);
+
+    crypto1->even |= feed << 23;
+    return out;
+}
+
+uint8_t crypto1_rollback_byte(Crypto1* crypto1, uint8_t in, int is_encrypted) {
+    furi_assert(crypto1);
+    uint8_t out = 0;
+    for(int8_t i = 7; i >= 0; i--) {
+        out |= crypto1_rollback_bit(crypto1, FURI_BIT(in, i), is_encrypted) << i;
+    }
+    return out;
+}
+
+uint32_t crypto1_rollback_word(Crypto1* crypto1, uint32_t in, int is_encrypted) {
+    furi_assert(crypto1);
+    uint32_t out = 0;
+    for(int8_t i = 31; i >= 0; i--) {
+        out |= (uint32_t)crypto1_rollback_bit(crypto1, BEBIT(in, i), is_encrypted) << (24 ^ i);
+    }
+    return out;
+}
+
+uint64_t crypto1_get_key(Crypto1* crypto1) {
+    furi_assert(crypto1);
+    uint64_t key = 0;
+    for(int8_t i = 23; i >= 0; i--) {
+        key = key << 1 | FURI_BIT(crypto1->odd, i ^ 3);
+        key = key << 1 | FURI_BIT(crypto1->even, i ^ 3);
+    }
+    return key;
+}
+
 uint32_t prng_successor(uint32_t x, uint32_t n) {
     SWAPENDIAN(x);
     while(n--) x = x >> 1 | (x >> 16 ^ x >> 18 ^ x >> 19 ^ x >> 21) << 31;
@@ -16,7 +16,21 @@ uint8_t crypto1_bit(Crypto1* crypto1, uint8_t in, int is_encrypted);
 
 uint8_t crypto1_byte(Crypto1* crypto1, uint8_t in, int is_encrypted);
 
-uint8_t crypto1_word(Crypto1* crypto1, uint32_t in, int is_encrypted);
+uint32_t crypto1_word(Crypto1* crypto1, uint32_t in, int is_encrypted);
+
+/** Step the cipher one bit back, undoing crypto1_bit called with the same arguments.
+ * Only the 48 bits of the LFSR are restored.
+ */
+uint8_t crypto1_rollback_bit(Crypto1* crypto1, uint8_t in, int is_encrypted);
+
+/** Step the cipher one byte back, undoing crypto1_byte called with the same arguments */
+uint8_t crypto1_rollback_byte(Crypto1* crypto1, uint8_t in, int is_encrypted);
+
+/** Step the cipher one word back, undoing crypto1_word called with the same arguments */
+uint32_t crypto1_rollback_word(Crypto1* crypto1, uint32_t in, int is_encrypted);
+
+/** Get the key the cipher would be initialized with to be in its current state */
+uint64_t crypto1_get_key(Crypto1* crypto1);
 
 uint32_t crypto1_filter(uint32_t in);
 
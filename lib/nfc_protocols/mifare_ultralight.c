@@ -152,6 +152,46 @@ uint16_t mf_ul_prepare_write(uint8_t* dest, uint16_t page_addr, uint32_t data) {
     return 6;
 }
 
+static void mf_ul_emulation_update_counter(MifareUlDevice* mf_ul_emulate, uint8_t cnt_num) {
+    uint8_t* response = mf_ul_emulate->read_cnt_response[cnt_num];
+    response[0] = mf_ul_emulate->data.counter[cnt_num] >> 16;
+    response[1] = mf_ul_emulate->data.counter[cnt_num] >> 8;
+    response[2] = mf_ul_emulate->data.counter[cnt_num];
+}
+
+static void mf_ul_emulation_update_tail(MifareUlDevice* mf_ul_emulate) {
+    // READ responses starting on the last pages roll over to page 0 or hide auth data
+    uint16_t page_num = mf_ul_emulate->page_num;
+    for(uint16_t start_page = mf_ul_emulate->tail_page; start_page < page_num; start_page++) {
+        uint8_t* response =
+            mf_ul_emulate->tail_read_response[start_page - mf_ul_emulate->tail_page];
+        for(uint8_t i = 0; i < MF_UL_READ_RESPONSE_SIZE / 4; i++) {
+            uint16_t page = (start_page + i) % page_num;
+            memcpy(&response[i * 4], &mf_ul_emulate->data.data[page * 4], 4);
+            if(mf_ul_emulate->auth_data && page == mf_ul_emulate->pwd_page) {
+                memset(&response[i * 4], 0, 4);
+            } else if(mf_ul_emulate->auth_data && page == mf_ul_emulate->pwd_page + 1) {
+                memset(&response[i * 4], 0, 2);
+            }
+        }
+    }
+}
+
+static void mf_ul_emulation_update_page(MifareUlDevice* mf_ul_emulate, uint16_t page) {
+    // Writable pages never hold auth data, only plain copies have to be patched
+    uint16_t page_num = mf_ul_emulate->page_num;
+    for(uint16_t start_page = mf_ul_emulate->tail_page; start_page < page_num; start_page++) {
+        uint16_t offset = (page + page_num - start_page) % page_num;
+        if(offset < MF_UL_READ_RESPONSE_SIZE / 4) {
+            memcpy(
+                &mf_ul_emulate->tail_read_response[start_page - mf_ul_emulate->tail_page]
+                                                  [offset * 4],
+                &mf_ul_emulate->data.data[page * 4],
+                4);
+        }
+    }
+}
+
 void mf_ul_prepare_emulation(MifareUlDevice* mf_ul_emulate, MifareUlData* data) {
     mf_ul_emulate->data = *data;
     mf_ul_emulate->auth_data = NULL;
@@ -177,9 +217,22 @@ void mf_ul_prepare_emulation(MifareUlDevice* mf_ul_emulate, MifareUlData* data)
         mf_ul_emulate->support_fast_read = true;
     }
 
+    mf_ul_emulate->page_num = data->data_size / 4;
+    mf_ul_emulate->pwd_page = 0;
     if(mf_ul_emulate->data.type >= MfUltralightTypeNTAG213) {
-        uint16_t pwd_page = (data->data_size / 4) - 2;
-        mf_ul_emulate->auth_data = (MifareUlAuthData*)&data->data[pwd_page * 4];
+        mf_ul_emulate->pwd_page = mf_ul_emulate->page_num - 2;
+        mf_ul_emulate->auth_data =
+            (MifareUlAuthData*)&mf_ul_emulate->data.data[mf_ul_emulate->pwd_page * 4];
+    }
+
+    if(mf_ul_emulate->page_num > MF_UL_EMULATION_TAIL_PAGES) {
+        mf_ul_emulate->tail_page = mf_ul_emulate->page_num - MF_UL_EMULATION_TAIL_PAGES;
+    } else {
+        mf_ul_emulate->tail_page = 0;
+    }
+    mf_ul_emulation_update_tail(mf_ul_emulate);
+    for(uint8_t i = 0; i < 3; i++) {
+        mf_ul_emulation_update_counter(mf_ul_emulate, i);
     }
 }
 
@@ -188,9 +241,9 @@ void mf_ul_protect_auth_data_on_read_command(
     uint8_t start_page,
     uint8_t end_page,
     MifareUlDevice* mf_ul_emulate) {
-    if(mf_ul_emulate->data.type >= MfUltralightTypeNTAG213) {
-        uint8_t pwd_page = (mf_ul_emulate->data.data_size / 4) - 2;
-        uint8_t pack_page = pwd_page + 1;
+    if(mf_ul_emulate->auth_data) {
+        uint16_t pwd_page = mf_ul_emulate->pwd_page;
+        uint16_t pack_page = pwd_page + 1;
         if((start_page <= pwd_page) && (end_page >= pwd_page)) {
             memset(&tx_buff[(pwd_page - start_page) * 4], 0, 4);
         }
@@ -210,7 +263,7 @@ bool mf_ul_prepare_emulation_response(
     furi_assert(context);
     MifareUlDevice* mf_ul_emulate = context;
     uint8_t cmd = buff_rx[0];
-    uint16_t page_num = mf_ul_emulate->data.data_size / 4;
+    uint16_t page_num = mf_ul_emulate->page_num;
     uint16_t tx_bytes = 0;
     uint16_t tx_bits = 0;
     bool command_parsed = false;
@@ -220,6 +273,7 @@ bool mf_ul_prepare_emulation_response(
         // Compatibility write is the only one composit command
         if(buff_rx_len == 16) {
             memcpy(&mf_ul_emulate->data.data[mf_ul_emulate->comp_write_page_addr * 4], buff_rx, 4);
+            mf_ul_emulation_update_page(mf_ul_emulate, mf_ul_emulate->comp_write_page_addr);
             mf_ul_emulate->data_changed = true;
             // Send ACK message
             buff_tx[0] = 0x0A;
@@ -238,20 +292,16 @@ bool mf_ul_prepare_emulation_response(
     } else if(cmd == MF_UL_READ_CMD) {
         uint8_t start_page = buff_rx[1];
         if(start_page < page_num) {
-            tx_bytes = 16;
-            if(start_page + 4 > page_num) {
-                // Handle roll-over mechanism
-                uint8_t end_pages_num = page_num - start_page;
-                memcpy(buff_tx, &mf_ul_emulate->data.data[start_page * 4], end_pages_num * 4);
-                memcpy(
-                    &buff_tx[end_pages_num * 4],
-                    mf_ul_emulate->data.data,
-                    (4 - end_pages_num) * 4);
-            } else {
+            tx_bytes = MF_UL_READ_RESPONSE_SIZE;
+            if(start_page < mf_ul_emulate->tail_page) {
                 memcpy(buff_tx, &mf_ul_emulate->data.data[start_page * 4], tx_bytes);
+            } else {
+                // Roll-over and auth data protection are already applied
+                memcpy(
+                    buff_tx,
+                    mf_ul_emulate->tail_read_response[start_page - mf_ul_emulate->tail_page],
+                    tx_bytes);
             }
-            mf_ul_protect_auth_data_on_read_command(
-                buff_tx, start_page, (start_page + 4), mf_ul_emulate);
             *data_type = FURI_HAL_NFC_TXRX_DEFAULT;
             command_parsed = true;
         }
@@ -272,6 +322,7 @@ bool mf_ul_prepare_emulation_response(
         uint8_t write_page = buff_rx[1];
         if((write_page > 1) && (write_page < page_num - 2)) {
             memcpy(&mf_ul_emulate->data.data[write_page * 4], &buff_rx[2], 4);
+            mf_ul_emulation_update_page(mf_ul_emulate, write_page);
             mf_ul_emulate->data_changed = true;
             // ACK
             buff_tx[0] = 0x0A;
@@ -293,10 +344,8 @@ bool mf_ul_prepare_emulation_response(
     } else if(cmd == MF_UL_READ_CNT) {
         uint8_t cnt_num = buff_rx[1];
         if(cnt_num < 3) {
-            buff_tx[0] = mf_ul_emulate->data.counter[cnt_num] >> 16;
-            buff_tx[1] = mf_ul_emulate->data.counter[cnt_num] >> 8;
-            buff_tx[2] = mf_ul_emulate->data.counter[cnt_num];
-            tx_bytes = 3;
+            tx_bytes = sizeof(mf_ul_emulate->read_cnt_response[cnt_num]);
+            memcpy(buff_tx, mf_ul_emulate->read_cnt_response[cnt_num], tx_bytes);
             *data_type = FURI_HAL_NFC_TXRX_DEFAULT;
             command_parsed = true;
         }
@@ -305,6 +354,7 @@ bool mf_ul_prepare_emulation_response(
         uint32_t inc = (buff_rx[2] | (buff_rx[3] << 8) | (buff_rx[4] << 16));
         if((cnt_num < 3) && (mf_ul_emulate->data.counter[cnt_num] + inc < 0x00FFFFFF)) {
             mf_ul_emulate->data.counter[cnt_num] += inc;
+            mf_ul_emulation_update_counter(mf_ul_emulate, cnt_num);
             mf_ul_emulate->data_changed = true;
             // ACK
             buff_tx[0] = 0x0A;
@@ -8,6 +8,9 @@
 
 #define MF_UL_TEARING_FLAG_DEFAULT (0xBD)
 
+#define MF_UL_READ_RESPONSE_SIZE (16)
+#define MF_UL_EMULATION_TAIL_PAGES (5)
+
 #define MF_UL_HALT_START (0x50)
 #define MF_UL_GET_VERSION_CMD (0x60)
 #define MF_UL_READ_CMD (0x30)
@@ -81,6 +84,12 @@ typedef struct {
     MifareUlAuthData* auth_data;
     bool comp_write_cmd_started;
     uint8_t comp_write_page_addr;
+    // Emulation responses prepared in advance and patched on data changes
+    uint16_t page_num;
+    uint16_t pwd_page;
+    uint16_t tail_page;
+    uint8_t tail_read_response[MF_UL_EMULATION_TAIL_PAGES][MF_UL_READ_RESPONSE_SIZE];
+    uint8_t read_cnt_response[3][3];
 } MifareUlDevice;
 
 bool mf_ul_check_card_type(uint8_t ATQA0, uint8_t ATQA1, uint8_t SAK);
@@ -115,6 +124,14 @@ void mf_ul_parse_fast_read_response(
 
 uint16_t mf_ul_prepare_write(uint8_t* dest, uint16_t page_addr, uint32_t data);
 
+/** Prepare emulation state and all static responses
+ *
+ * READ responses that need roll-over or hide password pages are built here, so
+ * mf_ul_prepare_emulation_response only copies data. They are patched on WRITE and
+ * counters changes.
+ * @param mf_ul_emulate MifareUlDevice to prepare
+ * @param data tag data to emulate, copied
+ */
 void mf_ul_prepare_emulation(MifareUlDevice* mf_ul_emulate, MifareUlData* data);
 bool mf_ul_prepare_emulation_response(
     uint8_t* buff_rx,
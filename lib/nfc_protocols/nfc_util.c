@@ -46,18 +46,93 @@ uint8_t nfc_util_odd_parity8(uint8_t data) {
     return nfc_util_odd_byte_parity[data];
 }
 
-void nfc_util_merge_data_and_parity(
-    uint8_t* data,
+/* 8 data bytes with their parity bits make exactly 9 bitstream bytes. Full groups go
+ * through one 64 bit word, the rest is done byte by byte with an accumulator. */
+
+uint16_t nfc_util_merge_data_and_parity(
+    const uint8_t* data,
     uint16_t data_len,
-    uint8_t* parity,
-    uint16_t parity_len,
-    uint8_t* res,
-    uint16_t* res_len);
+    const uint8_t* parity,
+    uint8_t* res) {
+    furi_assert(data);
+    furi_assert(parity);
+    furi_assert(res);
+
+    uint16_t i = 0;
+    for(; i + 8 <= data_len; i += 8) {
+        uint8_t par = parity[i / 8];
+        uint64_t word = 0;
+        for(uint8_t j = 0; j < 7; j++) {
+            uint32_t value = data[i + j] | (par >> (7 - j) & 1) << 8;
+            word |= (uint64_t)value << (9 * j);
+        }
+        word |= (uint64_t)data[i + 7] << 63;
+        memcpy(res, &word, sizeof(word));
+        res[8] = data[i + 7] >> 1 | (par & 1) << 7;
+        res += 9;
+    }
+
+    uint32_t acc = 0;
+    uint8_t acc_bits = 0;
+    for(; i < data_len; i++) {
+        acc |= (data[i] | (uint32_t)FURI_BIT(parity[i / 8], 7 - i % 8) << 8) << acc_bits;
+        acc_bits += 9;
+        while(acc_bits >= 8) {
+            *res++ = acc;
+            acc >>= 8;
+            acc_bits -= 8;
+        }
+    }
+    if(acc_bits) {
+        *res = acc;
+    }
 
-void nfc_util_split_data_and_parity(
+    return data_len * 9;
+}
+
+uint16_t nfc_util_split_data_and_parity(
+    const uint8_t* bitstream,
+    uint16_t bits,
     uint8_t* data,
-    uint16_t data_len,
-    uint8_t* parity,
-    uint16_t parity_len,
-    uint8_t* res,
-    uint16_t* res_len);
\ No newline at end of file
+    uint8_t* parity) {
+    furi_assert(bitstream);
+    furi_assert(data);
+    furi_assert(parity);
+
+    if(bits % 9 != 0) {
+        return 0;
+    }
+    uint16_t data_len = bits / 9;
+
+    uint16_t i = 0;
+    for(; i + 8 <= data_len; i += 8) {
+        uint64_t word;
+        memcpy(&word, bitstream, sizeof(word));
+        uint8_t par = 0;
+        for(uint8_t j = 0; j < 7; j++) {
+            data[i + j] = word >> (9 * j);
+            par |= (word >> (9 * j + 8) & 1) << (7 - j);
+        }
+        data[i + 7] = word >> 63 | bitstream[8] << 1;
+        parity[i / 8] = par | bitstream[8] >> 7;
+        bitstream += 9;
+    }
+
+    if(i < data_len) {
+        parity[i / 8] = 0;
+    }
+    uint32_t acc = 0;
+    uint8_t acc_bits = 0;
+    for(; i < data_len; i++) {
+        while(acc_bits < 9) {
+            acc |= (uint32_t)*bitstream++ << acc_bits;
+            acc_bits += 8;
+        }
+        data[i] = acc;
+        parity[i / 8] |= (acc >> 8 & 1) << (7 - i % 8);
+        acc >>= 9;
+        acc_bits -= 9;
+    }
+
+    return data_len;
+}
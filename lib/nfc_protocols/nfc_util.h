@@ -10,18 +10,28 @@ uint8_t nfc_util_even_parity32(uint32_t data);
 
 uint8_t nfc_util_odd_parity8(uint8_t data);
 
-void nfc_util_merge_data_and_parity(
-    uint8_t* data,
+/** Pack data bytes and their parity bits into a bitstream, 9 bits per byte, LSB first
+ * @param data data bytes
+ * @param data_len number of data bytes
+ * @param parity parity bits, MSB of parity[0] is the parity of data[0]
+ * @param res bitstream, (data_len * 9 + 7) / 8 bytes
+ * @return bitstream length in bits
+ */
+uint16_t nfc_util_merge_data_and_parity(
+    const uint8_t* data,
     uint16_t data_len,
-    uint8_t* parity,
-    uint16_t parity_len,
-    uint8_t* res,
-    uint16_t* res_len);
+    const uint8_t* parity,
+    uint8_t* res);
 
-void nfc_util_split_data_and_parity(
+/** Unpack a bitstream made by nfc_util_merge_data_and_parity
+ * @param bitstream bitstream
+ * @param bits bitstream length in bits
+ * @param data data bytes, bits / 9 bytes
+ * @param parity parity bits, (bits / 9 + 7) / 8 bytes
+ * @return number of data bytes, 0 if bits is not a multiple of 9
+ */
+uint16_t nfc_util_split_data_and_parity(
+    const uint8_t* bitstream,
+    uint16_t bits,
     uint8_t* data,
-    uint16_t data_len,
-    uint8_t* parity,
-    uint16_t parity_len,
-    uint8_t* res,
-    uint16_t* res_len);
+    uint8_t* parity);
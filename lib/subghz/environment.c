@@ -1,9 +1,14 @@
 #include "environment.h"
 
+#define TAG "SubGhzEnvironment"
+
 struct SubGhzEnvironment {
     SubGhzKeystore* keystore;
     const char* came_atomo_rainbow_table_file_name;
     const char* nice_flor_s_rainbow_table_file_name;
+    // Opened on first use, shared by every decoder allocated with this environment
+    SubGhzKeystoreRawReader* came_atomo_rainbow_table;
+    SubGhzKeystoreRawReader* nice_flor_s_rainbow_table;
 };
 
 SubGhzEnvironment* subghz_environment_alloc() {
@@ -12,13 +17,35 @@ SubGhzEnvironment* subghz_environment_alloc() {
     instance->keystore = subghz_keystore_alloc();
     instance->came_atomo_rainbow_table_file_name = NULL;
     instance->nice_flor_s_rainbow_table_file_name = NULL;
+    instance->came_atomo_rainbow_table = NULL;
+    instance->nice_flor_s_rainbow_table = NULL;
 
     return instance;
 }
 
+static void subghz_environment_free_rainbow_table(SubGhzKeystoreRawReader** rainbow_table) {
+    if(*rainbow_table) {
+        subghz_keystore_raw_reader_free(*rainbow_table);
+        *rainbow_table = NULL;
+    }
+}
+
+static SubGhzKeystoreRawReader* subghz_environment_get_rainbow_table(
+    SubGhzKeystoreRawReader** rainbow_table,
+    const char* file_name) {
+    if(!*rainbow_table && file_name && strcmp(file_name, "")) {
+        FURI_LOG_I(TAG, "Loading rainbow table from %s", file_name);
+        *rainbow_table = subghz_keystore_raw_reader_alloc();
+        subghz_keystore_raw_reader_open(*rainbow_table, file_name);
+    }
+    return *rainbow_table;
+}
+
 void subghz_environment_free(SubGhzEnvironment* instance) {
     furi_assert(instance);
 
+    subghz_environment_free_rainbow_table(&instance->came_atomo_rainbow_table);
+    subghz_environment_free_rainbow_table(&instance->nice_flor_s_rainbow_table);
     subghz_keystore_free(instance->keystore);
 
     free(instance);
@@ -42,6 +69,7 @@ void subghz_environment_set_came_atomo_rainbow_table_file_name(
     furi_assert(instance);
 
     instance->came_atomo_rainbow_table_file_name = filename;
+    subghz_environment_free_rainbow_table(&instance->came_atomo_rainbow_table);
 }
 
 const char*
@@ -51,12 +79,21 @@ const char*
     return instance->came_atomo_rainbow_table_file_name;
 }
 
+SubGhzKeystoreRawReader*
+    subghz_environment_get_came_atomo_rainbow_table(SubGhzEnvironment* instance) {
+    furi_assert(instance);
+
+    return subghz_environment_get_rainbow_table(
+        &instance->came_atomo_rainbow_table, instance->came_atomo_rainbow_table_file_name);
+}
+
 void subghz_environment_set_nice_flor_s_rainbow_table_file_name(
     SubGhzEnvironment* instance,
     const char* filename) {
     furi_assert(instance);
 
     instance->nice_flor_s_rainbow_table_file_name = filename;
+    subghz_environment_free_rainbow_table(&instance->nice_flor_s_rainbow_table);
 }
 
 const char*
@@ -65,3 +102,11 @@ const char*
 
     return instance->nice_flor_s_rainbow_table_file_name;
 }
+
+SubGhzKeystoreRawReader*
+    subghz_environment_get_nice_flor_s_rainbow_table(SubGhzEnvironment* instance) {
+    furi_assert(instance);
+
+    return subghz_environment_get_rainbow_table(
+        &instance->nice_flor_s_rainbow_table, instance->nice_flor_s_rainbow_table_file_name);
+}
@@ -48,6 +48,15 @@ void subghz_environment_set_came_atomo_rainbow_table_file_name(
  */
 const char* subghz_environment_get_came_atomo_rainbow_table_file_name(SubGhzEnvironment* instance);
 
+/**
+ * Get Came Atomo rainbow table, opened on first use and shared by the environment decoders.
+ * @param instance Pointer to a SubGhzEnvironment instance
+ * @return SubGhzKeystoreRawReader* pointer to a SubGhzKeystoreRawReader instance,
+ * NULL if no file is set
+ */
+SubGhzKeystoreRawReader*
+    subghz_environment_get_came_atomo_rainbow_table(SubGhzEnvironment* instance);
+
 /**
  * Set filename to work with Nice Flor-S.
  * @param instance Pointer to a SubGhzEnvironment instance
@@ -64,3 +73,12 @@ void subghz_environment_set_nice_flor_s_rainbow_table_file_name(
  */
 const char*
     subghz_environment_get_nice_flor_s_rainbow_table_file_name(SubGhzEnvironment* instance);
+
+/**
+ * Get Nice Flor-S rainbow table, opened on first use and shared by the environment decoders.
+ * @param instance Pointer to a SubGhzEnvironment instance
+ * @return SubGhzKeystoreRawReader* pointer to a SubGhzKeystoreRawReader instance,
+ * NULL if no file is set
+ */
+SubGhzKeystoreRawReader*
+    subghz_environment_get_nice_flor_s_rainbow_table(SubGhzEnvironment* instance);
@@ -62,3 +62,15 @@ uint8_t subghz_protocol_decoder_base_get_hash_data(SubGhzProtocolDecoderBase* de
 
     return hash;
 }
+
+void subghz_protocol_decoder_base_set_wake(
+    SubGhzProtocolDecoderWake* wake,
+    bool level,
+    uint32_t center,
+    uint32_t delta) {
+    furi_assert(wake);
+    furi_assert(delta);
+    wake->level = level;
+    wake->duration_min = (center >= delta) ? center - delta + 1 : 0;
+    wake->duration_max = center + delta - 1;
+}
@@ -70,6 +70,20 @@ bool subghz_protocol_decoder_base_deserialize(
  */
 uint8_t subghz_protocol_decoder_base_get_hash_data(SubGhzProtocolDecoderBase* decoder_base);
 
+/**
+ * Fill the pulse window that can take an idle decoder out of its reset state.
+ * Matches the DURATION_DIFF(duration, center) < delta check used by decoders.
+ * @param wake Pointer to a SubGhzProtocolDecoderWake instance
+ * @param level Signal level true-high false-low
+ * @param center Expected duration, us
+ * @param delta Allowed deviation, us
+ */
+void subghz_protocol_decoder_base_set_wake(
+    SubGhzProtocolDecoderWake* wake,
+    bool level,
+    uint32_t center,
+    uint32_t delta);
+
 // Encoder Base
 typedef struct SubGhzProtocolEncoderBase SubGhzProtocolEncoderBase;
 
@@ -53,6 +53,8 @@ const SubGhzProtocolDecoder subghz_protocol_came_decoder = {
     .serialize = subghz_protocol_decoder_came_serialize,
     .deserialize = subghz_protocol_decoder_came_deserialize,
     .get_string = subghz_protocol_decoder_came_get_string,
+
+    .get_wake = subghz_protocol_decoder_came_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_came_encoder = {
@@ -272,6 +274,17 @@ void subghz_protocol_decoder_came_feed(void* context, bool level, uint32_t durat
     }
 }
 
+bool subghz_protocol_decoder_came_get_wake(void* context, SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderCame* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake,
+        false,
+        subghz_protocol_came_const.te_short * 51,
+        subghz_protocol_came_const.te_delta * 51);
+    return instance->decoder.parser_step == CameDecoderStepReset;
+}
+
 uint8_t subghz_protocol_decoder_came_get_hash_data(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderCame* instance = context;
@@ -37,6 +37,14 @@ void subghz_protocol_decoder_came_atomo_reset(void* context);
  */
 void subghz_protocol_decoder_came_atomo_feed(void* context, bool level, uint32_t duration);
 
+/**
+ * Getting the pulse that can take the decoder out of its reset state.
+ * @param context Pointer to a SubGhzProtocolDecoderCameAtomo instance
+ * @param wake Pointer to a SubGhzProtocolDecoderWake instance
+ * @return true If the decoder is idle and ignores any other pulse
+ */
+bool subghz_protocol_decoder_came_atomo_get_wake(void* context, SubGhzProtocolDecoderWake* wake);
+
 /**
  * Getting the hash sum of the last randomly received parcel.
  * @param context Pointer to a SubGhzProtocolDecoderCameAtomo instance
@@ -81,6 +81,8 @@ const SubGhzProtocolDecoder subghz_protocol_came_twee_decoder = {
     .serialize = subghz_protocol_decoder_came_twee_serialize,
     .deserialize = subghz_protocol_decoder_came_twee_deserialize,
     .get_string = subghz_protocol_decoder_came_twee_get_string,
+
+    .get_wake = subghz_protocol_decoder_came_twee_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_came_twee_encoder = {
@@ -407,6 +409,17 @@ void subghz_protocol_decoder_came_twee_feed(void* context, bool level, uint32_t
     }
 }
 
+bool subghz_protocol_decoder_came_twee_get_wake(void* context, SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderCameTwee* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake,
+        false,
+        subghz_protocol_came_twee_const.te_long * 51,
+        subghz_protocol_came_twee_const.te_delta * 20);
+    return instance->decoder.parser_step == CameTweeDecoderStepReset;
+}
+
 uint8_t subghz_protocol_decoder_came_twee_get_hash_data(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderCameTwee* instance = context;
@@ -47,6 +47,8 @@ const SubGhzProtocolDecoder subghz_protocol_faac_slh_decoder = {
     .serialize = subghz_protocol_decoder_faac_slh_serialize,
     .deserialize = subghz_protocol_decoder_faac_slh_deserialize,
     .get_string = subghz_protocol_decoder_faac_slh_get_string,
+
+    .get_wake = subghz_protocol_decoder_faac_slh_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_faac_slh_encoder = {
@@ -159,6 +161,17 @@ void subghz_protocol_decoder_faac_slh_feed(void* context, bool level, uint32_t d
     }
 }
 
+bool subghz_protocol_decoder_faac_slh_get_wake(void* context, SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderFaacSLH* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake,
+        true,
+        subghz_protocol_faac_slh_const.te_long * 2,
+        subghz_protocol_faac_slh_const.te_delta * 3);
+    return instance->decoder.parser_step == FaacSLHDecoderStepReset;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
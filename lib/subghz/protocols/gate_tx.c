@@ -47,6 +47,8 @@ const SubGhzProtocolDecoder subghz_protocol_gate_tx_decoder = {
     .serialize = subghz_protocol_decoder_gate_tx_serialize,
     .deserialize = subghz_protocol_decoder_gate_tx_deserialize,
     .get_string = subghz_protocol_decoder_gate_tx_get_string,
+
+    .get_wake = subghz_protocol_decoder_gate_tx_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_gate_tx_encoder = {
@@ -263,6 +265,17 @@ void subghz_protocol_decoder_gate_tx_feed(void* context, bool level, uint32_t du
     }
 }
 
+bool subghz_protocol_decoder_gate_tx_get_wake(void* context, SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderGateTx* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake,
+        false,
+        subghz_protocol_gate_tx_const.te_short * 47,
+        subghz_protocol_gate_tx_const.te_delta * 47);
+    return instance->decoder.parser_step == GateTXDecoderStepReset;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
@@ -49,6 +49,8 @@ const SubGhzProtocolDecoder subghz_protocol_hormann_decoder = {
     .serialize = subghz_protocol_decoder_hormann_serialize,
     .deserialize = subghz_protocol_decoder_hormann_deserialize,
     .get_string = subghz_protocol_decoder_hormann_get_string,
+
+    .get_wake = subghz_protocol_decoder_hormann_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_hormann_encoder = {
@@ -290,6 +292,17 @@ void subghz_protocol_decoder_hormann_feed(void* context, bool level, uint32_t du
     }
 }
 
+bool subghz_protocol_decoder_hormann_get_wake(void* context, SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderHormann* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake,
+        true,
+        subghz_protocol_hormann_const.te_short * 64,
+        subghz_protocol_hormann_const.te_delta * 64);
+    return instance->decoder.parser_step == HormannDecoderStepReset;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
@@ -47,6 +47,8 @@ const SubGhzProtocolDecoder subghz_protocol_ido_decoder = {
     .deserialize = subghz_protocol_decoder_ido_deserialize,
     .serialize = subghz_protocol_decoder_ido_serialize,
     .get_string = subghz_protocol_decoder_ido_get_string,
+
+    .get_wake = subghz_protocol_decoder_ido_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_ido_encoder = {
@@ -158,6 +160,17 @@ void subghz_protocol_decoder_ido_feed(void* context, bool level, uint32_t durati
     }
 }
 
+bool subghz_protocol_decoder_ido_get_wake(void* context, SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderIDo* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake,
+        true,
+        subghz_protocol_ido_const.te_short * 10,
+        subghz_protocol_ido_const.te_delta * 5);
+    return instance->decoder.parser_step == IDoDecoderStepReset;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
@@ -59,6 +59,8 @@ const SubGhzProtocolDecoder subghz_protocol_keeloq_decoder = {
     .serialize = subghz_protocol_decoder_keeloq_serialize,
     .deserialize = subghz_protocol_decoder_keeloq_deserialize,
     .get_string = subghz_protocol_decoder_keeloq_get_string,
+
+    .get_wake = subghz_protocol_decoder_keeloq_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_keeloq_encoder = {
@@ -127,35 +129,30 @@ static bool subghz_protocol_keeloq_gen_data(SubGhzProtocolEncoderKeeloq* instanc
                        instance->generic.cnt;
     uint32_t hop = 0;
     uint64_t man = 0;
-    int res = 0;
-
-    for
-        M_EACH(manufacture_code, *subghz_keystore_get_data(instance->keystore), SubGhzKeyArray_t) {
-            res = strcmp(string_get_cstr(manufacture_code->name), instance->manufacture_name);
-            if(res == 0) {
-                switch(manufacture_code->type) {
-                case KEELOQ_LEARNING_SIMPLE:
-                    //Simple Learning
-                    hop = subghz_protocol_keeloq_common_encrypt(decrypt, manufacture_code->key);
-                    break;
-                case KEELOQ_LEARNING_NORMAL:
-                    //Simple Learning
-                    man =
-                        subghz_protocol_keeloq_common_normal_learning(fix, manufacture_code->key);
-                    hop = subghz_protocol_keeloq_common_encrypt(decrypt, man);
-                    break;
-                case KEELOQ_LEARNING_MAGIC_XOR_TYPE_1:
-                    man = subghz_protocol_keeloq_common_magic_xor_type1_learning(
-                        instance->generic.serial, manufacture_code->key);
-                    hop = subghz_protocol_keeloq_common_encrypt(decrypt, man);
-                    break;
-                case KEELOQ_LEARNING_UNKNOWN:
-                    hop = 0; //todo
-                    break;
-                }
-                break;
-            }
+
+    SubGhzKey* manufacture_code =
+        subghz_keystore_get_key_by_name(instance->keystore, instance->manufacture_name);
+    if(manufacture_code) {
+        switch(manufacture_code->type) {
+        case KEELOQ_LEARNING_SIMPLE:
+            //Simple Learning
+            hop = subghz_protocol_keeloq_common_encrypt(decrypt, manufacture_code->key);
+            break;
+        case KEELOQ_LEARNING_NORMAL:
+            //Simple Learning
+            man = subghz_protocol_keeloq_common_normal_learning(fix, manufacture_code->key);
+            hop = subghz_protocol_keeloq_common_encrypt(decrypt, man);
+            break;
+        case KEELOQ_LEARNING_MAGIC_XOR_TYPE_1:
+            man = subghz_protocol_keeloq_common_magic_xor_type1_learning(
+                instance->generic.serial, manufacture_code->key);
+            hop = subghz_protocol_keeloq_common_encrypt(decrypt, man);
+            break;
+        case KEELOQ_LEARNING_UNKNOWN:
+            hop = 0; //todo
+            break;
         }
+    }
     if(hop) {
         uint64_t yek = (uint64_t)fix << 32 | hop;
         instance->generic.data =
@@ -433,26 +430,30 @@ void subghz_protocol_decoder_keeloq_feed(void* context, bool level, uint32_t dur
     }
 }
 
+bool subghz_protocol_decoder_keeloq_get_wake(void* context, SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderKeeloq* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake, true, subghz_protocol_keeloq_const.te_short, subghz_protocol_keeloq_const.te_delta);
+    return instance->decoder.parser_step == KeeloqDecoderStepReset;
+}
+
+typedef struct {
+    uint8_t btn;
+    uint16_t end_serial;
+} SubGhzProtocolKeeloqCheckContext;
+
 /**
  * Validation of decrypt data.
- * @param instance Pointer to a SubGhzBlockGeneric instance
  * @param decrypt Decrypd data
- * @param btn Button number, 4 bit
- * @param end_serial decrement the last 10 bits of the serial number
+ * @param context Pointer to a SubGhzProtocolKeeloqCheckContext instance
  * @return true On success
  */
-static inline bool subghz_protocol_keeloq_check_decrypt(
-    SubGhzBlockGeneric* instance,
-    uint32_t decrypt,
-    uint8_t btn,
-    uint32_t end_serial) {
-    furi_assert(instance);
-    if((decrypt >> 28 == btn) && (((((uint16_t)(decrypt >> 16)) & 0xFF) == end_serial) ||
-                                  ((((uint16_t)(decrypt >> 16)) & 0xFF) == 0))) {
-        instance->cnt = decrypt & 0x0000FFFF;
-        return true;
-    }
-    return false;
+static bool subghz_protocol_keeloq_check_decrypt(uint32_t decrypt, void* context) {
+    SubGhzProtocolKeeloqCheckContext* check = context;
+    return (decrypt >> 28 == check->btn) &&
+           (((((uint16_t)(decrypt >> 16)) & 0xFF) == check->end_serial) ||
+            ((((uint16_t)(decrypt >> 16)) & 0xFF) == 0));
 }
 
 /** 
@@ -473,125 +474,27 @@ static uint8_t subghz_protocol_keeloq_check_remote_controller_selector(
     // protocol HCS300 uses 10 bits in discriminator, HCS200 uses 8 bits, for backward compatibility, we are looking for the 8-bit pattern
     // HCS300 -> uint16_t end_serial = (uint16_t)(fix & 0x3FF);
     // HCS200 -> uint16_t end_serial = (uint16_t)(fix & 0xFF);
-
-    uint16_t end_serial = (uint16_t)(fix & 0xFF);
-    uint8_t btn = (uint8_t)(fix >> 28);
+    SubGhzProtocolKeeloqCheckContext check = {
+        .btn = (uint8_t)(fix >> 28),
+        .end_serial = (uint16_t)(fix & 0xFF),
+    };
     uint32_t decrypt = 0;
-    uint64_t man;
-    uint32_t seed = 0;
-
-    for
-        M_EACH(manufacture_code, *subghz_keystore_get_data(keystore), SubGhzKeyArray_t) {
-            switch(manufacture_code->type) {
-            case KEELOQ_LEARNING_SIMPLE:
-                // Simple Learning
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, manufacture_code->key);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                break;
-            case KEELOQ_LEARNING_NORMAL:
-                // Normal Learning
-                // https://phreakerclub.com/forum/showpost.php?p=43557&postcount=37
-                man = subghz_protocol_keeloq_common_normal_learning(fix, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                break;
-            case KEELOQ_LEARNING_SECURE:
-                man = subghz_protocol_keeloq_common_secure_learning(
-                    fix, seed, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                break;
-            case KEELOQ_LEARNING_MAGIC_XOR_TYPE_1:
-                man = subghz_protocol_keeloq_common_magic_xor_type1_learning(
-                    fix, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                break;
-            case KEELOQ_LEARNING_UNKNOWN:
-                // Simple Learning
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, manufacture_code->key);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                // Check for mirrored man
-                uint64_t man_rev = 0;
-                uint64_t man_rev_byte = 0;
-                for(uint8_t i = 0; i < 64; i += 8) {
-                    man_rev_byte = (uint8_t)(manufacture_code->key >> i);
-                    man_rev = man_rev | man_rev_byte << (56 - i);
-                }
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man_rev);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                //###########################
-                // Normal Learning
-                // https://phreakerclub.com/forum/showpost.php?p=43557&postcount=37
-                man = subghz_protocol_keeloq_common_normal_learning(fix, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-
-                // Check for mirrored man
-                man = subghz_protocol_keeloq_common_normal_learning(fix, man_rev);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
 
-                // Secure Learning
-                man = subghz_protocol_keeloq_common_secure_learning(
-                    fix, seed, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-
-                // Check for mirrored man
-                man = subghz_protocol_keeloq_common_secure_learning(fix, seed, man_rev);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-
-                // Magic xor type1 learning
-                man = subghz_protocol_keeloq_common_magic_xor_type1_learning(
-                    fix, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-
-                // Check for mirrored man
-                man = subghz_protocol_keeloq_common_magic_xor_type1_learning(fix, man_rev);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man);
-                if(subghz_protocol_keeloq_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                break;
-            }
-        }
+    // Learning types and mirrored keys are checked in bit-sliced batches
+    // https://phreakerclub.com/forum/showpost.php?p=43557&postcount=37
+    SubGhzKey* manufacture_code = subghz_protocol_keeloq_common_search(
+        subghz_keystore_get_keeloq_search(keystore),
+        fix,
+        hop,
+        KEELOQ_SEARCH_ALL,
+        subghz_protocol_keeloq_check_decrypt,
+        &check,
+        &decrypt);
+    if(manufacture_code) {
+        *manufacture_name = manufacture_code->name;
+        instance->cnt = decrypt & 0x0000FFFF;
+        return 1;
+    }
 
     *manufacture_name = "Unknown";
     instance->cnt = 0;
@@ -81,4 +81,343 @@ inline uint64_t
     subghz_protocol_keeloq_common_magic_xor_type1_learning(uint32_t data, uint64_t xor) {
     data &= 0x0FFFFFFF;
     return (((uint64_t)data << 32) | data) ^ xor;
-}
\ No newline at end of file
+}
+/*
+ * Bit-sliced engine
+ *
+ * Every uint32_t word holds one bit position for KEELOQ_BATCH_LANES independent
+ * keys: bit `l` of key[n] is bit `n` of the key in lane `l`. One pass of the
+ * cipher then decrypts the same data with all lane keys at once.
+ */
+
+#define KEELOQ_SLICE_ALL 0xFFFFFFFFu
+
+typedef struct {
+    uint32_t key[64];
+    uint32_t seed[32];
+    uint16_t index[KEELOQ_BATCH_LANES];
+    uint32_t lanes;
+    uint16_t type;
+} SubGhzKeeloqKeyBatch;
+
+ARRAY_DEF(SubGhzKeeloqKeyBatchArray, SubGhzKeeloqKeyBatch, M_POD_OPLIST)
+
+#define M_OPL_SubGhzKeeloqKeyBatchArray_t() \
+    ARRAY_OPLIST(SubGhzKeeloqKeyBatchArray, M_POD_OPLIST)
+
+struct SubGhzKeeloqKeySearch {
+    SubGhzKeeloqKeyBatchArray_t batches;
+    SubGhzKeyArray_t* keys;
+};
+
+/** Transpose 32x32 bit matrix in place: bit `j` of row `i` goes to bit `i` of row `j`
+ * @param matrix - 32 rows
+ */
+static void subghz_protocol_keeloq_common_transpose(uint32_t* matrix) {
+    uint32_t mask = 0x0000FFFF;
+    for(uint32_t width = 16; width != 0; width >>= 1, mask ^= (mask << width)) {
+        for(uint32_t row = 0; row < 32; row = (row + width + 1) & ~width) {
+            uint32_t swap = ((matrix[row] >> width) ^ matrix[row + width]) & mask;
+            matrix[row] ^= swap << width;
+            matrix[row + width] ^= swap;
+        }
+    }
+}
+
+/** Pack up to KEELOQ_BATCH_LANES keys into bit-sliced form
+ * @param keys - manufacture keys (64bit)
+ * @param count - number of keys
+ * @param key - 64 bit-sliced words
+ */
+static void subghz_protocol_keeloq_common_slice_keys(
+    const uint64_t* keys,
+    size_t count,
+    uint32_t* key) {
+    furi_assert(count <= KEELOQ_BATCH_LANES);
+    memset(key, 0, sizeof(uint32_t) * 64);
+    for(size_t lane = 0; lane < count; lane++) {
+        key[lane] = (uint32_t)keys[lane];
+        key[lane + 32] = (uint32_t)(keys[lane] >> 32);
+    }
+    subghz_protocol_keeloq_common_transpose(&key[0]);
+    subghz_protocol_keeloq_common_transpose(&key[32]);
+}
+
+/** Bit-sliced Simple Learning Decrypt
+ * @param data - keeloq encrypt data, same for every lane
+ * @param key - 64 bit-sliced key words
+ * @param result - 32 bit-sliced words of decrypted data
+ */
+static void subghz_protocol_keeloq_common_decrypt_sliced(
+    const uint32_t data,
+    const uint32_t* key,
+    uint32_t* result) {
+    // State is kept in a ring, shifting left is a move of the ring origin
+    uint32_t x[32];
+    for(uint8_t i = 0; i < 32; i++) {
+        x[i] = bit(data, i) ? KEELOQ_SLICE_ALL : 0;
+    }
+
+    uint32_t origin = 0;
+    for(uint32_t r = 0; r < 528; r++) {
+        const uint32_t a = x[origin];
+        const uint32_t b = x[(origin + 8) & 31];
+        const uint32_t c = x[(origin + 19) & 31];
+        const uint32_t d = x[(origin + 25) & 31];
+        const uint32_t e = x[(origin + 30) & 31];
+        // KEELOQ_NLF in algebraic normal form:
+        // a^b^ab^bc^ad^cd ^ e(a^ab^c^ac^bd^cd)
+        const uint32_t b_xor_c = b ^ c;
+        const uint32_t b_xor_d = b ^ d;
+        const uint32_t nlf = ((a & ~b_xor_d) ^ b ^ (c & b_xor_d)) ^
+                             (e & ((a & ~b_xor_c) ^ c ^ (d & b_xor_c)));
+
+        origin = (origin - 1) & 31;
+        // x[origin] now holds bit 31 of the state before shift
+        x[origin] ^= x[(origin + 16) & 31] ^ key[(15 - r) & 63] ^ nlf;
+    }
+
+    for(uint8_t i = 0; i < 32; i++) {
+        result[i] = x[(origin + i) & 31];
+    }
+}
+
+void subghz_protocol_keeloq_common_decrypt_batch(
+    const uint32_t data,
+    const uint64_t* keys,
+    size_t count,
+    uint32_t* result) {
+    uint32_t key[64];
+    uint32_t sliced[32];
+    subghz_protocol_keeloq_common_slice_keys(keys, count, key);
+    subghz_protocol_keeloq_common_decrypt_sliced(data, key, sliced);
+    subghz_protocol_keeloq_common_transpose(sliced);
+    memcpy(result, sliced, sizeof(uint32_t) * count);
+}
+
+SubGhzKeeloqKeySearch* subghz_protocol_keeloq_common_search_alloc() {
+    SubGhzKeeloqKeySearch* instance = malloc(sizeof(SubGhzKeeloqKeySearch));
+    SubGhzKeeloqKeyBatchArray_init(instance->batches);
+    instance->keys = NULL;
+    return instance;
+}
+
+void subghz_protocol_keeloq_common_search_free(SubGhzKeeloqKeySearch* instance) {
+    furi_assert(instance);
+    SubGhzKeeloqKeyBatchArray_clear(instance->batches);
+    free(instance);
+}
+
+static void subghz_protocol_keeloq_common_search_load_type(
+    SubGhzKeeloqKeySearch* instance,
+    uint16_t type) {
+    uint64_t keys[KEELOQ_BATCH_LANES];
+    SubGhzKeeloqKeyBatch* batch = NULL;
+    size_t count = 0;
+    size_t index = 0;
+
+    for
+        M_EACH(manufacture_code, *instance->keys, SubGhzKeyArray_t) {
+            if(manufacture_code->type == type) {
+                if(count == 0) {
+                    batch = SubGhzKeeloqKeyBatchArray_push_new(instance->batches);
+                    batch->type = type;
+                }
+                batch->index[count] = index;
+                keys[count++] = manufacture_code->key;
+                if(count == KEELOQ_BATCH_LANES) {
+                    subghz_protocol_keeloq_common_slice_keys(keys, count, batch->key);
+                    batch->lanes = KEELOQ_SLICE_ALL;
+                    count = 0;
+                }
+            }
+            index++;
+        }
+
+    if(count) {
+        subghz_protocol_keeloq_common_slice_keys(keys, count, batch->key);
+        batch->lanes = (1u << count) - 1;
+    }
+}
+
+static int subghz_protocol_keeloq_common_batch_cmp(const void* batch_a, const void* batch_b) {
+    const SubGhzKeeloqKeyBatch* a = batch_a;
+    const SubGhzKeeloqKeyBatch* b = batch_b;
+    return (a->index[0] > b->index[0]) - (a->index[0] < b->index[0]);
+}
+
+/** Mirror bytes of bit-sliced key
+ * @param key - 64 bit-sliced key words
+ * @param mirror - 64 bit-sliced words of the byte mirrored key
+ */
+static void subghz_protocol_keeloq_common_slice_mirror(const uint32_t* key, uint32_t* mirror) {
+    for(uint8_t i = 0; i < 64; i += 8) {
+        memcpy(&mirror[56 - i], &key[i], sizeof(uint32_t) * 8);
+    }
+}
+
+void subghz_protocol_keeloq_common_search_load(
+    SubGhzKeeloqKeySearch* instance,
+    SubGhzKeyArray_t* keys) {
+    furi_assert(instance);
+    furi_assert(keys);
+    furi_assert(SubGhzKeyArray_size(*keys) <= UINT16_MAX);
+
+    instance->keys = keys;
+    SubGhzKeeloqKeyBatchArray_reset(instance->batches);
+    subghz_protocol_keeloq_common_search_load_type(instance, KEELOQ_LEARNING_UNKNOWN);
+    subghz_protocol_keeloq_common_search_load_type(instance, KEELOQ_LEARNING_SIMPLE);
+    subghz_protocol_keeloq_common_search_load_type(instance, KEELOQ_LEARNING_NORMAL);
+    subghz_protocol_keeloq_common_search_load_type(instance, KEELOQ_LEARNING_SECURE);
+    subghz_protocol_keeloq_common_search_load_type(instance, KEELOQ_LEARNING_MAGIC_XOR_TYPE_1);
+
+    // Walk batches in keystore order, that allows to stop on the first hit
+    size_t batch_count = SubGhzKeeloqKeyBatchArray_size(instance->batches);
+    if(batch_count > 1) {
+        qsort(
+            SubGhzKeeloqKeyBatchArray_get(instance->batches, 0),
+            batch_count,
+            sizeof(SubGhzKeeloqKeyBatch),
+            subghz_protocol_keeloq_common_batch_cmp);
+    }
+
+    // Secure Learning seed half does not depend on the parcel
+    uint32_t mirror[64];
+    for
+        M_EACH(batch, instance->batches, SubGhzKeeloqKeyBatchArray_t) {
+            if(batch->type == KEELOQ_LEARNING_SECURE) {
+                subghz_protocol_keeloq_common_decrypt_sliced(
+                    KEELOQ_SECURE_LEARNING_SEED, batch->key, batch->seed);
+            } else if(batch->type == KEELOQ_LEARNING_UNKNOWN) {
+                // Unknown learning keeps the seed half of the mirrored key
+                subghz_protocol_keeloq_common_slice_mirror(batch->key, mirror);
+                subghz_protocol_keeloq_common_decrypt_sliced(
+                    KEELOQ_SECURE_LEARNING_SEED, mirror, batch->seed);
+            }
+        }
+}
+
+/** Derive bit-sliced manufacture key for the learning variant
+ * @param batch - key batch
+ * @param key - bit-sliced manufacture keys of the batch, possibly mirrored
+ * @param variant - KEELOQ_SEARCH_* variant
+ * @param fix - fix part of the parcel
+ * @param man - 64 bit-sliced words of the derived key
+ * @return pointer to the key to decrypt the hop with
+ */
+static const uint32_t* subghz_protocol_keeloq_common_search_derive(
+    const SubGhzKeeloqKeyBatch* batch,
+    const uint32_t* key,
+    uint8_t variant,
+    uint32_t fix,
+    uint32_t* man) {
+    const uint32_t serial = fix & 0x0FFFFFFF;
+
+    switch(variant) {
+    case KEELOQ_SEARCH_SIMPLE:
+    case KEELOQ_SEARCH_SIMPLE_MIRROR:
+        return key;
+    case KEELOQ_SEARCH_NORMAL:
+    case KEELOQ_SEARCH_NORMAL_MIRROR:
+        subghz_protocol_keeloq_common_decrypt_sliced(serial | 0x20000000, key, &man[0]);
+        subghz_protocol_keeloq_common_decrypt_sliced(serial | 0x60000000, key, &man[32]);
+        return man;
+    case KEELOQ_SEARCH_SECURE:
+    case KEELOQ_SEARCH_SECURE_MIRROR:
+        if(variant == KEELOQ_SEARCH_SECURE && batch->type == KEELOQ_LEARNING_UNKNOWN) {
+            // Only the mirrored seed half is cached for unknown learning
+            subghz_protocol_keeloq_common_decrypt_sliced(
+                KEELOQ_SECURE_LEARNING_SEED, key, &man[0]);
+        } else {
+            memcpy(&man[0], batch->seed, sizeof(batch->seed));
+        }
+        subghz_protocol_keeloq_common_decrypt_sliced(serial, key, &man[32]);
+        return man;
+    default:
+        for(uint8_t i = 0; i < 32; i++) {
+            man[i] = key[i] ^ (bit(serial, i) ? KEELOQ_SLICE_ALL : 0);
+            man[i + 32] = key[i + 32] ^ (bit(serial, i) ? KEELOQ_SLICE_ALL : 0);
+        }
+        return man;
+    }
+}
+
+SubGhzKey* subghz_protocol_keeloq_common_search(
+    SubGhzKeeloqKeySearch* instance,
+    uint32_t fix,
+    uint32_t hop,
+    uint8_t variants,
+    SubGhzKeeloqCheckDecrypt check,
+    void* context,
+    uint32_t* decrypt) {
+    furi_assert(instance);
+    furi_assert(check);
+
+    uint32_t mirror[64];
+    uint32_t man[64];
+    uint32_t result[32];
+    size_t found_index = SIZE_MAX;
+    uint8_t found_variant = 0;
+    uint32_t found_decrypt = 0;
+
+    for
+        M_EACH(batch, instance->batches, SubGhzKeeloqKeyBatchArray_t) {
+            // Batches are ordered by the first key, nothing better is left
+            if(batch->index[0] > found_index) break;
+
+            uint8_t batch_variants = 0;
+            switch(batch->type) {
+            case KEELOQ_LEARNING_SIMPLE:
+                batch_variants = KEELOQ_SEARCH_SIMPLE;
+                break;
+            case KEELOQ_LEARNING_NORMAL:
+                batch_variants = KEELOQ_SEARCH_NORMAL;
+                break;
+            case KEELOQ_LEARNING_SECURE:
+                batch_variants = KEELOQ_SEARCH_SECURE;
+                break;
+            case KEELOQ_LEARNING_MAGIC_XOR_TYPE_1:
+                batch_variants = KEELOQ_SEARCH_MAGIC_XOR_TYPE_1;
+                break;
+            default:
+                batch_variants = KEELOQ_SEARCH_ALL;
+                subghz_protocol_keeloq_common_slice_mirror(batch->key, mirror);
+                break;
+            }
+            batch_variants &= variants;
+
+            for(uint8_t variant = 1; batch_variants; variant <<= 1) {
+                if(!(batch_variants & variant)) continue;
+                batch_variants &= ~variant;
+
+                const bool is_mirror = variant & (KEELOQ_SEARCH_SIMPLE_MIRROR |
+                                                  KEELOQ_SEARCH_NORMAL_MIRROR |
+                                                  KEELOQ_SEARCH_SECURE_MIRROR |
+                                                  KEELOQ_SEARCH_MAGIC_XOR_TYPE_1_MIRROR);
+                const uint32_t* key = subghz_protocol_keeloq_common_search_derive(
+                    batch, is_mirror ? mirror : batch->key, variant, fix, man);
+                subghz_protocol_keeloq_common_decrypt_sliced(hop, key, result);
+                subghz_protocol_keeloq_common_transpose(result);
+
+                for(uint8_t lane = 0; lane < KEELOQ_BATCH_LANES; lane++) {
+                    if(!(batch->lanes & (1u << lane))) break;
+                    size_t index = batch->index[lane];
+                    if(index > found_index) break;
+                    if(index == found_index && variant > found_variant) break;
+                    if(check(result[lane], context)) {
+                        found_index = index;
+                        found_variant = variant;
+                        found_decrypt = result[lane];
+                        break;
+                    }
+                }
+            }
+        }
+
+    if(found_index == SIZE_MAX) {
+        return NULL;
+    }
+
+    if(decrypt) *decrypt = found_decrypt;
+    return SubGhzKeyArray_get(*instance->keys, found_index);
+}
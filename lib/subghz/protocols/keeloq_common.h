@@ -25,6 +25,42 @@
 #define KEELOQ_LEARNING_SECURE 3u
 #define KEELOQ_LEARNING_MAGIC_XOR_TYPE_1 4u
 
+/*
+ * Number of keys evaluated at once by the bit-sliced engine,
+ * one key per bit of a machine word
+ */
+#define KEELOQ_BATCH_LANES 32u
+
+/*
+ * Learning variants tried by the batched key search, in priority order.
+ * Keys of a known learning type are checked with their own variant only,
+ * KEELOQ_LEARNING_UNKNOWN keys are checked with every enabled variant.
+ */
+#define KEELOQ_SEARCH_SIMPLE (1u << 0)
+#define KEELOQ_SEARCH_SIMPLE_MIRROR (1u << 1)
+#define KEELOQ_SEARCH_NORMAL (1u << 2)
+#define KEELOQ_SEARCH_NORMAL_MIRROR (1u << 3)
+#define KEELOQ_SEARCH_SECURE (1u << 4)
+#define KEELOQ_SEARCH_SECURE_MIRROR (1u << 5)
+#define KEELOQ_SEARCH_MAGIC_XOR_TYPE_1 (1u << 6)
+#define KEELOQ_SEARCH_MAGIC_XOR_TYPE_1_MIRROR (1u << 7)
+#define KEELOQ_SEARCH_ALL 0xFFu
+
+/*
+ * Seed used for Secure Learning when the transmitted seed is not known
+ */
+#define KEELOQ_SECURE_LEARNING_SEED 0u
+
+typedef struct SubGhzKeeloqKeySearch SubGhzKeeloqKeySearch;
+
+/**
+ * Decrypted hop validation callback
+ * @param decrypt - decrypted hop
+ * @param context - callback context
+ * @return true if decrypted hop matches the fix part of the parcel
+ */
+typedef bool (*SubGhzKeeloqCheckDecrypt)(uint32_t decrypt, void* context);
+
 /**
  * Simple Learning Encrypt
  * @param data - 0xBSSSCCCC, B(4bit) key, S(10bit) serial&0x3FF, C(16bit) counter
@@ -66,3 +102,58 @@ uint64_t
  * @return manufacture for this serial number (64bit)
  */
 uint64_t subghz_protocol_keeloq_common_magic_xor_type1_learning(uint32_t data, uint64_t xor);
+
+/** 
+ * Batched Simple Learning Decrypt, one bit-sliced pass for up to KEELOQ_BATCH_LANES keys
+ * @param data - keeloq encrypt data
+ * @param keys - manufacture keys (64bit)
+ * @param count - number of keys, KEELOQ_BATCH_LANES max
+ * @param result - decrypted data for every key
+ */
+void subghz_protocol_keeloq_common_decrypt_batch(
+    const uint32_t data,
+    const uint64_t* keys,
+    size_t count,
+    uint32_t* result);
+
+/**
+ * Allocate SubGhzKeeloqKeySearch.
+ * @return SubGhzKeeloqKeySearch* pointer to a SubGhzKeeloqKeySearch instance
+ */
+SubGhzKeeloqKeySearch* subghz_protocol_keeloq_common_search_alloc();
+
+/**
+ * Free SubGhzKeeloqKeySearch.
+ * @param instance Pointer to a SubGhzKeeloqKeySearch instance
+ */
+void subghz_protocol_keeloq_common_search_free(SubGhzKeeloqKeySearch* instance);
+
+/**
+ * Rebuild bit-sliced key batches, must be called every time the key array changes.
+ * @param instance Pointer to a SubGhzKeeloqKeySearch instance
+ * @param keys Keystore key array, must outlive the search
+ */
+void subghz_protocol_keeloq_common_search_load(
+    SubGhzKeeloqKeySearch* instance,
+    SubGhzKeyArray_t* keys);
+
+/**
+ * Find manufacture key for the parcel.
+ * Result is the same as checking keys one by one in keystore order.
+ * @param instance Pointer to a SubGhzKeeloqKeySearch instance
+ * @param fix - fix part of the parcel
+ * @param hop - hop encrypted part of the parcel
+ * @param variants - KEELOQ_SEARCH_* mask of learning variants to try
+ * @param check - decrypted hop validation callback
+ * @param context - callback context
+ * @param decrypt - decrypted hop of the found key
+ * @return SubGhzKey* found key, NULL if nothing matches
+ */
+SubGhzKey* subghz_protocol_keeloq_common_search(
+    SubGhzKeeloqKeySearch* instance,
+    uint32_t fix,
+    uint32_t hop,
+    uint8_t variants,
+    SubGhzKeeloqCheckDecrypt check,
+    void* context,
+    uint32_t* decrypt);
@@ -54,6 +54,8 @@ const SubGhzProtocolDecoder subghz_protocol_nero_sketch_decoder = {
     .serialize = subghz_protocol_decoder_nero_sketch_serialize,
     .deserialize = subghz_protocol_decoder_nero_sketch_deserialize,
     .get_string = subghz_protocol_decoder_nero_sketch_get_string,
+
+    .get_wake = subghz_protocol_decoder_nero_sketch_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_nero_sketch_encoder = {
@@ -321,6 +323,17 @@ void subghz_protocol_decoder_nero_sketch_feed(void* context, bool level, uint32_
     }
 }
 
+bool subghz_protocol_decoder_nero_sketch_get_wake(void* context, SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderNeroSketch* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake,
+        true,
+        subghz_protocol_nero_sketch_const.te_short,
+        subghz_protocol_nero_sketch_const.te_delta);
+    return instance->decoder.parser_step == NeroSketchDecoderStepReset;
+}
+
 uint8_t subghz_protocol_decoder_nero_sketch_get_hash_data(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderNeroSketch* instance = context;
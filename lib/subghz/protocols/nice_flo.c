@@ -52,6 +52,8 @@ const SubGhzProtocolDecoder subghz_protocol_nice_flo_decoder = {
     .serialize = subghz_protocol_decoder_nice_flo_serialize,
     .deserialize = subghz_protocol_decoder_nice_flo_deserialize,
     .get_string = subghz_protocol_decoder_nice_flo_get_string,
+
+    .get_wake = subghz_protocol_decoder_nice_flo_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_nice_flo_encoder = {
@@ -271,6 +273,17 @@ void subghz_protocol_decoder_nice_flo_feed(void* context, bool level, uint32_t d
     }
 }
 
+bool subghz_protocol_decoder_nice_flo_get_wake(void* context, SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderNiceFlo* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake,
+        false,
+        subghz_protocol_nice_flo_const.te_short * 36,
+        subghz_protocol_nice_flo_const.te_delta * 36);
+    return instance->decoder.parser_step == NiceFloDecoderStepReset;
+}
+
 uint8_t subghz_protocol_decoder_nice_flo_get_hash_data(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderNiceFlo* instance = context;
@@ -26,7 +26,8 @@ struct SubGhzProtocolDecoderNiceFlorS {
     SubGhzBlockDecoder decoder;
     SubGhzBlockGeneric generic;
 
-    const char* nice_flor_s_rainbow_table_file_name;
+    // Owned by the environment
+    SubGhzKeystoreRawReader* nice_flor_s_rainbow_table;
 };
 
 struct SubGhzProtocolEncoderNiceFlorS {
@@ -55,6 +56,8 @@ const SubGhzProtocolDecoder subghz_protocol_nice_flor_s_decoder = {
     .serialize = subghz_protocol_decoder_nice_flor_s_serialize,
     .deserialize = subghz_protocol_decoder_nice_flor_s_deserialize,
     .get_string = subghz_protocol_decoder_nice_flor_s_get_string,
+
+    .get_wake = subghz_protocol_decoder_nice_flor_s_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_nice_flor_s_encoder = {
@@ -78,16 +81,17 @@ const SubGhzProtocol subghz_protocol_nice_flor_s = {
 
 /** 
  * Read bytes from rainbow table
- * @param file_name Full path to rainbow table the file 
+ * @param rainbow_table Pointer to a SubGhzKeystoreRawReader instance with opened rainbow table
  * @param address Byte address in file
  * @return data
  */
-static uint8_t
-    subghz_protocol_nice_flor_s_get_byte_in_file(const char* file_name, uint32_t address) {
-    if(!file_name) return 0;
+static uint8_t subghz_protocol_nice_flor_s_get_byte_in_file(
+    SubGhzKeystoreRawReader* rainbow_table,
+    uint32_t address) {
+    if(!rainbow_table) return 0;
 
     uint8_t buffer[1] = {0};
-    if(subghz_keystore_raw_get_data(file_name, address, buffer, sizeof(uint8_t))) {
+    if(subghz_keystore_raw_reader_get_data(rainbow_table, address, buffer, sizeof(uint8_t))) {
         return buffer[0];
     } else {
         return 0;
@@ -100,17 +104,18 @@ static inline void subghz_protocol_decoder_nice_flor_s_magic_xor(uint8_t* p, uin
     }
 }
 
-uint64_t subghz_protocol_nice_flor_s_encrypt(uint64_t data, const char* file_name) {
+uint64_t
+    subghz_protocol_nice_flor_s_encrypt(uint64_t data, SubGhzKeystoreRawReader* rainbow_table) {
     uint8_t* p = (uint8_t*)&data;
 
     uint8_t k = 0;
     for(uint8_t y = 0; y < 2; y++) {
-        k = subghz_protocol_nice_flor_s_get_byte_in_file(file_name, p[0] & 0x1f);
+        k = subghz_protocol_nice_flor_s_get_byte_in_file(rainbow_table, p[0] & 0x1f);
         subghz_protocol_decoder_nice_flor_s_magic_xor(p, k);
 
         p[5] &= 0x0f;
         p[0] ^= k & 0xe0;
-        k = subghz_protocol_nice_flor_s_get_byte_in_file(file_name, p[0] >> 3) + 0x25;
+        k = subghz_protocol_nice_flor_s_get_byte_in_file(rainbow_table, p[0] >> 3) + 0x25;
         subghz_protocol_decoder_nice_flor_s_magic_xor(p, k);
 
         p[5] &= 0x0f;
@@ -134,8 +139,9 @@ uint64_t subghz_protocol_nice_flor_s_encrypt(uint64_t data, const char* file_nam
     return data;
 }
 
-static uint64_t
-    subghz_protocol_nice_flor_s_decrypt(SubGhzBlockGeneric* instance, const char* file_name) {
+static uint64_t subghz_protocol_nice_flor_s_decrypt(
+    SubGhzBlockGeneric* instance,
+    SubGhzKeystoreRawReader* rainbow_table) {
     furi_assert(instance);
     uint64_t data = instance->data;
     uint8_t* p = (uint8_t*)&data;
@@ -152,12 +158,12 @@ static uint64_t
     p[1] = k;
 
     for(uint8_t y = 0; y < 2; y++) {
-        k = subghz_protocol_nice_flor_s_get_byte_in_file(file_name, p[0] >> 3) + 0x25;
+        k = subghz_protocol_nice_flor_s_get_byte_in_file(rainbow_table, p[0] >> 3) + 0x25;
         subghz_protocol_decoder_nice_flor_s_magic_xor(p, k);
 
         p[5] &= 0x0f;
         p[0] ^= k & 0x7;
-        k = subghz_protocol_nice_flor_s_get_byte_in_file(file_name, p[0] & 0x1f);
+        k = subghz_protocol_nice_flor_s_get_byte_in_file(rainbow_table, p[0] & 0x1f);
         subghz_protocol_decoder_nice_flor_s_magic_xor(p, k);
 
         p[5] &= 0x0f;
@@ -176,19 +182,15 @@ void* subghz_protocol_decoder_nice_flor_s_alloc(SubGhzEnvironment* environment)
     SubGhzProtocolDecoderNiceFlorS* instance = malloc(sizeof(SubGhzProtocolDecoderNiceFlorS));
     instance->base.protocol = &subghz_protocol_nice_flor_s;
     instance->generic.protocol_name = instance->base.protocol->name;
-    instance->nice_flor_s_rainbow_table_file_name =
-        subghz_environment_get_nice_flor_s_rainbow_table_file_name(environment);
-    if(instance->nice_flor_s_rainbow_table_file_name) {
-        FURI_LOG_I(
-            TAG, "Loading rainbow table from %s", instance->nice_flor_s_rainbow_table_file_name);
-    }
+    instance->nice_flor_s_rainbow_table =
+        subghz_environment_get_nice_flor_s_rainbow_table(environment);
     return instance;
 }
 
 void subghz_protocol_decoder_nice_flor_s_free(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderNiceFlorS* instance = context;
-    instance->nice_flor_s_rainbow_table_file_name = NULL;
+    instance->nice_flor_s_rainbow_table = NULL;
     free(instance);
 }
 
@@ -277,14 +279,25 @@ void subghz_protocol_decoder_nice_flor_s_feed(void* context, bool level, uint32_
     }
 }
 
+bool subghz_protocol_decoder_nice_flor_s_get_wake(void* context, SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderNiceFlorS* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake,
+        false,
+        subghz_protocol_nice_flor_s_const.te_short * 38,
+        subghz_protocol_nice_flor_s_const.te_delta * 38);
+    return instance->decoder.parser_step == NiceFlorSDecoderStepReset;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
- * @param file_name Full path to rainbow table the file 
+ * @param rainbow_table Pointer to a SubGhzKeystoreRawReader instance with opened rainbow table
  */
 static void subghz_protocol_nice_flor_s_remote_controller(
     SubGhzBlockGeneric* instance,
-    const char* file_name) {
+    SubGhzKeystoreRawReader* rainbow_table) {
     /*
     * Packet format Nice Flor-s: START-P0-P1-P2-P3-P4-P5-P6-P7-STOP
     * P0 (4-bit)    - button positional code - 1:0x1, 2:0x2, 3:0x4, 4:0x8;
@@ -307,12 +320,12 @@ static void subghz_protocol_nice_flor_s_remote_controller(
     * decrypt => 0x10436c6820444 => 0x1  0436c682 0444
     * 
     */
-    if(!file_name) {
+    if(!rainbow_table) {
         instance->cnt = 0;
         instance->serial = 0;
         instance->btn = 0;
     } else {
-        uint64_t decrypt = subghz_protocol_nice_flor_s_decrypt(instance, file_name);
+        uint64_t decrypt = subghz_protocol_nice_flor_s_decrypt(instance, rainbow_table);
         instance->cnt = decrypt & 0xFFFF;
         instance->serial = (decrypt >> 16) & 0xFFFFFFF;
         instance->btn = (decrypt >> 48) & 0xF;
@@ -347,7 +360,7 @@ void subghz_protocol_decoder_nice_flor_s_get_string(void* context, string_t outp
     SubGhzProtocolDecoderNiceFlorS* instance = context;
 
     subghz_protocol_nice_flor_s_remote_controller(
-        &instance->generic, instance->nice_flor_s_rainbow_table_file_name);
+        &instance->generic, instance->nice_flor_s_rainbow_table);
     uint32_t code_found_hi = instance->generic.data >> 32;
     uint32_t code_found_lo = instance->generic.data & 0x00000000ffffffff;
 
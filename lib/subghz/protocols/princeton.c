@@ -56,6 +56,8 @@ const SubGhzProtocolDecoder subghz_protocol_princeton_decoder = {
     .serialize = subghz_protocol_decoder_princeton_serialize,
     .deserialize = subghz_protocol_decoder_princeton_deserialize,
     .get_string = subghz_protocol_decoder_princeton_get_string,
+
+    .get_wake = subghz_protocol_decoder_princeton_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_princeton_encoder = {
@@ -282,6 +284,17 @@ void subghz_protocol_decoder_princeton_feed(void* context, bool level, uint32_t
     }
 }
 
+bool subghz_protocol_decoder_princeton_get_wake(void* context, SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderPrinceton* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake,
+        false,
+        subghz_protocol_princeton_const.te_short * 36,
+        subghz_protocol_princeton_const.te_delta * 36);
+    return instance->decoder.parser_step == PrincetonDecoderStepReset;
+}
+
 uint8_t subghz_protocol_decoder_princeton_get_hash_data(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderPrinceton* instance = context;
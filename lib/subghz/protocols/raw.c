@@ -1,6 +1,7 @@
 #include "raw.h"
 #include <lib/flipper_format/flipper_format.h>
 #include "../subghz_file_encoder_worker.h"
+#include "../subghz_raw_binary.h"
 
 #include "../blocks/const.h"
 #include "../blocks/decoder.h"
@@ -32,6 +33,8 @@ struct SubGhzProtocolDecoderRAW {
     string_t file_name;
     size_t sample_write;
     bool last_level;
+    SubGhzProtocolRAWFormat format;
+    SubGhzRawBinary* raw_binary;
 };
 
 struct SubGhzProtocolEncoderRAW {
@@ -143,6 +146,15 @@ bool subghz_protocol_raw_save_to_file_init(
             break;
         }
 
+        if(instance->format == SubGhzProtocolRAWFormatBinary) {
+            if(!subghz_raw_binary_write_marker(
+                   flipper_format_get_raw_stream(instance->flipper_file))) {
+                FURI_LOG_E(TAG, "Unable to add RAW_Format");
+                break;
+            }
+            instance->raw_binary = subghz_raw_binary_alloc();
+        }
+
         instance->upload_raw = malloc(SUBGHZ_DOWNLOAD_MAX_SIZE * sizeof(int32_t));
         instance->file_is_open = RAWFileIsOpenWrite;
         instance->sample_write = 0;
@@ -158,7 +170,19 @@ static bool subghz_protocol_raw_save_to_file_write(SubGhzProtocolDecoderRAW* ins
     furi_assert(instance);
 
     bool is_write = false;
-    if(instance->file_is_open == RAWFileIsOpenWrite) {
+    if(instance->file_is_open == RAWFileIsOpenWrite && instance->raw_binary) {
+        if(!subghz_raw_binary_write(
+               instance->raw_binary,
+               flipper_format_get_raw_stream(instance->flipper_file),
+               instance->upload_raw,
+               instance->ind_write)) {
+            FURI_LOG_E(TAG, "Unable to add RAW block");
+        } else {
+            instance->sample_write += instance->ind_write;
+            instance->ind_write = 0;
+            is_write = true;
+        }
+    } else if(instance->file_is_open == RAWFileIsOpenWrite) {
         if(!flipper_format_write_int32(
                instance->flipper_file, "RAW_Data", instance->upload_raw, instance->ind_write)) {
             FURI_LOG_E(TAG, "Unable to add RAW_Data");
@@ -179,6 +203,10 @@ void subghz_protocol_raw_save_to_file_stop(SubGhzProtocolDecoderRAW* instance) {
     if(instance->file_is_open != RAWFileIsOpenClose) {
         free(instance->upload_raw);
         instance->upload_raw = NULL;
+        if(instance->raw_binary) {
+            subghz_raw_binary_free(instance->raw_binary);
+            instance->raw_binary = NULL;
+        }
         flipper_format_file_close(instance->flipper_file);
         flipper_format_free(instance->flipper_file);
         furi_record_close("storage");
@@ -191,6 +219,112 @@ size_t subghz_protocol_raw_get_sample_write(SubGhzProtocolDecoderRAW* instance)
     return instance->sample_write + instance->ind_write;
 }
 
+void subghz_protocol_raw_set_save_format(
+    SubGhzProtocolDecoderRAW* instance,
+    SubGhzProtocolRAWFormat format) {
+    furi_assert(instance);
+    furi_assert(instance->file_is_open == RAWFileIsOpenClose);
+    instance->format = format;
+}
+
+bool subghz_protocol_raw_convert(
+    const char* input_file_name,
+    const char* output_file_name,
+    SubGhzProtocolRAWFormat format) {
+    bool result = false;
+    Storage* storage = furi_record_open("storage");
+    FlipperFormat* input = flipper_format_file_alloc(storage);
+    FlipperFormat* output = flipper_format_file_alloc(storage);
+    SubGhzRawBinary* raw_binary = subghz_raw_binary_alloc();
+    int32_t* samples = malloc(SUBGHZ_DOWNLOAD_MAX_SIZE * sizeof(int32_t));
+
+    string_t temp_str;
+    string_init(temp_str);
+    uint32_t temp_data32;
+
+    do {
+        if(!flipper_format_file_open_existing(input, input_file_name)) {
+            FURI_LOG_E(TAG, "Unable to open file for read: %s", input_file_name);
+            break;
+        }
+        if(!flipper_format_file_open_always(output, output_file_name)) {
+            FURI_LOG_E(TAG, "Unable to open file for write: %s", output_file_name);
+            break;
+        }
+
+        if(!flipper_format_read_header(input, temp_str, &temp_data32) ||
+           strcmp(string_get_cstr(temp_str), SUBGHZ_RAW_FILE_TYPE) != 0) {
+            FURI_LOG_E(TAG, "Missing or incorrect header");
+            break;
+        }
+        if(!flipper_format_write_header(output, temp_str, temp_data32)) {
+            FURI_LOG_E(TAG, "Unable to add header");
+            break;
+        }
+        if(!flipper_format_read_uint32(input, "Frequency", &temp_data32, 1) ||
+           !flipper_format_write_uint32(output, "Frequency", &temp_data32, 1)) {
+            FURI_LOG_E(TAG, "Unable to copy Frequency");
+            break;
+        }
+        if(!flipper_format_read_string(input, "Preset", temp_str) ||
+           !flipper_format_write_string(output, "Preset", temp_str)) {
+            FURI_LOG_E(TAG, "Unable to copy Preset");
+            break;
+        }
+        if(!flipper_format_read_string(input, "Protocol", temp_str) ||
+           !flipper_format_write_string(output, "Protocol", temp_str)) {
+            FURI_LOG_E(TAG, "Unable to copy Protocol");
+            break;
+        }
+
+        Stream* input_stream = flipper_format_get_raw_stream(input);
+        Stream* output_stream = flipper_format_get_raw_stream(output);
+        //skip the end of the previous line "\n"
+        stream_seek(input_stream, 1, StreamOffsetFromCurrent);
+        bool input_binary = subghz_raw_binary_check_marker(input_stream);
+        if(format == SubGhzProtocolRAWFormatBinary &&
+           !subghz_raw_binary_write_marker(output_stream)) {
+            FURI_LOG_E(TAG, "Unable to add RAW_Format");
+            break;
+        }
+
+        result = true;
+        while(result) {
+            size_t count = 0;
+            if(input_binary) {
+                if(stream_eof(input_stream)) break;
+                result = subghz_raw_binary_read(raw_binary, input_stream, samples, &count);
+            } else {
+                if(!flipper_format_get_value_count(input, "RAW_Data", &temp_data32)) break;
+                if(temp_data32 > SUBGHZ_DOWNLOAD_MAX_SIZE) {
+                    FURI_LOG_E(TAG, "RAW_Data line too long");
+                    result = false;
+                    break;
+                }
+                count = temp_data32;
+                result = flipper_format_read_int32(input, "RAW_Data", samples, count);
+            }
+
+            if(!result) {
+                FURI_LOG_E(TAG, "Unable to read RAW data");
+            } else if(format == SubGhzProtocolRAWFormatBinary) {
+                result = subghz_raw_binary_write(raw_binary, output_stream, samples, count);
+            } else {
+                result = flipper_format_write_int32(output, "RAW_Data", samples, count);
+            }
+        }
+    } while(false);
+
+    string_clear(temp_str);
+    free(samples);
+    subghz_raw_binary_free(raw_binary);
+    flipper_format_free(output);
+    flipper_format_free(input);
+    furi_record_close("storage");
+
+    return result;
+}
+
 void* subghz_protocol_decoder_raw_alloc(SubGhzEnvironment* environment) {
     SubGhzProtocolDecoderRAW* instance = malloc(sizeof(SubGhzProtocolDecoderRAW));
     instance->base.protocol = &subghz_protocol_raw;
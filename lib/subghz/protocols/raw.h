@@ -6,6 +6,11 @@
 
 typedef void (*SubGhzProtocolEncoderRAWCallbackEnd)(void* context);
 
+typedef enum {
+    SubGhzProtocolRAWFormatText,
+    SubGhzProtocolRAWFormatBinary,
+} SubGhzProtocolRAWFormat;
+
 typedef struct SubGhzProtocolDecoderRAW SubGhzProtocolDecoderRAW;
 typedef struct SubGhzProtocolEncoderRAW SubGhzProtocolEncoderRAW;
 
@@ -40,6 +45,27 @@ void subghz_protocol_raw_save_to_file_stop(SubGhzProtocolDecoderRAW* instance);
  */
 size_t subghz_protocol_raw_get_sample_write(SubGhzProtocolDecoderRAW* instance);
 
+/**
+ * Set the encoding of RAW data for the next recording, text by default.
+ * @param instance Pointer to a SubGhzProtocolDecoderRAW instance
+ * @param format SubGhzProtocolRAWFormat
+ */
+void subghz_protocol_raw_set_save_format(
+    SubGhzProtocolDecoderRAW* instance,
+    SubGhzProtocolRAWFormat format);
+
+/**
+ * Convert a RAW file between text and binary encodings.
+ * @param input_file_name Full path to the input file, any encoding
+ * @param output_file_name Full path to the output file
+ * @param format Encoding of the output file
+ * @return true On success
+ */
+bool subghz_protocol_raw_convert(
+    const char* input_file_name,
+    const char* output_file_name,
+    SubGhzProtocolRAWFormat format);
+
 /**
  * Allocate SubGhzProtocolDecoderRAW.
  * @param environment Pointer to a SubGhzEnvironment instance
@@ -53,6 +53,8 @@ const SubGhzProtocolDecoder subghz_protocol_somfy_keytis_decoder = {
     .serialize = subghz_protocol_decoder_somfy_keytis_serialize,
     .deserialize = subghz_protocol_decoder_somfy_keytis_deserialize,
     .get_string = subghz_protocol_decoder_somfy_keytis_get_string,
+
+    .get_wake = subghz_protocol_decoder_somfy_keytis_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_somfy_keytis_encoder = {
@@ -236,6 +238,19 @@ void subghz_protocol_decoder_somfy_keytis_feed(void* context, bool level, uint32
     }
 }
 
+bool subghz_protocol_decoder_somfy_keytis_get_wake(
+    void* context,
+    SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderSomfyKeytis* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake,
+        true,
+        subghz_protocol_somfy_keytis_const.te_short * 4,
+        subghz_protocol_somfy_keytis_const.te_delta * 4);
+    return instance->decoder.parser_step == SomfyKeytisDecoderStepReset;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
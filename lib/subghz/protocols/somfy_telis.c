@@ -52,6 +52,8 @@ const SubGhzProtocolDecoder subghz_protocol_somfy_telis_decoder = {
     .serialize = subghz_protocol_decoder_somfy_telis_serialize,
     .deserialize = subghz_protocol_decoder_somfy_telis_deserialize,
     .get_string = subghz_protocol_decoder_somfy_telis_get_string,
+
+    .get_wake = subghz_protocol_decoder_somfy_telis_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_somfy_telis_encoder = {
@@ -230,6 +232,17 @@ void subghz_protocol_decoder_somfy_telis_feed(void* context, bool level, uint32_
     }
 }
 
+bool subghz_protocol_decoder_somfy_telis_get_wake(void* context, SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderSomfyTelis* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake,
+        true,
+        subghz_protocol_somfy_telis_const.te_short * 4,
+        subghz_protocol_somfy_telis_const.te_delta * 4);
+    return instance->decoder.parser_step == SomfyTelisDecoderStepReset;
+}
+
 /** 
  * Analysis of received data
  * @param instance Pointer to a SubGhzBlockGeneric* instance
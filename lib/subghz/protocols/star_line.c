@@ -56,6 +56,8 @@ const SubGhzProtocolDecoder subghz_protocol_star_line_decoder = {
     .serialize = subghz_protocol_decoder_star_line_serialize,
     .deserialize = subghz_protocol_decoder_star_line_deserialize,
     .get_string = subghz_protocol_decoder_star_line_get_string,
+
+    .get_wake = subghz_protocol_decoder_star_line_get_wake,
 };
 
 const SubGhzProtocolEncoder subghz_protocol_star_line_encoder = {
@@ -181,25 +183,34 @@ void subghz_protocol_decoder_star_line_feed(void* context, bool level, uint32_t
     }
 }
 
+bool subghz_protocol_decoder_star_line_get_wake(void* context, SubGhzProtocolDecoderWake* wake) {
+    furi_assert(context);
+    SubGhzProtocolDecoderStarLine* instance = context;
+    subghz_protocol_decoder_base_set_wake(
+        wake,
+        true,
+        subghz_protocol_star_line_const.te_long * 2,
+        subghz_protocol_star_line_const.te_delta * 2);
+    // Preamble pulses are counted while idle, only a clean counter is quiet
+    return (instance->decoder.parser_step == StarLineDecoderStepReset) &&
+           (instance->header_count == 0);
+}
+
+typedef struct {
+    uint8_t btn;
+    uint16_t end_serial;
+} SubGhzProtocolStarLineCheckContext;
+
 /**
  * Validation of decrypt data.
- * @param instance Pointer to a SubGhzBlockGeneric instance
  * @param decrypt Decrypd data
- * @param btn Button number, 4 bit
- * @param end_serial decrement the last 10 bits of the serial number
+ * @param context Pointer to a SubGhzProtocolStarLineCheckContext instance
  * @return true On success
  */
-static inline bool subghz_protocol_star_line_check_decrypt(
-    SubGhzBlockGeneric* instance,
-    uint32_t decrypt,
-    uint8_t btn,
-    uint32_t end_serial) {
-    furi_assert(instance);
-    if((decrypt >> 24 == btn) && ((((uint16_t)(decrypt >> 16)) & 0x00FF) == end_serial)) {
-        instance->cnt = decrypt & 0x0000FFFF;
-        return true;
-    }
-    return false;
+static bool subghz_protocol_star_line_check_decrypt(uint32_t decrypt, void* context) {
+    SubGhzProtocolStarLineCheckContext* check = context;
+    return (decrypt >> 24 == check->btn) &&
+           ((((uint16_t)(decrypt >> 16)) & 0x00FF) == check->end_serial);
 }
 
 /** 
@@ -217,71 +228,28 @@ static uint8_t subghz_protocol_star_line_check_remote_controller_selector(
     uint32_t hop,
     SubGhzKeystore* keystore,
     const char** manufacture_name) {
-    uint16_t end_serial = (uint16_t)(fix & 0xFF);
-    uint8_t btn = (uint8_t)(fix >> 24);
+    SubGhzProtocolStarLineCheckContext check = {
+        .btn = (uint8_t)(fix >> 24),
+        .end_serial = (uint16_t)(fix & 0xFF),
+    };
     uint32_t decrypt = 0;
-    uint64_t man_normal_learning;
-
-    for
-        M_EACH(manufacture_code, *subghz_keystore_get_data(keystore), SubGhzKeyArray_t) {
-            switch(manufacture_code->type) {
-            case KEELOQ_LEARNING_SIMPLE:
-                //Simple Learning
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, manufacture_code->key);
-                if(subghz_protocol_star_line_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                break;
-            case KEELOQ_LEARNING_NORMAL:
-                // Normal_Learning
-                // https://phreakerclub.com/forum/showpost.php?p=43557&postcount=37
-                man_normal_learning =
-                    subghz_protocol_keeloq_common_normal_learning(fix, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man_normal_learning);
-                if(subghz_protocol_star_line_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                break;
-            case KEELOQ_LEARNING_UNKNOWN:
-                // Simple Learning
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, manufacture_code->key);
-                if(subghz_protocol_star_line_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                // Check for mirrored man
-                uint64_t man_rev = 0;
-                uint64_t man_rev_byte = 0;
-                for(uint8_t i = 0; i < 64; i += 8) {
-                    man_rev_byte = (uint8_t)(manufacture_code->key >> i);
-                    man_rev = man_rev | man_rev_byte << (56 - i);
-                }
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man_rev);
-                if(subghz_protocol_star_line_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                //###########################
-                // Normal_Learning
-                // https://phreakerclub.com/forum/showpost.php?p=43557&postcount=37
-                man_normal_learning =
-                    subghz_protocol_keeloq_common_normal_learning(fix, manufacture_code->key);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man_normal_learning);
-                if(subghz_protocol_star_line_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                man_normal_learning = subghz_protocol_keeloq_common_normal_learning(fix, man_rev);
-                decrypt = subghz_protocol_keeloq_common_decrypt(hop, man_normal_learning);
-                if(subghz_protocol_star_line_check_decrypt(instance, decrypt, btn, end_serial)) {
-                    *manufacture_name = string_get_cstr(manufacture_code->name);
-                    return 1;
-                }
-                break;
-            }
-        }
+
+    // Star Line supports Simple and Normal learning only
+    // https://phreakerclub.com/forum/showpost.php?p=43557&postcount=37
+    SubGhzKey* manufacture_code = subghz_protocol_keeloq_common_search(
+        subghz_keystore_get_keeloq_search(keystore),
+        fix,
+        hop,
+        KEELOQ_SEARCH_SIMPLE | KEELOQ_SEARCH_SIMPLE_MIRROR | KEELOQ_SEARCH_NORMAL |
+            KEELOQ_SEARCH_NORMAL_MIRROR,
+        subghz_protocol_star_line_check_decrypt,
+        &check,
+        &decrypt);
+    if(manufacture_code) {
+        *manufacture_name = manufacture_code->name;
+        instance->cnt = decrypt & 0x0000FFFF;
+        return 1;
+    }
 
     *manufacture_name = "Unknown";
     instance->cnt = 0;
@@ -11,14 +11,76 @@ typedef struct {
 ARRAY_DEF(SubGhzReceiverSlotArray, SubGhzReceiverSlot, M_POD_OPLIST);
 #define M_OPL_SubGhzReceiverSlotArray_t() ARRAY_OPLIST(SubGhzReceiverSlotArray, M_POD_OPLIST)
 
+/* Slots are tracked in 32-bit masks */
+#define SUBGHZ_RECEIVER_SLOT_MAX 32
+/* Durations are grouped in quarter-octave timing classes, longer ones share the last class */
+#define SUBGHZ_RECEIVER_TIMING_CLASS_DURATION_MAX ((1UL << 24) - 1)
+#define SUBGHZ_RECEIVER_TIMING_CLASS_COUNT (23 * 4 + 4)
+
 struct SubGhzReceiver {
     SubGhzReceiverSlotArray_t slots;
     SubGhzProtocolFlag filter;
 
+    /* Slots passing the filter */
+    uint32_t enabled;
+    /* Slots that must see every pulse: busy decoders and decoders without get_wake */
+    uint32_t active;
+    /* Idle slots that a pulse of given level and timing class may wake up */
+    uint32_t wake[2][SUBGHZ_RECEIVER_TIMING_CLASS_COUNT];
+
+    /* Per slot counters, NULL unless profiling is enabled */
+    SubGhzReceiverProfile* profile;
+
     SubGhzReceiverCallback callback;
     void* context;
 };
 
+static inline size_t subghz_receiver_get_timing_class(uint32_t duration) {
+    if(duration > SUBGHZ_RECEIVER_TIMING_CLASS_DURATION_MAX) {
+        duration = SUBGHZ_RECEIVER_TIMING_CLASS_DURATION_MAX;
+    }
+    if(duration < 4) return duration;
+    // Octave and its two next bits, monotonic in duration
+    uint32_t msb = 31 - __builtin_clz(duration);
+    return (msb << 2) | ((duration >> (msb - 2)) & 0x3);
+}
+
+/** Update slot activity after it has seen a pulse or a reset */
+static inline void subghz_receiver_update_active(
+    SubGhzReceiver* instance,
+    size_t index,
+    SubGhzReceiverSlot* slot) {
+    SubGhzProtocolDecoderWake wake;
+    const SubGhzProtocolDecoder* decoder = slot->base->protocol->decoder;
+    if(decoder->get_wake && decoder->get_wake(slot->base, &wake)) {
+        instance->active &= ~(1UL << index);
+    } else {
+        instance->active |= (1UL << index);
+    }
+}
+
+static void subghz_receiver_build_dispatch(SubGhzReceiver* instance) {
+    memset(instance->wake, 0, sizeof(instance->wake));
+    instance->active = 0;
+
+    size_t index = 0;
+    for
+        M_EACH(slot, instance->slots, SubGhzReceiverSlotArray_t) {
+            SubGhzProtocolDecoderWake wake;
+            const SubGhzProtocolDecoder* decoder = slot->base->protocol->decoder;
+            if(decoder->get_wake && decoder->get_wake(slot->base, &wake)) {
+                size_t first = subghz_receiver_get_timing_class(wake.duration_min);
+                size_t last = subghz_receiver_get_timing_class(wake.duration_max);
+                for(size_t i = first; i <= last; i++) {
+                    instance->wake[wake.level][i] |= (1UL << index);
+                }
+            } else {
+                instance->active |= (1UL << index);
+            }
+            index++;
+        }
+}
+
 SubGhzReceiver* subghz_receiver_alloc_init(SubGhzEnvironment* environment) {
     SubGhzReceiver* instance = malloc(sizeof(SubGhzReceiver));
     SubGhzReceiverSlotArray_init(instance->slots);
@@ -31,6 +93,10 @@ SubGhzReceiver* subghz_receiver_alloc_init(SubGhzEnvironment* environment) {
             slot->base = protocol->decoder->alloc(environment);
         }
     }
+    furi_check(SubGhzReceiverSlotArray_size(instance->slots) <= SUBGHZ_RECEIVER_SLOT_MAX);
+
+    subghz_receiver_build_dispatch(instance);
+    subghz_receiver_set_filter(instance, 0);
 
     instance->callback = NULL;
     instance->context = NULL;
@@ -51,6 +117,7 @@ void subghz_receiver_free(SubGhzReceiver* instance) {
             slot->base = NULL;
         }
     SubGhzReceiverSlotArray_clear(instance->slots);
+    if(instance->profile) free(instance->profile);
 
     free(instance);
 }
@@ -59,26 +126,52 @@ void subghz_receiver_decode(SubGhzReceiver* instance, bool level, uint32_t durat
     furi_assert(instance);
     furi_assert(instance->slots);
 
-    for
-        M_EACH(slot, instance->slots, SubGhzReceiverSlotArray_t) {
-            if((slot->base->protocol->flag & instance->filter) == instance->filter) {
-                slot->base->protocol->decoder->feed(slot->base, level, duration);
-            }
+    uint32_t pending = instance->enabled &
+                       (instance->active |
+                        instance->wake[level ? 1 : 0][subghz_receiver_get_timing_class(duration)]);
+
+    while(pending) {
+        size_t index = __builtin_ctz(pending);
+        pending &= pending - 1;
+
+        SubGhzReceiverSlot* slot = SubGhzReceiverSlotArray_get(instance->slots, index);
+        if(instance->profile) {
+            uint32_t start = DWT->CYCCNT;
+            slot->base->protocol->decoder->feed(slot->base, level, duration);
+            instance->profile[index].cycles += DWT->CYCCNT - start;
+            instance->profile[index].pulses++;
+        } else {
+            slot->base->protocol->decoder->feed(slot->base, level, duration);
         }
+        subghz_receiver_update_active(instance, index, slot);
+    }
 }
 
 void subghz_receiver_reset(SubGhzReceiver* instance) {
     furi_assert(instance);
     furi_assert(instance->slots);
 
+    size_t index = 0;
     for
         M_EACH(slot, instance->slots, SubGhzReceiverSlotArray_t) {
             slot->base->protocol->decoder->reset(slot->base);
+            subghz_receiver_update_active(instance, index++, slot);
         }
 }
 
 static void subghz_receiver_rx_callback(SubGhzProtocolDecoderBase* decoder_base, void* context) {
     SubGhzReceiver* instance = context;
+    if(instance->profile) {
+        size_t index = 0;
+        for
+            M_EACH(slot, instance->slots, SubGhzReceiverSlotArray_t) {
+                if((SubGhzProtocolDecoderBase*)slot->base == decoder_base) {
+                    instance->profile[index].decoded++;
+                    break;
+                }
+                index++;
+            }
+    }
     if(instance->callback) {
         instance->callback(instance, decoder_base, instance->context);
     }
@@ -103,6 +196,16 @@ void subghz_receiver_set_rx_callback(
 void subghz_receiver_set_filter(SubGhzReceiver* instance, SubGhzProtocolFlag filter) {
     furi_assert(instance);
     instance->filter = filter;
+
+    instance->enabled = 0;
+    size_t index = 0;
+    for
+        M_EACH(slot, instance->slots, SubGhzReceiverSlotArray_t) {
+            if((slot->base->protocol->flag & filter) == filter) {
+                instance->enabled |= (1UL << index);
+            }
+            index++;
+        }
 }
 
 SubGhzProtocolDecoderBase* subghz_receiver_search_decoder_base_by_name(
@@ -119,3 +222,31 @@ SubGhzProtocolDecoderBase* subghz_receiver_search_decoder_base_by_name(
         }
     return result;
 }
+
+void subghz_receiver_set_profiling(SubGhzReceiver* instance, bool enable) {
+    furi_assert(instance);
+    if(enable && !instance->profile) {
+        size_t count = SubGhzReceiverSlotArray_size(instance->slots);
+        instance->profile = malloc(sizeof(SubGhzReceiverProfile) * count);
+        for(size_t i = 0; i < count; i++) {
+            instance->profile[i].name =
+                SubGhzReceiverSlotArray_get(instance->slots, i)->base->protocol->name;
+        }
+    } else if(!enable && instance->profile) {
+        free(instance->profile);
+        instance->profile = NULL;
+    }
+}
+
+bool subghz_receiver_get_profile(
+    SubGhzReceiver* instance,
+    size_t index,
+    SubGhzReceiverProfile* profile) {
+    furi_assert(instance);
+    furi_assert(profile);
+    if(!instance->profile || index >= SubGhzReceiverSlotArray_size(instance->slots)) {
+        return false;
+    }
+    *profile = instance->profile[index];
+    return true;
+}
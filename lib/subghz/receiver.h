@@ -5,6 +5,13 @@
 
 typedef struct SubGhzReceiver SubGhzReceiver;
 
+typedef struct {
+    const char* name; /**< Protocol name */
+    uint32_t pulses; /**< Pulses fed to the decoder */
+    uint64_t cycles; /**< CPU cycles spent in the decoder feed */
+    uint32_t decoded; /**< Successful decodes */
+} SubGhzReceiverProfile;
+
 typedef void (*SubGhzReceiverCallback)(
     SubGhzReceiver* decoder,
     SubGhzProtocolDecoderBase* decoder_base,
@@ -63,3 +70,22 @@ void subghz_receiver_set_filter(SubGhzReceiver* instance, SubGhzProtocolFlag fil
  */
 SubGhzProtocolDecoderBase*
     subghz_receiver_search_decoder_base_by_name(SubGhzReceiver* instance, const char* decoder_name);
+
+/**
+ * Enable or disable per decoder profiling, counters start from zero when enabled.
+ * @param instance Pointer to a SubGhzReceiver instance
+ * @param enable true to enable
+ */
+void subghz_receiver_set_profiling(SubGhzReceiver* instance, bool enable);
+
+/**
+ * Get profiling counters of a decoder.
+ * @param instance Pointer to a SubGhzReceiver instance
+ * @param index Decoder index, from 0
+ * @param profile Pointer to a SubGhzReceiverProfile to fill
+ * @return true if profiling is enabled and index is valid
+ */
+bool subghz_receiver_get_profile(
+    SubGhzReceiver* instance,
+    size_t index,
+    SubGhzReceiverProfile* profile);
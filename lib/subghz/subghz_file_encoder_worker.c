@@ -1,4 +1,5 @@
 #include "subghz_file_encoder_worker.h"
+#include "subghz_raw_binary.h"
 #include <stream_buffer.h>
 
 #include <toolbox/stream/stream.h>
@@ -7,7 +8,41 @@
 
 #define TAG "SubGhzFileEncoderWorker"
 
+/* Samples pushed to the stream buffer at once */
 #define SUBGHZ_FILE_ENCODER_LOAD 512
+/* Stream buffer capacity, samples */
+#define SUBGHZ_FILE_ENCODER_STREAM_SIZE 2048
+/* The ISR requests a refill once fewer samples are buffered */
+#define SUBGHZ_FILE_ENCODER_WATERMARK (SUBGHZ_FILE_ENCODER_STREAM_SIZE / 2)
+/* Refill anyway if a request was missed */
+#define SUBGHZ_FILE_ENCODER_REFILL_TIMEOUT 50
+/* Size of each of the two file read buffers */
+#define SUBGHZ_FILE_ENCODER_READ_SIZE 512
+
+#define SUBGHZ_FILE_ENCODER_RAW_DATA_KEY "RAW_Data"
+
+typedef enum {
+    SubGhzFileEncoderWorkerEvtRefill = (1 << 0),
+    SubGhzFileEncoderWorkerEvtEnd = (1 << 1),
+    SubGhzFileEncoderWorkerEvtStop = (1 << 2),
+} SubGhzFileEncoderWorkerEvt;
+
+#define SUBGHZ_FILE_ENCODER_ALL_EVENTS                                    \
+    (SubGhzFileEncoderWorkerEvtRefill | SubGhzFileEncoderWorkerEvtEnd | \
+     SubGhzFileEncoderWorkerEvtStop)
+
+typedef enum {
+    SubGhzFileEncoderWorkerParserStepKey,
+    SubGhzFileEncoderWorkerParserStepValues,
+} SubGhzFileEncoderWorkerParserStep;
+
+typedef struct {
+    SubGhzFileEncoderWorkerParserStep step;
+    uint8_t key_match;
+    bool negative;
+    bool digits;
+    uint32_t value;
+} SubGhzFileEncoderWorkerParser;
 
 struct SubGhzFileEncoderWorker {
     FuriThread* thread;
@@ -15,14 +50,29 @@ struct SubGhzFileEncoderWorker {
 
     Storage* storage;
     FlipperFormat* flipper_format;
+    SubGhzRawBinary* raw_binary;
 
     volatile bool worker_running;
     volatile bool worker_stoping;
+    volatile bool refill_pending;
     bool level;
     int32_t duration;
     string_t str_data;
     string_t file_path;
 
+    // Double buffered file reads, the spare buffer is prefetched after each refill
+    uint8_t read_buffer[2][SUBGHZ_FILE_ENCODER_READ_SIZE];
+    size_t read_size[2];
+    uint8_t read_index;
+    size_t read_position;
+    bool read_end;
+    SubGhzFileEncoderWorkerParser parser;
+
+    int32_t load[SUBGHZ_FILE_ENCODER_LOAD];
+    size_t load_count;
+
+    volatile SubGhzFileEncoderWorkerStats stats;
+
     SubGhzFileEncoderWorkerCallbackEnd callback_end;
     void* context_end;
 };
@@ -54,37 +104,154 @@ void subghz_file_encoder_worker_add_livel_duration(
     if(res) {
         instance->level = !instance->level;
         instance->duration += duration;
-        xStreamBufferSend(instance->stream, &instance->duration, sizeof(int32_t), 10);
+        furi_assert(instance->load_count < SUBGHZ_FILE_ENCODER_LOAD);
+        instance->load[instance->load_count++] = instance->duration;
         instance->duration = 0;
     }
 }
 
-bool subghz_file_encoder_worker_data_parse(
-    SubGhzFileEncoderWorker* instance,
-    const char* strStart,
-    size_t len) {
-    char* str1;
-    size_t ind_start = (size_t)strStart; //store the start address of the beginning of the line
-    bool res = false;
+/** Push parsed samples to the stream buffer, waits for room, returns false if stopped */
+static bool subghz_file_encoder_worker_flush(SubGhzFileEncoderWorker* instance) {
+    const uint8_t* data = (const uint8_t*)instance->load;
+    size_t size = instance->load_count * sizeof(int32_t);
+    while(size && instance->worker_running) {
+        size_t ret = xStreamBufferSend(instance->stream, data, size, 10);
+        data += ret;
+        size -= ret;
+    }
+    instance->load_count = 0;
+    return !size;
+}
+
+static inline void subghz_file_encoder_worker_parser_emit(SubGhzFileEncoderWorker* instance) {
+    SubGhzFileEncoderWorkerParser* parser = &instance->parser;
+    if(parser->digits) {
+        int32_t value = parser->negative ? -(int32_t)parser->value : (int32_t)parser->value;
+        // "-0" is not an end of transmission mark
+        if(value) subghz_file_encoder_worker_add_livel_duration(instance, value);
+    }
+    parser->negative = false;
+    parser->digits = false;
+    parser->value = 0;
+}
 
-    str1 = strstr(
-        strStart, "RAW_Data: "); //looking for the beginning of the desired title in the line
-    if(str1 != NULL) {
-        str1 = strchr(
-            str1,
-            ' '); //if found, shift the pointer by 1 element per line "RAW_Data: -1, 2, -2..."
-        while(
-            strchr(str1, ' ') != NULL &&
-            ((size_t)str1 <
-             (len +
-              ind_start))) { //check that there is still an element in the line and that it has not gone beyond the line
-            str1 = strchr(str1, ' ');
-            str1 += 1; //if found, shift the pointer by next element per line
-            subghz_file_encoder_worker_add_livel_duration(instance, atoi(str1));
+/** Feed one character of "RAW_Data: 1 -2 3" lines, returns false on anything else */
+static inline bool
+    subghz_file_encoder_worker_parser_feed(SubGhzFileEncoderWorker* instance, char c) {
+    SubGhzFileEncoderWorkerParser* parser = &instance->parser;
+    const size_t key_size = strlen(SUBGHZ_FILE_ENCODER_RAW_DATA_KEY);
+
+    if(parser->step == SubGhzFileEncoderWorkerParserStepKey) {
+        if(parser->key_match == 0 && (c == '\n' || c == '\r')) {
+            return true;
+        } else if(c == ':') {
+            if(parser->key_match != key_size) return false;
+            parser->step = SubGhzFileEncoderWorkerParserStepValues;
+            parser->key_match = 0;
+        } else if(
+            parser->key_match < key_size &&
+            c == SUBGHZ_FILE_ENCODER_RAW_DATA_KEY[parser->key_match]) {
+            parser->key_match++;
+        } else {
+            return false;
         }
-        res = true;
+    } else if(c >= '0' && c <= '9') {
+        parser->value = parser->value * 10 + (c - '0');
+        parser->digits = true;
+    } else if(c == '-' && !parser->digits) {
+        parser->negative = true;
+    } else if(c == ' ' || c == ',' || c == '\r') {
+        subghz_file_encoder_worker_parser_emit(instance);
+    } else if(c == '\n') {
+        subghz_file_encoder_worker_parser_emit(instance);
+        parser->step = SubGhzFileEncoderWorkerParserStepKey;
+    } else {
+        return false;
     }
-    return res;
+    return true;
+}
+
+static void subghz_file_encoder_worker_prefetch(SubGhzFileEncoderWorker* instance) {
+    uint8_t spare = instance->read_index ^ 1;
+    if(instance->read_size[spare] == 0 && !instance->read_end) {
+        Stream* stream = flipper_format_get_raw_stream(instance->flipper_format);
+        instance->read_size[spare] =
+            stream_read(stream, instance->read_buffer[spare], SUBGHZ_FILE_ENCODER_READ_SIZE);
+        if(instance->read_size[spare] == 0) instance->read_end = true;
+    }
+}
+
+/** Switch to the prefetched buffer, returns false at the end of the file */
+static bool subghz_file_encoder_worker_next_buffer(SubGhzFileEncoderWorker* instance) {
+    instance->read_size[instance->read_index] = 0;
+    instance->read_index ^= 1;
+    instance->read_position = 0;
+    if(instance->read_size[instance->read_index] == 0) {
+        // Prefetch did not keep up, read synchronously
+        instance->read_index ^= 1;
+        subghz_file_encoder_worker_prefetch(instance);
+        instance->read_index ^= 1;
+    }
+    return instance->read_size[instance->read_index] != 0;
+}
+
+/** Parse text samples into the load buffer, returns false at the end of data */
+static bool subghz_file_encoder_worker_parse_text(SubGhzFileEncoderWorker* instance) {
+    while(instance->load_count < SUBGHZ_FILE_ENCODER_LOAD) {
+        if(instance->read_position == instance->read_size[instance->read_index] &&
+           !subghz_file_encoder_worker_next_buffer(instance)) {
+            subghz_file_encoder_worker_parser_emit(instance);
+            return false;
+        }
+
+        const char* data = (const char*)instance->read_buffer[instance->read_index];
+        size_t size = instance->read_size[instance->read_index];
+        size_t position = instance->read_position;
+        while(position < size && instance->load_count < SUBGHZ_FILE_ENCODER_LOAD) {
+            if(!subghz_file_encoder_worker_parser_feed(instance, data[position++])) {
+                instance->read_position = position;
+                subghz_file_encoder_worker_parser_emit(instance);
+                return false;
+            }
+        }
+        instance->read_position = position;
+    }
+    return true;
+}
+
+/** Decode one binary block into the load buffer, returns false at the end of data */
+static bool subghz_file_encoder_worker_parse_binary(SubGhzFileEncoderWorker* instance) {
+    furi_assert(instance->load_count == 0);
+    Stream* stream = flipper_format_get_raw_stream(instance->flipper_format);
+    size_t count = 0;
+    if(!subghz_raw_binary_read(instance->raw_binary, stream, instance->load, &count)) {
+        return false;
+    }
+    // Merging samples only ever moves them towards the start of the buffer
+    for(size_t i = 0; i < count; i++) {
+        subghz_file_encoder_worker_add_livel_duration(instance, instance->load[i]);
+    }
+    return true;
+}
+
+/** Top up the stream buffer, returns false once the end of data was queued */
+static bool subghz_file_encoder_worker_refill(SubGhzFileEncoderWorker* instance) {
+    instance->stats.refill_count++;
+    while(xStreamBufferSpacesAvailable(instance->stream) >=
+          SUBGHZ_FILE_ENCODER_LOAD * sizeof(int32_t)) {
+        bool more = instance->raw_binary ? subghz_file_encoder_worker_parse_binary(instance) :
+                                           subghz_file_encoder_worker_parse_text(instance);
+        if(!subghz_file_encoder_worker_flush(instance)) return false;
+        if(!more) {
+            //to stop DMA correctly
+            subghz_file_encoder_worker_add_livel_duration(instance, LEVEL_DURATION_RESET);
+            subghz_file_encoder_worker_add_livel_duration(instance, LEVEL_DURATION_RESET);
+            subghz_file_encoder_worker_flush(instance);
+            return false;
+        }
+    }
+    if(!instance->raw_binary) subghz_file_encoder_worker_prefetch(instance);
+    return true;
 }
 
 LevelDuration subghz_file_encoder_worker_get_level_duration(void* context) {
@@ -95,6 +262,15 @@ LevelDuration subghz_file_encoder_worker_get_level_duration(void* context) {
     int ret = xStreamBufferReceiveFromISR(
         instance->stream, &duration, sizeof(int32_t), &xHigherPriorityTaskWoken);
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+
+    size_t buffered = xStreamBufferBytesAvailable(instance->stream) / sizeof(int32_t);
+    if(buffered < instance->stats.buffered_min) instance->stats.buffered_min = buffered;
+    if(buffered < SUBGHZ_FILE_ENCODER_WATERMARK && !instance->refill_pending) {
+        instance->refill_pending = true;
+        osThreadFlagsSet(
+            furi_thread_get_thread_id(instance->thread), SubGhzFileEncoderWorkerEvtRefill);
+    }
+
     if(ret == sizeof(int32_t)) {
         LevelDuration level_duration = {.level = LEVEL_DURATION_RESET};
         if(duration < 0) {
@@ -103,20 +279,21 @@ LevelDuration subghz_file_encoder_worker_get_level_duration(void* context) {
             level_duration = level_duration_make(true, duration);
         } else if(duration == 0) {
             level_duration = level_duration_reset();
-            FURI_LOG_I(TAG, "Stop transmission");
             instance->worker_stoping = true;
+            osThreadFlagsSet(
+                furi_thread_get_thread_id(instance->thread), SubGhzFileEncoderWorkerEvtEnd);
         }
         return level_duration;
     } else {
-        FURI_LOG_E(TAG, "Slow flash read");
+        instance->stats.underrun_count++;
         return level_duration_wait();
     }
 }
 
 /** Worker thread
- * 
- * @param context 
- * @return exit code 
+ *
+ * @param context
+ * @return exit code
  */
 static int32_t subghz_file_encoder_worker_thread(void* context) {
     SubGhzFileEncoderWorker* instance = context;
@@ -137,46 +314,50 @@ static int32_t subghz_file_encoder_worker_thread(void* context) {
 
         //skip the end of the previous line "\n"
         stream_seek(stream, 1, StreamOffsetFromCurrent);
+        if(subghz_raw_binary_check_marker(stream)) {
+            instance->raw_binary = subghz_raw_binary_alloc();
+        }
         res = true;
         instance->worker_stoping = false;
         FURI_LOG_I(TAG, "Start transmission");
     } while(0);
 
     while(res && instance->worker_running) {
-        size_t stream_free_byte = xStreamBufferSpacesAvailable(instance->stream);
-        if((stream_free_byte / sizeof(int32_t)) >= SUBGHZ_FILE_ENCODER_LOAD) {
-            if(stream_read_line(stream, instance->str_data)) {
-                string_strim(instance->str_data);
-                if(!subghz_file_encoder_worker_data_parse(
-                       instance,
-                       string_get_cstr(instance->str_data),
-                       strlen(string_get_cstr(instance->str_data)))) {
-                    //to stop DMA correctly
-                    subghz_file_encoder_worker_add_livel_duration(instance, LEVEL_DURATION_RESET);
-                    subghz_file_encoder_worker_add_livel_duration(instance, LEVEL_DURATION_RESET);
-
-                    break;
-                }
-            } else {
-                subghz_file_encoder_worker_add_livel_duration(instance, LEVEL_DURATION_RESET);
-                subghz_file_encoder_worker_add_livel_duration(instance, LEVEL_DURATION_RESET);
-                break;
-            }
-        }
-        osDelay(5);
+        instance->refill_pending = false;
+        if(!subghz_file_encoder_worker_refill(instance)) break;
+
+        uint32_t events = osThreadFlagsWait(
+            SubGhzFileEncoderWorkerEvtRefill | SubGhzFileEncoderWorkerEvtStop,
+            osFlagsWaitAny,
+            SUBGHZ_FILE_ENCODER_REFILL_TIMEOUT);
+        if(!(events & osFlagsError) && (events & SubGhzFileEncoderWorkerEvtStop)) break;
     }
     //waiting for the end of the transfer
     FURI_LOG_I(TAG, "End read file");
 
+    bool end_reported = false;
     while(instance->worker_running) {
-        if(instance->worker_stoping) {
+        if(instance->worker_stoping && !end_reported) {
             if(instance->callback_end) instance->callback_end(instance->context_end);
+            end_reported = true;
         }
-        osDelay(50);
+        osThreadFlagsWait(
+            SubGhzFileEncoderWorkerEvtEnd | SubGhzFileEncoderWorkerEvtStop,
+            osFlagsWaitAny,
+            osWaitForever);
     }
     flipper_format_file_close(instance->flipper_format);
+    if(instance->raw_binary) {
+        subghz_raw_binary_free(instance->raw_binary);
+        instance->raw_binary = NULL;
+    }
 
-    FURI_LOG_I(TAG, "Worker stop");
+    FURI_LOG_I(
+        TAG,
+        "Worker stop, underruns: %lu, refills: %lu, min buffered: %lu",
+        instance->stats.underrun_count,
+        instance->stats.refill_count,
+        instance->stats.buffered_min);
     return 0;
 }
 
@@ -188,7 +369,8 @@ SubGhzFileEncoderWorker* subghz_file_encoder_worker_alloc() {
     furi_thread_set_stack_size(instance->thread, 2048);
     furi_thread_set_context(instance->thread, instance);
     furi_thread_set_callback(instance->thread, subghz_file_encoder_worker_thread);
-    instance->stream = xStreamBufferCreate(sizeof(int32_t) * 2048, sizeof(int32_t));
+    instance->stream = xStreamBufferCreate(
+        sizeof(int32_t) * SUBGHZ_FILE_ENCODER_STREAM_SIZE, sizeof(int32_t));
 
     instance->storage = furi_record_open("storage");
     instance->flipper_format = flipper_format_file_alloc(instance->storage);
@@ -222,6 +404,18 @@ bool subghz_file_encoder_worker_start(SubGhzFileEncoderWorker* instance, const c
 
     xStreamBufferReset(instance->stream);
     string_set(instance->file_path, file_path);
+
+    memset(instance->read_size, 0, sizeof(instance->read_size));
+    instance->read_index = 0;
+    instance->read_position = 0;
+    instance->read_end = false;
+    memset(&instance->parser, 0, sizeof(instance->parser));
+    instance->load_count = 0;
+    instance->refill_pending = false;
+    instance->stats.underrun_count = 0;
+    instance->stats.refill_count = 0;
+    instance->stats.buffered_min = SUBGHZ_FILE_ENCODER_STREAM_SIZE;
+
     instance->worker_running = true;
     bool res = furi_thread_start(instance->thread);
     return res;
@@ -232,6 +426,8 @@ void subghz_file_encoder_worker_stop(SubGhzFileEncoderWorker* instance) {
     furi_assert(instance->worker_running);
 
     instance->worker_running = false;
+    osThreadFlagsSet(
+        furi_thread_get_thread_id(instance->thread), SubGhzFileEncoderWorkerEvtStop);
     furi_thread_join(instance->thread);
 }
 
@@ -239,3 +435,13 @@ bool subghz_file_encoder_worker_is_running(SubGhzFileEncoderWorker* instance) {
     furi_assert(instance);
     return instance->worker_running;
 }
+
+void subghz_file_encoder_worker_get_stats(
+    SubGhzFileEncoderWorker* instance,
+    SubGhzFileEncoderWorkerStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+    stats->underrun_count = instance->stats.underrun_count;
+    stats->refill_count = instance->stats.refill_count;
+    stats->buffered_min = instance->stats.buffered_min;
+}
@@ -6,6 +6,12 @@ typedef void (*SubGhzFileEncoderWorkerCallbackEnd)(void* context);
 
 typedef struct SubGhzFileEncoderWorker SubGhzFileEncoderWorker;
 
+typedef struct {
+    uint32_t underrun_count; /**< Samples requested while the buffer was empty */
+    uint32_t refill_count; /**< Buffer refills done by the worker thread */
+    uint32_t buffered_min; /**< Lowest buffer fill seen by the consumer, samples */
+} SubGhzFileEncoderWorkerStats;
+
 /** 
  * End callback SubGhzWorker.
  * @param instance SubGhzFileEncoderWorker instance
@@ -54,3 +60,12 @@ void subghz_file_encoder_worker_stop(SubGhzFileEncoderWorker* instance);
  * @return bool - true if running
  */
 bool subghz_file_encoder_worker_is_running(SubGhzFileEncoderWorker* instance);
+
+/** 
+ * Get playback statistics of the current or last run
+ * @param instance Pointer to a SubGhzFileEncoderWorker instance
+ * @param stats Pointer to a SubGhzFileEncoderWorkerStats to fill
+ */
+void subghz_file_encoder_worker_get_stats(
+    SubGhzFileEncoderWorker* instance,
+    SubGhzFileEncoderWorkerStats* stats);
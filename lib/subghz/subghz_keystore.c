@@ -1,4 +1,5 @@
 #include "subghz_keystore.h"
+#include "protocols/keeloq_common.h"
 
 #include <furi.h>
 #include <furi_hal.h>
@@ -8,6 +9,7 @@
 #include <toolbox/stream/stream.h>
 #include <flipper_format/flipper_format.h>
 #include <flipper_format/flipper_format_i.h>
+#include <fnv1a-hash.h>
 
 #define TAG "SubGhzKeystore"
 
@@ -16,24 +18,71 @@
 #define SUBGHZ_KEYSTORE_FILE_TYPE "Flipper SubGhz Keystore File"
 #define SUBGHZ_KEYSTORE_FILE_RAW_TYPE "Flipper SubGhz Keystore RAW File"
 #define SUBGHZ_KEYSTORE_FILE_VERSION 0
+#define SUBGHZ_KEYSTORE_FILE_BINARY_VERSION 1
 
 #define SUBGHZ_KEYSTORE_FILE_ENCRYPTION_KEY_SLOT 1
 #define SUBGHZ_KEYSTORE_FILE_DECRYPTED_LINE_SIZE 512
 #define SUBGHZ_KEYSTORE_FILE_ENCRYPTED_LINE_SIZE (SUBGHZ_KEYSTORE_FILE_DECRYPTED_LINE_SIZE * 2)
 
+#define SUBGHZ_KEYSTORE_BINARY_MAGIC 0x424B4753 // "SGKB"
+#define SUBGHZ_KEYSTORE_NAME_POOL_CHUNK_SIZE 512
+#define SUBGHZ_KEYSTORE_NAME_INDEX_MIN_SIZE 64
+
 typedef enum {
     SubGhzKeystoreEncryptionNone,
     SubGhzKeystoreEncryptionAES256,
 } SubGhzKeystoreEncryption;
 
+/*
+ * Binary keystore payload, follows the IV line (or the Encryption line if not encrypted):
+ * SubGhzKeystoreBinaryHeader, name pool of zero terminated unique names,
+ * key_count of SubGhzKeystoreBinaryRecord, zero padding to the AES block size.
+ * Checksum is FNV-1a of everything after the header, padding excluded.
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t key_count;
+    uint16_t name_count;
+    uint32_t name_pool_size;
+    uint32_t checksum;
+} SubGhzKeystoreBinaryHeader;
+
+typedef struct {
+    uint64_t key;
+    uint16_t type;
+    uint16_t name;
+} __attribute__((packed)) SubGhzKeystoreBinaryRecord;
+
+ARRAY_DEF(SubGhzKeystoreNamePool, char*, M_PTR_OPLIST)
+
 struct SubGhzKeystore {
     SubGhzKeyArray_t data;
+    SubGhzKeeloqKeySearch* keeloq_search;
+
+    // Deduplicated names, chunks never move so keys can point into them
+    SubGhzKeystoreNamePool_t name_pool;
+    char* name_pool_cursor;
+    size_t name_pool_free;
+
+    // Open addressing name hash index: key index + 1, 0 is a free slot
+    uint16_t* name_index;
+    size_t name_index_size;
+    size_t name_count;
 };
 
 SubGhzKeystore* subghz_keystore_alloc() {
     SubGhzKeystore* instance = malloc(sizeof(SubGhzKeystore));
 
     SubGhzKeyArray_init(instance->data);
+    instance->keeloq_search = subghz_protocol_keeloq_common_search_alloc();
+
+    SubGhzKeystoreNamePool_init(instance->name_pool);
+    instance->name_pool_cursor = NULL;
+    instance->name_pool_free = 0;
+
+    instance->name_index = NULL;
+    instance->name_index_size = 0;
+    instance->name_count = 0;
 
     return instance;
 }
@@ -43,23 +92,123 @@ void subghz_keystore_free(SubGhzKeystore* instance) {
 
     for
         M_EACH(manufacture_code, instance->data, SubGhzKeyArray_t) {
-            string_clear(manufacture_code->name);
             manufacture_code->key = 0;
         }
     SubGhzKeyArray_clear(instance->data);
+    subghz_protocol_keeloq_common_search_free(instance->keeloq_search);
+
+    for
+        M_EACH(chunk, instance->name_pool, SubGhzKeystoreNamePool_t) {
+            free(*chunk);
+        }
+    SubGhzKeystoreNamePool_clear(instance->name_pool);
+    free(instance->name_index);
 
     free(instance);
 }
 
-static void subghz_keystore_add_key(
+static const char* subghz_keystore_name_pool_add(SubGhzKeystore* instance, const char* name) {
+    size_t size = strlen(name) + 1;
+    if(size > instance->name_pool_free) {
+        size_t chunk_size = MAX(size, (size_t)SUBGHZ_KEYSTORE_NAME_POOL_CHUNK_SIZE);
+        instance->name_pool_cursor = malloc(chunk_size);
+        instance->name_pool_free = chunk_size;
+        SubGhzKeystoreNamePool_push_back(instance->name_pool, instance->name_pool_cursor);
+    }
+
+    char* pooled_name = instance->name_pool_cursor;
+    memcpy(pooled_name, name, size);
+    instance->name_pool_cursor += size;
+    instance->name_pool_free -= size;
+
+    return pooled_name;
+}
+
+static uint32_t subghz_keystore_name_hash(const char* name) {
+    return fnv1a_buffer_hash((const uint8_t*)name, strlen(name), FNV_1A_INIT);
+}
+
+static SubGhzKey* subghz_keystore_name_index_find(SubGhzKeystore* instance, const char* name) {
+    if(instance->name_index_size == 0) return NULL;
+
+    const size_t mask = instance->name_index_size - 1;
+    size_t slot = subghz_keystore_name_hash(name) & mask;
+    while(instance->name_index[slot]) {
+        SubGhzKey* manufacture_code =
+            SubGhzKeyArray_get(instance->data, instance->name_index[slot] - 1);
+        if(strcmp(manufacture_code->name, name) == 0) {
+            return manufacture_code;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return NULL;
+}
+
+static void subghz_keystore_name_index_insert(SubGhzKeystore* instance, size_t index) {
+    const size_t mask = instance->name_index_size - 1;
+    SubGhzKey* manufacture_code = SubGhzKeyArray_get(instance->data, index);
+    size_t slot = subghz_keystore_name_hash(manufacture_code->name) & mask;
+    while(instance->name_index[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    instance->name_index[slot] = index + 1;
+    instance->name_count++;
+}
+
+/** Keep index load factor under 1/2 for the given number of names */
+static void subghz_keystore_name_index_reserve(SubGhzKeystore* instance, size_t name_count) {
+    if(name_count * 2 <= instance->name_index_size) return;
+
+    size_t size = SUBGHZ_KEYSTORE_NAME_INDEX_MIN_SIZE;
+    while(size < name_count * 2) size <<= 1;
+
+    free(instance->name_index);
+    instance->name_index = malloc(size * sizeof(uint16_t));
+    memset(instance->name_index, 0, size * sizeof(uint16_t));
+    instance->name_index_size = size;
+    instance->name_count = 0;
+
+    // First key with a name wins, as in the linear search
+    size_t index = 0;
+    for
+        M_EACH(manufacture_code, instance->data, SubGhzKeyArray_t) {
+            if(!subghz_keystore_name_index_find(instance, manufacture_code->name)) {
+                subghz_keystore_name_index_insert(instance, index);
+            }
+            index++;
+        }
+}
+
+static bool subghz_keystore_add_key(
     SubGhzKeystore* instance,
     const char* name,
     uint64_t key,
     uint16_t type) {
+    // Keys are addressed with 16 bit indexes, same limit as the binary loader
+    if(SubGhzKeyArray_size(instance->data) + 1 >= UINT16_MAX) {
+        FURI_LOG_E(TAG, "Too many keys, %s skipped", name);
+        return false;
+    }
+
+    SubGhzKey* named = subghz_keystore_name_index_find(instance, name);
+    if(named) {
+        name = named->name;
+    } else {
+        subghz_keystore_name_index_reserve(instance, instance->name_count + 1);
+        name = subghz_keystore_name_pool_add(instance, name);
+    }
+
     SubGhzKey* manufacture_code = SubGhzKeyArray_push_raw(instance->data);
-    string_init_set_str(manufacture_code->name, name);
+    manufacture_code->name = name;
     manufacture_code->key = key;
     manufacture_code->type = type;
+
+    if(!named) {
+        subghz_keystore_name_index_insert(instance, SubGhzKeyArray_size(instance->data) - 1);
+    }
+
+    return true;
 }
 
 static bool subghz_keystore_process_line(SubGhzKeystore* instance, char* line) {
@@ -70,8 +219,7 @@ static bool subghz_keystore_process_line(SubGhzKeystore* instance, char* line) {
     int ret = sscanf(line, "%16s:%hu:%64s", skey, &type, name);
     key = strtoull(skey, NULL, 16);
     if(ret == 3) {
-        subghz_keystore_add_key(instance, name, key, type);
-        return true;
+        return subghz_keystore_add_key(instance, name, key, type);
     } else {
         FURI_LOG_E(TAG, "Failed to load line: %s\r\n", line);
         return false;
@@ -177,6 +325,119 @@ static bool subghz_keystore_read_file(SubGhzKeystore* instance, Stream* stream,
     return result;
 }
 
+static bool
+    subghz_keystore_read_binary_file(SubGhzKeystore* instance, Stream* stream, uint8_t* iv) {
+    bool result = false;
+    uint8_t* payload = NULL;
+    size_t payload_size = 0;
+
+    do {
+        //skip the end of the previous line "\n"
+        stream_seek(stream, 1, StreamOffsetFromCurrent);
+
+        payload_size = stream_size(stream) - stream_tell(stream);
+        if(payload_size < sizeof(SubGhzKeystoreBinaryHeader) || (iv && payload_size % 16 != 0)) {
+            FURI_LOG_E(TAG, "Invalid binary payload size");
+            break;
+        }
+
+        payload = malloc(payload_size);
+        if(stream_read(stream, payload, payload_size) != payload_size) {
+            FURI_LOG_E(TAG, "Unable to read binary payload");
+            break;
+        }
+
+        if(iv) {
+            if(!furi_hal_crypto_store_load_key(SUBGHZ_KEYSTORE_FILE_ENCRYPTION_KEY_SLOT, iv)) {
+                FURI_LOG_E(TAG, "Unable to load decryption key");
+                break;
+            }
+            // Whole payload in one pass, in place
+            bool decrypted = furi_hal_crypto_decrypt(payload, payload, payload_size);
+            furi_hal_crypto_store_unload_key(SUBGHZ_KEYSTORE_FILE_ENCRYPTION_KEY_SLOT);
+            if(!decrypted) {
+                FURI_LOG_E(TAG, "Decryption failed");
+                break;
+            }
+        }
+
+        SubGhzKeystoreBinaryHeader header;
+        memcpy(&header, payload, sizeof(SubGhzKeystoreBinaryHeader));
+        // Sizes come from the file, compare each against what is left so nothing can wrap
+        size_t data_available = payload_size - sizeof(SubGhzKeystoreBinaryHeader);
+        size_t records_size = header.key_count * sizeof(SubGhzKeystoreBinaryRecord);
+        if(header.magic != SUBGHZ_KEYSTORE_BINARY_MAGIC ||
+           header.name_pool_size > data_available ||
+           records_size > data_available - header.name_pool_size ||
+           header.name_count > header.key_count ||
+           SubGhzKeyArray_size(instance->data) + header.key_count >= UINT16_MAX) {
+            FURI_LOG_E(TAG, "Malformed binary payload");
+            break;
+        }
+        size_t data_size = header.name_pool_size + records_size;
+
+        const uint8_t* data = payload + sizeof(SubGhzKeystoreBinaryHeader);
+        if(fnv1a_buffer_hash(data, data_size, FNV_1A_INIT) != header.checksum) {
+            FURI_LOG_E(TAG, "Checksum mismatch");
+            break;
+        }
+
+        // Names are already unique, pool becomes a chunk as is
+        char* name_pool = NULL;
+        if(header.name_pool_size) {
+            name_pool = malloc(header.name_pool_size);
+            memcpy(name_pool, data, header.name_pool_size);
+            name_pool[header.name_pool_size - 1] = '\0';
+            SubGhzKeystoreNamePool_push_back(instance->name_pool, name_pool);
+            instance->name_pool_free = 0;
+        }
+
+        subghz_keystore_name_index_reserve(instance, instance->name_count + header.name_count);
+        SubGhzKeyArray_reserve(
+            instance->data, SubGhzKeyArray_size(instance->data) + header.key_count);
+
+        const uint8_t* records = data + header.name_pool_size;
+        result = true;
+        for(size_t i = 0; i < header.key_count; i++) {
+            SubGhzKeystoreBinaryRecord record;
+            memcpy(&record, records + i * sizeof(SubGhzKeystoreBinaryRecord), sizeof(record));
+            if(record.name >= header.name_pool_size) {
+                FURI_LOG_E(TAG, "Invalid name offset: %u", record.name);
+                result = false;
+                break;
+            }
+
+            const char* name = &name_pool[record.name];
+            SubGhzKey* named = subghz_keystore_name_index_find(instance, name);
+            if(named) {
+                name = named->name;
+            } else {
+                subghz_keystore_name_index_reserve(instance, instance->name_count + 1);
+            }
+
+            SubGhzKey* manufacture_code = SubGhzKeyArray_push_raw(instance->data);
+            manufacture_code->name = name;
+            manufacture_code->key = record.key;
+            manufacture_code->type = record.type;
+
+            if(!named) {
+                subghz_keystore_name_index_insert(
+                    instance, SubGhzKeyArray_size(instance->data) - 1);
+            }
+        }
+
+        FURI_LOG_I(TAG, "Loaded %u keys, %u names", header.key_count, header.name_count);
+    } while(0);
+
+    if(payload) {
+        // Do not leave decrypted keys in the heap
+        memset(payload, 0, payload_size);
+        free(payload);
+    }
+
+    return result;
+}
+
 bool subghz_keystore_load(SubGhzKeystore* instance, const char* file_name) {
     furi_assert(instance);
     bool result = false;
@@ -207,21 +468,31 @@ bool subghz_keystore_load(SubGhzKeystore* instance, const char* file_name) {
         }
 
         if(strcmp(string_get_cstr(filetype), SUBGHZ_KEYSTORE_FILE_TYPE) != 0 ||
-           version != SUBGHZ_KEYSTORE_FILE_VERSION) {
+           (version != SUBGHZ_KEYSTORE_FILE_VERSION &&
+            version != SUBGHZ_KEYSTORE_FILE_BINARY_VERSION)) {
             FURI_LOG_E(TAG, "Type or version mismatch");
             break;
         }
 
         Stream* stream = flipper_format_get_raw_stream(flipper_format);
+        bool binary = (version == SUBGHZ_KEYSTORE_FILE_BINARY_VERSION);
         if(encryption == SubGhzKeystoreEncryptionNone) {
-            result = subghz_keystore_read_file(instance, stream, NULL);
+            if(binary) {
+                result = subghz_keystore_read_binary_file(instance, stream, NULL);
+            } else {
+                result = subghz_keystore_read_file(instance, stream, NULL);
+            }
         } else if(encryption == SubGhzKeystoreEncryptionAES256) {
             if(!flipper_format_read_hex(flipper_format, "IV", iv, 16)) {
                 FURI_LOG_E(TAG, "Missing IV");
                 break;
             }
             subghz_keystore_mess_with_iv(iv);
-            result = subghz_keystore_read_file(instance, stream, iv);
+            if(binary) {
+                result = subghz_keystore_read_binary_file(instance, stream, iv);
+            } else {
+                result = subghz_keystore_read_file(instance, stream, iv);
+            }
         } else {
             FURI_LOG_E(TAG, "Unknown encryption");
             break;
@@ -233,6 +504,8 @@ bool subghz_keystore_load(SubGhzKeystore* instance, const char* file_name) {
 
     string_clear(filetype);
 
+    subghz_protocol_keeloq_common_search_load(instance->keeloq_search, &instance->data);
+
     return result;
 }
 
@@ -287,7 +560,7 @@ bool subghz_keystore_save(SubGhzKeystore* instance, const char* file_name, uint8
                     (uint32_t)(key->key >> 32),
                     (uint32_t)key->key,
                     key->type,
-                    string_get_cstr(key->name));
+                    key->name);
                 // Verify length and align
                 furi_assert(len > 0);
                 if(len % 16 != 0) {
@@ -331,11 +604,143 @@ bool subghz_keystore_save(SubGhzKeystore* instance, const char* file_name, uint8
     return result;
 }
 
+bool subghz_keystore_save_binary(SubGhzKeystore* instance, const char* file_name, uint8_t* iv) {
+    furi_assert(instance);
+    bool result = false;
+
+    // Layout: header, name pool, records, padding
+    size_t key_count = SubGhzKeyArray_size(instance->data);
+    size_t name_pool_size = 0;
+    for
+        M_EACH(manufacture_code, instance->data, SubGhzKeyArray_t) {
+            if(subghz_keystore_name_index_find(instance, manufacture_code->name) ==
+               manufacture_code) {
+                name_pool_size += strlen(manufacture_code->name) + 1;
+            }
+        }
+    // Key count and name offsets are 16 bit wide, loader refuses UINT16_MAX keys
+    if(key_count >= UINT16_MAX || name_pool_size > UINT16_MAX) {
+        FURI_LOG_E(
+            TAG, "Keystore too large: %u keys, %u bytes of names", key_count, name_pool_size);
+        return false;
+    }
+
+    size_t data_size = name_pool_size + key_count * sizeof(SubGhzKeystoreBinaryRecord);
+    size_t payload_size = sizeof(SubGhzKeystoreBinaryHeader) + data_size;
+    if(payload_size % 16 != 0) {
+        payload_size += (16 - payload_size % 16);
+    }
+
+    uint8_t* payload = malloc(payload_size);
+    memset(payload, 0, payload_size);
+    uint8_t* name_pool = payload + sizeof(SubGhzKeystoreBinaryHeader);
+    uint8_t* records = name_pool + name_pool_size;
+
+    SubGhzKeystoreBinaryHeader header = {
+        .magic = SUBGHZ_KEYSTORE_BINARY_MAGIC,
+        .key_count = key_count,
+        .name_count = 0,
+        .name_pool_size = name_pool_size,
+    };
+
+    // Offset of the name is stored in the index slot of the first key with this name
+    uint16_t* name_offset = malloc(key_count * sizeof(uint16_t));
+    size_t name_pool_cursor = 0;
+    size_t index = 0;
+    for
+        M_EACH(manufacture_code, instance->data, SubGhzKeyArray_t) {
+            SubGhzKey* named = subghz_keystore_name_index_find(instance, manufacture_code->name);
+            size_t named_index = named - SubGhzKeyArray_get(instance->data, 0);
+            if(named == manufacture_code) {
+                size_t size = strlen(manufacture_code->name) + 1;
+                memcpy(name_pool + name_pool_cursor, manufacture_code->name, size);
+                name_offset[index] = name_pool_cursor;
+                name_pool_cursor += size;
+                header.name_count++;
+            }
+
+            SubGhzKeystoreBinaryRecord record = {
+                .key = manufacture_code->key,
+                .type = manufacture_code->type,
+                .name = name_offset[named_index],
+            };
+            memcpy(records + index * sizeof(record), &record, sizeof(record));
+            index++;
+        }
+    free(name_offset);
+
+    header.checksum = fnv1a_buffer_hash(name_pool, data_size, FNV_1A_INIT);
+    memcpy(payload, &header, sizeof(header));
+
+    Storage* storage = furi_record_open("storage");
+    FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
+    do {
+        if(!flipper_format_file_open_always(flipper_format, file_name)) {
+            FURI_LOG_E(TAG, "Unable to open file for write: %s", file_name);
+            break;
+        }
+        if(!flipper_format_write_header_cstr(
+               flipper_format, SUBGHZ_KEYSTORE_FILE_TYPE, SUBGHZ_KEYSTORE_FILE_BINARY_VERSION)) {
+            FURI_LOG_E(TAG, "Unable to add header");
+            break;
+        }
+        uint32_t encryption = SubGhzKeystoreEncryptionAES256;
+        if(!flipper_format_write_uint32(flipper_format, "Encryption", &encryption, 1)) {
+            FURI_LOG_E(TAG, "Unable to add Encryption");
+            break;
+        }
+        if(!flipper_format_write_hex(flipper_format, "IV", iv, 16)) {
+            FURI_LOG_E(TAG, "Unable to add IV");
+            break;
+        }
+
+        subghz_keystore_mess_with_iv(iv);
+
+        if(!furi_hal_crypto_store_load_key(SUBGHZ_KEYSTORE_FILE_ENCRYPTION_KEY_SLOT, iv)) {
+            FURI_LOG_E(TAG, "Unable to load encryption key");
+            break;
+        }
+        bool encrypted = furi_hal_crypto_encrypt(payload, payload, payload_size);
+        furi_hal_crypto_store_unload_key(SUBGHZ_KEYSTORE_FILE_ENCRYPTION_KEY_SLOT);
+        if(!encrypted) {
+            FURI_LOG_E(TAG, "Encryption failed");
+            break;
+        }
+
+        Stream* stream = flipper_format_get_raw_stream(flipper_format);
+        if(stream_write(stream, payload, payload_size) != payload_size) {
+            FURI_LOG_E(TAG, "Unable to write payload");
+            break;
+        }
+
+        FURI_LOG_I(TAG, "Success. Saved %d keys, %d names", key_count, header.name_count);
+        result = true;
+    } while(0);
+    flipper_format_free(flipper_format);
+    furi_record_close("storage");
+
+    memset(payload, 0, payload_size);
+    free(payload);
+
+    return result;
+}
+
 SubGhzKeyArray_t* subghz_keystore_get_data(SubGhzKeystore* instance) {
     furi_assert(instance);
     return &instance->data;
 }
 
+SubGhzKey* subghz_keystore_get_key_by_name(SubGhzKeystore* instance, const char* name) {
+    furi_assert(instance);
+    furi_assert(name);
+    return subghz_keystore_name_index_find(instance, name);
+}
+
+SubGhzKeeloqKeySearch* subghz_keystore_get_keeloq_search(SubGhzKeystore* instance) {
+    furi_assert(instance);
+    return instance->keeloq_search;
+}
+
 bool subghz_keystore_raw_encrypted_save(
     const char* input_file_name,
     const char* output_file_name,
@@ -475,29 +880,80 @@ bool subghz_keystore_raw_encrypted_save(
     return encrypted;
 }
 
-bool subghz_keystore_raw_get_data(const char* file_name, size_t offset, uint8_t* data, size_t len) {
-    bool result = false;
+#define SUBGHZ_KEYSTORE_RAW_BLOCK_SIZE 16
+/* Holds a whole Came Atomo table, one reader serves every decoder of an environment */
+#define SUBGHZ_KEYSTORE_RAW_READER_CACHE_SIZE 16
+
+typedef struct {
+    size_t block;
+    uint32_t last_used;
+    bool valid;
+    uint8_t data[SUBGHZ_KEYSTORE_RAW_BLOCK_SIZE];
+} SubGhzKeystoreRawReaderBlock;
+
+struct SubGhzKeystoreRawReader {
+    Storage* storage;
+    // File is open only while a lookup misses the cache, other readers may open it meanwhile
+    FlipperFormat* flipper_format;
+    bool file_opened;
+    string_t file_name;
+    bool opened;
+    osMutexId_t mutex;
+
     uint8_t iv[16];
+    size_t data_offset;
+    size_t data_size;
+
+    uint32_t use_counter;
+    SubGhzKeystoreRawReaderBlock cache[SUBGHZ_KEYSTORE_RAW_READER_CACHE_SIZE];
+};
+
+SubGhzKeystoreRawReader* subghz_keystore_raw_reader_alloc() {
+    SubGhzKeystoreRawReader* instance = malloc(sizeof(SubGhzKeystoreRawReader));
+    memset(instance, 0, sizeof(SubGhzKeystoreRawReader));
+
+    instance->storage = furi_record_open("storage");
+    instance->flipper_format = flipper_format_file_alloc(instance->storage);
+    string_init(instance->file_name);
+    instance->mutex = osMutexNew(NULL);
+
+    return instance;
+}
+
+void subghz_keystore_raw_reader_free(SubGhzKeystoreRawReader* instance) {
+    furi_assert(instance);
+
+    subghz_keystore_raw_reader_close(instance);
+    osMutexDelete(instance->mutex);
+    string_clear(instance->file_name);
+    flipper_format_free(instance->flipper_format);
+    furi_record_close("storage");
+
+    free(instance);
+}
+
+bool subghz_keystore_raw_reader_open(SubGhzKeystoreRawReader* instance, const char* file_name) {
+    furi_assert(instance);
     uint32_t version;
     SubGhzKeystoreEncryption encryption;
 
+    subghz_keystore_raw_reader_close(instance);
+
     string_t str_temp;
     string_init(str_temp);
 
-    Storage* storage = furi_record_open("storage");
-    char* decrypted_line = malloc(SUBGHZ_KEYSTORE_FILE_DECRYPTED_LINE_SIZE);
-
-    FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
+    furi_check(osMutexAcquire(instance->mutex, osWaitForever) == osOK);
     do {
-        if(!flipper_format_file_open_existing(flipper_format, file_name)) {
+        if(!flipper_format_file_open_existing(instance->flipper_format, file_name)) {
             FURI_LOG_E(TAG, "Unable to open file for read: %s", file_name);
             break;
         }
-        if(!flipper_format_read_header(flipper_format, str_temp, &version)) {
+        if(!flipper_format_read_header(instance->flipper_format, str_temp, &version)) {
             FURI_LOG_E(TAG, "Missing or incorrect header");
             break;
         }
-        if(!flipper_format_read_uint32(flipper_format, "Encryption", (uint32_t*)&encryption, 1)) {
+        if(!flipper_format_read_uint32(
+               instance->flipper_format, "Encryption", (uint32_t*)&encryption, 1)) {
             FURI_LOG_E(TAG, "Missing encryption type");
             break;
         }
@@ -508,97 +964,198 @@ bool subghz_keystore_raw_get_data(const char* file_name, size_t offset, uint8_t*
             break;
         }
 
-        Stream* stream = flipper_format_get_raw_stream(flipper_format);
         if(encryption != SubGhzKeystoreEncryptionAES256) {
             FURI_LOG_E(TAG, "Unknown encryption");
             break;
         }
 
-        if(offset < 16) {
-            if(!flipper_format_read_hex(flipper_format, "IV", iv, 16)) {
-                FURI_LOG_E(TAG, "Missing IV");
-                break;
-            }
-            subghz_keystore_mess_with_iv(iv);
+        if(!flipper_format_read_hex(instance->flipper_format, "IV", instance->iv, 16)) {
+            FURI_LOG_E(TAG, "Missing IV");
+            break;
         }
+        subghz_keystore_mess_with_iv(instance->iv);
 
-        if(!flipper_format_read_string(flipper_format, "Encrypt_data", str_temp)) {
+        if(!flipper_format_read_string(instance->flipper_format, "Encrypt_data", str_temp)) {
             FURI_LOG_E(TAG, "Missing Encrypt_data");
             break;
         }
 
-        size_t bufer_size;
-        if(len <= (16 - offset % 16)) {
-            bufer_size = 32;
-        } else {
-            bufer_size = (((len) / 16) + 2) * 32;
-        }
-        furi_assert(SUBGHZ_KEYSTORE_FILE_DECRYPTED_LINE_SIZE >= bufer_size / 2);
-
-        uint8_t buffer[bufer_size];
-        size_t ret = 0;
-        bool decrypted = true;
+        Stream* stream = flipper_format_get_raw_stream(instance->flipper_format);
         //skip the end of the previous line "\n"
-        stream_read(stream, buffer, 1);
+        stream_seek(stream, 1, StreamOffsetFromCurrent);
 
-        size_t size = stream_size(stream);
-        size -= stream_tell(stream);
-        if(size < (offset * 2 + len * 2)) {
-            FURI_LOG_E(TAG, "Seek position exceeds file size");
-            break;
+        instance->data_offset = stream_tell(stream);
+        instance->data_size = stream_size(stream) - instance->data_offset;
+        string_set_str(instance->file_name, file_name);
+        instance->opened = true;
+    } while(0);
+
+    string_clear(str_temp);
+    flipper_format_file_close(instance->flipper_format);
+    bool opened = instance->opened;
+    osMutexRelease(instance->mutex);
+
+    if(!opened) {
+        subghz_keystore_raw_reader_close(instance);
+    }
+
+    return opened;
+}
+
+void subghz_keystore_raw_reader_close(SubGhzKeystoreRawReader* instance) {
+    furi_assert(instance);
+
+    furi_check(osMutexAcquire(instance->mutex, osWaitForever) == osOK);
+    flipper_format_file_close(instance->flipper_format);
+    string_reset(instance->file_name);
+    instance->opened = false;
+    memset(instance->iv, 0, sizeof(instance->iv));
+    memset(instance->cache, 0, sizeof(instance->cache));
+    osMutexRelease(instance->mutex);
+}
+
+static void subghz_keystore_raw_hex_to_bin(const uint8_t* hex, uint8_t* bin, size_t bin_size) {
+    for(size_t i = 0; i < bin_size; i++) {
+        uint8_t hi_nibble = 0;
+        uint8_t lo_nibble = 0;
+        hex_char_to_hex_nibble(hex[i * 2], &hi_nibble);
+        hex_char_to_hex_nibble(hex[i * 2 + 1], &lo_nibble);
+        bin[i] = (hi_nibble << 4) | lo_nibble;
+    }
+}
+
+/** Decrypt one block: CBC needs only the previous ciphertext block as IV */
+static bool subghz_keystore_raw_reader_decrypt_block(
+    SubGhzKeystoreRawReader* instance,
+    size_t block,
+    uint8_t* data) {
+    const size_t hex_block_size = SUBGHZ_KEYSTORE_RAW_BLOCK_SIZE * 2;
+    uint8_t buffer[hex_block_size * 2];
+    uint8_t iv[SUBGHZ_KEYSTORE_RAW_BLOCK_SIZE];
+    uint8_t encrypted[SUBGHZ_KEYSTORE_RAW_BLOCK_SIZE];
+
+    if((block + 1) * hex_block_size > instance->data_size) {
+        FURI_LOG_E(TAG, "Seek position exceeds file size");
+        return false;
+    }
+
+    // Previous block and the block itself in one read
+    size_t first_block = block ? block - 1 : 0;
+    size_t read_size = (block - first_block + 1) * hex_block_size;
+    Stream* stream = flipper_format_get_raw_stream(instance->flipper_format);
+    if(!instance->file_opened) {
+        if(!flipper_format_file_open_existing(
+               instance->flipper_format, string_get_cstr(instance->file_name))) {
+            FURI_LOG_E(
+                TAG, "Unable to open file for read: %s", string_get_cstr(instance->file_name));
+            return false;
         }
+        instance->file_opened = true;
+    }
+    if(!stream_seek(
+           stream, instance->data_offset + first_block * hex_block_size, StreamOffsetFromStart) ||
+       stream_read(stream, buffer, read_size) != read_size) {
+        FURI_LOG_E(TAG, "Unable to read block %u", (unsigned)block);
+        return false;
+    }
 
-        if(offset >= 16) {
-            stream_seek(stream, ((offset / 16) - 1) * 32, StreamOffsetFromCurrent);
-            ret = stream_read(stream, buffer, 32);
-            furi_assert(ret == 32);
-            for(uint16_t i = 0; i < ret - 1; i += 2) {
-                uint8_t hi_nibble = 0;
-                uint8_t lo_nibble = 0;
-                hex_char_to_hex_nibble(buffer[i], &hi_nibble);
-                hex_char_to_hex_nibble(buffer[i + 1], &lo_nibble);
-                iv[i / 2] = (hi_nibble << 4) | lo_nibble;
-            }
+    if(block) {
+        subghz_keystore_raw_hex_to_bin(buffer, iv, sizeof(iv));
+        subghz_keystore_raw_hex_to_bin(buffer + hex_block_size, encrypted, sizeof(encrypted));
+    } else {
+        memcpy(iv, instance->iv, sizeof(iv));
+        subghz_keystore_raw_hex_to_bin(buffer, encrypted, sizeof(encrypted));
+    }
+
+    if(!furi_hal_crypto_store_load_key(SUBGHZ_KEYSTORE_FILE_ENCRYPTION_KEY_SLOT, iv)) {
+        FURI_LOG_E(TAG, "Unable to load encryption key");
+        return false;
+    }
+    bool decrypted = furi_hal_crypto_decrypt(encrypted, data, SUBGHZ_KEYSTORE_RAW_BLOCK_SIZE);
+    furi_hal_crypto_store_unload_key(SUBGHZ_KEYSTORE_FILE_ENCRYPTION_KEY_SLOT);
+    if(!decrypted) {
+        FURI_LOG_E(TAG, "Decryption failed");
+    }
+
+    return decrypted;
+}
+
+static const uint8_t*
+    subghz_keystore_raw_reader_get_block(SubGhzKeystoreRawReader* instance, size_t block) {
+    SubGhzKeystoreRawReaderBlock* victim = &instance->cache[0];
+    instance->use_counter++;
+
+    for(size_t i = 0; i < SUBGHZ_KEYSTORE_RAW_READER_CACHE_SIZE; i++) {
+        SubGhzKeystoreRawReaderBlock* cached = &instance->cache[i];
+        if(cached->valid && cached->block == block) {
+            cached->last_used = instance->use_counter;
+            return cached->data;
+        }
+        // Prefer free slots, then the least recently used one
+        if(!cached->valid) {
+            if(victim->valid) victim = cached;
+        } else if(victim->valid && cached->last_used < victim->last_used) {
+            victim = cached;
         }
+    }
 
-        if(!furi_hal_crypto_store_load_key(SUBGHZ_KEYSTORE_FILE_ENCRYPTION_KEY_SLOT, iv)) {
-            FURI_LOG_E(TAG, "Unable to load encryption key");
+    victim->valid = subghz_keystore_raw_reader_decrypt_block(instance, block, victim->data);
+    if(!victim->valid) return NULL;
+
+    victim->block = block;
+    victim->last_used = instance->use_counter;
+    return victim->data;
+}
+
+bool subghz_keystore_raw_reader_get_data(
+    SubGhzKeystoreRawReader* instance,
+    size_t offset,
+    uint8_t* data,
+    size_t len) {
+    furi_assert(instance);
+    bool result = true;
+
+    furi_check(osMutexAcquire(instance->mutex, osWaitForever) == osOK);
+    if(!instance->opened) result = false;
+
+    while(result && len) {
+        const uint8_t* block = subghz_keystore_raw_reader_get_block(
+            instance, offset / SUBGHZ_KEYSTORE_RAW_BLOCK_SIZE);
+        if(!block) {
+            result = false;
             break;
         }
 
-        do {
-            memset(buffer, 0, bufer_size);
-            ret = stream_read(stream, buffer, bufer_size);
-            furi_assert(ret == bufer_size);
-            for(uint16_t i = 0; i < ret - 1; i += 2) {
-                uint8_t hi_nibble = 0;
-                uint8_t lo_nibble = 0;
-                hex_char_to_hex_nibble(buffer[i], &hi_nibble);
-                hex_char_to_hex_nibble(buffer[i + 1], &lo_nibble);
-                buffer[i / 2] = (hi_nibble << 4) | lo_nibble;
-            }
+        size_t block_offset = offset % SUBGHZ_KEYSTORE_RAW_BLOCK_SIZE;
+        size_t chunk = MIN(len, SUBGHZ_KEYSTORE_RAW_BLOCK_SIZE - block_offset);
+        memcpy(data, block + block_offset, chunk);
 
-            memset(decrypted_line, 0, SUBGHZ_KEYSTORE_FILE_DECRYPTED_LINE_SIZE);
+        data += chunk;
+        offset += chunk;
+        len -= chunk;
+    }
 
-            if(!furi_hal_crypto_decrypt(
-                   (uint8_t*)buffer, (uint8_t*)decrypted_line, bufer_size / 2)) {
-                decrypted = false;
-                FURI_LOG_E(TAG, "Decryption failed");
-                break;
-            }
-            memcpy(data, (uint8_t*)decrypted_line + (offset - (offset / 16) * 16), len);
+    // Misses opened the file, do not hold it between lookups
+    if(instance->file_opened) {
+        flipper_format_file_close(instance->flipper_format);
+        instance->file_opened = false;
+    }
+    osMutexRelease(instance->mutex);
 
-        } while(0);
-        furi_hal_crypto_store_unload_key(SUBGHZ_KEYSTORE_FILE_ENCRYPTION_KEY_SLOT);
-        if(decrypted) result = true;
-    } while(0);
-    flipper_format_free(flipper_format);
+    return result;
+}
 
-    furi_record_close("storage");
+bool subghz_keystore_raw_get_data(
+    const char* file_name,
+    size_t offset,
+    uint8_t* data,
+    size_t len) {
+    SubGhzKeystoreRawReader* reader = subghz_keystore_raw_reader_alloc();
 
-    free(decrypted_line);
+    bool result = subghz_keystore_raw_reader_open(reader, file_name) &&
+                  subghz_keystore_raw_reader_get_data(reader, offset, data, len);
 
-    string_clear(str_temp);
+    subghz_keystore_raw_reader_free(reader);
 
     return result;
 }
@@ -5,8 +5,8 @@
 #include <stdint.h>
 
 typedef struct {
-    string_t name;
     uint64_t key;
+    const char* name;
     uint16_t type;
 } SubGhzKey;
 
@@ -16,6 +16,10 @@ ARRAY_DEF(SubGhzKeyArray, SubGhzKey, M_POD_OPLIST)
 
 typedef struct SubGhzKeystore SubGhzKeystore;
 
+typedef struct SubGhzKeeloqKeySearch SubGhzKeeloqKeySearch;
+
+typedef struct SubGhzKeystoreRawReader SubGhzKeystoreRawReader;
+
 /**
  * Allocate SubGhzKeystore.
  * @return SubGhzKeystore* pointer to a SubGhzKeystore instance
@@ -29,7 +33,7 @@ SubGhzKeystore* subghz_keystore_alloc();
 void subghz_keystore_free(SubGhzKeystore* instance);
 
 /** 
- * Loading manufacture key from file
+ * Loading manufacture key from file, text and binary formats are detected by version
  * @param instance Pointer to a SubGhzKeystore instance
  * @param filename Full path to the file
  */
@@ -43,6 +47,15 @@ bool subghz_keystore_load(SubGhzKeystore* instance, const char* filename);
  */
 bool subghz_keystore_save(SubGhzKeystore* instance, const char* filename, uint8_t* iv);
 
+/** 
+ * Save manufacture key to file in binary format
+ * @param instance Pointer to a SubGhzKeystore instance
+ * @param filename Full path to the file
+ * @param iv IV, 16 bytes
+ * @return true On success
+ */
+bool subghz_keystore_save_binary(SubGhzKeystore* instance, const char* filename, uint8_t* iv);
+
 /** 
  * Get array of keys and names manufacture
  * @param instance Pointer to a SubGhzKeystore instance
@@ -50,6 +63,21 @@ bool subghz_keystore_save(SubGhzKeystore* instance, const char* filename, uint8_
  */
 SubGhzKeyArray_t* subghz_keystore_get_data(SubGhzKeystore* instance);
 
+/** 
+ * Get first manufacture key with given name
+ * @param instance Pointer to a SubGhzKeystore instance
+ * @param name Manufacture name
+ * @return SubGhzKey* or NULL if not found
+ */
+SubGhzKey* subghz_keystore_get_key_by_name(SubGhzKeystore* instance, const char* name);
+
+/** 
+ * Get KeeLoq key search prepared for the loaded keys
+ * @param instance Pointer to a SubGhzKeystore instance
+ * @return SubGhzKeeloqKeySearch*
+ */
+SubGhzKeeloqKeySearch* subghz_keystore_get_keeloq_search(SubGhzKeystore* instance);
+
 /** 
  * Save RAW encrypted to file
  * @param input_file_name Full path to the input file
@@ -70,3 +98,45 @@ bool subghz_keystore_raw_encrypted_save(
  * @return true On success
  */
 bool subghz_keystore_raw_get_data(const char* file_name, size_t offset, uint8_t* data, size_t len);
+
+/**
+ * Allocate SubGhzKeystoreRawReader.
+ * @return SubGhzKeystoreRawReader* pointer to a SubGhzKeystoreRawReader instance
+ */
+SubGhzKeystoreRawReader* subghz_keystore_raw_reader_alloc();
+
+/**
+ * Free SubGhzKeystoreRawReader, closes file if opened.
+ * @param instance Pointer to a SubGhzKeystoreRawReader instance
+ */
+void subghz_keystore_raw_reader_free(SubGhzKeystoreRawReader* instance);
+
+/** 
+ * Open encrypted RAW file and parse its header. The file is only held open
+ * while a lookup misses the cache, so several readers may use the same file.
+ * @param instance Pointer to a SubGhzKeystoreRawReader instance
+ * @param file_name Full path to the input file
+ * @return true On success
+ */
+bool subghz_keystore_raw_reader_open(SubGhzKeystoreRawReader* instance, const char* file_name);
+
+/** 
+ * Close file and wipe decrypted data
+ * @param instance Pointer to a SubGhzKeystoreRawReader instance
+ */
+void subghz_keystore_raw_reader_close(SubGhzKeystoreRawReader* instance);
+
+/** 
+ * Get decrypted RAW data, recently used blocks are served from cache.
+ * Safe to call from several threads.
+ * @param instance Pointer to a SubGhzKeystoreRawReader instance
+ * @param offset Offset from the start of the RAW data
+ * @param data Returned array
+ * @param len Required data length
+ * @return true On success
+ */
+bool subghz_keystore_raw_reader_get_data(
+    SubGhzKeystoreRawReader* instance,
+    size_t offset,
+    uint8_t* data,
+    size_t len);
@@ -0,0 +1,153 @@
+#include "subghz_raw_binary.h"
+
+#include <furi.h>
+#include <fnv1a-hash.h>
+
+#define TAG "SubGhzRawBinary"
+
+#define SUBGHZ_RAW_BINARY_MARKER SUBGHZ_RAW_BINARY_KEY ": " SUBGHZ_RAW_BINARY_NAME "\n"
+#define SUBGHZ_RAW_BINARY_HEADER_SIZE 8
+
+struct SubGhzRawBinary {
+    uint8_t block[SUBGHZ_RAW_BINARY_BLOCK_SIZE_MAX];
+};
+
+SubGhzRawBinary* subghz_raw_binary_alloc() {
+    SubGhzRawBinary* instance = malloc(sizeof(SubGhzRawBinary));
+    return instance;
+}
+
+void subghz_raw_binary_free(SubGhzRawBinary* instance) {
+    furi_assert(instance);
+    free(instance);
+}
+
+bool subghz_raw_binary_write_marker(Stream* stream) {
+    return stream_write_cstring(stream, SUBGHZ_RAW_BINARY_MARKER) ==
+           strlen(SUBGHZ_RAW_BINARY_MARKER);
+}
+
+bool subghz_raw_binary_check_marker(Stream* stream) {
+    const size_t marker_size = strlen(SUBGHZ_RAW_BINARY_MARKER);
+    uint8_t buffer[marker_size];
+
+    size_t ret = stream_read(stream, buffer, marker_size);
+    if(ret == marker_size && memcmp(buffer, SUBGHZ_RAW_BINARY_MARKER, marker_size) == 0) {
+        return true;
+    }
+
+    stream_seek(stream, -(int32_t)ret, StreamOffsetFromCurrent);
+    return false;
+}
+
+static inline uint32_t subghz_raw_binary_checksum(const uint8_t* block, size_t size) {
+    // sample_count and size, then payload
+    uint32_t hash = fnv1a_buffer_hash(block, 4, FNV_1A_INIT);
+    return fnv1a_buffer_hash(block + SUBGHZ_RAW_BINARY_HEADER_SIZE, size, hash);
+}
+
+size_t subghz_raw_binary_encode(const int32_t* samples, size_t count, uint8_t* block) {
+    furi_assert(count <= SUBGHZ_RAW_BINARY_SAMPLES_MAX);
+
+    uint8_t* payload = block + SUBGHZ_RAW_BINARY_HEADER_SIZE;
+    size_t size = 0;
+    for(size_t i = 0; i < count; i++) {
+        // Wrapping arithmetic keeps any int32 pair representable
+        uint32_t delta = (uint32_t)samples[i] - (i < 2 ? 0 : (uint32_t)samples[i - 2]);
+        uint32_t zigzag = (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+        while(zigzag >= 0x80) {
+            payload[size++] = (zigzag & 0x7F) | 0x80;
+            zigzag >>= 7;
+        }
+        payload[size++] = zigzag;
+    }
+
+    block[0] = count & 0xFF;
+    block[1] = count >> 8;
+    block[2] = size & 0xFF;
+    block[3] = size >> 8;
+    uint32_t checksum = subghz_raw_binary_checksum(block, size);
+    for(size_t i = 0; i < 4; i++) {
+        block[4 + i] = checksum >> (i * 8);
+    }
+
+    return SUBGHZ_RAW_BINARY_HEADER_SIZE + size;
+}
+
+bool subghz_raw_binary_decode(const uint8_t* block, size_t size, int32_t* samples, size_t* count) {
+    if(size < SUBGHZ_RAW_BINARY_HEADER_SIZE) return false;
+
+    size_t sample_count = block[0] | (block[1] << 8);
+    size_t payload_size = block[2] | (block[3] << 8);
+    uint32_t checksum = block[4] | (block[5] << 8) | (block[6] << 16) | ((uint32_t)block[7] << 24);
+    if(sample_count > SUBGHZ_RAW_BINARY_SAMPLES_MAX ||
+       payload_size != size - SUBGHZ_RAW_BINARY_HEADER_SIZE ||
+       checksum != subghz_raw_binary_checksum(block, payload_size)) {
+        FURI_LOG_E(TAG, "Damaged block");
+        return false;
+    }
+
+    const uint8_t* payload = block + SUBGHZ_RAW_BINARY_HEADER_SIZE;
+    size_t offset = 0;
+    for(size_t i = 0; i < sample_count; i++) {
+        uint32_t zigzag = 0;
+        for(uint8_t shift = 0;; shift += 7) {
+            if(offset == payload_size || shift > 28) {
+                FURI_LOG_E(TAG, "Malformed varint");
+                return false;
+            }
+            uint8_t byte = payload[offset++];
+            zigzag |= (uint32_t)(byte & 0x7F) << shift;
+            if(!(byte & 0x80)) break;
+        }
+        uint32_t delta = (zigzag >> 1) ^ -(zigzag & 1);
+        samples[i] = (int32_t)(delta + (i < 2 ? 0 : (uint32_t)samples[i - 2]));
+    }
+    if(offset != payload_size) {
+        FURI_LOG_E(TAG, "Trailing data in block");
+        return false;
+    }
+
+    *count = sample_count;
+    return true;
+}
+
+bool subghz_raw_binary_write(
+    SubGhzRawBinary* instance,
+    Stream* stream,
+    const int32_t* samples,
+    size_t count) {
+    furi_assert(instance);
+    size_t size = subghz_raw_binary_encode(samples, count, instance->block);
+    return stream_write(stream, instance->block, size) == size;
+}
+
+bool subghz_raw_binary_read(
+    SubGhzRawBinary* instance,
+    Stream* stream,
+    int32_t* samples,
+    size_t* count) {
+    furi_assert(instance);
+    *count = 0;
+
+    size_t ret = stream_read(stream, instance->block, SUBGHZ_RAW_BINARY_HEADER_SIZE);
+    if(ret == 0) return false;
+    if(ret != SUBGHZ_RAW_BINARY_HEADER_SIZE) {
+        FURI_LOG_E(TAG, "Truncated block header");
+        return false;
+    }
+
+    size_t payload_size = instance->block[2] | (instance->block[3] << 8);
+    if(payload_size > SUBGHZ_RAW_BINARY_BLOCK_SIZE_MAX - SUBGHZ_RAW_BINARY_HEADER_SIZE) {
+        FURI_LOG_E(TAG, "Block too large");
+        return false;
+    }
+    if(stream_read(stream, instance->block + SUBGHZ_RAW_BINARY_HEADER_SIZE, payload_size) !=
+       payload_size) {
+        FURI_LOG_E(TAG, "Truncated block");
+        return false;
+    }
+
+    return subghz_raw_binary_decode(
+        instance->block, SUBGHZ_RAW_BINARY_HEADER_SIZE + payload_size, samples, count);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include <lib/toolbox/stream/stream.h>
+
+/**
+ * Binary RAW capture encoding.
+ *
+ * The file keeps the usual text header up to the "Protocol" key, followed by
+ * the "RAW_Format: Delta" marker line. Samples are then stored as a sequence
+ * of blocks until the end of the file:
+ *
+ * | sample_count: u16 | size: u16 | checksum: u32 | payload: size bytes |
+ *
+ * Each sample is stored as the zig-zag varint of its difference with the
+ * sample two positions earlier in the same block (the previous pulse of the
+ * same level). The checksum is FNV-1a over sample_count, size and payload.
+ */
+
+#define SUBGHZ_RAW_BINARY_KEY "RAW_Format"
+#define SUBGHZ_RAW_BINARY_NAME "Delta"
+
+/** Maximum samples in one block */
+#define SUBGHZ_RAW_BINARY_SAMPLES_MAX 512
+/** Maximum encoded block size, header included */
+#define SUBGHZ_RAW_BINARY_BLOCK_SIZE_MAX (8 + SUBGHZ_RAW_BINARY_SAMPLES_MAX * 5)
+
+typedef struct SubGhzRawBinary SubGhzRawBinary;
+
+/**
+ * Allocate SubGhzRawBinary.
+ * @return SubGhzRawBinary* pointer to a SubGhzRawBinary instance
+ */
+SubGhzRawBinary* subghz_raw_binary_alloc();
+
+/**
+ * Free SubGhzRawBinary.
+ * @param instance Pointer to a SubGhzRawBinary instance
+ */
+void subghz_raw_binary_free(SubGhzRawBinary* instance);
+
+/**
+ * Write the marker line that starts binary data.
+ * @param stream Stream positioned right after the "Protocol" line
+ * @return true On success
+ */
+bool subghz_raw_binary_write_marker(Stream* stream);
+
+/**
+ * Check for the marker line, consume it if present.
+ * @param stream Stream positioned right after the "Protocol" line
+ * @return true If binary data follows, false and stream position is unchanged otherwise
+ */
+bool subghz_raw_binary_check_marker(Stream* stream);
+
+/**
+ * Encode samples into a block.
+ * @param samples Signed durations, positive for high level
+ * @param count Sample count, up to SUBGHZ_RAW_BINARY_SAMPLES_MAX
+ * @param block Output buffer of SUBGHZ_RAW_BINARY_BLOCK_SIZE_MAX bytes
+ * @return size_t Encoded block size
+ */
+size_t subghz_raw_binary_encode(const int32_t* samples, size_t count, uint8_t* block);
+
+/**
+ * Decode and verify a block.
+ * @param block Encoded block
+ * @param size Encoded block size
+ * @param samples Output buffer of SUBGHZ_RAW_BINARY_SAMPLES_MAX samples
+ * @param count Decoded sample count
+ * @return true On success
+ */
+bool subghz_raw_binary_decode(const uint8_t* block, size_t size, int32_t* samples, size_t* count);
+
+/**
+ * Encode samples and write them as one block.
+ * @param instance Pointer to a SubGhzRawBinary instance
+ * @param stream Stream to write to
+ * @param samples Signed durations, positive for high level
+ * @param count Sample count, up to SUBGHZ_RAW_BINARY_SAMPLES_MAX
+ * @return true On success
+ */
+bool subghz_raw_binary_write(
+    SubGhzRawBinary* instance,
+    Stream* stream,
+    const int32_t* samples,
+    size_t count);
+
+/**
+ * Read and decode the next block.
+ * @param instance Pointer to a SubGhzRawBinary instance
+ * @param stream Stream to read from
+ * @param samples Output buffer of SUBGHZ_RAW_BINARY_SAMPLES_MAX samples
+ * @param count Decoded sample count
+ * @return true On success, false at the end of data or on a damaged block
+ */
+bool subghz_raw_binary_read(
+    SubGhzRawBinary* instance,
+    Stream* stream,
+    int32_t* samples,
+    size_t* count);
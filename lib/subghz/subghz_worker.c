@@ -1,16 +1,37 @@
 #include "subghz_worker.h"
 
-#include <stream_buffer.h>
 #include <furi.h>
 
 #define TAG "SubGhzWorker"
 
+/* Ring capacity, must be a power of two */
+#define SUBGHZ_WORKER_RING_SIZE 2048
+#define SUBGHZ_WORKER_RING_MASK (SUBGHZ_WORKER_RING_SIZE - 1)
+/* Wake the worker once this many edges are queued */
+#define SUBGHZ_WORKER_BATCH 64
+/* Drain sparse signals at least this often, ms */
+#define SUBGHZ_WORKER_TIMEOUT 10
+
+typedef enum {
+    SubGhzWorkerEvtRx = (1 << 0),
+    SubGhzWorkerEvtStop = (1 << 1),
+} SubGhzWorkerEvt;
+
 struct SubGhzWorker {
     FuriThread* thread;
-    StreamBufferHandle_t stream;
+
+    // Single producer (capture ISR), single consumer (worker thread) ring.
+    // head and tail are free running, only the ISR writes head and only the thread writes tail.
+    LevelDuration ring[SUBGHZ_WORKER_RING_SIZE];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile bool wake_pending;
 
     volatile bool running;
     volatile bool overrun;
+    volatile uint32_t overrun_count;
+    volatile uint32_t high_water;
+    uint32_t batch_count;
 
     LevelDuration filter_level_duration;
     bool filter_running;
@@ -29,17 +50,63 @@ struct SubGhzWorker {
  */
 void subghz_worker_rx_callback(bool level, uint32_t duration, void* context) {
     SubGhzWorker* instance = context;
+    // Capture may outlive the worker thread, never signal a thread that is gone
+    if(!instance->running) return;
+
+    uint32_t head = instance->head;
+    uint32_t used = head - instance->tail;
+    if(used == SUBGHZ_WORKER_RING_SIZE) {
+        instance->overrun = true;
+        instance->overrun_count++;
+        return;
+    }
 
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    LevelDuration level_duration = level_duration_make(level, duration);
     if(instance->overrun) {
         instance->overrun = false;
-        level_duration = level_duration_reset();
+        instance->ring[head & SUBGHZ_WORKER_RING_MASK] = level_duration_reset();
+    } else {
+        instance->ring[head & SUBGHZ_WORKER_RING_MASK] = level_duration_make(level, duration);
+    }
+    // Publish the slot before the index
+    __DMB();
+    instance->head = head + 1;
+
+    used++;
+    if(used > instance->high_water) instance->high_water = used;
+    if(used >= SUBGHZ_WORKER_BATCH && !instance->wake_pending) {
+        instance->wake_pending = true;
+        osThreadFlagsSet(furi_thread_get_thread_id(instance->thread), SubGhzWorkerEvtRx);
+    }
+}
+
+static inline void subghz_worker_process(SubGhzWorker* instance, LevelDuration level_duration) {
+    if(level_duration_is_reset(level_duration)) {
+        FURI_LOG_E(TAG, "Overrun buffer");
+        if(instance->overrun_callback) instance->overrun_callback(instance->context);
+    } else {
+        bool level = level_duration_get_level(level_duration);
+        uint32_t duration = level_duration_get_duration(level_duration);
+
+        if(instance->filter_running) {
+            if((duration < instance->filter_duration) ||
+               (instance->filter_level_duration.level == level)) {
+                instance->filter_level_duration.duration += duration;
+
+            } else if(instance->filter_level_duration.level != level) {
+                if(instance->pair_callback)
+                    instance->pair_callback(
+                        instance->context,
+                        instance->filter_level_duration.level,
+                        instance->filter_level_duration.duration);
+
+                instance->filter_level_duration.duration = duration;
+                instance->filter_level_duration.level = level;
+            }
+        } else {
+            if(instance->pair_callback)
+                instance->pair_callback(instance->context, level, duration);
+        }
     }
-    size_t ret = xStreamBufferSendFromISR(
-        instance->stream, &level_duration, sizeof(LevelDuration), &xHigherPriorityTaskWoken);
-    if(sizeof(LevelDuration) != ret) instance->overrun = true;
-    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 /** Worker callback thread
@@ -50,40 +117,23 @@ void subghz_worker_rx_callback(bool level, uint32_t duration, void* context) {
 static int32_t subghz_worker_thread_callback(void* context) {
     SubGhzWorker* instance = context;
 
-    LevelDuration level_duration;
     while(instance->running) {
-        int ret =
-            xStreamBufferReceive(instance->stream, &level_duration, sizeof(LevelDuration), 10);
-        if(ret == sizeof(LevelDuration)) {
-            if(level_duration_is_reset(level_duration)) {
-                FURI_LOG_E(TAG, "Overrun buffer");
-                ;
-                if(instance->overrun_callback) instance->overrun_callback(instance->context);
-            } else {
-                bool level = level_duration_get_level(level_duration);
-                uint32_t duration = level_duration_get_duration(level_duration);
-
-                if(instance->filter_running) {
-                    if((duration < instance->filter_duration) ||
-                       (instance->filter_level_duration.level == level)) {
-                        instance->filter_level_duration.duration += duration;
-
-                    } else if(instance->filter_level_duration.level != level) {
-                        if(instance->pair_callback)
-                            instance->pair_callback(
-                                instance->context,
-                                instance->filter_level_duration.level,
-                                instance->filter_level_duration.duration);
-
-                        instance->filter_level_duration.duration = duration;
-                        instance->filter_level_duration.level = level;
-                    }
-                } else {
-                    if(instance->pair_callback)
-                        instance->pair_callback(instance->context, level, duration);
-                }
-            }
+        osThreadFlagsWait(
+            SubGhzWorkerEvtRx | SubGhzWorkerEvtStop, osFlagsWaitAny, SUBGHZ_WORKER_TIMEOUT);
+        instance->wake_pending = false;
+
+        // Drain everything queued so far, then release the slots in one go
+        uint32_t head = instance->head;
+        __DMB();
+        uint32_t tail = instance->tail;
+        if(tail == head) continue;
+        instance->batch_count++;
+        while(tail != head) {
+            subghz_worker_process(instance, instance->ring[tail & SUBGHZ_WORKER_RING_MASK]);
+            tail++;
         }
+        __DMB();
+        instance->tail = tail;
     }
 
     return 0;
@@ -98,8 +148,6 @@ SubGhzWorker* subghz_worker_alloc() {
     furi_thread_set_context(instance->thread, instance);
     furi_thread_set_callback(instance->thread, subghz_worker_thread_callback);
 
-    instance->stream = xStreamBufferCreate(sizeof(LevelDuration) * 2048, sizeof(LevelDuration));
-
     //setting filter
     instance->filter_running = true;
     instance->filter_duration = 20;
@@ -110,7 +158,6 @@ SubGhzWorker* subghz_worker_alloc() {
 void subghz_worker_free(SubGhzWorker* instance) {
     furi_assert(instance);
 
-    vStreamBufferDelete(instance->stream);
     furi_thread_free(instance->thread);
 
     free(instance);
@@ -137,6 +184,11 @@ void subghz_worker_start(SubGhzWorker* instance) {
     furi_assert(instance);
     furi_assert(!instance->running);
 
+    // Capture may already be running, drop what it queued from the consumer side
+    instance->tail = instance->head;
+    instance->overrun_count = 0;
+    instance->high_water = 0;
+    instance->batch_count = 0;
     instance->running = true;
 
     furi_thread_start(instance->thread);
@@ -147,6 +199,7 @@ void subghz_worker_stop(SubGhzWorker* instance) {
     furi_assert(instance->running);
 
     instance->running = false;
+    osThreadFlagsSet(furi_thread_get_thread_id(instance->thread), SubGhzWorkerEvtStop);
 
     furi_thread_join(instance->thread);
 }
@@ -155,3 +208,12 @@ bool subghz_worker_is_running(SubGhzWorker* instance) {
     furi_assert(instance);
     return instance->running;
 }
+
+void subghz_worker_get_stats(SubGhzWorker* instance, SubGhzWorkerStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+    stats->overrun_count = instance->overrun_count;
+    stats->high_water = instance->high_water;
+    stats->batch_count = instance->batch_count;
+    stats->capacity = SUBGHZ_WORKER_RING_SIZE;
+}
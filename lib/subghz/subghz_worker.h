@@ -4,6 +4,13 @@
 
 typedef struct SubGhzWorker SubGhzWorker;
 
+typedef struct {
+    uint32_t overrun_count; /**< Edges dropped because the ring was full */
+    uint32_t high_water; /**< Highest ring fill, edges */
+    uint32_t batch_count; /**< Ring drains done by the worker thread */
+    uint32_t capacity; /**< Ring size, edges */
+} SubGhzWorkerStats;
+
 typedef void (*SubGhzWorkerOverrunCallback)(void* context);
 
 typedef void (*SubGhzWorkerPairCallback)(void* context, bool level, uint32_t duration);
@@ -62,3 +69,10 @@ void subghz_worker_stop(SubGhzWorker* instance);
  * @return bool - true if running
  */
 bool subghz_worker_is_running(SubGhzWorker* instance);
+
+/** 
+ * Get capture statistics since the last start.
+ * @param instance Pointer to a SubGhzWorker instance
+ * @param stats Pointer to a SubGhzWorkerStats to fill
+ */
+void subghz_worker_get_stats(SubGhzWorker* instance, SubGhzWorkerStats* stats);
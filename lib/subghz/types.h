@@ -38,10 +38,17 @@ typedef bool (*SubGhzSerialize)(
 typedef bool (*SubGhzDeserialize)(void* context, FlipperFormat* flipper_format);
 
 // Decoder specific
+typedef struct {
+    bool level;
+    uint32_t duration_min;
+    uint32_t duration_max;
+} SubGhzProtocolDecoderWake;
+
 typedef void (*SubGhzDecoderFeed)(void* decoder, bool level, uint32_t duration);
 typedef void (*SubGhzDecoderReset)(void* decoder);
 typedef uint8_t (*SubGhzGetHashData)(void* decoder);
 typedef void (*SubGhzGetString)(void* decoder, string_t output);
+typedef bool (*SubGhzDecoderGetWake)(void* decoder, SubGhzProtocolDecoderWake* wake);
 
 // Encoder specific
 typedef void (*SubGhzEncoderStop)(void* encoder);
@@ -58,6 +65,8 @@ typedef struct {
     SubGhzGetString get_string;
     SubGhzSerialize serialize;
     SubGhzDeserialize deserialize;
+
+    SubGhzDecoderGetWake get_wake;
 } SubGhzProtocolDecoder;
 
 typedef struct {
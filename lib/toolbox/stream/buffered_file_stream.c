@@ -0,0 +1,372 @@
+#include "stream.h"
+#include "stream_i.h"
+#include "buffered_file_stream.h"
+#include "file_stream_i.h"
+
+#define BUFFERED_FILE_STREAM_POSITION_UNKNOWN SIZE_MAX
+
+typedef struct {
+    Stream stream_base;
+    Storage* storage;
+    File* file;
+
+    uint8_t* buffer;
+    size_t buffer_size;
+    // file offset of the first buffered byte
+    size_t buffer_offset;
+    size_t buffer_length;
+    // buffer holds data that is not in the file yet
+    bool buffer_dirty;
+
+    size_t position;
+    size_t size;
+    // storage file pointer, seek is only sent when it differs
+    size_t file_position;
+} BufferedFileStream;
+
+static void buffered_file_stream_free(BufferedFileStream* stream);
+static bool buffered_file_stream_eof(BufferedFileStream* stream);
+static void buffered_file_stream_clean(BufferedFileStream* stream);
+static bool buffered_file_stream_seek(
+    BufferedFileStream* stream,
+    int32_t offset,
+    StreamOffset offset_type);
+static size_t buffered_file_stream_tell(BufferedFileStream* stream);
+static size_t buffered_file_stream_size(BufferedFileStream* stream);
+static size_t
+    buffered_file_stream_write(BufferedFileStream* stream, const uint8_t* data, size_t size);
+static size_t buffered_file_stream_read(BufferedFileStream* stream, uint8_t* data, size_t size);
+static bool buffered_file_stream_delete_and_insert(
+    BufferedFileStream* stream,
+    size_t delete_size,
+    StreamWriteCB write_callback,
+    const void* ctx);
+
+const StreamVTable buffered_file_stream_vtable = {
+    .free = (StreamFreeFn)buffered_file_stream_free,
+    .eof = (StreamEOFFn)buffered_file_stream_eof,
+    .clean = (StreamCleanFn)buffered_file_stream_clean,
+    .seek = (StreamSeekFn)buffered_file_stream_seek,
+    .tell = (StreamTellFn)buffered_file_stream_tell,
+    .size = (StreamSizeFn)buffered_file_stream_size,
+    .write = (StreamWriteFn)buffered_file_stream_write,
+    .read = (StreamReadFn)buffered_file_stream_read,
+    .delete_and_insert = (StreamDeleteAndInsertFn)buffered_file_stream_delete_and_insert,
+};
+
+static void buffered_file_stream_reset(BufferedFileStream* stream) {
+    stream->buffer_offset = 0;
+    stream->buffer_length = 0;
+    stream->buffer_dirty = false;
+    stream->position = 0;
+    stream->size = 0;
+    stream->file_position = 0;
+}
+
+static bool buffered_file_stream_file_seek(BufferedFileStream* stream, size_t position) {
+    if(stream->file_position == position) return true;
+
+    bool result = storage_file_seek(stream->file, position, true);
+    stream->file_position = result ? position : BUFFERED_FILE_STREAM_POSITION_UNKNOWN;
+    return result;
+}
+
+static size_t
+    buffered_file_stream_file_read(BufferedFileStream* stream, uint8_t* data, size_t size) {
+    size_t need_to_read = size;
+    while(need_to_read > 0) {
+        uint16_t was_read = storage_file_read(
+            stream->file, data + (size - need_to_read), MIN(need_to_read, UINT16_MAX));
+        need_to_read -= was_read;
+        stream->file_position += was_read;
+
+        if(was_read == 0) break;
+    }
+
+    return size - need_to_read;
+}
+
+static size_t
+    buffered_file_stream_file_write(BufferedFileStream* stream, const uint8_t* data, size_t size) {
+    size_t need_to_write = size;
+    while(need_to_write > 0) {
+        uint16_t was_written = storage_file_write(
+            stream->file, data + (size - need_to_write), MIN(need_to_write, UINT16_MAX));
+        need_to_write -= was_written;
+        stream->file_position += was_written;
+
+        if(was_written == 0) break;
+    }
+
+    return size - need_to_write;
+}
+
+static bool buffered_file_stream_flush(BufferedFileStream* stream) {
+    if(!stream->buffer_dirty) return true;
+    stream->buffer_dirty = false;
+
+    bool result = false;
+    if(buffered_file_stream_file_seek(stream, stream->buffer_offset)) {
+        size_t was_written =
+            buffered_file_stream_file_write(stream, stream->buffer, stream->buffer_length);
+        result = (was_written == stream->buffer_length);
+    }
+
+    // flushed data stays in the buffer as read cache
+    if(!result) stream->buffer_length = 0;
+    return result;
+}
+
+static bool buffered_file_stream_truncate(BufferedFileStream* stream) {
+    bool result = false;
+    if(buffered_file_stream_flush(stream) &&
+       buffered_file_stream_file_seek(stream, stream->position)) {
+        result = storage_file_truncate(stream->file);
+    }
+
+    if(result) {
+        stream->size = stream->position;
+        if(stream->buffer_offset + stream->buffer_length > stream->size) {
+            stream->buffer_length = stream->size > stream->buffer_offset ?
+                                        stream->size - stream->buffer_offset :
+                                        0;
+        }
+    }
+
+    return result;
+}
+
+Stream* buffered_file_stream_alloc(Storage* storage) {
+    return buffered_file_stream_alloc_ex(storage, BUFFERED_FILE_STREAM_BUFFER_SIZE);
+}
+
+Stream* buffered_file_stream_alloc_ex(Storage* storage, size_t buffer_size) {
+    furi_assert(buffer_size);
+    BufferedFileStream* stream = malloc(sizeof(BufferedFileStream));
+    stream->file = storage_file_alloc(storage);
+    stream->storage = storage;
+    stream->buffer = malloc(buffer_size);
+    stream->buffer_size = buffer_size;
+    buffered_file_stream_reset(stream);
+
+    stream->stream_base.vtable = &buffered_file_stream_vtable;
+    return (Stream*)stream;
+}
+
+bool buffered_file_stream_open(
+    Stream* _stream,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode) {
+    furi_assert(_stream);
+    BufferedFileStream* stream = (BufferedFileStream*)_stream;
+    furi_check(stream->stream_base.vtable == &buffered_file_stream_vtable);
+
+    buffered_file_stream_reset(stream);
+    bool result = storage_file_open(stream->file, path, access_mode, open_mode);
+    if(result) {
+        // append mode leaves the file pointer at the end
+        stream->size = storage_file_size(stream->file);
+        stream->position = storage_file_tell(stream->file);
+        stream->file_position = stream->position;
+    }
+
+    return result;
+}
+
+bool buffered_file_stream_close(Stream* _stream) {
+    furi_assert(_stream);
+    BufferedFileStream* stream = (BufferedFileStream*)_stream;
+    furi_check(stream->stream_base.vtable == &buffered_file_stream_vtable);
+
+    bool result = buffered_file_stream_flush(stream);
+    if(!storage_file_close(stream->file)) result = false;
+    buffered_file_stream_reset(stream);
+
+    return result;
+}
+
+bool buffered_file_stream_sync(Stream* _stream) {
+    furi_assert(_stream);
+    BufferedFileStream* stream = (BufferedFileStream*)_stream;
+    furi_check(stream->stream_base.vtable == &buffered_file_stream_vtable);
+    return buffered_file_stream_flush(stream);
+}
+
+FS_Error buffered_file_stream_get_error(Stream* _stream) {
+    furi_assert(_stream);
+    BufferedFileStream* stream = (BufferedFileStream*)_stream;
+    furi_check(stream->stream_base.vtable == &buffered_file_stream_vtable);
+    return storage_file_get_error(stream->file);
+}
+
+static void buffered_file_stream_free(BufferedFileStream* stream) {
+    buffered_file_stream_flush(stream);
+    storage_file_free(stream->file);
+    free(stream->buffer);
+    free(stream);
+}
+
+static bool buffered_file_stream_eof(BufferedFileStream* stream) {
+    return stream->position >= stream->size;
+}
+
+static void buffered_file_stream_clean(BufferedFileStream* stream) {
+    stream->position = 0;
+    buffered_file_stream_truncate(stream);
+}
+
+static bool buffered_file_stream_seek(
+    BufferedFileStream* stream,
+    int32_t offset,
+    StreamOffset offset_type) {
+    bool result = false;
+    size_t seek_position = 0;
+    size_t current_position = stream->position;
+    size_t size = stream->size;
+
+    // calc offset and limit to bottom
+    switch(offset_type) {
+    case StreamOffsetFromCurrent: {
+        if((int32_t)(current_position + offset) >= 0) {
+            seek_position = current_position + offset;
+            result = true;
+        }
+    } break;
+    case StreamOffsetFromStart: {
+        if(offset >= 0) {
+            seek_position = offset;
+            result = true;
+        }
+    } break;
+    case StreamOffsetFromEnd: {
+        if((int32_t)(size + offset) >= 0) {
+            seek_position = size + offset;
+            result = true;
+        }
+    } break;
+    }
+
+    // file pointer is moved lazily, on the next read or write
+    if(result) {
+        // limit to top
+        if((int32_t)(seek_position - size) > 0) {
+            stream->position = size;
+            result = false;
+        } else {
+            stream->position = seek_position;
+        }
+    } else {
+        stream->position = 0;
+    }
+
+    // leaving the end of the write buffer ends the sequential write, errors show up here
+    if(stream->buffer_dirty && stream->position != stream->buffer_offset + stream->buffer_length) {
+        if(!buffered_file_stream_flush(stream)) result = false;
+    }
+
+    return result;
+}
+
+static size_t buffered_file_stream_tell(BufferedFileStream* stream) {
+    return stream->position;
+}
+
+static size_t buffered_file_stream_size(BufferedFileStream* stream) {
+    return stream->size;
+}
+
+static size_t
+    buffered_file_stream_write(BufferedFileStream* stream, const uint8_t* data, size_t size) {
+    if(!stream->buffer_dirty) {
+        // read cache becomes the write buffer
+        stream->buffer_offset = stream->position;
+        stream->buffer_length = 0;
+        stream->buffer_dirty = true;
+    }
+
+    size_t need_to_write = size;
+    while(need_to_write > 0) {
+        // only sequential writes are collected
+        if(stream->position != stream->buffer_offset + stream->buffer_length ||
+           stream->buffer_length == stream->buffer_size) {
+            if(!buffered_file_stream_flush(stream)) break;
+            stream->buffer_offset = stream->position;
+            stream->buffer_length = 0;
+            stream->buffer_dirty = true;
+        }
+
+        // large writes bypass the buffer
+        if(stream->buffer_length == 0 && need_to_write >= stream->buffer_size) {
+            stream->buffer_dirty = false;
+            if(!buffered_file_stream_file_seek(stream, stream->position)) break;
+            size_t was_written = buffered_file_stream_file_write(
+                stream, data + (size - need_to_write), need_to_write);
+            stream->position += was_written;
+            need_to_write -= was_written;
+            break;
+        }
+
+        size_t chunk = MIN(need_to_write, stream->buffer_size - stream->buffer_length);
+        memcpy(stream->buffer + stream->buffer_length, data + (size - need_to_write), chunk);
+        stream->buffer_length += chunk;
+        stream->position += chunk;
+        need_to_write -= chunk;
+    }
+
+    stream->size = MAX(stream->size, stream->position);
+    return size - need_to_write;
+}
+
+static size_t buffered_file_stream_read(BufferedFileStream* stream, uint8_t* data, size_t size) {
+    if(!buffered_file_stream_flush(stream)) return 0;
+
+    size_t need_to_read = size;
+    while(need_to_read > 0 && stream->position < stream->size) {
+        size_t buffer_end = stream->buffer_offset + stream->buffer_length;
+
+        if(stream->position >= stream->buffer_offset && stream->position < buffer_end) {
+            size_t chunk = MIN(need_to_read, buffer_end - stream->position);
+            memcpy(
+                data + (size - need_to_read),
+                stream->buffer + (stream->position - stream->buffer_offset),
+                chunk);
+            stream->position += chunk;
+            need_to_read -= chunk;
+        } else if(need_to_read >= stream->buffer_size) {
+            // large reads bypass the buffer
+            if(!buffered_file_stream_file_seek(stream, stream->position)) break;
+            size_t was_read =
+                buffered_file_stream_file_read(stream, data + (size - need_to_read), need_to_read);
+            stream->position += was_read;
+            need_to_read -= was_read;
+            break;
+        } else {
+            // refill
+            stream->buffer_length = 0;
+            if(!buffered_file_stream_file_seek(stream, stream->position)) break;
+            stream->buffer_offset = stream->position;
+            stream->buffer_length =
+                buffered_file_stream_file_read(stream, stream->buffer, stream->buffer_size);
+            if(stream->buffer_length == 0) break;
+        }
+    }
+
+    return size - need_to_read;
+}
+
+static bool buffered_file_stream_delete_and_insert(
+    BufferedFileStream* stream,
+    size_t delete_size,
+    StreamWriteCB write_callback,
+    const void* ctx) {
+    if(!buffered_file_stream_flush(stream)) return false;
+
+    return file_stream_delete_and_insert_with_scratchpad(
+        (Stream*)stream,
+        stream->storage,
+        delete_size,
+        write_callback,
+        ctx,
+        (FileStreamTruncateFn)buffered_file_stream_truncate);
+}
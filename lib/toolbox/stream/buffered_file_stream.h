@@ -0,0 +1,64 @@
+#pragma once
+#include <stdlib.h>
+#include <storage/storage.h>
+#include "stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Default read-ahead / write-behind buffer size */
+#define BUFFERED_FILE_STREAM_BUFFER_SIZE 512
+
+/**
+ * Allocate buffered file stream with the default buffer size
+ * @return Stream*
+ */
+Stream* buffered_file_stream_alloc(Storage* storage);
+
+/**
+ * Allocate buffered file stream
+ * @param storage pointer to storage api
+ * @param buffer_size read-ahead / write-behind buffer size
+ * @return Stream*
+ */
+Stream* buffered_file_stream_alloc_ex(Storage* storage, size_t buffer_size);
+
+/**
+ * Opens an existing file or create a new one.
+ * @param stream pointer to buffered file stream object.
+ * @param path path to file
+ * @param access_mode access mode from FS_AccessMode
+ * @param open_mode open mode from FS_OpenMode
+ * @return success flag. You need to close the file even if the open operation failed.
+ */
+bool buffered_file_stream_open(
+    Stream* stream,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode);
+
+/**
+ * Writes buffered data to the file and closes it.
+ * @param stream pointer to buffered file stream object.
+ * @return success flag
+ */
+bool buffered_file_stream_close(Stream* stream);
+
+/**
+ * Writes buffered data to the file.
+ * @param stream pointer to buffered file stream object.
+ * @return success flag
+ */
+bool buffered_file_stream_sync(Stream* stream);
+
+/**
+ * Retrieves the error id from the file object
+ * @param stream pointer to stream object.
+ * @return FS_Error error id
+ */
+FS_Error buffered_file_stream_get_error(Stream* stream);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,6 +1,7 @@
 #include "stream.h"
 #include "stream_i.h"
 #include "file_stream.h"
+#include "file_stream_i.h"
 
 typedef struct {
     Stream stream_base;
@@ -161,22 +162,41 @@ static size_t file_stream_read(FileStream* stream, uint8_t* data, size_t size) {
     return size - need_to_read;
 }
 
+static bool file_stream_truncate(FileStream* stream) {
+    return storage_file_truncate(stream->file);
+}
+
 static bool file_stream_delete_and_insert(
-    FileStream* _stream,
+    FileStream* stream,
     size_t delete_size,
     StreamWriteCB write_callback,
     const void* ctx) {
+    return file_stream_delete_and_insert_with_scratchpad(
+        (Stream*)stream,
+        stream->storage,
+        delete_size,
+        write_callback,
+        ctx,
+        (FileStreamTruncateFn)file_stream_truncate);
+}
+
+bool file_stream_delete_and_insert_with_scratchpad(
+    Stream* stream,
+    Storage* storage,
+    size_t delete_size,
+    StreamWriteCB write_callback,
+    const void* ctx,
+    FileStreamTruncateFn truncate) {
     bool result = false;
-    Stream* stream = (Stream*)_stream;
 
     // open scratchpad
-    Stream* scratch_stream = file_stream_alloc(_stream->storage);
+    Stream* scratch_stream = file_stream_alloc(storage);
 
     // TODO: we need something like "storage_open_tmpfile and storage_close_tmpfile"
     string_t scratch_name;
     string_t tmp_name;
     string_init(tmp_name);
-    storage_get_next_filename(_stream->storage, "/any", ".scratch", ".pad", tmp_name, 255);
+    storage_get_next_filename(storage, "/any", ".scratch", ".pad", tmp_name, 255);
     string_init_printf(scratch_name, "/any/%s.pad", string_get_cstr(tmp_name));
     string_clear(tmp_name);
 
@@ -215,7 +235,7 @@ static bool file_stream_delete_and_insert(
         if(stream_copy(scratch_stream, stream, new_file_size) != new_file_size) break;
 
         // and truncate original file
-        if(!storage_file_truncate(_stream->file)) break;
+        if(!truncate(stream)) break;
 
         // move seek pointer at insert end
         if(!stream_seek(stream, new_position, StreamOffsetFromStart)) break;
@@ -224,7 +244,7 @@ static bool file_stream_delete_and_insert(
     } while(false);
 
     stream_free(scratch_stream);
-    storage_common_remove(_stream->storage, string_get_cstr(scratch_name));
+    storage_common_remove(storage, string_get_cstr(scratch_name));
     string_clear(scratch_name);
 
     return result;
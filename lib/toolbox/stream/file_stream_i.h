@@ -0,0 +1,32 @@
+#pragma once
+#include <storage/storage.h>
+#include "stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef bool (*FileStreamTruncateFn)(Stream* stream);
+
+/**
+ * Deletes and inserts data through a scratchpad file, shared by file based streams.
+ * Stream is read and written with the generic stream functions.
+ * @param stream file based stream
+ * @param storage storage of the stream, scratchpad is created on it
+ * @param delete_size size of the data to delete at the current position
+ * @param write_callback inserted data writer, can be NULL
+ * @param ctx write_callback context
+ * @param truncate truncates the stream at its current position
+ * @return true on success
+ */
+bool file_stream_delete_and_insert_with_scratchpad(
+    Stream* stream,
+    Storage* storage,
+    size_t delete_size,
+    StreamWriteCB write_callback,
+    const void* ctx,
+    FileStreamTruncateFn truncate);
+
+#ifdef __cplusplus
+}
+#endif
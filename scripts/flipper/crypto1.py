@@ -0,0 +1,269 @@
+"""Crypto1 cipher and mfkey32 key recovery
+
+Same algorithms as lib/nfc_protocols/crypto1.c and the proxmark3 crapto1 library
+(https://github.com/RfidResearchGroup/proxmark3.git). State halves are plain ints.
+"""
+
+LF_POLY_ODD = 0x29CE5C
+LF_POLY_EVEN = 0x870804
+MASK32 = 0xFFFFFFFF
+
+
+def _filter_table():
+    # Nibble functions of the filter, combined into tables for 8 bits at a time
+    low = [(0xF22C0 >> (i & 0xF) & 16) | (0x6C9C0 >> (i >> 4) & 8) for i in range(256)]
+    high = [(0x3C8B0 >> (i & 0xF) & 4) | (0x1E458 >> (i >> 4) & 2) for i in range(256)]
+    top = [0x0D938 >> i & 1 for i in range(16)]
+    return bytes(
+        0xEC57E80A >> (low[i & 0xFF] | high[i >> 8 & 0xFF] | top[i >> 16]) & 1
+        for i in range(1 << 20)
+    )
+
+
+# Filter output for the lowest 20 bits of the odd half
+FILTER = _filter_table()
+
+
+try:
+    _popcount = int.bit_count
+except AttributeError:
+
+    def _popcount(x):
+        return bin(x).count("1")
+
+
+def parity(x):
+    return _popcount(x) & 1
+
+
+def bebit(x, n):
+    return x >> (n ^ 24) & 1
+
+
+def prng_successor(x, n):
+    x = int.from_bytes(x.to_bytes(4, "big"), "little")
+    for _ in range(n):
+        x = x >> 1 | ((x >> 16 ^ x >> 18 ^ x >> 19 ^ x >> 21) & 1) << 31
+    return int.from_bytes(x.to_bytes(4, "big"), "little")
+
+
+class Crypto1:
+    def __init__(self, key=0, odd=None, even=None):
+        if odd is not None:
+            self.odd, self.even = odd, even
+            return
+        self.odd = self.even = 0
+        for i in range(47, 0, -2):
+            self.odd = self.odd << 1 | key >> ((i - 1) ^ 7) & 1
+            self.even = self.even << 1 | key >> (i ^ 7) & 1
+
+    def bit(self, data, is_encrypted=False):
+        out = FILTER[self.odd & 0xFFFFF]
+        feed = (out & is_encrypted) ^ (1 if data else 0)
+        feed ^= parity((self.odd & LF_POLY_ODD) ^ (self.even & LF_POLY_EVEN))
+        self.even = (self.even << 1 | feed) & MASK32
+        self.odd, self.even = self.even, self.odd
+        return out
+
+    def word(self, data, is_encrypted=False):
+        out = 0
+        for i in range(32):
+            out |= self.bit(bebit(data, i), is_encrypted) << (24 ^ i)
+        return out
+
+    def rollback_bit(self, data, is_encrypted=False):
+        self.odd &= 0xFFFFFF
+        self.odd, self.even = self.even, self.odd
+        feed = self.even & 1
+        self.even >>= 1
+        feed ^= parity((self.odd & LF_POLY_ODD) ^ (self.even & LF_POLY_EVEN))
+        feed ^= 1 if data else 0
+        out = FILTER[self.odd & 0xFFFFF]
+        feed ^= out & is_encrypted
+        self.even |= feed << 23
+        return out
+
+    def rollback_word(self, data, is_encrypted=False):
+        out = 0
+        for i in range(31, -1, -1):
+            out |= self.rollback_bit(bebit(data, i), is_encrypted) << (24 ^ i)
+        return out
+
+    def get_key(self):
+        key = 0
+        for i in range(23, -1, -1):
+            key = key << 1 | self.odd >> (i ^ 3) & 1
+            key = key << 1 | self.even >> (i ^ 3) & 1
+        return key
+
+
+def _extend_simple(table, bit):
+    result = []
+    append = result.append
+    for value in table:
+        value <<= 1
+        out = FILTER[value & 0xFFFFF]
+        if out != FILTER[(value | 1) & 0xFFFFF]:
+            append(value | (out ^ bit))
+        elif out == bit:
+            append(value)
+            append(value | 1)
+    return result
+
+
+def _extend(table, bit, mask1, mask2, data):
+    # Top byte of every entry accumulates the LFSR feedback contribution of its half
+    data <<= 24
+    result = []
+    append = result.append
+    popcount = _popcount
+    for value in table:
+        value = value << 1 & MASK32
+        out = FILTER[value & 0xFFFFF]
+        if out != FILTER[(value | 1) & 0xFFFFF]:
+            values = (value | (out ^ bit),)
+        elif out == bit:
+            values = (value, value | 1)
+        else:
+            continue
+        for value in values:
+            p = (value >> 25) << 2
+            p |= (popcount(value & mask1) & 1) << 1 | popcount(value & mask2) & 1
+            append((p << 24 | (value & 0xFFFFFF)) & MASK32 ^ data)
+    return result
+
+
+def _recover(odd, odd_ks, even, even_ks, rem, data, states, tasks=None):
+    if rem == -1:
+        feed_in = 1 if data & 4 else 0
+        for e in even:
+            e = (e << 1 ^ parity(e & LF_POLY_EVEN) ^ feed_in) & MASK32
+            for o in odd:
+                states.append((e ^ parity(o & LF_POLY_ODD), o))
+        return
+
+    i = 0
+    while i < 4:
+        rem -= 1
+        if rem == -1:
+            break
+        odd_ks >>= 1
+        even_ks >>= 1
+        data >>= 2
+        odd = _extend(odd, odd_ks & 1, LF_POLY_EVEN << 1 | 1, LF_POLY_ODD << 1, 0)
+        if not odd:
+            return
+        even = _extend(even, even_ks & 1, LF_POLY_ODD, LF_POLY_EVEN << 1 | 1, data & 3)
+        if not even:
+            return
+        i += 1
+
+    # Halves can only be combined when their feedback contributions match
+    buckets = {}
+    for o in odd:
+        buckets.setdefault(o >> 24, ([], []))[0].append(o)
+    for e in even:
+        bucket = buckets.get(e >> 24)
+        if bucket is not None:
+            bucket[1].append(e)
+    for odd_bucket, even_bucket in buckets.values():
+        if not even_bucket:
+            continue
+        if tasks is not None:
+            tasks.append((odd_bucket, odd_ks, even_bucket, even_ks, rem, data))
+        else:
+            _recover(odd_bucket, odd_ks, even_bucket, even_ks, rem, data, states)
+
+
+def lfsr_recovery32_tasks(keystream, data=0):
+    """Split lfsr_recovery32 into independent tasks for lfsr_recovery32_run"""
+    odd_ks = even_ks = 0
+    for i in range(31, -1, -2):
+        odd_ks = odd_ks << 1 | bebit(keystream, i)
+    for i in range(30, -1, -2):
+        even_ks = even_ks << 1 | bebit(keystream, i)
+
+    # All 20 bit halves giving the first bit of their half of the keystream
+    odd = [i for i in range(1 << 20) if FILTER[i] == odd_ks & 1]
+    even = [i for i in range(1 << 20) if FILTER[i] == even_ks & 1]
+
+    for _ in range(4):
+        odd_ks >>= 1
+        even_ks >>= 1
+        odd = _extend_simple(odd, odd_ks & 1)
+        even = _extend_simple(even, even_ks & 1)
+
+    data = (data >> 16 & 0xFF) | (data << 16 & MASK32) | (data & 0xFF00)
+    tasks = []
+    _recover(odd, odd_ks, even, even_ks, 11, data << 1 & MASK32, None, tasks)
+    return tasks
+
+
+def lfsr_recovery32_run(task):
+    states = []
+    _recover(*task, states)
+    return states
+
+
+def lfsr_recovery32(keystream, data=0):
+    """Get all states (odd, even) that produce 32 bits of keystream with given input.
+
+    States are the ones after the keystream was generated.
+    """
+    states = []
+    for task in lfsr_recovery32_tasks(keystream, data):
+        states += lfsr_recovery32_run(task)
+    return states
+
+
+def _mfkey32_check(auth, states):
+    uid, nt0, nr0_enc, ar0_enc, nt1, nr1_enc, ar1_enc = auth
+    ar1 = prng_successor(nt1, 64)
+    for odd, even in states:
+        state = Crypto1(odd=odd, even=even)
+        state.rollback_word(0)
+        state.rollback_word(nr0_enc, True)
+        state.rollback_word(uid ^ nt0)
+        key = state.get_key()
+
+        # Candidate has to explain the second authentication too
+        state = Crypto1(key)
+        state.word(uid ^ nt1)
+        state.word(nr1_enc, True)
+        if ar1_enc == state.word(0) ^ ar1:
+            return key
+    return None
+
+
+def mfkey32_tasks(auth):
+    """Split mfkey32 into independent tasks, to be run with mfkey32_run in any order"""
+    uid, nt0, nr0_enc, ar0_enc, nt1, nr1_enc, ar1_enc = auth
+    keystream = ar0_enc ^ prng_successor(nt0, 64)
+    return [(auth, task) for task in lfsr_recovery32_tasks(keystream)]
+
+
+def mfkey32_run(task):
+    auth, recovery_task = task
+    return _mfkey32_check(auth, lfsr_recovery32_run(recovery_task))
+
+
+def mfkey32(auth):
+    """Recover the key from two authentications of a reader to the same sector.
+
+    auth is (uid, nt0, nr0_enc, ar0_enc, nt1, nr1_enc, ar1_enc), reader nonces and
+    answers are the encrypted values seen on air. Returns the key or None.
+    """
+    for task in mfkey32_tasks(auth):
+        key = mfkey32_run(task)
+        if key is not None:
+            return key
+    return None
+
+
+def simulate_auth(key, uid, nt, nr):
+    """Encrypted reader nonce and answer of an authentication, as a sniffer sees them"""
+    state = Crypto1(key)
+    state.word(uid ^ nt)
+    nr_enc = nr ^ state.word(nr)
+    ar_enc = prng_successor(nt, 64) ^ state.word(0)
+    return nr_enc, ar_enc
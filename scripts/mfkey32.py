@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+
+from flipper.app import App
+from flipper import crypto1
+
+import multiprocessing
+import os
+import random
+import time
+
+
+class Main(App):
+    def init(self):
+        self.parser.add_argument(
+            "-j",
+            "--jobs",
+            type=int,
+            default=os.cpu_count(),
+            help="Worker processes",
+        )
+        self.subparsers = self.parser.add_subparsers(help="sub-command help")
+
+        # recover
+        self.parser_recover = self.subparsers.add_parser(
+            "recover", help="Recover key from two authentications"
+        )
+        for name in ("uid", "nt0", "nr0", "ar0", "nt1", "nr1", "ar1"):
+            self.parser_recover.add_argument(
+                name, type=self._hex, help=f"{name}, hex, encrypted as seen on air"
+            )
+        self.parser_recover.set_defaults(func=self.recover)
+
+        # log
+        self.parser_log = self.subparsers.add_parser(
+            "log",
+            help="Recover keys from a log, 'uid nt0 nr0 ar0 nt1 nr1 ar1' line per key",
+        )
+        self.parser_log.add_argument("path", help="Log file path")
+        self.parser_log.set_defaults(func=self.log)
+
+        # bench
+        self.parser_bench = self.subparsers.add_parser(
+            "bench", help="Benchmark cipher and recovery on generated authentications"
+        )
+        self.parser_bench.add_argument(
+            "-n", dest="count", type=int, default=2, help="Keys to recover"
+        )
+        self.parser_bench.add_argument(
+            "-s", dest="seed", type=int, default=0, help="Random seed"
+        )
+        self.parser_bench.set_defaults(func=self.bench)
+
+    @staticmethod
+    def _hex(value):
+        return int(value, 16)
+
+    def _recover(self, auth):
+        # Candidate buckets are independent, first one with the key ends the search
+        tasks = crypto1.mfkey32_tasks(auth)
+        with multiprocessing.Pool(self.args.jobs) as pool:
+            for key in pool.imap_unordered(crypto1.mfkey32_run, tasks):
+                if key is not None:
+                    return key
+        return None
+
+    def _recover_all(self, auths):
+        keys = []
+        start = time.monotonic()
+        for auth in auths:
+            key = self._recover(auth)
+            if key is None:
+                self.logger.error(f"UID {auth[0]:08X}: key not found")
+            else:
+                self.logger.info(f"UID {auth[0]:08X}: key {key:012X}")
+            keys.append(key)
+        elapsed = time.monotonic() - start
+        if auths:
+            self.logger.info(
+                f"{len(auths)} recoveries in {elapsed:.1f}s, "
+                f"{len(auths) / elapsed:.3f} recoveries/s, {self.args.jobs} jobs"
+            )
+        return keys
+
+    def recover(self):
+        args = self.args
+        auth = (args.uid, args.nt0, args.nr0, args.ar0, args.nt1, args.nr1, args.ar1)
+        keys = self._recover_all([auth])
+        return 0 if keys[0] is not None else 1
+
+    def log(self):
+        auths = []
+        with open(self.args.path, "r") as file:
+            for number, line in enumerate(file, 1):
+                line = line.split("#", 1)[0].strip()
+                if not line:
+                    continue
+                values = line.split()
+                if len(values) != 7:
+                    self.logger.error(f"{self.args.path}:{number}: expected 7 values")
+                    return 1
+                auths.append(tuple(self._hex(value) for value in values))
+
+        keys = self._recover_all(auths)
+        return 0 if all(key is not None for key in keys) else 1
+
+    def bench(self):
+        rng = random.Random(self.args.seed)
+
+        # Cipher alone
+        state = crypto1.Crypto1(rng.getrandbits(48))
+        words = 4096
+        start = time.monotonic()
+        for i in range(words):
+            state.word(i)
+        elapsed = time.monotonic() - start
+        self.logger.info(f"crypto1: {words * 32 / elapsed:.0f} bits/s")
+
+        auths = []
+        expected = []
+        for _ in range(self.args.count):
+            key = rng.getrandbits(48)
+            uid, nt0, nr0, nt1, nr1 = (rng.getrandbits(32) for _ in range(5))
+            nr0_enc, ar0_enc = crypto1.simulate_auth(key, uid, nt0, nr0)
+            nr1_enc, ar1_enc = crypto1.simulate_auth(key, uid, nt1, nr1)
+            auths.append((uid, nt0, nr0_enc, ar0_enc, nt1, nr1_enc, ar1_enc))
+            expected.append(key)
+
+        keys = self._recover_all(auths)
+        if keys != expected:
+            self.logger.error("Recovered keys don't match")
+            return 1
+        return 0
+
+
+if __name__ == "__main__":
+    Main()()